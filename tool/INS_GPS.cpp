@@ -41,6 +41,7 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 #include <string>
 #include <exception>
 
@@ -51,7 +52,7 @@
 
 #include <vector>
 #include <utility>
-#include <deque>
+#include <algorithm>
 
 #define IS_LITTLE_ENDIAN 1
 #include "SylphideStream.h"
@@ -69,6 +70,8 @@ typedef Processor_t::M_Observer_t M_Observer_t;
 #include "param/complex.h"
 VECTOR3_NO_FLY_WEIGHT(float_sylph_t);
 QUATERNION_NO_FLY_WEIGHT(float_sylph_t);
+VECTOR3_NO_FLY_WEIGHT(float);
+QUATERNION_NO_FLY_WEIGHT(float);
 
 #include "navigation/INS_GPS2.h"
 #include "navigation/INS_GPS_BE.h"
@@ -76,6 +79,13 @@ QUATERNION_NO_FLY_WEIGHT(float_sylph_t);
 #include "navigation/MagneticField.h"
 
 #include "analyze_common.h"
+#include "util/scratch_file.h"
+#include "util/time_ring.h"
+#include "util/measurement_scheduler.h"
+#include "util/shm_ring.h"
+#include "util/instrument.h"
+
+#include "calibration.h"
 
 struct Options : public GlobalOptions<float_sylph_t> {
   bool back_propagate;  //< true when use back_propagation, that is, smoothing.
@@ -89,13 +99,159 @@ struct Options : public GlobalOptions<float_sylph_t> {
   float_sylph_t back_propagate_depth;
   
   bool gps_fake_lock; //< true when gps dummy date is used.
+  
+  bool matrix_pool; //< true when matrix storage is recycled through a pool.
+  
+  bool sequential_correct; //< true when measurements with diagonal R are processed one by one.
+  
+  /**
+   * Number of IMU samples per covariance time update of the filter.
+   * 1 means every sample, and 0 means only before measurement updates.
+   * The navigation solution itself is always updated at every sample.
+   * With back_propagate, snapshots are taken at each covariance time update,
+   * and with rts_smooth, the forward pass is recorded at the same rate.
+   */
+  unsigned int predict_interval;
+  
+  typedef INS<float_sylph_t>::mechanization_t mechanization_t;
+  
+  /**
+   * Strapdown mechanization, "euler" (first order, default), "rk4" (fourth order Runge-Kutta),
+   * or "coning" (coning and sculling compensated increments, see INS_ConingSculling).
+   */
+  mechanization_t mechanization;
+  
+  /**
+   * Number of IMU samples combined into a navigation step,
+   * in which both the mechanization and the time update of the filter are performed.
+   * More than 1 implies the "coning" mechanization.
+   */
+  unsigned int nav_decimation;
+  
+  bool use_increment() const {
+    return (mechanization == INS<float_sylph_t>::MECHANIZATION_INCREMENT) || (nav_decimation > 1);
+  }
+  
+  static const char *mechanization_name(const mechanization_t &mech){
+    switch(mech){
+      case INS<float_sylph_t>::MECHANIZATION_RK4: return "rk4";
+      case INS<float_sylph_t>::MECHANIZATION_INCREMENT: return "coning";
+      default: return "euler";
+    }
+  }
+  
+  /**
+   * true when use offline Rauch-Tung-Striebel smoothing, which precedes back_propagate.
+   * The forward pass is stored in a scratch file, then the backward pass is performed at the end.
+   */
+  bool rts_smooth;
+  const char *rts_scratch_dir; //< directory of the scratch file, NULL means TMPDIR or /tmp.
+  
+  /**
+   * Overrides of the filter configuration, mainly for members of an ensemble.
+   * sigma_accel and sigma_gyro replace the ones of the calibration in the matrix Q,
+   * and lever_arm replaces the one given with the log.
+   */
+  bool has_sigma_accel, has_sigma_gyro, has_lever_arm;
+  Vector3<float_sylph_t> sigma_accel, sigma_gyro, lever_arm;
+  
+  /**
+   * File listing the configurations of an ensemble, one filter per line.
+   * Each line consists of options separated by white spaces, which override the common ones.
+   * Blank lines and lines starting with '#' are ignored.
+   * The log is decoded only once, and its records are fed to all the filters.
+   */
+  const char *ensemble_spec;
+  int ensemble_index; //< index in the ensemble, or negative when not a member.
+  
+  /**
+   * true when the navigator is computed in single precision (float),
+   * whose position is still integrated and corrected in double precision (@see INS).
+   * The inputs and the outputs are in float_sylph_t regardless of this option.
+   * Unless use_josephkf or use_srkf is specified, the UD filter is used,
+   * because the standard form covariance update loses the positive definiteness
+   * of the tiny position variances in single precision.
+   */
+  bool nav_float;
+  
+  /**
+   * true when the log is processed by a single precision navigator in addition to the normal one,
+   * in order to report the divergence of each state between them at the end.
+   * The output is the one of the normal navigator. It is ignored with ensemble.
+   */
+  bool precision_check;
+  
+  /**
+   * Tolerance of the cached magnetic field model in nT, which is used for yaw correction.
+   * The model is evaluated at the corners of a tile around the position and interpolated,
+   * and the tile is shrunk until the interpolation errors at its center, face centers,
+   * and edge midpoints are within the tolerance; otherwise, the model is evaluated directly.
+   * Zero or negative values disable the cache.
+   */
+  float_sylph_t mag_model_tolerance;
+  
+  /**
+   * true when each IMU sample is propagated and dumped as soon as it is read,
+   * for example, for a serial port input (@see loop_realtime()).
+   * The filter itself lags behind the samples by up to realtime_window seconds,
+   * in order to accept GPS solutions which arrive later than the IMU samples of the same time.
+   * back_propagate and rts_smooth are not available.
+   */
+  bool realtime;
+  float_sylph_t realtime_window; //< maximum delay of GPS solutions in seconds, which is also the lag of the filter.
+  
+  /**
+   * Name of the shared memory, to which each dumped state is published as NAVRecord
+   * in addition to the normal output (@see SharedMemoryRing).
+   * A member of an ensemble publishes only when its own name is specified.
+   */
+  const char *out_shm;
+  unsigned int out_shm_capacity; //< number of records in the shared memory
+  
+  /**
+   * Checkpoint file, to which the states of the filters and the input streams are saved
+   * at a measurement update every checkpoint_interval seconds in GPS time (@see Checkpoint).
+   * The processing is restarted from the saved point with resume option,
+   * whose other options must be the same as those of the saved one.
+   * They are not available with realtime.
+   */
+  const char *checkpoint;
+  float_sylph_t checkpoint_interval; //< interval of checkpoints in seconds
+  const char *resume; //< checkpoint file to be resumed, or NULL
 
   Options()
       : super_t(),
       back_propagate(false), back_propagate_depth(0),
-      gps_fake_lock(false) {}
+      gps_fake_lock(false),
+      matrix_pool(false),
+      sequential_correct(false),
+      predict_interval(1),
+      mechanization(INS<float_sylph_t>::MECHANIZATION_EULER), nav_decimation(1),
+      rts_smooth(false), rts_scratch_dir(NULL),
+      has_sigma_accel(false), has_sigma_gyro(false), has_lever_arm(false),
+      sigma_accel(), sigma_gyro(), lever_arm(),
+      ensemble_spec(NULL), ensemble_index(-1),
+      nav_float(false), precision_check(false),
+      mag_model_tolerance(1),
+      realtime(false), realtime_window(1),
+      out_shm(NULL), out_shm_capacity(0x400),
+      checkpoint(NULL), checkpoint_interval(60), resume(NULL) {}
   ~Options(){}
   
+  /**
+   * Parse "x,y,z" formatted value
+   * 
+   * @param value string to be parsed
+   * @param res parsed vector
+   * @return (bool) true when success, otherwise false
+   */
+  static bool parse_vector3(const char *value, Vector3<float_sylph_t> &res){
+    double buf[3];
+    if(std::sscanf(value, "%lf,%lf,%lf", &buf[0], &buf[1], &buf[2]) != 3){return false;}
+    res = Vector3<float_sylph_t>(buf[0], buf[1], buf[2]);
+    return true;
+  }
+  
   /**
    * Check spec
    * 
@@ -121,12 +277,163 @@ struct Options : public GlobalOptions<float_sylph_t> {
     CHECK_OPTION(fake_lock,
         gps_fake_lock = is_true(value),
         (gps_fake_lock ? "on" : "off"));
+    CHECK_OPTION(matrix_pool,
+        matrix_pool = is_true(value),
+        (matrix_pool ? "on" : "off"));
+    CHECK_OPTION(sequential_correct,
+        sequential_correct = is_true(value),
+        (sequential_correct ? "on" : "off"));
+    CHECK_OPTION(predict_interval,
+        predict_interval = std::atoi(value),
+        predict_interval);
+    CHECK_OPTION(mechanization,
+        if(std::strcmp(value, "euler") == 0){
+          mechanization = INS<float_sylph_t>::MECHANIZATION_EULER;
+        }else if(std::strcmp(value, "rk4") == 0){
+          mechanization = INS<float_sylph_t>::MECHANIZATION_RK4;
+        }else if(std::strcmp(value, "coning") == 0){
+          mechanization = INS<float_sylph_t>::MECHANIZATION_INCREMENT;
+        }else{
+          std::cerr << "(error!) mechanization option requires euler, rk4, or coning." << std::endl;
+          exit(-1);
+        },
+        mechanization_name(mechanization));
+    CHECK_OPTION(nav_decimation,
+        char *end;
+        long decimation(std::strtol(value, &end, 10));
+        if((end == value) || (*end != '\0') || (decimation < 1)){
+          std::cerr << "(error!) nav_decimation option requires a positive integer." << std::endl;
+          exit(-1);
+        }
+        nav_decimation = (unsigned int)decimation,
+        nav_decimation);
+    CHECK_OPTION(rts_smooth,
+        rts_smooth = is_true(value),
+        (rts_smooth ? "on" : "off"));
+    CHECK_OPTION(rts_scratch_dir,
+        rts_scratch_dir = value,
+        rts_scratch_dir);
+#define CHECK_VECTOR3_OPTION(name) \
+CHECK_OPTION(name, \
+    if(!(has_ ## name = parse_vector3(value, name))){ \
+      std::cerr << "(error!) " #name " option requires 3 arguments." << std::endl; \
+      exit(-1); \
+    }, \
+    name);
+    CHECK_VECTOR3_OPTION(sigma_accel);
+    CHECK_VECTOR3_OPTION(sigma_gyro);
+    CHECK_VECTOR3_OPTION(lever_arm);
+#undef CHECK_VECTOR3_OPTION
+    CHECK_OPTION(ensemble,
+        ensemble_spec = value,
+        ensemble_spec);
+    CHECK_OPTION(nav_float,
+        nav_float = is_true(value),
+        (nav_float ? "on" : "off"));
+    CHECK_OPTION(precision_check,
+        precision_check = is_true(value),
+        (precision_check ? "on" : "off"));
+    CHECK_OPTION(mag_model_tolerance,
+        mag_model_tolerance = std::atof(value),
+        mag_model_tolerance << " [nT]");
+    CHECK_OPTION(realtime,
+        realtime = is_true(value),
+        (realtime ? "on" : "off"));
+    CHECK_OPTION(realtime_window,
+        realtime_window = std::atof(value),
+        realtime_window << " [s]");
+    CHECK_OPTION(out_shm,
+        out_shm = value,
+        out_shm);
+    CHECK_OPTION(out_shm_capacity,
+        out_shm_capacity = std::atoi(value),
+        out_shm_capacity);
+    CHECK_OPTION(checkpoint,
+        checkpoint = value,
+        checkpoint);
+    CHECK_OPTION(checkpoint_interval,
+        checkpoint_interval = std::atof(value),
+        checkpoint_interval << " [s]");
+    CHECK_OPTION(resume,
+        resume = value,
+        resume);
 #undef CHECK_OPTION
     
     return super_t::check_spec(spec);
   }
 } options;
 
+/**
+ * Raw binary serialization used by checkpoints (@see Checkpoint).
+ * Values are stored in the native representation,
+ * therefore a checkpoint is loadable only by the same build on the same architecture.
+ */
+struct Serializer {
+  template <class T>
+  static void put(std::ostream &out, const T &value){
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+  template <class T>
+  static void get(std::istream &in, T &value) throw(std::ios_base::failure) {
+    if(!in.read(reinterpret_cast<char *>(&value), sizeof(T))){
+      throw std::ios_base::failure("Truncated checkpoint");
+    }
+  }
+  template <class FloatT>
+  static void put(std::ostream &out, const Vector3<FloatT> &v){
+    put(out, v.getX()); put(out, v.getY()); put(out, v.getZ());
+  }
+  template <class FloatT>
+  static void get(std::istream &in, Vector3<FloatT> &v) throw(std::ios_base::failure) {
+    FloatT x, y, z;
+    get(in, x); get(in, y); get(in, z);
+    v = Vector3<FloatT>(x, y, z);
+  }
+  template <class FloatT>
+  static void put(std::ostream &out, const Matrix<FloatT> &m){
+    Matrix<FloatT> &m_(const_cast<Matrix<FloatT> &>(m));
+    for(unsigned int i(0); i < m.rows(); i++){
+      for(unsigned int j(0); j < m.columns(); j++){put(out, m_(i, j));}
+    }
+  }
+  /**
+   * @param m matrix, which must be allocated beforehand in the saved size
+   */
+  template <class FloatT>
+  static void get(std::istream &in, Matrix<FloatT> &m) throw(std::ios_base::failure) {
+    for(unsigned int i(0); i < m.rows(); i++){
+      for(unsigned int j(0); j < m.columns(); j++){get(in, m(i, j));}
+    }
+  }
+  template <class T, class TimeT>
+  static void put(std::ostream &out, const TimeRing<T, TimeT> &ring){
+    put(out, ring.size());
+    for(unsigned int i(0); i < ring.size(); i++){put(out, ring[i]);}
+  }
+  template <class T, class TimeT>
+  static void get(std::istream &in, TimeRing<T, TimeT> &ring) throw(std::ios_base::failure) {
+    unsigned int size;
+    get(in, size);
+    ring.clear();
+    for(unsigned int i(0); i < size; i++){
+      T item;
+      get(in, item);
+      ring.push_back(item);
+    }
+  }
+  /**
+   * Check a value such as a size, which must be equal to the saved one.
+   */
+  template <class T>
+  static void expect(std::istream &in, const T &value, const char *what) throw(std::ios_base::failure) {
+    T saved;
+    get(in, saved);
+    if(!(saved == value)){
+      throw std::ios_base::failure(std::string("Checkpoint mismatch: ").append(what));
+    }
+  }
+};
+
 class NAV : public NAVData {
   public:
     struct back_propagated_item_t {
@@ -144,9 +451,34 @@ class NAV : public NAVData {
     };
     typedef std::vector<
         back_propagated_item_t> back_propagated_list_t;
+  protected:
+    MagneticFieldCache mag_model_cache; ///< Earth's magnetic field model around the current position
+  public:
+    NAV() : NAVData(), mag_model_cache(IGRF11::IGRF2010) {}
     virtual ~NAV(){}
   public:
     virtual back_propagated_list_t back_propagated() = 0;
+    
+    /**
+     * Mark the current state to be outputted after RTS smoothing.
+     * 
+     * @param tag user defined tag
+     * @param itow current time
+     */
+    virtual void smooth_mark(const int &tag, const float_sylph_t &itow){}
+    /**
+     * Perform the backward pass of RTS smoothing.
+     */
+    virtual void smooth(){}
+    /**
+     * Load the next smoothed state in chronological order,
+     * which is marked by smooth_mark() in the forward pass.
+     * 
+     * @param tag tag of the mark
+     * @param itow time of the mark
+     * @return (bool) true when loaded, false when no more state
+     */
+    virtual bool smoothed(int &tag, float_sylph_t &itow){return false;}
     virtual void init(
         const float_sylph_t &latitude, 
         const float_sylph_t &longitude, 
@@ -157,7 +489,6 @@ class NAV : public NAVData {
         const float_sylph_t &yaw, 
         const float_sylph_t &pitch, 
         const float_sylph_t &roll) = 0;
-    virtual float_sylph_t &operator[](unsigned index) = 0;
     virtual NAV &update(
         const Vector3<float_sylph_t> &accel, 
         const Vector3<float_sylph_t> &gyro, 
@@ -173,6 +504,30 @@ class NAV : public NAVData {
     virtual NAV &correct_yaw(const float_sylph_t &delta_yaw){
       return *this;
     }
+    
+    /**
+     * Restart the real-time prediction from the current state,
+     * which is propagated ahead of the filter by realtime_update().
+     */
+    virtual void realtime_reset(){}
+    virtual void realtime_update(
+        const Vector3<float_sylph_t> &accel, 
+        const Vector3<float_sylph_t> &gyro, 
+        const float_sylph_t &deltaT){}
+    /**
+     * @return (const NAVData &) state of the real-time prediction
+     */
+    virtual const NAVData &realtime() const {return *this;}
+    
+    /**
+     * Save the state of the filter for a checkpoint, which is restored by load().
+     * The snapshots of back_propagate and the forward pass of rts_smooth are not saved,
+     * therefore the smoothing restarts at the resumed point.
+     * 
+     * @param out binary stream
+     */
+    virtual void save(std::ostream &out) const = 0;
+    virtual void load(std::istream &in) throw(std::ios_base::failure) = 0;
 
     /**
      * Estimate yaw correction angle by using magnetic sensor values
@@ -183,7 +538,7 @@ class NAV : public NAVData {
     static float_sylph_t get_mag_delta_yaw(
         const Vector3<float_sylph_t> &mag,
         const Quaternion<float_sylph_t> &attitude,
-        const float_sylph_t &latitude, const float_sylph_t &longitude, const float_sylph_t &altitude){
+        const MagneticField::filed_components_res_t &mag_model){
 
       typedef Vector3<float_sylph_t> vec_t;
       typedef Quaternion<float_sylph_t> quat_t;
@@ -191,10 +546,6 @@ class NAV : public NAVData {
       // Cancel attitude (inverted)
       vec_t mag_horizontal((attitude * quat_t(0, mag) * attitude.conj()).vector());
 
-      // Call Earth's magnetic field model
-      MagneticField::filed_components_res_t mag_model(
-          MagneticField::filed_components(IGRF11::IGRF2010,
-              latitude, longitude, altitude));
       vec_t mag_filed(mag_model.north, mag_model.east, mag_model.down);
 
       // Get the correction angle with the model
@@ -202,19 +553,34 @@ class NAV : public NAVData {
           - std::atan2(mag_horizontal[1], mag_horizontal[0]);
     }
 
+    static float_sylph_t get_mag_delta_yaw(
+        const Vector3<float_sylph_t> &mag,
+        const Quaternion<float_sylph_t> &attitude,
+        const float_sylph_t &latitude, const float_sylph_t &longitude, const float_sylph_t &altitude){
+
+      // Call Earth's magnetic field model
+      return get_mag_delta_yaw(mag, attitude,
+          MagneticField::filed_components(IGRF11::IGRF2010,
+              latitude, longitude, altitude));
+    }
+
+    /**
+     * Estimate yaw correction angle with the cached magnetic field model
+     * around the current position, which is re-evaluated only when leaving its tile.
+     */
     float_sylph_t get_mag_delta_yaw(
         const Vector3<float_sylph_t> &mag,
         const Quaternion<float_sylph_t> &attitude){
 
-      return get_mag_delta_yaw(mag, attitude, latitude(), longitude(), height());
+      return get_mag_delta_yaw(mag, attitude,
+          mag_model_cache(latitude(), longitude(), height()));
     }
 
     float_sylph_t get_mag_delta_yaw(
         const Vector3<float_sylph_t> &mag){
 
       return get_mag_delta_yaw(mag,
-          INS<float_sylph_t>::euler2q(euler_psi(), euler_theta(), euler_phi()),
-          latitude(), longitude(), height());
+          INS<float_sylph_t>::euler2q(euler_psi(), euler_theta(), euler_phi()));
     }
 
     /**
@@ -234,10 +600,9 @@ class NAV : public NAVData {
 
     float_sylph_t get_mag_yaw(const Vector3<float_sylph_t> &mag){
 
-      return get_mag_yaw(
+      return get_mag_delta_yaw(
           mag,
-          euler_theta(), euler_phi(),
-          latitude(), longitude(), height());
+          INS<float_sylph_t>::euler2q(0, euler_theta(), euler_phi()));
     }
 };
 
@@ -272,6 +637,7 @@ struct G_Packet : Packet {
   float_sylph_t acc_2d, acc_v;
   float_sylph_t vel_ned[3];
   float_sylph_t acc_vel;
+  int wn; ///< GPS week number, which is the latest one when the packet is completed
 
   /**
    * convert to a structured data required by INS/GPS routine
@@ -300,53 +666,235 @@ struct M_Packet : Packet {
   Vector3<float_sylph_t> mag;
 };
 
+template <>
+void Serializer::put(std::ostream &out, const M_Packet &packet){
+  put(out, packet.itow);
+  put(out, packet.mag);
+}
+template <>
+void Serializer::get(std::istream &in, M_Packet &packet) throw(std::ios_base::failure) {
+  get(in, packet.itow);
+  get(in, packet.mag);
+}
+
+/**
+ * Conversion between the precision of the log (float_sylph_t) and that of a navigator.
+ */
+template <class To, class From>
+struct Precision {
+  static Vector3<To> convert(const Vector3<From> &v){
+    return Vector3<To>(v.getX(), v.getY(), v.getZ());
+  }
+  static GPS_UBLOX_3D<To> convert(const GPS_UBLOX_3D<From> &gps){
+    GPS_UBLOX_3D<To> res;
+    res.v_n = gps.v_n;
+    res.v_e = gps.v_e;
+    res.v_d = gps.v_d;
+    res.sigma_vel = gps.sigma_vel;
+    res.latitude = gps.latitude;
+    res.longitude = gps.longitude;
+    res.height = gps.height;
+    res.sigma_2d = gps.sigma_2d;
+    res.sigma_height = gps.sigma_height;
+    return res;
+  }
+};
+template <class T>
+struct Precision<T, T> {
+  static const Vector3<T> &convert(const Vector3<T> &v){return v;}
+  static const GPS_UBLOX_3D<T> &convert(const GPS_UBLOX_3D<T> &gps){return gps;}
+};
+
+/**
+ * Navigator, whose precision is INS_GPS::float_t.
+ * The interface is in float_sylph_t regardless of it,
+ * and the position is outputted in double precision (@see INS::latitude_precise()).
+ */
 template <class INS_GPS>
 class INS_GPS_NAV : public NAV {
+  public:
+    typedef typename INS_GPS::float_t float_t;
   protected:
-    class INS_GPS_back_propagate;
-    struct snapshot_content_t {
-      INS_GPS_back_propagate *ins_gps;
-      Matrix<float_sylph_t> Phi;
-      Matrix<float_sylph_t> GQGt;
+    typedef Precision<float_t, float_sylph_t> conv_t;
+    /**
+     * Snapshot of the states required by back-propagation (smoothing).
+     * It holds the state values and the covariance of the filter at a time update,
+     * the transition matrix Phi and the system noise Gamma Q Gamma^T of that update,
+     * and the navigation solution to be outputted.
+     * Its state values and matrices are stored in the buffers of snapshot_ring_t.
+     */
+    struct snapshot_t : public NAVData {
       float_sylph_t deltaT_from_last_correct;
-      snapshot_content_t(
-          INS_GPS_back_propagate *_ins_gps,
-          const Matrix<float_sylph_t> &_Phi,
-          const Matrix<float_sylph_t> &_GQGt, 
-          const float_sylph_t &_deltaT)
-          : ins_gps(_ins_gps), Phi(_Phi), GQGt(_GQGt), 
-          deltaT_from_last_correct(_deltaT){
-      }
-      snapshot_content_t &operator=(const snapshot_content_t &another){
-        ins_gps = another.ins_gps;
-        Phi = another.Phi;
-        GQGt = another.GQGt;
-        deltaT_from_last_correct = another.deltaT_from_last_correct;
-        return *this;
+      double *x; ///< state values, i.e., INS_GPS::get_precise()
+      float_t *P; ///< P_SIZE x P_SIZE, row major
+      float_t *Phi; ///< P_SIZE x P_SIZE, row major
+      float_t *GQGt; ///< P_SIZE x P_SIZE, row major
+#define MAKE_COMMIT_FUNC(fname) \
+float_sylph_t m_ ## fname; \
+float_sylph_t fname() const {return m_ ## fname;}
+      MAKE_COMMIT_FUNC(longitude);
+      MAKE_COMMIT_FUNC(latitude);
+      MAKE_COMMIT_FUNC(height);
+      MAKE_COMMIT_FUNC(v_north);
+      MAKE_COMMIT_FUNC(v_east);
+      MAKE_COMMIT_FUNC(v_down);
+      MAKE_COMMIT_FUNC(heading);
+      MAKE_COMMIT_FUNC(euler_phi);
+      MAKE_COMMIT_FUNC(euler_theta);
+      MAKE_COMMIT_FUNC(euler_psi);
+      MAKE_COMMIT_FUNC(azimuth);
+#undef MAKE_COMMIT_FUNC
+      template <class T>
+      void commit(const T &nav){
+        m_longitude = nav.longitude_precise();
+        m_latitude = nav.latitude_precise();
+        m_height = nav.height_precise();
+        m_v_north = nav.v_north();
+        m_v_east = nav.v_east();
+        m_v_down = nav.v_down();
+        m_heading = nav.heading();
+        m_euler_phi = nav.euler_phi();
+        m_euler_theta = nav.euler_theta();
+        m_euler_psi = nav.euler_psi();
+        m_azimuth = nav.azimuth();
       }
     };
-    typedef std::vector<snapshot_content_t> snapshots_t;
-    snapshots_t snapshots;
+
+    /**
+     * Ring buffer of snapshots, whose storage is preallocated.
+     * Push to the back and trim of the front are O(1) without heap allocation;
+     * the storage is doubled only when it is full,
+     * therefore it stops growing as soon as it covers the span of back-propagation.
+     */
+    class snapshot_ring_t {
+      protected:
+        unsigned int x_size, P_size;
+        std::vector<double> x_storage; ///< state values in double precision, @see INS::get_precise()
+        std::vector<float_t> storage;
+        std::vector<snapshot_t> slots;
+        unsigned int head, length;
+
+        unsigned int stride() const {
+          return P_size * P_size * 3;
+        }
+        void allocate(const unsigned int &capacity){
+          x_storage.assign(x_size * capacity, 0);
+          storage.assign(stride() * capacity, 0);
+          slots.assign(capacity, snapshot_t());
+          for(unsigned int i(0); i < capacity; i++){
+            slots[i].x = &x_storage[x_size * i];
+            float_t *p(&storage[stride() * i]);
+            slots[i].P = p; p += P_size * P_size;
+            slots[i].Phi = p; p += P_size * P_size;
+            slots[i].GQGt = p;
+          }
+        }
+        void grow(){
+          std::vector<double> old_x_storage;
+          std::vector<float_t> old_storage;
+          std::vector<snapshot_t> old_slots;
+          old_x_storage.swap(x_storage);
+          old_storage.swap(storage);
+          old_slots.swap(slots);
+          unsigned int old_head(head);
+          allocate(old_slots.size() * 2);
+          for(unsigned int i(0); i < length; i++){
+            snapshot_t &src(old_slots[(old_head + i) % old_slots.size()]), &dst(slots[i]);
+            double *x(dst.x);
+            float_t *P(dst.P), *Phi(dst.Phi), *GQGt(dst.GQGt);
+            dst = src;
+            dst.x = x; dst.P = P; dst.Phi = Phi; dst.GQGt = GQGt;
+            std::memcpy(x, src.x, sizeof(double) * x_size);
+            std::memcpy(P, src.P, sizeof(float_t) * stride());
+          }
+          head = 0;
+        }
+      public:
+        snapshot_ring_t() : x_size(0), P_size(0), x_storage(), storage(), slots(), head(0), length(0) {}
+        void setup(
+            const unsigned int &_x_size, const unsigned int &_P_size,
+            const unsigned int &capacity = 0x100){
+          x_size = _x_size;
+          P_size = _P_size;
+          head = length = 0;
+          allocate(capacity);
+        }
+        const unsigned int &state_values() const {return x_size;}
+        bool empty() const {return length == 0;}
+        unsigned int size() const {return length;}
+        /**
+         * @param index 0 is the oldest
+         */
+        snapshot_t &operator[](const unsigned int &index){
+          return slots[(head + index) % slots.size()];
+        }
+        snapshot_t &back(){return (*this)[length - 1];}
+        /**
+         * Append a snapshot, whose contents are left to be filled by the caller.
+         */
+        snapshot_t &push_back(){
+          if(length == slots.size()){grow();}
+          return (*this)[length++];
+        }
+        /**
+         * Discard the oldest snapshots.
+         */
+        void pop_front(const unsigned int &count){
+          head = (head + count) % slots.size();
+          length -= count;
+        }
+    };
+    const Options &options;
+    snapshot_ring_t snapshots;
+
+    /**
+     * Filter to correct snapshots one by one.
+     * The snapshot is loaded to this, corrected, and stored to the snapshot again.
+     */
+    class snapshot_corrector_t : public INS_GPS {
+      public:
+        snapshot_corrector_t() : INS_GPS() {}
+        void load(const snapshot_t &snapshot, const unsigned int &x_size){
+          for(unsigned int i(0); i < x_size; i++){
+            INS_GPS::set_precise(i, snapshot.x[i]);
+          }
+          INS_GPS::recalc(false);
+          INS_GPS::getFilter().setP(
+              Matrix<float_t>(INS_GPS::P_SIZE, INS_GPS::P_SIZE, snapshot.P));
+        }
+        void store(snapshot_t &snapshot, const unsigned int &x_size){
+          for(unsigned int i(0); i < x_size; i++){
+            snapshot.x[i] = INS_GPS::get_precise(i);
+          }
+          Matrix<float_t> &P(
+              const_cast<Matrix<float_t> &>(INS_GPS::getFilter().getP()));
+          for(unsigned int i(0), k(0); i < INS_GPS::P_SIZE; i++){
+            for(unsigned int j(0); j < INS_GPS::P_SIZE; j++, k++){
+              snapshot.P[k] = P(i, j);
+            }
+          }
+          snapshot.commit(*this);
+        }
+    };
+
     class INS_GPS_back_propagate : public INS_GPS, public NAVData {
       protected:
-        snapshots_t &snapshots;
+        const Options &options;
+        snapshot_ring_t &snapshots;
+        snapshot_corrector_t corrector;
+        std::vector<float_t> Gamma, GammaQ; ///< workspace of before_update_INS()
       public:
-        INS_GPS_back_propagate(snapshots_t &_snapshots) 
-            : INS_GPS(), snapshots(_snapshots) {}
-        INS_GPS_back_propagate(
-            const INS_GPS_back_propagate &orig, 
-            const bool deepcopy = false)
-            : INS_GPS(orig, deepcopy), snapshots(orig.snapshots){}
-        INS_GPS_back_propagate &operator=(const INS_GPS_back_propagate &another){
-          snapshots = another.snapshots;
-          INS_GPS::operator=(another);
-          return *this;
+        INS_GPS_back_propagate(snapshot_ring_t &_snapshots, const Options &_options)
+            : INS_GPS(), options(_options), snapshots(_snapshots), corrector(),
+            Gamma(INS_GPS::P_SIZE * INS_GPS::Q_SIZE), GammaQ(INS_GPS::P_SIZE * INS_GPS::Q_SIZE) {
+          snapshots.setup(INS_GPS::state_values(), INS_GPS::P_SIZE);
+          corrector.sequential_correct() = options.sequential_correct;
         }
 #define MAKE_COMMIT_FUNC(fname) \
 float_sylph_t fname() const {return INS_GPS::fname();}
-        MAKE_COMMIT_FUNC(longitude);
-        MAKE_COMMIT_FUNC(latitude);
-        MAKE_COMMIT_FUNC(height);
+        float_sylph_t longitude() const {return INS_GPS::longitude_precise();}
+        float_sylph_t latitude() const {return INS_GPS::latitude_precise();}
+        float_sylph_t height() const {return INS_GPS::height_precise();}
         MAKE_COMMIT_FUNC(v_north);
         MAKE_COMMIT_FUNC(v_east);
         MAKE_COMMIT_FUNC(v_down);
@@ -366,21 +914,62 @@ float_sylph_t fname() const {return INS_GPS::fname();}
          * @patam deltaT interval time
          */
         void before_update_INS(
-            const Matrix<float_sylph_t> &A, const Matrix<float_sylph_t> &B, 
-            const float_sylph_t &deltaT){
-          Matrix<float_sylph_t> Phi(A * deltaT);
-          for(unsigned i(0); i < A.rows(); i++){Phi(i, i) += 1;}
-          Matrix<float_sylph_t> Gamma(B * deltaT);
+            const Matrix<float_t> &A, const Matrix<float_t> &B, 
+            const float_t &deltaT){
           
           float_sylph_t deltaT_from_last_correct(deltaT);
           if(!snapshots.empty()){
             deltaT_from_last_correct += snapshots.back().deltaT_from_last_correct;
           }
           
-          snapshots.push_back(
-              snapshot_content_t(new INS_GPS_back_propagate(*this, true), 
-                  Phi, Gamma * INS_GPS::getFilter().getQ() * Gamma.transpose(),
-                  deltaT_from_last_correct));
+          snapshot_t &snapshot(snapshots.push_back());
+          snapshot.deltaT_from_last_correct = deltaT_from_last_correct;
+          
+          for(unsigned int i(0); i < snapshots.state_values(); i++){
+            snapshot.x[i] = INS_GPS::get_precise(i);
+          }
+          snapshot.commit(*this);
+          
+          const unsigned int n(INS_GPS::P_SIZE), m(INS_GPS::Q_SIZE);
+          Matrix<float_t>
+              &A_(const_cast<Matrix<float_t> &>(A)),
+              &B_(const_cast<Matrix<float_t> &>(B)),
+              &P_(const_cast<Matrix<float_t> &>(INS_GPS::getFilter().getP())),
+              &Q_(const_cast<Matrix<float_t> &>(INS_GPS::getFilter().getQ()));
+          
+          // P, and Phi = I + A * deltaT
+          for(unsigned int i(0), k(0); i < n; i++){
+            for(unsigned int j(0); j < n; j++, k++){
+              snapshot.P[k] = P_(i, j);
+              snapshot.Phi[k] = A_(i, j) * deltaT;
+            }
+            snapshot.Phi[i * n + i] += 1;
+          }
+          
+          // Gamma * Q * Gamma^T, where Gamma = B * deltaT
+          for(unsigned int i(0), k(0); i < n; i++){
+            for(unsigned int j(0); j < m; j++, k++){
+              Gamma[k] = B_(i, j) * deltaT;
+            }
+          }
+          for(unsigned int i(0); i < n; i++){
+            for(unsigned int j(0); j < m; j++){
+              float_t sum(Gamma[i * m] * Q_(0, j));
+              for(unsigned int k(1); k < m; k++){
+                sum += Gamma[i * m + k] * Q_(k, j);
+              }
+              GammaQ[i * m + j] = sum;
+            }
+          }
+          for(unsigned int i(0); i < n; i++){
+            for(unsigned int j(0); j < n; j++){
+              float_t sum(GammaQ[i * m] * Gamma[j * m]);
+              for(unsigned int k(1); k < m; k++){
+                sum += GammaQ[i * m + k] * Gamma[j * m + k];
+              }
+              snapshot.GQGt[i * n + j] = sum;
+            }
+          }
         }
     
         /**
@@ -393,129 +982,396 @@ float_sylph_t fname() const {return INS_GPS::fname();}
          * @param x_hat values to be corrected
          */
         void before_correct_INS(
-            const Matrix<float_sylph_t> &H,
-            const Matrix<float_sylph_t> &R,
-            const Matrix<float_sylph_t> &K,
-            const Matrix<float_sylph_t> &v,
-            Matrix<float_sylph_t> &x_hat){
-          if(!snapshots.empty()){
+            const Matrix<float_t> &H,
+            const Matrix<float_t> &R,
+            const Matrix<float_t> &K,
+            const Matrix<float_t> &v,
+            Matrix<float_t> &x_hat){
+          if(snapshots.empty()){return;}
+          INSTRUMENT_SCOPE("back_propagation");
+          
+          float_sylph_t mod_deltaT(snapshots.back().deltaT_from_last_correct);
+          if(mod_deltaT > 0){
             
-            // This routine is invoked by measurement update function called correct().
-            // In addition, this routine is reduced to be activated once with the following if-statement.
-            float_sylph_t mod_deltaT(snapshots.back().deltaT_from_last_correct);
-            if(mod_deltaT > 0){
-              
-              // The latest is the first
-              for(typename snapshots_t::reverse_iterator it(snapshots.rbegin());
-                  it != snapshots.rend();
-                  ++it){
-                // This statement controls depth of back propagation.
-                if(it->deltaT_from_last_correct < options.back_propagate_depth){
-                  if(mod_deltaT > 0.1){ // Skip only when sufficient amount of snapshots are existed.
-                    for(typename snapshots_t::reverse_iterator it2(it);
-                        it2 != snapshots.rend();
-                        ++it2){
-                      delete it2->ins_gps;
-                    }
-                    snapshots.erase(snapshots.begin(), it.base());
-                    //cerr << "[erase]" << endl;
-                    if(snapshots.empty()){return;}
-                  }
-                  break;
+            // The latest is the first
+            for(unsigned int i(snapshots.size()); i > 0; ){
+              snapshot_t &snapshot(snapshots[--i]);
+              // This statement controls depth of back propagation.
+              if(snapshot.deltaT_from_last_correct < options.back_propagate_depth){
+                if(mod_deltaT > 0.1){ // Skip only when sufficient amount of snapshots are existed.
+                  snapshots.pop_front(i + 1);
+                  //cerr << "[erase]" << endl;
+                  if(snapshots.empty()){return;}
                 }
-                // Positive value stands for states to which applied back-propagation have not been applied
-                it->deltaT_from_last_correct -= mod_deltaT;
+                break;
               }
+              // Positive value stands for states to which applied back-propagation have not been applied
+              snapshot.deltaT_from_last_correct -= mod_deltaT;
             }
-            
-            snapshot_content_t previous(snapshots.back());
-            snapshots.pop_back();
-            
-            // Perform back-propagation
-            Matrix<float_sylph_t> H_dash(H * previous.Phi);
-            Matrix<float_sylph_t> R_dash(R + H * previous.GQGt * H.transpose());
-            previous.ins_gps->correct(H_dash, v, R_dash);
-            
-            snapshots.push_back(previous);
+          }
+          
+          // Perform back-propagation, the latest is the first.
+          // The observation is propagated backward through each time update as
+          // H' = H * Phi and R' = R + H * Gamma * Q * Gamma^T * H^T.
+          const unsigned int n(INS_GPS::P_SIZE);
+          Matrix<float_t> H_dash(H), R_dash(R);
+          for(unsigned int i(snapshots.size()); i > 0; ){
+            snapshot_t &snapshot(snapshots[--i]);
+            Matrix<float_t> H_previous(H_dash);
+            H_dash = H_previous * Matrix<float_t>(n, n, snapshot.Phi);
+            R_dash = R_dash + H_previous * Matrix<float_t>(n, n, snapshot.GQGt) * H_previous.transpose();
+            corrector.load(snapshot, snapshots.state_values());
+            corrector.correct(H_dash, v, R_dash);
+            corrector.store(snapshot, snapshots.state_values());
           }
         }
     }; 
-    INS_GPS *_nav, &nav;
-  public:
-    INS_GPS_NAV() 
-        : NAV(), snapshots(), 
-        _nav(options.back_propagate ? new INS_GPS_back_propagate(snapshots) : new INS_GPS()),
-        nav(*_nav) {}
-    ~INS_GPS_NAV() {
-      delete _nav;
-    }
-    back_propagated_list_t back_propagated() {
-      back_propagated_list_t res;
-      if(options.back_propagate){
-        for(typename snapshots_t::iterator it(snapshots.begin());
-            it != snapshots.end();
-            ++it){
-          res.push_back(
-              NAV::back_propagated_item_t(it->deltaT_from_last_correct, *(it->ins_gps)));
-        }
-        //cerr << "snapshots.size() : " << snapshots.size() << endl;
-      }
-      return res;
-    }
     
-  public:
-    void set_filter_Q(const Vector3<float_sylph_t> &accel, const Vector3<float_sylph_t> &gyro){
-      /**
-       * Initialization of matrix Q, input covariance matrix, of Kalman filter.
-       * orthogonal elements are
-       *  0-2 : accelerometer output variance in X, Y, Z axes, [m/s^2]^2
-       *  3-5 : angular speed output variance in X, Y, Z axes, [rad/s]^2
-       *  6   : gravity variance [m/s^2]^2, normally set small value, such as 1E-6
-       */
-      {
-        Matrix<float_sylph_t> Q(nav.getFilter().getQ());
+    /**
+     * Rauch-Tung-Striebel (RTS) smoother.
+     * 
+     * In the forward pass, the following values are stored in a scratch file
+     * at each covariance time update from k to k+1;
+     * the state values x_{k} before the update, the predicted x_{k+1}^{-},
+     * and the smoother gain C_{k} = P_{k} Phi_{k}^{T} (P_{k+1}^{-})^{-1},
+     * which is obtained with the Cholesky decomposition of P_{k+1}^{-} instead of its inverse.
+     * The backward pass reads the file in reverse order to obtain the smoothed error
+     * dx_{k} = C_{k} dx_{k+1}^{-},
+     * where dx_{k+1}^{-} is the difference between the smoothed x_{k+1} and x_{k+1}^{-},
+     * therefore any measurement updates between k and k+1 are taken into account implicitly.
+     * When the covariance time update is performed every predict_interval samples,
+     * k and k+1 are the both ends of the interval, and the records are reduced accordingly.
+     * The smoothed states at the marked points are stored in another scratch file,
+     * which is read in reverse order again to output them in chronological order.
+     * Only the states are smoothed; the smoothed covariance is not calculated.
+     * The records are in double precision regardless of float_t,
+     * and the position is taken before rounded (@see INS::get_precise()).
+     */
+    class INS_GPS_RTS : public INS_GPS {
+      protected:
+        ScratchFile forward, backward;
+        ScratchFile::reverse_reader *output;
         
-        Q(0, 0) = pow(accel.getX(), 2);
-        Q(1, 1) = pow(accel.getY(), 2);
-        Q(2, 2) = pow(accel.getZ(), 2);
-        Q(3, 3) = pow(gyro.getX(), 2);
-        Q(4, 4) = pow(gyro.getY(), 2);
-        Q(5, 5) = pow(gyro.getZ(), 2);
-        Q(6, 6) = 1E-6; //1E-14
+        enum record_type_t {
+          RECORD_UPDATE = 1,
+          RECORD_MARK,
+        };
         
-        nav.getFilter().setQ(Q);
-      }
-    }
-
-    void init(
-        const float_sylph_t &latitude, 
-        const float_sylph_t &longitude, 
-        const float_sylph_t &height,
-        const float_sylph_t &v_north, 
-        const float_sylph_t &v_east, 
-        const float_sylph_t &v_down,
-        const float_sylph_t &yaw, 
-        const float_sylph_t &pitch, 
-        const float_sylph_t &roll){
-      
-      nav.initPosition(latitude, longitude, height);
-      nav.initVelocity(v_north, v_east, v_down);
-      nav.initAttitude(yaw, pitch, roll);
-
-      /**
-       * Initialization of matrix P, system covariance matrix, of Kalman filter.
-       * orthogonal elements are
-       *  0-2 : initial velocity variance in N, E, D axes, [m/s^2]^2
-       *  3-5 : initial variance of position on the Earth which is represented by a delta quaternion
-       *        composed of latitude, longitude, and wander azimuth angle.
-       *        For instance, 1E-8 is a sufficiently big value.
-       *  6   : initial altitude variance [m]^2
-       *  7-9 : initial attitude variance represented by a delta quaternion
-       *        composed of yaw, pitch, and roll angles.
-       *        For instance, 1E-4 is a sufficiently big value.
-       */
-      {
-        Matrix<float_sylph_t> P(nav.getFilter().getP());
+        /*
+         * Layout of an update record:
+         * x_{k}, x_{k+1}^{-}, C_{k}, record type.
+         */
+        unsigned int x_size;
+        unsigned int P_SIZE;
+        std::vector<double> record;
+        double *x, *x_predicted, *C;
+        Matrix<double> P_begin; ///< P_{k}, which is taken at the beginning of the interval
+        bool interval_open; ///< true when x_{k} and P_{k} have been taken
+        bool in_update; ///< true while update() is in progress
+        bool gain_ready; ///< true when C has been calculated in update() and not written yet
+        
+        void load(const double *values){
+          for(unsigned int i(0); i < x_size; i++){
+            INS_GPS::set_precise(i, values[i]);
+          }
+          INS_GPS::recalc(false);
+        }
+        void store(double *values){
+          for(unsigned int i(0); i < x_size; i++){
+            values[i] = INS_GPS::get_precise(i);
+          }
+        }
+        static Matrix<double> to_double(const Matrix<float_t> &m){
+          Matrix<float_t> &m_(const_cast<Matrix<float_t> &>(m));
+          Matrix<double> res(m.rows(), m.columns());
+          for(unsigned int i(0); i < m.rows(); i++){
+            for(unsigned int j(0); j < m.columns(); j++){
+              res(i, j) = m_(i, j);
+            }
+          }
+          return res;
+        }
+        
+        void write_record(){
+          store(x_predicted);
+          forward.write(&record[0], sizeof(double) * record.size());
+          interval_open = gain_ready = false;
+        }
+        
+        /**
+         * Error between state values in the same form as x_hat of correct_INS(),
+         * i.e., correct_INS() with the return value converts x_ref to x_target.
+         */
+        Matrix<double> difference(
+            const double *x_ref, const double *x_target) const {
+          typedef Quaternion<double> quat_t;
+          Matrix<double> res(P_SIZE, 1);
+          for(unsigned int i(0); i < 3; i++){ // velocity
+            res(i, 0) = x_ref[i] - x_target[i];
+          }
+          { // position represented by q_e2n
+            quat_t q(quat_t(x_target[3], x_target[4], x_target[5], x_target[6])
+                * quat_t(x_ref[3], x_ref[4], x_ref[5], x_ref[6]).conj());
+            for(unsigned int i(0); i < 3; i++){
+              res(i + 3, 0) = -q[i + 1] / q[0];
+            }
+          }
+          res(6, 0) = x_ref[7] - x_target[7]; // height
+          { // attitude represented by q_n2b
+            quat_t q(quat_t(x_target[8], x_target[9], x_target[10], x_target[11])
+                * quat_t(x_ref[8], x_ref[9], x_ref[10], x_ref[11]).conj());
+            for(unsigned int i(0); i < 3; i++){
+              res(i + 7, 0) = -q[i + 1] / q[0];
+            }
+          }
+          for(unsigned int i(10); i < P_SIZE; i++){ // others, such as bias
+            res(i, 0) = x_ref[i + 2] - x_target[i + 2];
+          }
+          return res;
+        }
+        
+        /**
+         * Called just after the covariance time update,
+         * in which P_{k+1}^{-} is available and Phi_{k} = I + A deltaT.
+         */
+        void before_update_INS(
+            const Matrix<float_t> &A, const Matrix<float_t> &B, 
+            const float_t &deltaT){
+          // C_{k}^{T} = (P_{k+1}^{-})^{-1} Phi_{k} P_{k}, because P's are symmetric.
+          Matrix<double> Phi(to_double(A) * deltaT);
+          for(unsigned int i(0); i < P_SIZE; i++){Phi(i, i) += 1;}
+          Matrix<double> P_predicted(to_double(INS_GPS::getFilter().getP())), C_T;
+          try{
+            C_T = P_predicted.decomposeCholesky(false)
+                .solve_linear_eq_with_Cholesky(Phi * P_begin);
+          }catch(MatrixException &){
+            // P_{k+1}^{-} may be numerically indefinite, for example,
+            // when the standard form covariance update is computed in single precision.
+            C_T = P_predicted.inverse() * (Phi * P_begin);
+          }
+          for(unsigned int i(0), k(0); i < P_SIZE; i++){
+            for(unsigned int j(0); j < P_SIZE; j++, k++){
+              C[k] = C_T(j, i);
+            }
+          }
+          // In update(), x_{k+1}^{-} is not ready until the mechanization is performed.
+          if(in_update){
+            gain_ready = true;
+          }else{
+            write_record();
+          }
+        }
+        
+      public:
+        INS_GPS_RTS(const char *scratch_dir) 
+            : INS_GPS(),
+            forward(scratch_dir), backward(scratch_dir), output(NULL),
+            x_size(INS_GPS::state_values()),
+            P_SIZE(INS_GPS::P_SIZE),
+            record(x_size * 2 + P_SIZE * P_SIZE + 1),
+            P_begin(), interval_open(false), in_update(false), gain_ready(false) {
+          x = &record[0];
+          x_predicted = x + x_size;
+          C = x_predicted + x_size;
+          record.back() = RECORD_UPDATE;
+        }
+        ~INS_GPS_RTS(){
+          delete output;
+        }
+        
+        void update(
+            const Vector3<float_t> &accel, 
+            const Vector3<float_t> &gyro, 
+            const float_t &deltaT){
+          if(!interval_open){
+            store(x);
+            P_begin = to_double(INS_GPS::getFilter().getP());
+            interval_open = true;
+          }
+          in_update = true;
+          INS_GPS::update(accel, gyro, deltaT); // C is filled by before_update_INS()
+          in_update = false;
+          if(gain_ready){write_record();}
+        }
+        
+        void mark(const int &tag, const float_sylph_t &itow){
+          INS_GPS::flush_predict(); // The marked point is placed at the end of an interval.
+          double buf[] = {(double)tag, itow, RECORD_MARK};
+          forward.write(buf, sizeof(buf));
+        }
+        
+        void smooth(){
+          INSTRUMENT_SCOPE("rts_smooth");
+          std::cerr << "RTS forward pass: " << forward.size() << " bytes ("
+              << (sizeof(double) * record.size()) << " bytes per time update)" << std::endl;
+          // The latest state is the smoothed one for itself.
+          std::vector<double> x_smoothed(x_size + 2);
+          store(&x_smoothed[0]);
+          
+          ScratchFile::reverse_reader in(forward);
+          while(!in.empty()){
+            double type(*(const double *)in.read(sizeof(double)));
+            if(type == RECORD_MARK){
+              const double *buf((const double *)in.read(sizeof(double) * 2));
+              x_smoothed[x_size] = buf[0]; // tag
+              x_smoothed[x_size + 1] = buf[1]; // itow
+              backward.write(&x_smoothed[0], sizeof(double) * x_smoothed.size());
+              continue;
+            }
+            const double *rec((const double *)in.read(
+                sizeof(double) * (record.size() - 1)));
+            const double *x_(rec), *x_predicted_(x_ + x_size), *C_(x_predicted_ + x_size);
+            Matrix<double> dx(
+                Matrix<double>(P_SIZE, P_SIZE, C_)
+                  * difference(x_predicted_, &x_smoothed[0]));
+            Matrix<float_t> x_hat(P_SIZE, 1);
+            for(unsigned int i(0); i < P_SIZE; i++){x_hat(i, 0) = dx(i, 0);}
+            load(x_);
+            INS_GPS::correct_INS(x_hat);
+            store(&x_smoothed[0]);
+          }
+        }
+        
+        bool smoothed(int &tag, float_sylph_t &itow){
+          if(!output){output = new ScratchFile::reverse_reader(backward);}
+          if(output->empty()){return false;}
+          const double *buf((const double *)output->read(
+              sizeof(double) * (x_size + 2)));
+          load(buf);
+          tag = (int)buf[x_size];
+          itow = buf[x_size + 1];
+          return true;
+        }
+    };
+    INS_GPS_RTS *rts;
+    INS_GPS *_nav, &nav;
+    
+    /**
+     * Navigator without the filter for the real-time prediction,
+     * which is a copy of the filter at the last correction, propagated with the following IMU samples.
+     * The states of the filter other than the navigation solution, such as biases, are dumped as they are.
+     */
+    class prediction_t : public INS<float_t>, public NAVData {
+      protected:
+        const INS_GPS_NAV &owner;
+      public:
+        prediction_t(const INS_GPS_NAV &_owner) : INS<float_t>(), NAVData(), owner(_owner) {}
+        prediction_t &operator=(const INS<float_t> &ins){
+          INS<float_t>::operator=(ins);
+          return *this;
+        }
+        float_sylph_t longitude() const {return INS<float_t>::longitude_precise();}
+        float_sylph_t latitude() const {return INS<float_t>::latitude_precise();}
+        float_sylph_t height() const {return INS<float_t>::height_precise();}
+#define MAKE_COMMIT_FUNC(fname) \
+float_sylph_t fname() const {return INS<float_t>::fname();}
+        MAKE_COMMIT_FUNC(v_north);
+        MAKE_COMMIT_FUNC(v_east);
+        MAKE_COMMIT_FUNC(v_down);
+        MAKE_COMMIT_FUNC(heading);
+        MAKE_COMMIT_FUNC(euler_phi);
+        MAKE_COMMIT_FUNC(euler_theta);
+        MAKE_COMMIT_FUNC(euler_psi);
+        MAKE_COMMIT_FUNC(azimuth);
+#undef MAKE_COMMIT_FUNC
+      protected:
+        void dump(std::ostream &out) const {
+          NAVData::dump(out);
+          owner.dump_filter(out);
+        }
+    } prediction;
+    
+  public:
+    INS_GPS_NAV(const Options &_options = ::options) 
+        : NAV(), options(_options), snapshots(), 
+        rts(options.rts_smooth ? new INS_GPS_RTS(options.rts_scratch_dir) : NULL),
+        _nav(rts ? rts
+            : options.back_propagate ? new INS_GPS_back_propagate(snapshots, options) : new INS_GPS()),
+        nav(*_nav), prediction(*this) {
+      mag_model_cache.tolerance() = options.mag_model_tolerance;
+      nav.sequential_correct() = options.sequential_correct;
+      nav.predict_interval() = options.predict_interval;
+      nav.mechanization() = (typename INS<float_t>::mechanization_t)(options.use_increment()
+          ? INS<float_sylph_t>::MECHANIZATION_INCREMENT
+          : options.mechanization);
+    }
+    ~INS_GPS_NAV() {
+      delete _nav;
+    }
+    back_propagated_list_t back_propagated() {
+      back_propagated_list_t res;
+      if(options.back_propagate){
+        for(unsigned int i(0); i < snapshots.size(); i++){
+          res.push_back(
+              NAV::back_propagated_item_t(snapshots[i].deltaT_from_last_correct, snapshots[i]));
+        }
+        //cerr << "snapshots.size() : " << snapshots.size() << endl;
+      }
+      return res;
+    }
+    void smooth_mark(const int &tag, const float_sylph_t &itow){
+      if(rts){rts->mark(tag, itow);}
+    }
+    void smooth(){
+      if(rts){rts->smooth();}
+    }
+    bool smoothed(int &tag, float_sylph_t &itow){
+      return rts ? rts->smoothed(tag, itow) : false;
+    }
+    
+  public:
+    void set_filter_Q(const Vector3<float_sylph_t> &accel, const Vector3<float_sylph_t> &gyro){
+      /**
+       * Initialization of matrix Q, input covariance matrix, of Kalman filter.
+       * orthogonal elements are
+       *  0-2 : accelerometer output variance in X, Y, Z axes, [m/s^2]^2
+       *  3-5 : angular speed output variance in X, Y, Z axes, [rad/s]^2
+       *  6   : gravity variance [m/s^2]^2, normally set small value, such as 1E-6
+       */
+      {
+        Matrix<float_t> Q(nav.getFilter().getQ());
+        
+        Q(0, 0) = pow(accel.getX(), 2);
+        Q(1, 1) = pow(accel.getY(), 2);
+        Q(2, 2) = pow(accel.getZ(), 2);
+        Q(3, 3) = pow(gyro.getX(), 2);
+        Q(4, 4) = pow(gyro.getY(), 2);
+        Q(5, 5) = pow(gyro.getZ(), 2);
+        Q(6, 6) = 1E-6; //1E-14
+        
+        nav.getFilter().setQ(Q);
+      }
+    }
+
+    void init(
+        const float_sylph_t &latitude, 
+        const float_sylph_t &longitude, 
+        const float_sylph_t &height,
+        const float_sylph_t &v_north, 
+        const float_sylph_t &v_east, 
+        const float_sylph_t &v_down,
+        const float_sylph_t &yaw, 
+        const float_sylph_t &pitch, 
+        const float_sylph_t &roll){
+      
+      nav.initPosition(latitude, longitude, height);
+      nav.initVelocity(v_north, v_east, v_down);
+      nav.initAttitude(yaw, pitch, roll);
+
+      /**
+       * Initialization of matrix P, system covariance matrix, of Kalman filter.
+       * orthogonal elements are
+       *  0-2 : initial velocity variance in N, E, D axes, [m/s^2]^2
+       *  3-5 : initial variance of position on the Earth which is represented by a delta quaternion
+       *        composed of latitude, longitude, and wander azimuth angle.
+       *        For instance, 1E-8 is a sufficiently big value.
+       *  6   : initial altitude variance [m]^2
+       *  7-9 : initial attitude variance represented by a delta quaternion
+       *        composed of yaw, pitch, and roll angles.
+       *        For instance, 1E-4 is a sufficiently big value.
+       */
+      {
+        Matrix<float_t> P(nav.getFilter().getP());
 
         P(0, 0) = P(1, 1) = P(2, 2) = 1E+1;
         P(3, 3) = P(4, 4) = P(5, 5) = 1E-8;
@@ -528,9 +1384,9 @@ float_sylph_t fname() const {return INS_GPS::fname();}
 
 #define MAKE_COMMIT_FUNC(fname, rtype, attr) \
 rtype fname() attr {return nav.fname();}
-    MAKE_COMMIT_FUNC(longitude, float_sylph_t, const);
-    MAKE_COMMIT_FUNC(latitude, float_sylph_t, const);
-    MAKE_COMMIT_FUNC(height, float_sylph_t, const);
+    float_sylph_t longitude() const {return nav.longitude_precise();}
+    float_sylph_t latitude() const {return nav.latitude_precise();}
+    float_sylph_t height() const {return nav.height_precise();}
     MAKE_COMMIT_FUNC(v_north, float_sylph_t, const);
     MAKE_COMMIT_FUNC(v_east, float_sylph_t, const);
     MAKE_COMMIT_FUNC(v_down, float_sylph_t, const);
@@ -541,26 +1397,24 @@ rtype fname() attr {return nav.fname();}
     MAKE_COMMIT_FUNC(azimuth, float_sylph_t, const);
 #undef MAKE_COMMIT_FUNC
     
-    float_sylph_t &operator[](unsigned index){return nav[index];}
-    
     NAV &update(
         const Vector3<float_sylph_t> &accel, 
         const Vector3<float_sylph_t> &gyro, 
         const float_sylph_t &deltaT){
-      nav.update(accel, gyro, deltaT);
+      nav.update(conv_t::convert(accel), conv_t::convert(gyro), deltaT);
       return *this;
     }
   
   public:
     NAV &correct(const GPS_UBLOX_3D<float_sylph_t> &gps){
-      nav.correct(gps);
+      nav.correct(conv_t::convert(gps));
       return *this;
     }
     NAV &correct(
         const GPS_UBLOX_3D<float_sylph_t> &gps, 
         const Vector3<float_sylph_t> &lever_arm_b,
         const Vector3<float_sylph_t> &omega_b2i_4b){
-      nav.correct(gps, lever_arm_b, omega_b2i_4b);
+      nav.correct(conv_t::convert(gps), conv_t::convert(lever_arm_b), conv_t::convert(omega_b2i_4b));
       return *this;
     }
     NAV &correct_yaw(const float_sylph_t &delta_yaw){
@@ -568,6 +1422,91 @@ rtype fname() attr {return nav.fname();}
       return *this;
     }
     
+    void realtime_reset(){
+      prediction = nav;
+    }
+    void realtime_update(
+        const Vector3<float_sylph_t> &accel, 
+        const Vector3<float_sylph_t> &gyro, 
+        const float_sylph_t &deltaT){
+      prediction.update(conv_t::convert(accel), conv_t::convert(gyro), deltaT);
+    }
+    const NAVData &realtime() const {return prediction;}
+    
+    /**
+     * Save P of the filter, which is restored by load_P().
+     * A UD or square root filter saves its factors instead of P,
+     * because factorizing P again is not exact, especially in single precision.
+     */
+    static void save_P(std::ostream &out, const KalmanFilter<float_t> &filter){
+      Serializer::put(out, filter.getP());
+    }
+    static void save_P(std::ostream &out, const KalmanFilterUD<float_t> &filter){
+      Serializer::put(out, filter.getU());
+      Serializer::put(out, filter.getD());
+    }
+    static void save_P(std::ostream &out, const KalmanFilterSquareRoot<float_t> &filter){
+      Serializer::put(out, filter.getS());
+    }
+    static void load_P(std::istream &in, KalmanFilter<float_t> &filter) throw(std::ios_base::failure) {
+      Matrix<float_t> P(INS_GPS::P_SIZE, INS_GPS::P_SIZE);
+      Serializer::get(in, P);
+      filter.setP(P);
+    }
+    static void load_P(std::istream &in, KalmanFilterUD<float_t> &filter) throw(std::ios_base::failure) {
+      Matrix<float_t> U(INS_GPS::P_SIZE, INS_GPS::P_SIZE), D(INS_GPS::P_SIZE, INS_GPS::P_SIZE);
+      Serializer::get(in, U);
+      Serializer::get(in, D);
+      filter.setUD(U, D);
+    }
+    static void load_P(std::istream &in, KalmanFilterSquareRoot<float_t> &filter) throw(std::ios_base::failure) {
+      Matrix<float_t> S(INS_GPS::P_SIZE, INS_GPS::P_SIZE);
+      Serializer::get(in, S);
+      filter.setS(S);
+    }
+    
+    /**
+     * Save the state values, P and Q of the filter, which are restored exactly by load().
+     * The state values are saved in double precision by get_precise(),
+     * so that the position is restored before rounded even if float_t is float.
+     * Any pending time update of P is performed beforehand by getFilter().
+     */
+    void save(std::ostream &out) const {
+      const unsigned int x_size(nav.state_values());
+      Serializer::put(out, (unsigned int)sizeof(float_t));
+      Serializer::put(out, x_size);
+      Serializer::put(out, INS_GPS::P_SIZE);
+      Serializer::put(out, INS_GPS::Q_SIZE);
+      for(unsigned int i(0); i < x_size; i++){
+        Serializer::put(out, nav.get_precise(i));
+      }
+      save_P(out, nav.getFilter());
+      Serializer::put(out, nav.getFilter().getQ());
+      save_filter(out);
+    }
+    void load(std::istream &in) throw(std::ios_base::failure) {
+      const unsigned int x_size(nav.state_values());
+      Serializer::expect(in, (unsigned int)sizeof(float_t), "precision");
+      Serializer::expect(in, x_size, "number of states");
+      Serializer::expect(in, INS_GPS::P_SIZE, "size of P");
+      Serializer::expect(in, INS_GPS::Q_SIZE, "size of Q");
+      {
+        std::vector<double> x(x_size);
+        for(unsigned int i(0); i < x_size; i++){
+          Serializer::get(in, x[i]);
+        }
+        nav.set_states_precise(&x[0]);
+      }
+      load_P(in, nav.getFilter());
+      {
+        Matrix<float_t> Q(INS_GPS::Q_SIZE, INS_GPS::Q_SIZE);
+        Serializer::get(in, Q);
+        nav.getFilter().setQ(Q);
+      }
+      load_filter(in);
+      prediction = nav;
+    }
+    
     /**
      * print label
      */
@@ -583,27 +1522,39 @@ rtype fname() attr {return nav.fname();}
      */
     void dump(std::ostream &out) const {
       NAV::dump(out);
+      dump_filter(out);
     }
+    
+    /**
+     * print states of the filter other than the navigation solution
+     */
+    virtual void dump_filter(std::ostream &out) const {}
+    
+    /**
+     * save and load internal states of the filter other than the state values
+     */
+    virtual void save_filter(std::ostream &out) const {}
+    virtual void load_filter(std::istream &in) throw(std::ios_base::failure) {}
 };
 
 template <class INS_GPS_BE>
 class INS_GPS_BE_NAV : public INS_GPS_NAV<INS_GPS_BE> {
   public:
     typedef INS_GPS_NAV<INS_GPS_BE> super_t;
-    INS_GPS_BE_NAV() : super_t() {
+    INS_GPS_BE_NAV(const Options &_options = ::options) : super_t(_options) {
       /**
        * Configuration for bias drift of accelerometer and gyro.
        */
       super_t::nav.beta_accel() *= 0.1;
       super_t::nav.beta_gyro() *= 0.1;
       {
-        Matrix<float_sylph_t> P(super_t::nav.getFilter().getP());
+        Matrix<typename super_t::float_t> P(super_t::nav.getFilter().getP());
         P(10, 10) = P(11, 11) = P(12, 12) = 1E-4;
         P(13, 13) = P(14, 14) = P(15, 15) = 1E-6;
         super_t::nav.getFilter().setP(P);
       }
       {
-        Matrix<float_sylph_t> Q(super_t::nav.getFilter().getQ());
+        Matrix<typename super_t::float_t> Q(super_t::nav.getFilter().getQ());
         Q(7, 7) = 1E-6;
         Q(8, 8) = 1E-6;
         Q(9, 9) = 1E-6;
@@ -619,8 +1570,21 @@ class INS_GPS_BE_NAV : public INS_GPS_NAV<INS_GPS_BE> {
         const GPS_UBLOX_3D<float_sylph_t> &gps, 
         const Vector3<float_sylph_t> &lever_arm_b,
         const Vector3<float_sylph_t> &omega_b2i_4b){
-      return super_t::correct(
-          gps, lever_arm_b, omega_b2i_4b - super_t::nav.bias_gyro());
+      typedef typename super_t::conv_t conv_t;
+      super_t::nav.correct(
+          conv_t::convert(gps), conv_t::convert(lever_arm_b),
+          conv_t::convert(omega_b2i_4b) - super_t::nav.bias_gyro());
+      return *this;
+    }
+    
+    void realtime_update(
+        const Vector3<float_sylph_t> &accel, 
+        const Vector3<float_sylph_t> &gyro, 
+        const float_sylph_t &deltaT){
+      typedef typename super_t::conv_t conv_t;
+      super_t::prediction.update(
+          conv_t::convert(accel) + super_t::nav.bias_accel(),
+          conv_t::convert(gyro) + super_t::nav.bias_gyro(), deltaT);
     }
     
     void label(std::ostream &out = std::cout) const {
@@ -634,10 +1598,9 @@ class INS_GPS_BE_NAV : public INS_GPS_NAV<INS_GPS_BE> {
     }
   
   protected:
-    void dump(std::ostream &out) const {
-      super_t::dump(out);
-      Vector3<float_sylph_t> &ba(super_t::nav.bias_accel());
-      Vector3<float_sylph_t> &bg(super_t::nav.bias_gyro());
+    void dump_filter(std::ostream &out) const {
+      Vector3<typename super_t::float_t> &ba(super_t::nav.bias_accel());
+      Vector3<typename super_t::float_t> &bg(super_t::nav.bias_gyro());
       out << ba.getX() << ", "     // Bias
            << ba.getY() << ", "
            << ba.getZ() << ", "
@@ -645,153 +1608,21 @@ class INS_GPS_BE_NAV : public INS_GPS_NAV<INS_GPS_BE> {
            << bg.getY() << ", "
            << bg.getZ() << ", ";
     }
-};
-
-struct StandardCalibration {
-
-  int index_base, index_temp_ch;
-  template <std::size_t N>
-  struct calibration_info_t {
-    float_sylph_t bias_tc[N];
-    float_sylph_t bias_base[N];
-    float_sylph_t sf[N];
-    float_sylph_t alignment[N][N];
-    float_sylph_t sigma[N];
-  };
-  calibration_info_t<3> accel, gyro;
-
-  static const char *get_value(const char *spec, const char *key){
-    int offset(std::strlen(key));
-    if(std::strncmp(spec, key, offset) != 0){return NULL;}
-    if((spec[offset] == '\0') || std::isgraph(spec[offset])){return NULL;} // no value or different key.
-    while(spec[++offset] != '\0'){
-      if(std::isgraph(spec[offset])){return &spec[offset];}
-    }
-    return NULL; // no value
-  }
-
-  bool check_spec(const char *line){
-    const char *value;
-    if(value = get_value(line, "index_base")){
-      index_base = std::atoi(value);
-      return true;
-    }
-    if(value = get_value(line, "index_temp_ch")){
-      index_temp_ch = std::atoi(value);
-      return true;
-    }
-#define TO_STRING(name) # name
-#define make_proc1(name, sensor, item) \
-if(value = get_value(line, TO_STRING(name))){ \
-  std::cerr << TO_STRING(name) << ":"; \
-  char *spec(const_cast<char *>(value)); \
-  for(int i(0); i < 3; i++){ \
-    sensor.item[i] = std::strtod(spec, &spec); \
-    std::cerr << " " << sensor.item[i]; \
-  } \
-  std::cerr << std::endl; \
-  return true; \
-}
-#define make_proc2(name, sensor, item) \
-if(value = get_value(line, TO_STRING(name))){ \
-  std::cerr << TO_STRING(name) << ": {"; \
-  char *spec(const_cast<char *>(value)); \
-  for(int i(0); i < 3; i++){ \
-    for(int j(0); j < 3; j++){ \
-      sensor.item[i][j] = std::strtod(spec, &spec); \
-    } \
-    std::cerr \
-        << std::endl << "{" \
-        << sensor.item[i][0] << ", " \
-        << sensor.item[i][1] << ", " \
-        << sensor.item[i][2] << "}"; \
-  } \
-  std::cerr << "}" << std::endl; \
-  return true; \
-}
-    make_proc1(acc_bias_tc, accel, bias_tc);
-    make_proc1(acc_bias, accel, bias_base);
-    make_proc1(acc_sf, accel, sf);
-    make_proc2(acc_mis, accel, alignment);
-    make_proc1(gyro_bias_tc, gyro, bias_tc);
-    make_proc1(gyro_bias, gyro, bias_base);
-    make_proc1(gyro_sf, gyro, sf);
-    make_proc2(gyro_mis, gyro, alignment);
-    make_proc1(sigma_accel, accel, sigma);
-    make_proc1(sigma_gyro, gyro, sigma);
-#undef make_proc1
-#undef make_proc2
-#undef TO_STRING
-
-    return false;
-  }
-
-  template <class NumType, std::size_t N>
-  static void calibrate(
-      const NumType raw[],
-      const NumType &bias_mod,
-      const calibration_info_t<N> &info,
-      float_sylph_t (&res)[N]) {
-
-    // Temperature compensation
-    float_sylph_t bias[N];
-    for(int i(0); i < N; i++){
-      bias[i] = info.bias_base[i] + (info.bias_tc[i] * bias_mod);
-    }
-
-    // Convert raw values to physical quantity by using scale factor
-    float_sylph_t tmp[N];
-    for(int i(0); i < N; i++){
-      tmp[i] = (((float_sylph_t)raw[i] - bias[i]) / info.sf[i]);
+    
+    void save_filter(std::ostream &out) const {
+      const unsigned int aux_size(INS_GPS_BE::AUX_VALUES);
+      Serializer::put(out, aux_size);
+      for(unsigned int i(0); i < aux_size; i++){
+        Serializer::put(out, super_t::nav.aux(i));
+      }
     }
-
-    // Misalignment compensation
-    for(int i(0); i < N; i++){
-      res[i] = 0;
-      for(int j(0); j < N; j++){
-        res[i] += info.alignment[i][j] * tmp[j];
+    void load_filter(std::istream &in) throw(std::ios_base::failure) {
+      const unsigned int aux_size(INS_GPS_BE::AUX_VALUES);
+      Serializer::expect(in, aux_size, "number of bias states");
+      for(unsigned int i(0); i < aux_size; i++){
+        Serializer::get(in, super_t::nav.aux(i));
       }
     }
-  }
-
-  StandardCalibration() {}
-  ~StandardCalibration() {}
-
-  /**
-   * Get acceleration in m/s^2
-   */
-  Vector3<float_sylph_t> raw2accel(const int *raw_data) const{
-    float_sylph_t res[3];
-    calibrate(
-        &raw_data[index_base], raw_data[index_temp_ch],
-        accel, res);
-    return Vector3<float_sylph_t>(res[0], res[1], res[2]);
-  }
-
-  /**
-   * Get angular speed in rad/sec
-   */
-  Vector3<float_sylph_t> raw2gyro(const int *raw_data) const{
-    float_sylph_t res[3];
-    calibrate(
-        &raw_data[index_base + 3], raw_data[index_temp_ch],
-        gyro, res);
-    return Vector3<float_sylph_t>(res[0], res[1], res[2]);
-  }
-
-  /**
-   * Accelerometer output variance in [m/s^2]^2
-   */
-  Vector3<float_sylph_t> sigma_accel() const{
-    return Vector3<float_sylph_t>(accel.sigma[0], accel.sigma[1], accel.sigma[2]);
-  }
-
-  /**
-   * Angular speed output variance in X, Y, Z axes, [rad/s]^2
-   */
-  Vector3<float_sylph_t> sigma_gyro() const{
-    return Vector3<float_sylph_t>(gyro.sigma[0], gyro.sigma[1], gyro.sigma[2]);
-  }
 };
 
 using namespace std;
@@ -800,28 +1631,30 @@ void a_packet_handler(const A_Observer_t &);
 void g_packet_handler(const G_Observer_t &);
 void m_packet_handler(const M_Observer_t &);
 
-bool require_switch_processor(false);
-
 class StreamProcessor : public Processor_t {
   protected:
     int invoked;
     istream *_in;
+    long long consumed; ///< bytes read from the stream
     
   public:
     bool use_lever_arm;
     Vector3<float_sylph_t> lever_arm;
     StandardCalibration calibration;
-    deque<A_Packet> a_packet_deque;
-    G_Packet g_packet;
-    bool g_packet_updated;
+    typedef TimeRing<A_Packet, float_sylph_t> a_packets_t;
+    a_packets_t a_packets; ///< A packets which are not used for time update yet
+    G_Packet g_packet; ///< G packet under construction
     int g_packet_wn;
-    deque<M_Packet> m_packet_deque;
+    typedef TimeRing<G_Packet, float_sylph_t> g_packets_t;
+    g_packets_t g_packets; ///< completed G packets, which are not used for measurement update yet
+    typedef TimeRing<M_Packet, float_sylph_t> m_packets_t;
+    m_packets_t m_packets; ///< recent M packets
     StreamProcessor()
-        : Processor_t(), _in(NULL), invoked(0),
+        : Processor_t(), invoked(0), _in(NULL), consumed(0),
         use_lever_arm(false), lever_arm(), calibration(),
-        a_packet_deque(),
-        g_packet(), g_packet_updated(false), g_packet_wn(0),
-        m_packet_deque() {
+        a_packets(128),
+        g_packet(), g_packet_wn(0), g_packets(0x10),
+        m_packets(0x41) {
 
     }
     ~StreamProcessor(){}
@@ -838,10 +1671,16 @@ class StreamProcessor : public Processor_t {
       char buffer[PAGE_SIZE];
       
       int read_count;
-      _in->read(buffer, PAGE_SIZE);
-      read_count = static_cast<int>(_in->gcount());
+      {
+        INSTRUMENT_SCOPE("page_read");
+        _in->read(buffer, PAGE_SIZE);
+        read_count = static_cast<int>(_in->gcount());
+      }
       if(_in->fail() || (read_count == 0)){return false;}
       invoked++;
+      consumed += read_count;
+      INSTRUMENT_COUNT("pages", 1);
+      INSTRUMENT_TICK();
     
 #if DEBUG
       cerr << "--read-- : " << invoked << " page" << endl;
@@ -862,31 +1701,156 @@ class StreamProcessor : public Processor_t {
 #endif
       }
       
-      process(buffer, read_count);
+      {
+        INSTRUMENT_SCOPE("decode");
+        process(buffer, read_count);
+      }
       return true;
     }
 
+    /**
+     * Get A packet at the specified time, which is interpolated with the stored ones.
+     * Accelerometer and temperature channels are interpolated linearly,
+     * and gyro channels are interpolated with cubic Hermite.
+     * Out of the stored period, the nearest one is used.
+     * 
+     * @param itow time, which is also the time stamp of the result
+     * @return (A_Packet) interpolated packet; at least one packet must be stored.
+     */
+    A_Packet get_a(const float_sylph_t &itow) const {
+      A_Packet res;
+      unsigned int index;
+      float_sylph_t ratio;
+      if(!a_packets.bracket(itow, index, ratio)){
+        res = a_packets.back();
+      }else if(ratio <= 0){
+        res = a_packets[index];
+      }else if(ratio >= 1){
+        res = a_packets[index + 1];
+      }else{
+        const A_Packet *y[4] = {
+          &a_packets[index > 0 ? (index - 1) : index],
+          &a_packets[index],
+          &a_packets[index + 1],
+          &a_packets[(index + 2) < a_packets.size() ? (index + 2) : (index + 1)],
+        };
+        float_sylph_t hermite[4];
+        a_packets_t::hermite_weights(ratio, hermite);
+        const int gyro_begin(calibration.index_base + 3), gyro_end(gyro_begin + 3);
+        for(int i(0); i < (int)(sizeof(res.ch) / sizeof(res.ch[0])); i++){
+          float_sylph_t value((i >= gyro_begin) && (i < gyro_end)
+              ? (y[0]->ch[i] * hermite[0] + y[1]->ch[i] * hermite[1]
+                + y[2]->ch[i] * hermite[2] + y[3]->ch[i] * hermite[3])
+              : (y[1]->ch[i] * (1. - ratio) + y[2]->ch[i] * ratio));
+          res.ch[i] = (int)std::floor(value + 0.5);
+        }
+      }
+      res.itow = itow;
+      return res;
+    }
+
+  protected:
+    template <class Observer>
+    static void save_observer(std::ostream &out, const Observer &observer, const bool &seek_next){
+      std::vector<char> buf(observer.stored());
+      if(!buf.empty()){observer.inspect(&buf[0], buf.size());}
+      Serializer::put(out, (unsigned int)buf.size());
+      if(!buf.empty()){out.write(&buf[0], buf.size());}
+      Serializer::put(out, seek_next);
+    }
+    template <class Observer>
+    static void load_observer(std::istream &in, Observer &observer, bool &seek_next)
+        throw(std::ios_base::failure) {
+      unsigned int size;
+      Serializer::get(in, size);
+      std::vector<char> buf(size);
+      if((size > 0) && !in.read(&buf[0], size)){
+        throw std::ios_base::failure("Truncated checkpoint");
+      }
+      observer.skip(observer.stored());
+      if((size > 0) && (observer.write(&buf[0], size) != size)){
+        throw std::ios_base::failure("Checkpoint mismatch: size of observer");
+      }
+      Serializer::get(in, seek_next);
+    }
+    
+  public:
+    /**
+     * Save the state for a checkpoint, which is restored by load().
+     * It consists of the position in the stream, the bytes buffered in the observers,
+     * and the packets which are not used yet.
+     * 
+     * @param out binary stream
+     */
+    void save(std::ostream &out) const {
+      Serializer::put(out, consumed);
+      Serializer::put(out, invoked);
+#define save_observer_of(type) save_observer(out, observer_ ## type, previous_seek_next_ ## type)
+      save_observer_of(A);
+      save_observer_of(G);
+      save_observer_of(F);
+      save_observer_of(P);
+      save_observer_of(M);
+      save_observer_of(N);
+#undef save_observer_of
+      Serializer::put(out, a_packets);
+      Serializer::put(out, g_packet);
+      Serializer::put(out, g_packet_wn);
+      Serializer::put(out, g_packets);
+      Serializer::put(out, m_packets);
+    }
+    
+    /**
+     * Restore the state saved by save(), then skip the stream to the saved position.
+     * The stream is sought when possible, otherwise read and discarded.
+     * 
+     * @param in binary stream
+     */
+    void load(std::istream &in) throw(std::ios_base::failure) {
+      Serializer::get(in, consumed);
+      Serializer::get(in, invoked);
+#define load_observer_of(type) load_observer(in, observer_ ## type, previous_seek_next_ ## type)
+      load_observer_of(A);
+      load_observer_of(G);
+      load_observer_of(F);
+      load_observer_of(P);
+      load_observer_of(M);
+      load_observer_of(N);
+#undef load_observer_of
+      Serializer::get(in, a_packets);
+      Serializer::get(in, g_packet);
+      Serializer::get(in, g_packet_wn);
+      Serializer::get(in, g_packets);
+      Serializer::get(in, m_packets);
+      
+      if(!_in->seekg(consumed, std::ios::beg)){
+        _in->clear();
+        for(long long rest(consumed); rest > 0; ){
+          std::streamsize chunk((std::streamsize)std::min(rest, (long long)0x100000));
+          if(_in->ignore(chunk).gcount() != chunk){
+            throw std::ios_base::failure("Log is shorter than checkpoint");
+          }
+          rest -= chunk;
+        }
+      }
+    }
+
     Vector3<float_sylph_t> get_mag() {
-      return m_packet_deque.empty()
+      return m_packets.empty()
           ? Vector3<float_sylph_t>(1, 0, 0) // heading is north
-          : m_packet_deque.back().mag;
+          : m_packets.back().mag;
     }
 
     Vector3<float_sylph_t> get_mag(const float_sylph_t &itow){
-      if(m_packet_deque.size() < 2){
+      unsigned int index;
+      float_sylph_t ratio;
+      if(!m_packets.bracket(itow, index, ratio)){
         return Vector3<float_sylph_t>(1, 0, 0); // heading is north
       }
-      deque<M_Packet>::iterator
-          previous_it(m_packet_deque.begin()),
-          next_it(m_packet_deque.begin() + 1);
-      for(int i(distance(previous_it, m_packet_deque.end()));
-          i > 2;
-          i--, previous_it++, next_it++){
-        if(next_it->itow >= itow){break;}
-      }
+      const M_Packet *previous_it(&m_packets[index]), *next_it(&m_packets[index + 1]);
       float_sylph_t
-          weight_previous((next_it->itow - itow) / (next_it->itow - previous_it->itow)),
-          weight_next(1. - weight_previous);
+          weight_previous(1. - ratio),
+          weight_next(ratio);
       /* Reduce excessive extrapolation.
        * The extrapolation is required, because M page combines several samples which are sometimes obtained late.
        * The threshold is +/- 2 steps.
@@ -905,28 +1869,105 @@ class StreamProcessor : public Processor_t {
 typedef vector<StreamProcessor *> processor_storage_t;
 processor_storage_t processor_storage;
 
+/**
+ * Matrix pool enabled during a filter step when matrix_pool is specified.
+ * The pool is per thread, then each step, which may run in an OpenMP worker
+ * for ensembles, opens its own scope, and the free lists are released at the end of the step.
+ * The statistics of all threads are summed up in total.
+ *
+ * @param FloatT precision of the pooled matrices
+ */
+template <class FloatT>
+struct MatrixPoolScopeGeneric {
+  typedef Array2D_Dense_Pool<FloatT> pool_t;
+  typedef typename pool_t::stats_t stats_t;
+  static stats_t total;
+  typename pool_t::Scope scope;
+  MatrixPoolScopeGeneric(const bool &enable) : scope(enable) {}
+  ~MatrixPoolScopeGeneric(){
+    if(!options.matrix_pool){return;}
+    stats_t stats(scope.stats());
+#if defined(_OPENMP)
+#pragma omp critical(matrix_pool_stats)
+#endif
+    total += stats;
+  }
+  static void report(std::ostream &out, const char *label){
+    out << "Matrix pool (" << label << "): "
+        << total.requested << " requests, "
+        << total.allocations_avoided() << " allocations avoided, "
+        << total.frees_avoided() << " frees avoided" << endl;
+  }
+};
+template <class FloatT>
+typename MatrixPoolScopeGeneric<FloatT>::stats_t MatrixPoolScopeGeneric<FloatT>::total = {0, 0, 0, 0, 0};
+
+/**
+ * Matrix pools of both precisions, because the navigators use float matrices with nav_float option,
+ * and a member of an ensemble may use either.
+ */
+struct MatrixPoolScope {
+  static const bool float_differs
+      = (std::numeric_limits<float>::digits != std::numeric_limits<float_sylph_t>::digits);
+  MatrixPoolScopeGeneric<float_sylph_t> scope_sylph;
+  MatrixPoolScopeGeneric<float> scope_float;
+  MatrixPoolScope()
+      : scope_sylph(options.matrix_pool),
+      scope_float(options.matrix_pool && float_differs) {}
+  static void report(std::ostream &out){
+    MatrixPoolScopeGeneric<float_sylph_t>::report(out, float_differs ? "double" : "float");
+    if(float_differs){MatrixPoolScopeGeneric<float>::report(out, "float");}
+  }
+};
+
 class Status{
   private:
+    const Options &options;
     bool initalized;
     NAV &nav;
+    SharedMemoryRing<NAVRecord> *shm; ///< output to other processes, or NULL
     int min_a_packets_for_init; // must be greater than 0
-    deque<A_Packet> recent_a_packets;
-    unsigned int max_recent_a_packets;
+    TimeRing<A_Packet, float_sylph_t> recent_a_packets;
 
   // Used for compensation of lever arm effect
   protected:
     Vector3<float_sylph_t> gyro_storage[16];
     int gyro_index;
     bool gyro_init;
+    
+    INS_ConingSculling<float_sylph_t> increment; ///< IMU samples of the current navigation step
+    
+    float_sylph_t prediction_itow; ///< time of the real-time prediction
+    
+    bool corrected; ///< true when no time update follows the last measurement update
 
   public:
-    Status(NAV &_nav) : initalized(false), nav(_nav), gyro_index(0), gyro_init(false),
+    Status(NAV &_nav, const Options &_options = ::options)
+        : options(_options), initalized(false), nav(_nav),
+        shm(options.out_shm ? new SharedMemoryRing<NAVRecord>(options.out_shm, options.out_shm_capacity) : NULL),
         min_a_packets_for_init(options.has_initial_attitude ? 1 : 0x10),
-        recent_a_packets(), max_recent_a_packets(max(min_a_packets_for_init, 0x100)) {
+        recent_a_packets(max(min_a_packets_for_init, 0x100)),
+        gyro_index(0), gyro_init(false),
+        increment(),
+        prediction_itow(0), corrected(false) {
+    }
+    ~Status(){
+      delete shm;
     }
   
   public:
     NAV &get_nav() {return nav;}
+    bool is_initialized() const {return initalized;}
+    
+    /**
+     * Stream for messages, which are prefixed with the index of the ensemble member.
+     */
+    ostream &message() const {
+      if(options.ensemble_index >= 0){
+        cerr << "[" << options.ensemble_index << "] ";
+      }
+      return cerr;
+    }
     
     void dump_label(){
       if(!options.out_is_N_packet){
@@ -949,7 +1990,14 @@ class Status{
      * @param itow current time
      * @param target NAV to be outputted
      */
-    static void dump(const char *label, const float_sylph_t &itow, const NAVData &target){
+    void dump(const char *label, const float_sylph_t &itow, const NAVData &target) const {
+      INSTRUMENT_SCOPE("output");
+      INSTRUMENT_COUNT("solutions", 1);
+      
+      if(shm){
+        target.encode_record(itow, label, shm->begin_write());
+        shm->end_write();
+      }
       
       if(options.out_is_N_packet){
         char buf[PAGE_SIZE];
@@ -974,6 +2022,16 @@ class Status{
 
       if(!initalized){return;}
       
+      // The navigation step is in progress, then the state is not at itow.
+      if((mode == DUMP_UPDATE) && (increment.samples() > 0)){return;}
+      
+      if(options.rts_smooth){ // When RTS smoothing is activated, only mark in the forward pass.
+        if((mode == DUMP_UPDATE) ? options.dump_update : options.dump_correct){
+          nav.smooth_mark(mode, itow);
+        }
+        return;
+      }
+      
       switch(mode){
         case DUMP_UPDATE:
           if(!options.dump_update){return;}
@@ -1011,15 +2069,40 @@ class Status{
       }
     }
     
+    /**
+     * Perform time update with the IMU samples accumulated in the current navigation step.
+     */
+    void flush_increment(){
+      if(!(increment.deltaT() > 0)){return;} // no sample, or only zero intervals
+      nav.update(increment.mean_accel(), increment.mean_gyro(), increment.deltaT());
+      increment.reset();
+    }
+    
     /**
      * Perform time update by using acceleration and angular speed obtained with accelerometer and gyro.
      * 
      * @param a_packet raw values of ADC
      */
     void time_update(const A_Packet &a_packet){
-      Vector3<float_sylph_t>
-          accel(current_processor->calibration.raw2accel(a_packet.ch)),
-          gyro(current_processor->calibration.raw2gyro(a_packet.ch));
+      // A packets for time update are of the first stream, even while reading others.
+      const StandardCalibration &calibration(processor_storage.front()->calibration);
+      time_update(a_packet,
+          calibration.raw2accel(a_packet.ch),
+          calibration.raw2gyro(a_packet.ch));
+    }
+
+    /**
+     * Perform time update with acceleration and angular speed calibrated in advance.
+     * 
+     * @param a_packet raw values of ADC
+     * @param accel acceleration [m/s^2]
+     * @param gyro angular speed [rad/s]
+     */
+    void time_update(
+        const A_Packet &a_packet,
+        const Vector3<float_sylph_t> &accel, const Vector3<float_sylph_t> &gyro){
+      INSTRUMENT_SCOPE("time_update");
+      MatrixPoolScope pool;
 
       if(initalized){
         const A_Packet &previous(recent_a_packets.back());
@@ -1041,12 +2124,54 @@ class Status{
           interval = INTERVAL_FORCE_VALUE;
         }
 
-        nav.update(accel, gyro, interval);
+        if(options.use_increment()){
+          increment.add(accel, gyro, interval);
+          if(increment.samples() >= options.nav_decimation){flush_increment();}
+        }else{
+          nav.update(accel, gyro, interval);
+        }
       }
 
       recent_a_packets.push_back(a_packet);
-      if(recent_a_packets.size() > max_recent_a_packets){
-        recent_a_packets.pop_front();
+      corrected = false;
+    }
+    
+    /**
+     * Restart the real-time prediction from the current state of the filter.
+     * 
+     * @param itow time of the current state of the filter
+     */
+    void predict_reset(const float_sylph_t &itow){
+      if(!initalized){return;}
+      flush_increment();
+      nav.realtime_reset();
+      prediction_itow = itow;
+    }
+    
+    /**
+     * Propagate the real-time prediction with an IMU sample newer than the filter.
+     * 
+     * @param a_packet raw values of ADC
+     * @param dump_state true when the predicted state is dumped as time update
+     */
+    void predict(const A_Packet &a_packet, const bool &dump_state = true){
+      if(!initalized){return;}
+      INSTRUMENT_SCOPE("predict");
+      MatrixPoolScope pool;
+      
+      float_sylph_t interval(a_packet.itow - prediction_itow);
+      if((interval < 0) || (interval >= INTERVAL_THRESHOLD)){
+        interval = INTERVAL_FORCE_VALUE;
+      }
+      nav.realtime_update(
+          current_processor->calibration.raw2accel(a_packet.ch),
+          current_processor->calibration.raw2gyro(a_packet.ch),
+          interval);
+      prediction_itow = a_packet.itow;
+      
+      if(dump_state && options.dump_update){
+        dump("TU", a_packet.itow, nav.realtime());
+        options.out().flush();
       }
     }
 
@@ -1056,12 +2181,18 @@ class Status{
      * @param g_packet observation data of GPS receiver
      */
     void measurement_update(const G_Packet &g_packet){
+      INSTRUMENT_SCOPE("measurement_update");
+      MatrixPoolScope pool;
       
       if(g_packet.acc_2d >= 100.){return;} // When estimated accuracy is too big, skip.
       if(initalized){
-        cerr << "MU : " << setprecision(10) << g_packet.itow << endl;
+        flush_increment();
+        if(options.ensemble_index <= 0){ // Members of an ensemble share the same time.
+          cerr << "MU : " << setprecision(10) << g_packet.itow << endl;
+        }
         
-        if(gyro_init && (current_processor->use_lever_arm)){ // When use lever arm effect.
+        if(gyro_init
+            && (options.has_lever_arm || current_processor->use_lever_arm)){ // When use lever arm effect.
           Vector3<float_sylph_t> omega_b2i_4n;
           for(int i(0); i < (sizeof(gyro_storage) / sizeof(gyro_storage[0])); i++){
             omega_b2i_4n += gyro_storage[i];
@@ -1069,17 +2200,18 @@ class Status{
           omega_b2i_4n /= (sizeof(gyro_storage) / sizeof(gyro_storage[0]));
           nav.correct(
               g_packet.convert(), 
-              current_processor->lever_arm,
+              options.has_lever_arm ? options.lever_arm : current_processor->lever_arm,
               omega_b2i_4n);
         }else{ // When do not use lever arm effect.
           nav.correct(g_packet.convert());
         }
-        if(!current_processor->m_packet_deque.empty()){ // When magnetic sensor is activated, try to perform yaw compensation
+        if(!current_processor->m_packets.empty()){ // When magnetic sensor is activated, try to perform yaw compensation
           if((options.yaw_correct_with_mag_when_speed_less_than_ms > 0)
               && (pow(g_packet.vel_ned[0], 2) + pow(g_packet.vel_ned[1], 2)) < pow(options.yaw_correct_with_mag_when_speed_less_than_ms, 2)){
             nav.correct_yaw(nav.get_mag_delta_yaw(current_processor->get_mag(g_packet.itow)));
           }
         }
+        corrected = true;
       }else if((current_processor == processor_storage.front())
           && (recent_a_packets.size() >= min_a_packets_for_init)
           && (std::abs(recent_a_packets.front().itow - g_packet.itow) < (0.1 * recent_a_packets.size())) // time synchronization check
@@ -1102,10 +2234,8 @@ class Status{
           
           // Normalization
           vec_t acc(0, 0, 0);
-          for(deque<A_Packet>::iterator it(recent_a_packets.begin());
-              it != recent_a_packets.end();
-              ++it){
-            acc += current_processor->calibration.raw2accel(it->ch);
+          for(unsigned int i(0); i < recent_a_packets.size(); i++){
+            acc += current_processor->calibration.raw2accel(recent_a_packets[i].ch);
           }
           acc /= recent_a_packets.size();
           vec_t acc_reg(-acc / acc.abs());
@@ -1116,29 +2246,93 @@ class Status{
           roll = atan2(acc_reg[1], acc_reg[2]);
           
           // Estimate yaw when magnetic sensor is available
-          if(!current_processor->m_packet_deque.empty()){
+          if(!current_processor->m_packets.empty()){
             yaw = nav.get_mag_yaw(current_processor->get_mag(g_packet.itow), pitch, roll, latitude, longitude, g_packet.llh[2]);
           }
           
           break;
         }
         
-        cerr << "Init : " << setprecision(10) << g_packet.itow << endl;
-        initalized = true;
+        initalized = corrected = true;
         nav.init(
             latitude, longitude, g_packet.llh[2],
             g_packet.vel_ned[0], g_packet.vel_ned[1], g_packet.vel_ned[2],
             yaw, pitch, roll);
-        cerr << "Initial attitude (yaw, pitch, roll) [deg]: "
-            << rad2deg(yaw) << ", "
-            << rad2deg(pitch) << ", "
-            << rad2deg(roll) << endl;
+#if defined(_OPENMP)
+#pragma omp critical(status_message)
+#endif
+        {
+          message() << "Init : " << setprecision(10) << g_packet.itow << endl;
+          message() << "Initial attitude (yaw, pitch, roll) [deg]: "
+              << rad2deg(yaw) << ", "
+              << rad2deg(pitch) << ", "
+              << rad2deg(roll) << endl;
+        }
         
         dump_label();
       }
     }
     
-    bool is_initalized(){return initalized;}
+    bool is_initalized(){return initalized;}
+    
+    /**
+     * @return (bool) true when the state is able to be saved by save(),
+     * i.e., not initialized yet, or no time update follows the last measurement update,
+     * where no IMU sample is pending in the navigation step and the covariance update.
+     */
+    bool is_checkpointable() const {
+      return (!initalized) || corrected;
+    }
+    
+    /**
+     * Save the state for a checkpoint, which is restored by load().
+     * 
+     * @param out binary stream
+     */
+    void save(std::ostream &out) const {
+      Serializer::put(out, initalized);
+      Serializer::put(out, recent_a_packets);
+      for(unsigned int i(0); i < sizeof(gyro_storage) / sizeof(gyro_storage[0]); i++){
+        Serializer::put(out, gyro_storage[i]);
+      }
+      Serializer::put(out, gyro_index);
+      Serializer::put(out, gyro_init);
+      if(initalized){nav.save(out);}
+    }
+    
+    /**
+     * Restore the state saved by save().
+     * The label is dumped again when initialized.
+     * 
+     * @param in binary stream
+     */
+    void load(std::istream &in) throw(std::ios_base::failure) {
+      Serializer::get(in, initalized);
+      Serializer::get(in, recent_a_packets);
+      for(unsigned int i(0); i < sizeof(gyro_storage) / sizeof(gyro_storage[0]); i++){
+        Serializer::get(in, gyro_storage[i]);
+      }
+      Serializer::get(in, gyro_index);
+      Serializer::get(in, gyro_init);
+      if(initalized){
+        nav.load(in);
+        corrected = true;
+        dump_label();
+      }
+    }
+    
+    /**
+     * Perform the backward pass of RTS smoothing, then dump the smoothed states.
+     */
+    void smooth(){
+      if(!initalized){return;}
+      nav.smooth();
+      int mode;
+      float_sylph_t itow;
+      while(nav.smoothed(mode, itow)){
+        dump(((mode == DUMP_UPDATE) ? "RTS_TU" : "RTS_MU"), itow, nav);
+      }
+    }
 };
 
 /**
@@ -1158,21 +2352,21 @@ void a_packet_handler(const A_Observer_t &observer){
   }
   packet.ch[8] = values.temperature;
   
-  deque<A_Packet> &a_packet_deque(
-      current_processor->a_packet_deque);
+  StreamProcessor::a_packets_t &a_packets(current_processor->a_packets);
 
   while(options.reduce_1pps_sync_error){
-    if(a_packet_deque.empty()){break;}
-    float_sylph_t delta_t(packet.itow - a_packet_deque.back().itow);
+    if(a_packets.empty()){break;}
+    float_sylph_t delta_t(packet.itow - a_packets.back().itow);
     if((delta_t < 1) || (delta_t >= 2)){break;}
     packet.itow -= 1;
     break;
   }
 
-  while(a_packet_deque.size() >= 128){
-    a_packet_deque.pop_front();
+  // Time must be non-decreasing in the ring; going back such as week rollover restarts it.
+  if((!a_packets.empty()) && (packet.itow < a_packets.back().itow)){
+    a_packets.clear();
   }
-  a_packet_deque.push_back(packet);
+  a_packets.push_back(packet); // The oldest is discarded when full.
 }
 
 /**
@@ -1227,10 +2421,13 @@ void g_packet_handler(const G_Observer_t &observer){
             packet.vel_ned[1] = velocity.east;
             packet.vel_ned[2] = velocity.down;
             packet.acc_vel = velocity_acc.acc;
+            packet.wn = current_processor->g_packet_wn;
             
-            current_processor->g_packet_updated = true;
-            
-            require_switch_processor = true;
+            StreamProcessor::g_packets_t &g_packets(current_processor->g_packets);
+            if((!g_packets.empty()) && (packet.itow < g_packets.back().itow)){
+              g_packets.clear();
+            }
+            g_packets.push_back(packet);
           }
             
           break;
@@ -1263,9 +2460,7 @@ void m_packet_handler(const M_Observer_t &observer){
     }
   }
   
-  while(current_processor->m_packet_deque.size() > 0x40){
-    current_processor->m_packet_deque.pop_front();
-  }
+  StreamProcessor::m_packets_t &m_packets(current_processor->m_packets);
 
   // TODO: magnetic sensor axes must correspond to ones of accelerometer and gyro.
   Vector3<float_sylph_t> mag(values.x[3], values.y[3], values.z[3]);
@@ -1274,151 +2469,690 @@ void m_packet_handler(const M_Observer_t &observer){
   m_packet.mag = mag;
 
   while(options.reduce_1pps_sync_error){
-    if(current_processor->m_packet_deque.empty()){break;}
-    float_sylph_t delta_t(m_packet.itow - current_processor->m_packet_deque.back().itow);
+    if(m_packets.empty()){break;}
+    float_sylph_t delta_t(m_packet.itow - m_packets.back().itow);
     if((delta_t < 1) || (delta_t >= 2)){break;}
     m_packet.itow -= 1;
     break;
   }
 
-  current_processor->m_packet_deque.push_back(m_packet);
+  if((!m_packets.empty()) && (m_packet.itow < m_packets.back().itow)){
+    m_packets.clear();
+  }
+  m_packets.push_back(m_packet);
 }
 
-void loop(){
-  INS_GPS_NAV<
-      INS_GPS2<
-          float_sylph_t,
-          KalmanFilter<float_sylph_t> > > nav;
-  INS_GPS_NAV<INS_GPS2<float_sylph_t> > nav_udkf;
-  
-  INS_GPS_BE_NAV<
-      INS_GPS2_BiasEstimated<
-          float_sylph_t,
-          KalmanFilter<float_sylph_t> > > nav_bias;
-  INS_GPS_BE_NAV<INS_GPS2_BiasEstimated<float_sylph_t> > nav_bias_udkf;
+/**
+ * Create a navigator whose matrix Q is configured with the sensor noise
+ * of the calibration, or with the overrides in options.
+ * 
+ * @param opt options
+ */
+template <class NAV_T>
+NAV *make_nav(const Options &opt){
+  NAV_T *res(new NAV_T(opt));
+  res->set_filter_Q(
+      opt.has_sigma_accel ? opt.sigma_accel : processor_storage.front()->calibration.sigma_accel(),
+      opt.has_sigma_gyro ? opt.sigma_gyro : processor_storage.front()->calibration.sigma_gyro());
+  return res;
+}
+
+/**
+ * Create a navigator specified by options, whose precision is FloatT.
+ */
+template <class FloatT>
+struct NAV_Factory {
+  static NAV *make(const Options &opt){
+    if(opt.use_srkf){
+      return opt.est_bias
+          ? make_nav<INS_GPS_BE_NAV<
+              INS_GPS2_BiasEstimated<
+                  FloatT,
+                  KalmanFilterSquareRoot<FloatT> > > >(opt)
+          : make_nav<INS_GPS_NAV<
+              INS_GPS2<
+                  FloatT,
+                  KalmanFilterSquareRoot<FloatT> > > >(opt);
+    }else if(opt.use_josephkf){
+      return opt.est_bias
+          ? make_nav<INS_GPS_BE_NAV<
+              INS_GPS2_BiasEstimated<
+                  FloatT,
+                  KalmanFilterJoseph<FloatT> > > >(opt)
+          : make_nav<INS_GPS_NAV<
+              INS_GPS2<
+                  FloatT,
+                  KalmanFilterJoseph<FloatT> > > >(opt);
+    }else if(opt.use_udkf
+        || (std::numeric_limits<FloatT>::digits < std::numeric_limits<double>::digits)){
+      return opt.est_bias
+          ? make_nav<INS_GPS_BE_NAV<INS_GPS2_BiasEstimated<FloatT> > >(opt)
+          : make_nav<INS_GPS_NAV<INS_GPS2<FloatT> > >(opt);
+    }else{
+      return opt.est_bias
+          ? make_nav<INS_GPS_BE_NAV<
+              INS_GPS2_BiasEstimated<
+                  FloatT,
+                  KalmanFilter<FloatT> > > >(opt)
+          : make_nav<INS_GPS_NAV<
+              INS_GPS2<
+                  FloatT,
+                  KalmanFilter<FloatT> > > >(opt);
+    }
+  }
+};
+
+/**
+ * Create a navigator specified by options.
+ * 
+ * @param opt options
+ */
+NAV *make_nav(const Options &opt){
+  return opt.nav_float
+      ? NAV_Factory<float>::make(opt)
+      : NAV_Factory<float_sylph_t>::make(opt);
+}
+
+/**
+ * Member of an ensemble, whose options are the common ones overridden by a line of the ensemble file.
+ * When the line has no "--out", the output is written to "(ensemble file).(index).out".
+ */
+class EnsembleMember {
+  protected:
+    vector<char> spec; ///< the line, which is referred by options
+    string out_fname;
+  private:
+    EnsembleMember(const EnsembleMember &);
+    EnsembleMember &operator=(const EnsembleMember &);
+  public:
+    Options options;
+    NAV *nav;
+    Status *status;
+    EnsembleMember(const Options &common, const string &line, const int &index)
+        : spec(line.begin(), line.end()), out_fname(), options(common), nav(NULL), status(NULL) {
+      options.iostream_pool.clear(); // streams are owned by the common options
+      options.ensemble_spec = NULL;
+      options.ensemble_index = index;
+      
+      cerr << "Ensemble member [" << index << "]" << endl;
+      spec.push_back('\0');
+      for(vector<char>::iterator it(spec.begin()); *it != '\0'; ){
+        if(std::isspace(*it)){
+          *(it++) = '\0';
+          continue;
+        }
+        const char *token(&(*it));
+        while((*it != '\0') && !std::isspace(*it)){++it;}
+        if(*it != '\0'){*(it++) = '\0';}
+        if(!options.check_spec(token)){
+          cerr << "(error!) Unknown option in ensemble: " << token << endl;
+          exit(-1);
+        }
+      }
+      
+      if(options.out_shm == common.out_shm){
+        options.out_shm = NULL; // the shared memory must have a single writer
+      }
+      if(options._out == common._out){
+        stringstream ss;
+        ss << common.ensemble_spec << "." << index << ".out";
+        out_fname = ss.str();
+        cerr << "out: ";
+        options._out = &(options.spec2ostream(out_fname.c_str(), true));
+      }
+      if(options.out_sylphide){
+        options._out = new SylphideOStream(options.out(), PAGE_SIZE);
+      }else{
+        options.out() << setprecision(10);
+      }
+      
+      nav = make_nav(options);
+      status = new Status(*nav, options);
+    }
+    ~EnsembleMember(){
+      delete status;
+      delete nav;
+    }
+};
+
+/**
+ * Divergence of a navigator from a reference one, for example, float from double.
+ * The maximum and the RMS of the difference of each state are accumulated
+ * at every measurement update, then reported as CSV.
+ */
+class PrecisionCheck {
+  protected:
+    Status &reference, &target;
+    enum {
+      ITEM_NORTH, ITEM_EAST, ITEM_HEIGHT,
+      ITEM_V_NORTH, ITEM_V_EAST, ITEM_V_DOWN,
+      ITEM_HEADING, ITEM_ROLL, ITEM_PITCH, ITEM_YAW,
+      ITEMS,
+    };
+    float_sylph_t max_abs[ITEMS], sum_square[ITEMS];
+    unsigned int samples;
+    
+    static float_sylph_t angle_deg(const float_sylph_t &delta){
+      float_sylph_t res(std::fmod(rad2deg(delta), 360.));
+      if(res >= 180){res -= 360;}
+      else if(res < -180){res += 360;}
+      return res;
+    }
+    
+  public:
+    PrecisionCheck(Status &_reference, Status &_target)
+        : reference(_reference), target(_target), samples(0) {
+      for(int i(0); i < ITEMS; i++){max_abs[i] = sum_square[i] = 0;}
+    }
+    
+    /**
+     * Accumulate the current difference
+     */
+    void check(){
+      if(!(reference.is_initialized() && target.is_initialized())){return;}
+      const NAV &ref(reference.get_nav()), &tgt(target.get_nav());
+      float_sylph_t diff[ITEMS] = {
+        (tgt.latitude() - ref.latitude()) * WGS84::R_meridian(ref.latitude()),
+        (tgt.longitude() - ref.longitude()) * WGS84::R_normal(ref.latitude()) * std::cos(ref.latitude()),
+        tgt.height() - ref.height(),
+        tgt.v_north() - ref.v_north(),
+        tgt.v_east() - ref.v_east(),
+        tgt.v_down() - ref.v_down(),
+        angle_deg(tgt.heading() - ref.heading()),
+        angle_deg(tgt.euler_phi() - ref.euler_phi()),
+        angle_deg(tgt.euler_theta() - ref.euler_theta()),
+        angle_deg(tgt.euler_psi() - ref.euler_psi()),
+      };
+      for(int i(0); i < ITEMS; i++){
+        max_abs[i] = std::max(max_abs[i], std::abs(diff[i]));
+        sum_square[i] += diff[i] * diff[i];
+      }
+      samples++;
+    }
+    
+    /**
+     * Print the accumulated divergence
+     * 
+     * @param out stream
+     */
+    void report(std::ostream &out) const {
+      static const char *names[][2] = {
+        {"north", "m"}, {"east", "m"}, {"height", "m"},
+        {"v_north", "m/s"}, {"v_east", "m/s"}, {"v_down", "m/s"},
+        {"heading", "deg"}, {"roll", "deg"}, {"pitch", "deg"}, {"yaw", "deg"},
+      };
+      out << "precision_check, samples, " << samples << endl;
+      out << "state, unit, max, rms" << endl;
+      for(int i(0); i < ITEMS; i++){
+        out << names[i][0] << ", " << names[i][1] << ", "
+            << max_abs[i] << ", "
+            << (samples > 0 ? std::sqrt(sum_square[i] / samples) : 0) << endl;
+      }
+    }
+};
+
+/**
+ * Scheduler to merge G packets of all the input streams in order of time.
+ * The packet handlers are bound to the stream being read.
+ */
+struct MeasurementScheduler : public MeasurementSchedulerGeneric<StreamProcessor> {
+  static bool fill(StreamProcessor *processor){
+    current_processor = processor;
+    return MeasurementSchedulerGeneric<StreamProcessor>::fill(processor);
+  }
+};
+
+/**
+ * Checkpoint of the forward processing (@see loop_forward()),
+ * which is a compact binary file consisting of the time of the last measurement update,
+ * the states of the input streams (@see StreamProcessor::save()),
+ * and the states of the filters (@see Status::save()).
+ * It is written to a temporary file at first, then renamed, not to leave a broken one.
+ */
+struct Checkpoint {
+  static const char *magic(){return "NSINSGPS";}
   
-#define setQ(ins_gps) \
-ins_gps.set_filter_Q( \
-    processor_storage.front()->calibration.sigma_accel(), \
-    processor_storage.front()->calibration.sigma_gyro());
-  setQ(nav);
-  setQ(nav_udkf);
-  setQ(nav_bias);
-  setQ(nav_bias_udkf);
-#undef setQ
-
-  Status status(
-      options.use_udkf
-          ? (options.est_bias ? (NAV &)nav_bias_udkf : (NAV &)nav_udkf)
-          : (options.est_bias ? (NAV &)nav_bias : (NAV &)nav));
+  /**
+   * @param fname file name
+   * @param statuses filters, all of which must be Status::is_checkpointable()
+   * @param itow time of the last measurement update
+   */
+  static void save(
+      const char *fname, const vector<Status *> &statuses, const float_sylph_t &itow)
+      throw(std::ios_base::failure) {
+    string fname_tmp(string(fname).append(".tmp"));
+    {
+      ofstream out(fname_tmp.c_str(), ios::out | ios::binary | ios::trunc);
+      out.write(magic(), 8);
+      Serializer::put(out, (unsigned int)sizeof(float_sylph_t));
+      Serializer::put(out, itow);
+      Serializer::put(out, (unsigned int)processor_storage.size());
+      for(processor_storage_t::const_iterator it(processor_storage.begin());
+          it != processor_storage.end();
+          ++it){
+        (*it)->save(out);
+      }
+      Serializer::put(out, (unsigned int)statuses.size());
+      for(unsigned int i(0); i < statuses.size(); i++){
+        statuses[i]->save(out);
+      }
+      out.close();
+      if(out.fail()){
+        throw std::ios_base::failure(string("Could not write checkpoint ").append(fname_tmp));
+      }
+    }
+    std::remove(fname); // rename() of Windows does not overwrite.
+    if(std::rename(fname_tmp.c_str(), fname) != 0){
+      throw std::ios_base::failure(string("Could not rename checkpoint to ").append(fname));
+    }
+  }
   
-  while(true){
+  /**
+   * @param fname file name
+   * @param statuses filters, which must be configured in the same way as saved
+   * @return (float_sylph_t) time of the last measurement update
+   */
+  static float_sylph_t load(const char *fname, vector<Status *> &statuses)
+      throw(std::ios_base::failure) {
+    ifstream in(fname, ios::in | ios::binary);
+    if(in.fail()){
+      throw std::ios_base::failure(string("Could not open checkpoint ").append(fname));
+    }
+    char buf[8];
+    if((!in.read(buf, sizeof(buf))) || (std::memcmp(buf, magic(), sizeof(buf)) != 0)){
+      throw std::ios_base::failure(string("Not a checkpoint ").append(fname));
+    }
+    Serializer::expect(in, (unsigned int)sizeof(float_sylph_t), "precision");
+    float_sylph_t itow;
+    Serializer::get(in, itow);
+    Serializer::expect(in, (unsigned int)processor_storage.size(), "number of logs");
     for(processor_storage_t::iterator it(processor_storage.begin());
         it != processor_storage.end();
         ++it){
-      if((*it)->g_packet_updated){continue;}
-      current_processor = *it;
-      require_switch_processor = false;
-      while(!require_switch_processor){
-        if(!current_processor->process_1page()){
-          if(it == processor_storage.begin()){
-            return;
-          }else{
-            break;
-          }
-        }
+      (*it)->load(in);
+    }
+    Serializer::expect(in, (unsigned int)statuses.size(), "number of filters");
+    for(unsigned int i(0); i < statuses.size(); i++){
+      statuses[i]->load(in);
+    }
+    return itow;
+  }
+};
+
+void loop_forward(vector<Status *> &statuses, PrecisionCheck *check = NULL);
+void loop_realtime(vector<Status *> &statuses, PrecisionCheck *check = NULL);
+
+void loop(){
+  vector<EnsembleMember *> members;
+  vector<Status *> statuses;
+  
+  if(options.ensemble_spec){
+    cerr << "Ensemble file (" << options.ensemble_spec << ") reading..." << endl;
+    fstream fin(options.ensemble_spec, ios::in);
+    if(fin.fail()){
+      cerr << "(error!) Ensemble file not found: " << options.ensemble_spec << endl;
+      exit(-1);
+    }
+    string line;
+    while(getline(fin, line)){
+      string::size_type head(line.find_first_not_of(" \t\r"));
+      if((head == string::npos) || (line[head] == '#')){continue;}
+      members.push_back(new EnsembleMember(options, line, members.size()));
+      statuses.push_back(members.back()->status);
+    }
+    if(members.empty()){
+      cerr << "(error!) No member in ensemble file: " << options.ensemble_spec << endl;
+      exit(-1);
+    }
+  }
+  
+  NAV *nav(NULL);
+  PrecisionCheck *check(NULL);
+  if(members.empty()){
+    nav = make_nav(options);
+    statuses.push_back(new Status(*nav, options));
+    if(options.precision_check){
+      // A single precision navigator, whose output is discarded, runs along with the normal one.
+      members.push_back(new EnsembleMember(options,
+          string("--nav_float=on --out=").append(Options::null_fname()), 1));
+      statuses.push_back(members.back()->status);
+      check = new PrecisionCheck(*statuses.front(), *statuses.back());
+    }
+  }
+  
+  if(options.realtime){
+    loop_realtime(statuses, check);
+  }else{
+    loop_forward(statuses, check);
+  }
+  
+  if(check){
+    check->report(cerr);
+    delete check;
+  }
+  
+  if(options.rts_smooth){
+    cerr << "RTS smoothing..." << endl;
+  }
+  // Members with rts_smooth are smoothed independently.
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) if(statuses.size() > 1)
+#endif
+  for(int i = 0; i < (int)statuses.size(); i++){
+    statuses[i]->smooth();
+  }
+  
+  if(nav){
+    delete statuses.front();
+    delete nav;
+  }
+  for(vector<EnsembleMember *>::iterator it(members.begin());
+      it != members.end();
+      ++it){
+    delete *it;
+  }
+}
+
+void loop_forward(vector<Status *> &statuses, PrecisionCheck *check){
+  /*
+   * Records are decoded once, then fed to all the filters (statuses).
+   * The filters are independent of each other, therefore they are processed in parallel
+   * when OpenMP is enabled. The decoded records are not modified during the parallel sections.
+   */
+  const int statuses_size(statuses.size());
+  
+  /*
+   * G packets of all the input streams are merged in order of time by MeasurementScheduler.
+   * The time update is performed with A packets of the first stream.
+   */
+  StreamProcessor &tu_processor(*processor_storage.front());
+  
+  bool updated(false);
+  float_sylph_t latest_measurement_update_itow(0), checkpoint_itow(0);
+  
+  if(options.resume){
+    try{
+      latest_measurement_update_itow = checkpoint_itow
+          = Checkpoint::load(options.resume, statuses);
+      updated = true;
+      cerr << "Resume : " << setprecision(10) << latest_measurement_update_itow << endl;
+    }catch(std::ios_base::failure &e){
+      cerr << "(error!) " << e.what() << endl;
+      exit(-1);
+    }
+  }
+  
+  MeasurementScheduler scheduler;
+  for(processor_storage_t::iterator it(processor_storage.begin());
+      it != processor_storage.end();
+      ++it){
+    if(MeasurementScheduler::fill(*it)){
+      scheduler.push(*it);
+    }else if(*it == &tu_processor){
+      return;
+    }
+  }
+  
+  /*
+   * With several filters, the A packets are calibrated once in batch
+   * instead of being calibrated by each filter.
+   */
+  const bool calibrate_batch(statuses_size > 1);
+  StandardCalibration::batch_t batch;
+  
+  StreamProcessor *previous(NULL);
+  
+  while(true){
+    if(previous){ // Read ahead the stream used at the last step
+      if(MeasurementScheduler::fill(previous)){
+        scheduler.push(previous);
+      }else if(previous == &tu_processor){
+        return;
       }
     }
+    if(scheduler.empty()){return;}
+    
+    current_processor = previous = scheduler.pop();
+    G_Packet g_packet(current_processor->g_packets.front());
+    current_processor->g_packets.pop_front();
+
+    if((options.start_gpswn > g_packet.wn) // Week number check
+        || (options.start_gpstime > g_packet.itow)){ // Time check
+      continue;
+    }
+    if(updated && (g_packet.itow < latest_measurement_update_itow)){
+      continue; // Older than the last measurement update
+    }
+    
+    const StreamProcessor::a_packets_t &a_packets(tu_processor.a_packets);
+    const bool a_packets_has_item(!a_packets.empty());
 
-    // Check and sort G packets in order of observation time
-    typedef vector<StreamProcessor *> mu_queue_t;
-    mu_queue_t mu_queue;
+    if(options.gps_fake_lock){
+      if(a_packets_has_item){
+        g_packet.itow = a_packets.back().itow;
+      }
+      g_packet.llh[0] = g_packet.llh[1] = g_packet.llh[2] = 0;
+      g_packet.acc_2d = g_packet.acc_v = 1E+1;
+      g_packet.vel_ned[0] = g_packet.vel_ned[1] = g_packet.vel_ned[2] = 0;
+      g_packet.acc_vel = 1;
+    }
+  
+    // Samples to the last one before GPS observation, i.e., [0, tu_end)
+    const unsigned int tu_end(a_packets.lower_bound(g_packet.itow));
     
-    mu_queue.push_back(*processor_storage.begin());
-    bool require_search_again(false);
-    for(processor_storage_t::iterator it(processor_storage.begin() + 1);
-        it != processor_storage.end();
-        ++it){
-      if(!((*it)->g_packet_updated)){continue;}
-      float_sylph_t itow((*it)->g_packet.itow);
-      float_sylph_t interval(
-          itow - processor_storage.front()->g_packet.itow);
+    // Interpolated sample at the GPS observation
+    A_Packet interpolation;
+    if(a_packets_has_item){
+      interpolation = tu_processor.get_a(g_packet.itow);
+    }
+    
+    if(calibrate_batch){ // [0, tu_end) and the interpolated one
+      const StandardCalibration &calibration(tu_processor.calibration);
+      batch.clear();
+      for(unsigned int j(0); j < tu_end; j++){
+        calibration.push_back(batch, a_packets[j].ch);
+      }
+      if(a_packets_has_item){
+        calibration.push_back(batch, interpolation.ch);
+      }
+      calibration.calibrate(batch);
+    }
+    
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) if(statuses_size > 1)
+#endif
+    for(int i = 0; i < statuses_size; i++){
+      Status &status(*statuses[i]);
+      
+      // Time update to the last sample before GPS observation
+      for(unsigned int j(0); j < tu_end; j++){
+        if(calibrate_batch){
+          status.time_update(a_packets[j], batch.get_accel(j), batch.get_gyro(j));
+        }else{
+          status.time_update(a_packets[j]);
+        }
+        status.dump(Status::DUMP_UPDATE, a_packets[j].itow);
+      }
       
-      if(std::abs(interval) <= 0.2){ // When the observation times are near, use the data
-        mu_queue_t::iterator it2(mu_queue.begin());
-        while(it2 != mu_queue.end()){
-          if((*it2)->g_packet.itow > itow){break;}
-          ++it2;
+      // Time update to the GPS observation
+      if(a_packets_has_item){
+        if(calibrate_batch){
+          status.time_update(interpolation, batch.get_accel(tu_end), batch.get_gyro(tu_end));
+        }else{
+          status.time_update(interpolation);
         }
-        mu_queue.insert(it2, *it);
-      }else if(interval < 0){ // When old data, try to search again
-        (*it)->g_packet_updated = false;
-        require_search_again = true;
-        break;
       }
+      
+      // Measurement update
+      status.measurement_update(g_packet);
+      status.dump(Status::DUMP_CORRECT, g_packet.itow);
     }
     
-    if(require_search_again){continue;}
+    if(check){check->check();}
     
-    float_sylph_t latest_measurement_update_itow(0);
-    int latest_measurement_update_gpswn(0);
-    for(mu_queue_t::iterator it_mu(mu_queue.begin());
-        it_mu != mu_queue.end();
-        ++it_mu){
-      
-      current_processor = *it_mu;
-      G_Packet g_packet(current_processor->g_packet);
-      current_processor->g_packet_updated = false;
+    tu_processor.a_packets.pop_front(tu_end);
+    if(!updated){checkpoint_itow = g_packet.itow;}
+    updated = true;
+    latest_measurement_update_itow = g_packet.itow;
+    
+    if(options.checkpoint
+        && (std::abs(g_packet.itow - checkpoint_itow) >= options.checkpoint_interval)){
+      bool checkpointable(true);
+      for(int i = 0; i < statuses_size; i++){
+        checkpointable = checkpointable && statuses[i]->is_checkpointable();
+      }
+      if(checkpointable){ // otherwise, retry at the next step
+        try{
+          Checkpoint::save(options.checkpoint, statuses, g_packet.itow);
+          cerr << "Checkpoint : " << setprecision(10) << g_packet.itow << endl;
+        }catch(std::ios_base::failure &e){
+          cerr << "(error!) " << e.what() << endl;
+        }
+        checkpoint_itow = g_packet.itow;
+      }
+    }
+    
+    if((g_packet.itow >= options.end_gpstime)
+        && (g_packet.wn >= options.end_gpswn)){
+      return;
+    }
+  }
+}
 
-      if((options.start_gpswn > current_processor->g_packet_wn) // Week number check
+/**
+ * Forward processing with low latency.
+ * Each IMU sample is propagated by the real-time predictions and dumped as soon as it is read,
+ * while the filters lag behind by up to options.realtime_window seconds.
+ * When a GPS solution arrives, the filters are time updated to its time and corrected,
+ * then the predictions are restarted from the corrected states and replayed
+ * with the buffered samples newer than the solution.
+ * Samples older than the window are applied to the filters without waiting for GPS,
+ * and a GPS solution older than them is dropped.
+ */
+void loop_realtime(vector<Status *> &statuses, PrecisionCheck *check){
+  const int statuses_size(statuses.size());
+  
+  // Only the first stream is used.
+  StreamProcessor &processor(*processor_storage.front());
+  StreamProcessor::a_packets_t &a_packets(processor.a_packets);
+  StreamProcessor::g_packets_t &g_packets(processor.g_packets);
+  current_processor = &processor;
+  
+  bool predicted(false), filtered(false);
+  float_sylph_t
+      prediction_itow(0), // time of the latest sample propagated by the predictions
+      filter_itow(0); // time of the filters
+  unsigned int late_packets(0);
+  
+  while(processor.process_1page()){
+    if(a_packets.empty()){continue;}
+    
+    // Real-time prediction with new samples
+    unsigned int predict_begin(0);
+    if(predicted && (a_packets.back().itow >= prediction_itow)){
+      predict_begin = a_packets.lower_bound(prediction_itow);
+      while((predict_begin < a_packets.size())
+          && (a_packets[predict_begin].itow <= prediction_itow)){
+        predict_begin++;
+      }
+    }
+    if(predict_begin < a_packets.size()){
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) if(statuses_size > 1)
+#endif
+      for(int i = 0; i < statuses_size; i++){
+        for(unsigned int j(predict_begin); j < a_packets.size(); j++){
+          statuses[i]->predict(a_packets[j]);
+        }
+      }
+      predicted = true;
+      prediction_itow = a_packets.back().itow;
+    }
+    
+    // Measurement updates with GPS solutions which are covered by the samples
+    while((!g_packets.empty()) && (!a_packets.empty())
+        && (g_packets.front().itow <= a_packets.back().itow)){
+      G_Packet g_packet(g_packets.front());
+      g_packets.pop_front();
+      
+      if((options.start_gpswn > g_packet.wn) // Week number check
           || (options.start_gpstime > g_packet.itow)){ // Time check
         continue;
       }
+      if(filtered && (g_packet.itow < filter_itow)){
+        late_packets++; // Older than the window
+        continue;
+      }
       
-      deque<A_Packet> &a_packet_deque(
-          processor_storage.front()->a_packet_deque);
-      deque<A_Packet>::iterator it_tu(a_packet_deque.begin()), it_tu_end(a_packet_deque.end());
-      const bool a_packet_deque_has_item(it_tu != it_tu_end);
-
       if(options.gps_fake_lock){
-        if(a_packet_deque_has_item){
-          g_packet.itow = (it_tu_end - 1)->itow;
-        }
+        g_packet.itow = a_packets.back().itow;
         g_packet.llh[0] = g_packet.llh[1] = g_packet.llh[2] = 0;
         g_packet.acc_2d = g_packet.acc_v = 1E+1;
         g_packet.vel_ned[0] = g_packet.vel_ned[1] = g_packet.vel_ned[2] = 0;
         g_packet.acc_vel = 1;
       }
-    
-      // Time update to the last sample before GPS observation
-      for(; 
-          (it_tu != it_tu_end) && (it_tu->itow < g_packet.itow);
-          ++it_tu){
-        status.time_update(*it_tu);
-        status.dump(Status::DUMP_UPDATE, it_tu->itow);
-      }
       
-      // Time update to the GPS observation
-      if(a_packet_deque_has_item){
-        A_Packet interpolation((it_tu != it_tu_end) ? *it_tu : *(it_tu - 1));
-        interpolation.itow = g_packet.itow;
+      const unsigned int tu_end(a_packets.lower_bound(g_packet.itow));
+      const A_Packet interpolation(processor.get_a(g_packet.itow));
+      
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) if(statuses_size > 1)
+#endif
+      for(int i = 0; i < statuses_size; i++){
+        Status &status(*statuses[i]);
+        
+        // Rewind, i.e., time update of the filter to the GPS observation
+        for(unsigned int j(0); j < tu_end; j++){
+          status.time_update(a_packets[j]);
+        }
         status.time_update(interpolation);
+        
+        status.measurement_update(g_packet);
+        status.dump(Status::DUMP_CORRECT, g_packet.itow);
+        
+        // Replay of the prediction, whose states have been already dumped
+        status.predict_reset(g_packet.itow);
+        for(unsigned int j(tu_end); j < a_packets.size(); j++){
+          status.predict(a_packets[j], false);
+        }
       }
+      options.out().flush();
       
-      a_packet_deque.erase(a_packet_deque.begin(), it_tu);
+      if(check){check->check();}
       
-      // Measurement update
-      status.measurement_update(g_packet);
-      latest_measurement_update_itow = g_packet.itow;
-      latest_measurement_update_gpswn = current_processor->g_packet_wn;
+      a_packets.pop_front(tu_end);
+      filtered = true;
+      filter_itow = g_packet.itow;
+      
+      if((g_packet.itow >= options.end_gpstime)
+          && (g_packet.wn >= options.end_gpswn)){
+        return;
+      }
     }
     
-    status.dump(Status::DUMP_CORRECT, latest_measurement_update_itow);
-    
-    if((latest_measurement_update_itow >= options.end_gpstime)
-        && (latest_measurement_update_gpswn >= options.end_gpswn)){
-      break;
+    // Bound of the rewind; the oldest samples are applied to the filters without GPS.
+    if(a_packets.empty()){continue;}
+    unsigned int commit_end(
+        a_packets.lower_bound(a_packets.back().itow - options.realtime_window));
+    if((commit_end == 0) && a_packets.full()){
+      commit_end = 1; // Keep a room in order not to lose the next sample.
     }
+    if(commit_end == 0){continue;}
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) if(statuses_size > 1)
+#endif
+    for(int i = 0; i < statuses_size; i++){
+      for(unsigned int j(0); j < commit_end; j++){
+        statuses[i]->time_update(a_packets[j]);
+      }
+    }
+    filtered = true;
+    filter_itow = a_packets[commit_end - 1].itow;
+    a_packets.pop_front(commit_end);
+  }
+  
+  if(late_packets > 0){
+    cerr << "GPS solutions older than the real-time window: " << late_packets << " dropped" << endl;
   }
 }
 
@@ -1428,7 +3162,7 @@ int main(int argc, char *argv[]){
   cerr << setprecision(10);
 
   cerr << "NinjaScan INS/GPS post-processor" << endl;
-  cerr << "Usage: (exe) [options] log.dat" << endl;
+  cerr << "Usage: (exe) [options] log.dat [[options] log2.dat ...]" << endl;
   if(argc < 2){
     cerr << "Error: too few arguments; " << argc << " < min(2)" << endl;
     return -1;
@@ -1439,22 +3173,7 @@ int main(int argc, char *argv[]){
 
   StreamProcessor *stream_processor(new StreamProcessor());
 
-  { // NinjsScan default calibration parameters
-#define config(spec) stream_processor->calibration.check_spec(spec);
-    config("index_base 0");
-    config("index_temp_ch 8");
-    config("acc_bias 32768 32768 32768");
-    config("acc_bias_tc 0 0 0"); // No temperature compensation
-    config("acc_sf 4.1767576e+2 4.1767576e+2 4.1767576e+2"); // MPU-6000/9250 8[G] full scale; (1<<15)/(8*9.80665) [1/(m/s^2)]
-    config("acc_mis 1 0 0 0 1 0 0 0 1"); // No misalignment compensation
-    config("gyro_bias 32768 32768 32768");
-    config("gyro_bias_tc 0 0 0"); // No temperature compensation
-    config("gyro_sf 9.3873405e+2 9.3873405e+2 9.3873405e+2"); // MPU-6000/9250 2000[dps] full scale; (1<<15)/(2000/180*PI) [1/(rad/s)]
-    config("gyro_mis 1 0 0 0 1 0 0 0 1"); // No misalignment compensation
-    config("sigma_accel 0.05 0.05 0.05"); // approx. 150[mG] ? standard deviation
-    config("sigma_gyro 5e-3 5e-3 5e-3"); // approx. 0.3[dps] standard deviation
-#undef config
-  }
+  stream_processor->calibration.set_default(); // NinjsScan default calibration parameters
 
   for(int arg_index(1); arg_index < argc; arg_index++){
     const char *value;
@@ -1465,11 +3184,7 @@ int main(int argc, char *argv[]){
         cerr << "(error!) Calibration file not found: " << value << endl;
         return -1;
       }
-      char buf[1024];
-      while(!fin.eof()){
-        fin.getline(buf, sizeof(buf));
-        stream_processor->calibration.check_spec(buf);
-      }
+      stream_processor->calibration.load(fin);
       continue;
     }
 
@@ -1489,8 +3204,16 @@ int main(int argc, char *argv[]){
     if(options.check_spec(argv[arg_index])){continue;}
     
     if(!processor_storage.empty()){
-      cerr << "(error!) Unknown option or too many log." << endl;
-      exit(-1);
+      /*
+       * Additional log, such as one of another GPS receiver, whose G packets are merged in order of time.
+       * Its calibration and lever arm are inherited from the previous log, and can be overwritten
+       * by calib_file and lever_arm options placed between the logs.
+       */
+      StreamProcessor *previous(stream_processor);
+      stream_processor = new StreamProcessor();
+      stream_processor->calibration = previous->calibration;
+      stream_processor->lever_arm = previous->lever_arm;
+      stream_processor->use_lever_arm = previous->use_lever_arm;
     }
 
     stream_processor->set_a_handler(a_packet_handler);  // Register A page handler
@@ -1511,6 +3234,23 @@ int main(int argc, char *argv[]){
     cerr << "(error!) No log file." << endl;
     exit(-1);
   }
+  if(processor_storage.back() != stream_processor){
+    delete stream_processor; // options after the last log
+  }
+  if((processor_storage.size() > 1) && options.realtime){
+    cerr << "(error!) realtime option uses only one log." << endl;
+    exit(-1);
+  }
+
+  if(options.realtime && (options.back_propagate || options.rts_smooth)){
+    cerr << "(error!) realtime option is exclusive with back_propagate and rts_smooth." << endl;
+    exit(-1);
+  }
+
+  if(options.realtime && (options.checkpoint || options.resume)){
+    cerr << "(error!) realtime option is exclusive with checkpoint and resume." << endl;
+    exit(-1);
+  }
 
   if(options.out_sylphide){
     options._out = new SylphideOStream(options.out(), PAGE_SIZE);
@@ -1518,7 +3258,13 @@ int main(int argc, char *argv[]){
     options.out() << setprecision(10);
   }
 
-  loop();
+  try{
+    loop();
+  }catch(std::ios_base::failure &e){ // for example, the shared memory output is not available
+    cerr << "(error!) " << e.what() << endl;
+    exit(-1);
+  }
+  if(options.matrix_pool){MatrixPoolScope::report(cerr);}
   
   for(processor_storage_t::iterator it(processor_storage.begin());
       it != processor_storage.end();
@@ -839,31 +839,31 @@ class G_Packet_Observer : public Packet_Observer<>{
 };
 
 /**
- * NpPbg(q@)Ɋւ`
+ * Nパケット(航法情報)に関する定義
  * 
  * Header (4byte)
  *   'N' (1byte)
- *   V[PXNo. (1byte)
- *   NpPbg̎ (1byte)
- *   g(`FbNTɂłg?) (1byte)
+ *   シーケンスNo. (1byte)
+ *   Nパケットの種類 (1byte)
+ *   拡張(チェックサムにでも使う?) (1byte)
  * 
- * [NpPbg̎ = 0x00] Content (28bytes)
+ * [Nパケットの種類 = 0x00] Content (28bytes)
  *   ITOW (4bytes) [msec]
- *   ʒu (12bytes)
- *     ܓx (4bytes -2147483648 ` 2147483647)
- *       -90.0000000 ` 90.0000000 [deg] * 10000000
- *     ox (4bytes -2147483648 ` 2147483647)
- *       -180.0000000 ` 180.0000000 [deg] * 10000000
- *     x (4bytes -2147483648 ` 2147483647)
- *       -214748.3648 ` 214748.3647 [m] * 10000
- *   x (6bytes)
- *     NED (2bytes -32768 ` 32767)
- *       -327.68 ` 327.68 [m/s] * 100
- *   p (6ytes)
- *     wfBO (2bytes -32768 ` 32767)
- *       -180.00 ` 180.00 [deg] * 100
- *     [Asb` (2bytes -32768 ` 32767)
- *       -90.00 ` 90.00 [deg] * 100
+ *   位置 (12bytes)
+ *     緯度 (4bytes -2147483648 ～ 2147483647)
+ *       -90.0000000 ～ 90.0000000 [deg] * 10000000
+ *     経度 (4bytes -2147483648 ～ 2147483647)
+ *       -180.0000000 ～ 180.0000000 [deg] * 10000000
+ *     高度 (4bytes -2147483648 ～ 2147483647)
+ *       -214748.3648 ～ 214748.3647 [m] * 10000
+ *   速度 (6bytes)
+ *     NED (2bytes -32768 ～ 32767)
+ *       -327.68 ～ 327.68 [m/s] * 100
+ *   姿勢 (6ytes)
+ *     ヘディング (2bytes -32768 ～ 32767)
+ *       -180.00 ～ 180.00 [deg] * 100
+ *     ロール、ピッチ (2bytes -32768 ～ 32767)
+ *       -90.00 ～ 90.00 [deg] * 100
  */
 template <class FloatType = double>
 class N_Packet_Observer : public Packet_Observer<>{
@@ -917,17 +917,17 @@ class N_Packet_Observer : public Packet_Observer<>{
       char buf[24];
       this->inspect(buf, sizeof(buf), 7);
       
-      // ʒu
+      // 位置
       result.latitude = (FloatType)1E-7 * le_char4_2_num<int>(*(buf));
       result.longitude = (FloatType)1E-7 * le_char4_2_num<int>(*(buf + 4));
       result.altitude = (FloatType)1E-4 * le_char4_2_num<int>(*(buf + 8));
       
-      // x
+      // 速度
       result.v_north = (FloatType)1E-2 * le_char2_2_num<short>(*(buf + 12));
       result.v_east = (FloatType)1E-2 * le_char2_2_num<short>(*(buf + 14));
       result.v_down = (FloatType)1E-2 * le_char2_2_num<short>(*(buf + 16));
       
-      // p
+      // 姿勢
       result.heading = (FloatType)1E-2 * le_char2_2_num<short>(*(buf + 18));
       result.pitch = (FloatType)1E-2 * le_char2_2_num<short>(*(buf + 20));
       result.roll = (FloatType)1E-2 * le_char2_2_num<short>(*(buf + 22));
@@ -69,38 +69,38 @@ struct SylphideProtocol {
   }
     
   /**
-   * GR[hs֐
+   * エンコードを行う関数
    * 
    */
   struct Encoder {
     /**
-     * GR[hsʂ̃pPbgTCY߂
+     * エンコードを行った結果のパケットサイズを求める
      * 
-     * @param payload_size yC[h̃TCY
-     * @return (unsigned int) pPbg̃TCY
+     * @param payload_size ペイロードのサイズ
+     * @return (unsigned int) パケットのサイズ
      */
     static const unsigned int packet_size(
         const unsigned int payload_size){
       
-      // yC[hTCYmF
+      // ペイロードサイズ確認
       switch(payload_size){
-        case 0: // yC[h񏊗L̏ꍇ͌Œ蒷(0bytes)
+        case 0: // ペイロード非所有の場合は固定長(0bytes)
           return capsule_size;
-        case payload_fixed_length: // yC[hLAŒ蒷
+        case payload_fixed_length: // ペイロード所有、固定長
           return capsule_size + payload_fixed_length;
-        default: // yC[hLAϒ
+        default: // ペイロード所有、可変長
           return capsule_size + 2 + payload_size;
       }   
     }
     
     /**
-     * GR[h̑O
+     * エンコードの前処理
      * 
-     * @param target GR[hʂi[
-     * @param payload_size yC[h̃TCY
-     * @param request_ack ACKvKvƂ邩
-     * @param ack_reply ACKւ̕ԓ
-     * @return (unsigne int) yC[h̐擪ƂȂׂItZbg
+     * @param target エンコード結果を格納する先
+     * @param payload_size ペイロードのサイズ
+     * @param request_ack ACK要求を必要とするか
+     * @param ack_reply ACKへの返答か
+     * @return (unsigne int) ペイロードの先頭となるべきオフセット量
      */
     template<class Container>
     static unsigned int preprocess(Container &target,
@@ -110,7 +110,7 @@ struct SylphideProtocol {
       
       unsigned int payload_start_offset(capsule_head_size);
       
-      // wb_̏
+      // ヘッダの書き込み
       for(int i(0); i < header_size; i++){
         target[i] = header[i];
       }
@@ -130,7 +130,7 @@ struct SylphideProtocol {
       if(request_ack){target[header_size - 1] |= 0x08;}
       if(ack_reply){target[header_size - 1] |= 0x04;}
       
-      // yC[hTCYς̏ꍇ̓TCYĂ
+      // ペイロードサイズが可変の場合はサイズも書いておく
       if(add_payload_size){
         v_u16_t payload_size_u16(payload_size);
         v_u16_t payload_size_u16_le(
@@ -146,16 +146,16 @@ struct SylphideProtocol {
     }
     
     /**
-      * V[PXԍ𖄂ߍ
+      * シーケンス番号を埋め込む
       *
-      * @param target GR[hʂ̊i[
-      * @param sequence_num V[PXԍ
+      * @param target エンコード結果の格納先
+      * @param sequence_num シーケンス番号
       */
      template<class Container>
      static void embed_sequence_num(Container &target,
          const unsigned int sequence_num){
 
-       // V[PXԍ̏
+       // シーケンス番号の書き込み
        v_u16_t sequence_num_u16(sequence_num);
        v_u16_t sequence_num_u16_le(
            le_char2_2_num<v_u16_t>(*(char *)&sequence_num_u16));
@@ -166,14 +166,14 @@ struct SylphideProtocol {
      }
 
     /**
-     * GR[hđM
+     * エンコードして送信する
      * 
-     * @param stream M^[Qbg
-     * @param sequence_num V[PXԍ
-     * @param payload yC[h
-     * @param payload_size yC[hTCY
-     * @param request_ack ACKvKvƂ邩
-     * @param ack_reply ACKւ̕ԓ
+     * @param stream 送信ターゲット
+     * @param sequence_num シーケンス番号
+     * @param payload ペイロード
+     * @param payload_size ペイロードサイズ
+     * @param request_ack ACK要求を必要とするか
+     * @param ack_reply ACKへの返答か
      */
     template<class Stream, class Container>
     static void send(
@@ -189,16 +189,16 @@ struct SylphideProtocol {
       unsigned int payload_offset(
           preprocess(header_buf, payload_size, request_ack, ack_reply));
 
-      // V[PXԍ̏
+      // シーケンス番号の書き込み
       embed_sequence_num(header_buf, sequence_num);
 
-      // wb_(+V[PXԍ(+TCY))M
+      // ヘッダ(+シーケンス番号(+サイズ))送信
       stream(header_buf, payload_offset);
 
-      // yC[hM
+      // ペイロード送信
       stream(payload, payload_size);
 
-      // CRC̕t
+      // CRCの付加
       v_u16_t crc_u16(calc_crc16(
           payload, payload_size, 0,
           calc_crc16(header_buf, payload_offset - header_size, header_size)));
@@ -206,26 +206,26 @@ struct SylphideProtocol {
       v_u16_t crc_u16_le(
           le_char2_2_num<v_u16_t>(*(char *)&crc_u16));
 
-      // tb^M
+      // フッタ送信
       stream((unsigned char *)&crc_u16_le, sizeof(crc_u16_le));
     }
 
     /**
-     * GR[ȟ㏈
+     * エンコードの後処理
      *
-     * @param target GR[hʂ̊i[
-     * @param sequence_num V[PXԍ
-     * @param whole_size GR[hʂ̃pPbgTCY
+     * @param target エンコード結果の格納先
+     * @param sequence_num シーケンス番号
+     * @param whole_size エンコードした結果のパケットサイズ
      */
     template<class Container>
     static void postprocess(Container &target,
         const unsigned int sequence_num,
         const unsigned int whole_size){
       
-      // V[PXԍ̏
+      // シーケンス番号の書き込み
       embed_sequence_num(target, sequence_num);
       
-      // CRC̕t
+      // CRCの付加
       v_u16_t crc_u16(calc_crc16(
           target, whole_size - capsule_tail_size - header_size, header_size));
       
@@ -256,18 +256,18 @@ struct SylphideProtocol {
   struct Decorder {
     
     /**
-     * 擪`FbNs
+     * 先頭チェックを行う
      * 
-     * @param target ̓Xg[
-     * @return (bool) 擪`FbNꍇtrue
+     * @param target 入力ストリーム
+     * @return (bool) 先頭チェックが完了した場合true
      */
     template<class Container>
     static bool valid_head(Container &target){
-      // ŏTCYŃTCYmF
+      // 最小サイズでサイズ確認
       if(capsule_size > target.stored()){
         return false;
       }
-      // wb_mF
+      // ヘッダ確認
       if(((unsigned char)target[0] != header[0])
           || (((unsigned char)target[1] & 0xF0) != header[1])){
         return false;
@@ -276,87 +276,87 @@ struct SylphideProtocol {
     }
     
     /**
-     * yC[h̃TCY߂
+     * ペイロードのサイズを求める
      * 
-     * @param target ̓Xg[
-     * @return (unsigned int) yC[h̃TCY
+     * @param target 入力ストリーム
+     * @return (unsigned int) ペイロードのサイズ
      */
     template<class Container>
     static unsigned int payload_size(Container &target){
       
-      // yC[hTCYmF
+      // ペイロードサイズ確認
       switch((unsigned char)target[1] & 0x03){
-        case 1: { // yC[hLAϒ
+        case 1: { // ペイロード所有、可変長
           unsigned char buf[] = {
               (unsigned char)target[4], (unsigned char)target[5]};
           return le_char2_2_num<v_u16_t>(*(const char *)buf);
         }
-        case 2: // yC[h񏊗LAŒ蒷(0bytes)
+        case 2: // ペイロード非所有、固定長(0bytes)
           return 0;
-        case 3: // yC[h񏊗LAϒ(0bytes)
+        case 3: // ペイロード非所有、可変長(0bytes)
           return 0;
-        default: // yC[hLAŒ蒷(32bytes)
+        default: // ペイロード所有、固定長(32bytes)
           return payload_fixed_length;
       }   
     }
     
     /**
-     * pPbg̃TCY߂
+     * パケットのサイズを求める
      * 
-     * @param target ̓Xg[
-     * @return (unsigned int) pPbg̃TCY
+     * @param target 入力ストリーム
+     * @return (unsigned int) パケットのサイズ
      */
     template<class Container>
     static unsigned int packet_size(Container &target){
       
-      // yC[hTCYmF
+      // ペイロードサイズ確認
       switch((unsigned char)target[1] & 0x03){
-        case 1: { // yC[hLAϒ
+        case 1: { // ペイロード所有、可変長
           unsigned char buf[] = {
               (unsigned char)target[4], (unsigned char)target[5]};
           return le_char2_2_num<v_u16_t>(*(const char *)buf) + capsule_size + 2;
         }
-        case 2: // yC[h񏊗LAŒ蒷(0bytes)
+        case 2: // ペイロード非所有、固定長(0bytes)
           return capsule_size;
-        case 3: // yC[h񏊗LAϒ(0bytes)
+        case 3: // ペイロード非所有、可変長(0bytes)
           return capsule_size + 2;
-        default: // yC[hLAŒ蒷(32bytes)
+        default: // ペイロード所有、固定長(32bytes)
           return payload_fixed_length + capsule_size;
       }
     }
     
     /**
-     * TCY`FbNs
+     * サイズチェックを行う
      * 
-     * @param target ̓Xg[
-     * @return (bool) 擪`FbNꍇtrue
+     * @param target 入力ストリーム
+     * @return (bool) 先頭チェックが完了した場合true
      */
     template<class Container>
     static bool valid_size(Container &target){
-      // ŏTCYŃTCYmF
+      // 最小サイズでサイズ確認
       return packet_size(target) <= target.stored();
     }
     
     /**
-     * V[PXԍ߂
+     * シーケンス番号を求める
      * 
-     * @param target ̓Xg[
-     * @return (unsigned int) V[PXԍ
+     * @param target 入力ストリーム
+     * @return (unsigned int) シーケンス番号
      */
     template<class Container>
     static unsigned int sequence_num(Container &target){
           
-      // V[PXԍ
+      // シーケンス番号
       unsigned char buf[] = {
           (unsigned char)target[2], (unsigned char)target[3]};
       return le_char2_2_num<v_u16_t>(*(const char *)buf);    
     }
     
     /**
-     * ACKvKvƂĂ邩ǂ
+     * ACK要求を必要としているかどうか
      * 
-     * @param target ̓Xg[
-     * @return (bool) ACKvKvƂĂꍇtrue
+     * @param target 入力ストリーム
+     * @return (bool) ACK要求を必要としている場合true
      */
     template<class Container>
     static bool is_request_ack(Container &target){
@@ -365,10 +365,10 @@ struct SylphideProtocol {
     }
     
     /**
-     * ACKւ̕ԓǂ
+     * ACKへの返答かどうか
      * 
-     * @param target ̓Xg[
-     * @return (bool) ACKւ̕ԓ̏ꍇtrue
+     * @param target 入力ストリーム
+     * @return (bool) ACKへの返答の場合true
      */
     template<class Container>
     static bool is_ack_reply(Container &target){
@@ -377,12 +377,12 @@ struct SylphideProtocol {
     }
     
     /**
-     * yC[ho
+     * ペイロードを取り出す
      * 
-     * @param target ̓Xg[
-     * @param buf Rs[
-     * @param whole_size pPbgŜ̃TCY
-     * @param extract_size yC[hTCY
+     * @param target 入力ストリーム
+     * @param buf コピー先
+     * @param whole_size パケット全体のサイズ
+     * @param extract_size ペイロードサイズ
      */
     template<class Container, class BufferT>
     static void extract_payload(
@@ -397,28 +397,28 @@ struct SylphideProtocol {
     }
     
     /**
-     * pPbgLǂmF
+     * パケットが有効かどうか確認する
      * 
-     * @param target ̓Xg[
-     * @return (bool) L̏ꍇtrue
+     * @param target 入力ストリーム
+     * @return (bool) 有効の場合true
      */
     template<class Container>
     static bool ready(Container &target){
-      // wb_̊mF
+      // ヘッダの確認
       return valid_head(target) && valid_size(target);
     }
     
     /**
-     * f[^̑Ó؂
+     * データの妥当性を検証する
      * 
-     * @param target ̓Xg[
-     * @return (bool) yC[h̃TCY
+     * @param target 入力ストリーム
+     * @return (bool) ペイロードのサイズ
      */
     template<class Container>
     static bool validate(Container &target){
       const unsigned int whole_size(packet_size(target));
         
-      // CRCmF
+      // CRC確認
       v_u16_t crc16_orig, crc16_calc;
       {
         unsigned char buf[] = {
@@ -471,7 +471,7 @@ const unsigned int SylphideProtocol::capsule_size
         + SylphideProtocol::capsule_tail_size;
 
 #ifndef __TI_COMPILER_VERSION__
-// DSP̏ꍇAstream/STL֘A̋@\̓JbgĂ
+// DSP向けの場合、stream/STL関連の機能はカットしておく
 
 #include <streambuf>
 #include <istream>
@@ -504,7 +504,7 @@ class basic_SylphideStreambuf_out : public std::basic_streambuf<_Elem, _Traits>{
     using super_t::setp;
     
     int_type overflow(int_type c = _Traits::eof()){
-      // GR[hS
+      // エンコードを担当
       //std::cerr << "overflow()" << std::endl;
       
       if(c != _Traits::eof()){
@@ -512,7 +512,7 @@ class basic_SylphideStreambuf_out : public std::basic_streambuf<_Elem, _Traits>{
         SylphideProtocol::Encoder::postprocess(
             packet, sequence_num, packet_size);
       
-        // wb_AV[PXԍA{ACRC16̏ɑM
+        // ヘッダ、シーケンス番号、本文、CRC16の順に送信する
         out.write(packet, packet_size);
         if(out.good()){
           setp(pbase(), epptr());
@@ -541,10 +541,10 @@ class basic_SylphideStreambuf_out : public std::basic_streambuf<_Elem, _Traits>{
     }
     
     /**
-     * RXgN^
+     * コンストラクタ
      * 
-     * o̓tB^ƂĎgpꍇB̎AGR[_B
-     * @param out o̓Xg[
+     * 出力フィルタとして使用する場合。この時、エンコーダが活性化する。
+     * @param out 出力ストリーム
      */
     basic_SylphideStreambuf_out(
         std::ostream &_out,
@@ -604,7 +604,7 @@ class basic_SylphideStreambuf_in : public std::basic_streambuf<_Elem, _Traits>{
     typedef typename super_t::int_type int_type;
     
     container_t buffer;
-    bool mode_fixed_size; ///< ܂̃pPbgEȂ悤ɂ郂[h
+    bool mode_fixed_size; ///< 決まった長さのパケットしか拾わないようにするモード
     unsigned int payload_size;
     _Elem *payload;
     unsigned int payload_bufsize;
@@ -626,7 +626,7 @@ class basic_SylphideStreambuf_in : public std::basic_streambuf<_Elem, _Traits>{
     
   protected:
     int_type underflow(){
-      // fR[hS
+      // デコードを担当
       //std::cerr << "underflow()" << std::endl;
       
       unsigned int buffer_size_min(SylphideProtocol::capsule_size);
@@ -683,11 +683,11 @@ class basic_SylphideStreambuf_in : public std::basic_streambuf<_Elem, _Traits>{
     
   public:
     /**
-     * RXgN^
+     * コンストラクタ
      * 
-     * fR[_Ƌ
+     * デコーダと協調する
      * 
-     * @param in ̓Xg[ 
+     * @param in 入力ストリーム 
      */
     basic_SylphideStreambuf_in(std::istream &_in)
         : buffer(_in), payload_size(0), 
@@ -696,12 +696,12 @@ class basic_SylphideStreambuf_in : public std::basic_streambuf<_Elem, _Traits>{
       setg(payload, payload, payload);
     }
     /**
-     * RXgN^
+     * コンストラクタ
      * 
-     * fR[_ƋAē̒̃pPbgEȂ悤ɂ
+     * デコーダと協調する、加えて特定の長さのパケットしか拾わないようにする
      * 
-     * @param in ̓Xg[
-     * @param payload_size pPbg̃yC[hTCY(0w肷ƗlXȒ̃pPbgE) 
+     * @param in 入力ストリーム
+     * @param payload_size パケット上のペイロードサイズ(0を指定すると様々な長さのパケットを拾う) 
      */
     basic_SylphideStreambuf_in(
         std::istream &_in, const unsigned int size)
@@ -33,39 +33,55 @@
 #define __INTEGRAL_H
 
 /** @file
- * @brief ϕ@Lqt@CłB
+ * @brief 積分法を記述したファイルです。
  * 
- * ϕ@Lqt@CłB
- * ݂̓IC[@ARunge-Kutta@(2A4)3ނ̐ϕ@T|[gĂ܂B
+ * 積分法を記述したファイルです。
+ * 現在はオイラー法、Runge-Kutta法(2次、4次)の3種類の積分法をサポートしています。
  *  
  */
 
 /**
- * Runge-Kutta@(4)ɂϕ
+ * Runge-Kutta法(4次)による目的量の増分
  * 
- * @param f \f$ f(x, y) \f$
- * @param x ԗ
- * @param y ړI
- * @param h ԗʂ̍
- * @return wԗʍo߂ۂ̖ړI
+ * 増分が目的量に比べ非常に小さく、加える際の丸め誤差を別途扱う場合に用います。
+ * 
+ * @param f 差分方程式\f$ f(x, y) \f$
+ * @param x 状態量
+ * @param y 目的量
+ * @param h 状態量の差分
+ * @return 指定状態量差分が経過した際の目的量の増分
  */
 template <class Function, class V1, class V2>
-V2 nextByRK4(const Function &f, const V1 &x, const V2 &y, const V1 &h){
+V2 deltaByRK4(const Function &f, const V1 &x, const V2 &y, const V1 &h){
   V2 k1(f(x, y) * h);
   V2 k2(f(x + h/2, y + k1/2) * h);
   V2 k3(f(x + h/2, y + k2/2) * h);
   V2 k4(f(x + h, y + k3) * h);
-  return y + (k1 + k2*2 + k3*2 + k4)/6;
+  return (k1 + k2*2 + k3*2 + k4)/6;
+}
+
+/**
+ * Runge-Kutta法(4次)による積分
+ * 
+ * @param f 差分方程式\f$ f(x, y) \f$
+ * @param x 状態量
+ * @param y 目的量
+ * @param h 状態量の差分
+ * @return 指定状態量差分が経過した際の目的量
+ */
+template <class Function, class V1, class V2>
+V2 nextByRK4(const Function &f, const V1 &x, const V2 &y, const V1 &h){
+  return y + deltaByRK4(f, x, y, h);
 }
 
 /**
- * Runge-Kutta@(2)ɂϕ
+ * Runge-Kutta法(2次)による積分
  * 
- * @param f \f$ f(x, y) \f$
- * @param x ԗ
- * @param y ړI
- * @param h ԗʂ̍
- * @return wԗʍo߂ۂ̖ړI
+ * @param f 差分方程式\f$ f(x, y) \f$
+ * @param x 状態量
+ * @param y 目的量
+ * @param h 状態量の差分
+ * @return 指定状態量差分が経過した際の目的量
  */
 template <class Function, class V1, class V2>
 V2 nextByRK2(const Function &f, const V1 &x, const V2 &y, const V1 &h){
@@ -75,13 +91,13 @@ V2 nextByRK2(const Function &f, const V1 &x, const V2 &y, const V1 &h){
 }
 
 /**
- * Euler@(1)ɂϕ
+ * Euler法(1次)による積分
  * 
- * @param f \f$ f(x, y) \f$
- * @param x ԗ
- * @param y ړI
- * @param h ԗʂ̍
- * @return wԗʍo߂ۂ̖ړI
+ * @param f 差分方程式\f$ f(x, y) \f$
+ * @param x 状態量
+ * @param y 目的量
+ * @param h 状態量の差分
+ * @return 指定状態量差分が経過した際の目的量
  */
 template <class Function, class V1, class V2>
 V2 nextByEuler(const Function &f, const V1 &x, const V2 &y, const V1 &h){
@@ -35,92 +35,343 @@
 #include "param/matrix.h"
 
 /** @file
- * @brief Kalman FilterLqt@CłB
+ * @brief Kalman Filterを記述したファイルです。
  * 
- * Kalman@FilterLqt@CłB
- * ݂2ނ̗UKalman FilterAȂ킿WIKalman Filter
- * UDKlamn FilterT|[gĂ܂B
- * IɍšvZsĂ邽߁As񃉃Cu( Matrix )KvƂ܂B
+ * Kalman　Filterを記述したファイルです。
+ * 現在は離散Kalman Filterとして、標準的なKalman Filter、
+ * UD分解Klamn Filter、Joseph形式Kalman Filter、平方根Kalman Filterをサポートしています。
+ * 内部的に行列の計算を行っているため、行列ライブラリ( Matrix )を必要とします。
  * 
- * @see Matrix s񃉃Cu 
+ * @see Matrix 行列ライブラリ 
  */
 
 /**
- * @brief WIKalman Filter
+ * @brief フィルター内部の作業領域
  * 
- * WIKalman Filter`Ă܂B
- * gp邽߂ɂ̓VXě덷UsPA͂̌덷UsQɎw肷Kv܂B
- * init()ĂяoďĂB
- * ԍXV(Time Update)ł̓VXeɊ֘As@f$ A @f$, @f$ B @f$ 
- * ܂͂Eulerϕ@f$ \Phi @f$܂@f$ \Gamma @f$KvłB
- * @f$ A @f$, @f$ B @f$̒`͏ԗ@f$ x @f$Aтɓ@f$ u @f$ɑ΂
+ * フィルター内部の一時的な計算に用いるメモリ領域です。
+ * 要求された大きさが確保済みの容量を超えた場合にのみ再確保するため、
+ * 定常状態ではヒープの確保、解放が発生しません。
+ * 
+ * @param FloatT 演算精度
+ */
+template <class FloatT>
+class KalmanFilterWorkspace {
+  protected:
+    FloatT *m_buffer;
+    unsigned int m_capacity;
+  public:
+    KalmanFilterWorkspace() : m_buffer(NULL), m_capacity(0) {}
+    
+    /**
+     * コピーコンストラクタ
+     * 作業領域の中身は共有せず、同じ容量を新たに確保します。
+     * 
+     * @param orig コピー元
+     */
+    KalmanFilterWorkspace(const KalmanFilterWorkspace &orig)
+        : m_buffer(NULL), m_capacity(0) {
+      reserve(orig.m_capacity);
+    }
+    
+    KalmanFilterWorkspace &operator=(const KalmanFilterWorkspace &orig){
+      reserve(orig.m_capacity);
+      return *this;
+    }
+    
+    ~KalmanFilterWorkspace(){delete [] m_buffer;}
+    
+    /**
+     * 指定した要素数以上の作業領域を返します。
+     * 
+     * @param size 要素数
+     * @return (FloatT *) 作業領域の先頭
+     */
+    FloatT *reserve(const unsigned int &size){
+      if(size > m_capacity){
+        delete [] m_buffer;
+        m_buffer = new FloatT[size];
+        m_capacity = size;
+      }
+      return m_buffer;
+    }
+};
+
+/**
+ * @brief in-placeなフィルター演算のための補助関数群
+ * 
+ * 行列の成分を内部の1次元配列(行優先)として直接操作するための関数群です。
+ * 
+ * @param FloatT 演算精度
+ */
+template <class FloatT>
+struct KalmanFilterKernel {
+  /**
+   * 密行列の内部配列を返します。
+   * 
+   * @param m Array2D_Denseをストレージに持つ行列
+   * @return (FloatT *) 内部配列
+   */
+  static FloatT *buffer(const Matrix<FloatT> &m){
+    return static_cast<const Array2D_Dense<FloatT> *>(m.storage())->buffer();
+  }
+  
+  /**
+   * 成分をin-placeに書き換えるために、密行列の内部配列を返します。
+   * 内部配列が他の行列(例えばgetP()の結果のシャローコピー)と共有されている場合は、
+   * 先に複製して共有を解除します(コピーオンライト)。
+   * これにより、呼び出し側が保持している行列が以後の更新で書き換わることはなく、
+   * 共有されていない場合はヒープの確保も発生しません。
+   * 
+   * @param m Array2D_Denseをストレージに持つ行列
+   * @return (FloatT *) 内部配列
+   */
+  static FloatT *writable_buffer(Matrix<FloatT> &m){
+    if(static_cast<const Array2D_Dense<FloatT> *>(m.storage())->shared()){
+      m = m.copy();
+    }
+    return buffer(m);
+  }
+  
+  /**
+   * 行列の成分を配列に書き出します。
+   * 
+   * @param src 行列
+   * @param dist 書き出し先(行優先)
+   */
+  static void serialize(const Matrix<FloatT> &src, FloatT *dist){
+    Matrix<FloatT> &_src(const_cast<Matrix<FloatT> &>(src));
+    for(unsigned int i(0); i < src.rows(); i++){
+      for(unsigned int j(0); j < src.columns(); j++){
+        *(dist++) = _src(i, j);
+      }
+    }
+  }
+  
+  /**
+   * 行列の成分を、他と共有しない密行列へコピーします。
+   * 大きさが同じ場合は再確保を行いません。
+   * 
+   * @param dist コピー先
+   * @param src コピー元
+   */
+  static void assign(Matrix<FloatT> &dist, const Matrix<FloatT> &src){
+    if((!dist.storage())
+        || (dist.rows() != src.rows()) || (dist.columns() != src.columns())
+        || static_cast<const Array2D_Dense<FloatT> *>(dist.storage())->shared()){
+      dist = Matrix<FloatT>(src.rows(), src.columns());
+    }
+    serialize(src, buffer(dist));
+  }
+  
+  /**
+   * コレスキー分解@f$ A = L L^{T} @f$を行います。
+   * 半正定値行列にも対応するため、ピボットが正でない列は0とします。
+   * 
+   * @param A 対称行列(n x n、下三角のみ参照)
+   * @param L 下三角行列の書き出し先(n x n)
+   * @param n 大きさ
+   * @return (bool) 全てのピボットが正の場合true
+   */
+  static bool cholesky(const FloatT *A, FloatT *L, const unsigned int &n){
+    bool res(true);
+    for(unsigned int i(0); i < n * n; i++){L[i] = FloatT(0);}
+    for(unsigned int j(0); j < n; j++){
+      FloatT sum(A[j * n + j]);
+      for(unsigned int k(0); k < j; k++){sum -= L[j * n + k] * L[j * n + k];}
+      if(!(sum > FloatT(0))){
+        res = false;
+        continue;
+      }
+      FloatT L_jj(L[j * n + j] = std::sqrt(sum));
+      for(unsigned int i(j + 1); i < n; i++){
+        FloatT sum2(A[i * n + j]);
+        for(unsigned int k(0); k < j; k++){sum2 -= L[i * n + k] * L[j * n + k];}
+        L[i * n + j] = sum2 / L_jj;
+      }
+    }
+    return res;
+  }
+  
+  /**
+   * 対称行列の上下の成分を平均し、丸め誤差による非対称性を取り除きます。
+   * 
+   * @param P 行列(n x n)
+   * @param n 大きさ
+   */
+  static void symmetrize(FloatT *P, const unsigned int &n){
+    for(unsigned int i(0); i < n; i++){
+      for(unsigned int j(i + 1); j < n; j++){
+        P[i * n + j] = P[j * n + i] = (P[i * n + j] + P[j * n + i]) / 2;
+      }
+    }
+  }
+  
+  /**
+   * 行列が対角行列であるかを調べます。
+   * 
+   * @param m 正方行列
+   * @return (bool) 対角行列の場合true
+   */
+  static bool is_diagonal(const Matrix<FloatT> &m){
+    Matrix<FloatT> &_m(const_cast<Matrix<FloatT> &>(m));
+    for(unsigned int i(0); i < m.rows(); i++){
+      for(unsigned int j(0); j < m.columns(); j++){
+        if((i != j) && (_m(i, j) != FloatT(0))){return false;}
+      }
+    }
+    return true;
+  }
+  
+  /**
+   * 観測を1つずつ独立なスカラー観測として順次処理し、@f$ P @f$をin-placeに更新します。
+   * 各観測についてrank-1の更新を行うため、逆行列の計算は不要です。
+   * 書き出される@f$ K @f$は、全観測を一括して処理した場合と等価なカルマンゲインです。
+   * 
+   * @param P 誤差共分散行列(n x n、対称)
+   * @param n 状態量の大きさ
+   * @param H 観測行列(p x n)
+   * @param r 観測値の誤差分散、すなわち@f$ R @f$の対角成分(p)
+   * @param p 観測量の大きさ
+   * @param K カルマンゲインの書き出し先(n x p)
+   * @param work 作業領域(n * 3 + p)
+   * @param joseph Joseph形式で@f$ P @f$を更新する場合true
+   */
+  static void correct_sequential(
+      FloatT *P, const unsigned int &n, 
+      const FloatT *H, const FloatT *r, const unsigned int &p,
+      FloatT *K, FloatT *work, const bool &joseph = false){
+    FloatT *PHt(work), *k(PHt + n), *Th(k + n), *hK(Th + n);
+    for(unsigned int c(0); c < p; c++){
+      const FloatT *h(H + c * n);
+      
+      // PHt = P * h^{T}, s = h * P * h^{T} + r
+      FloatT s(r[c]);
+      for(unsigned int i(0); i < n; i++){
+        FloatT sum(0);
+        for(unsigned int j(0); j < n; j++){sum += P[i * n + j] * h[j];}
+        PHt[i] = sum;
+        s += h[i] * sum;
+      }
+      for(unsigned int i(0); i < n; i++){k[i] = PHt[i] / s;}
+      
+      // 一括処理と等価なゲインの合成, K = K - k * (h * K) + k * e_c^{T}
+      for(unsigned int j(0); j < c; j++){
+        FloatT sum(0);
+        for(unsigned int i(0); i < n; i++){sum += h[i] * K[i * p + j];}
+        hK[j] = sum;
+      }
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j < c; j++){K[i * p + j] -= k[i] * hK[j];}
+        K[i * p + c] = k[i];
+      }
+      
+      if(joseph){
+        // T = (I - k * h) * P, P = T * (I - k * h)^{T} + k * r * k^{T}
+        for(unsigned int i(0); i < n; i++){
+          for(unsigned int j(0); j < n; j++){P[i * n + j] -= k[i] * PHt[j];}
+        }
+        for(unsigned int i(0); i < n; i++){
+          FloatT sum(0);
+          for(unsigned int j(0); j < n; j++){sum += P[i * n + j] * h[j];}
+          Th[i] = sum;
+        }
+        for(unsigned int i(0); i < n; i++){
+          for(unsigned int j(0); j < n; j++){
+            P[i * n + j] += (k[i] * r[c] - Th[i]) * k[j];
+          }
+        }
+        symmetrize(P, n);
+      }else{
+        // P = P - PHt * PHt^{T} / s, 対称性を利用して下三角のみ計算
+        for(unsigned int i(0); i < n; i++){
+          for(unsigned int j(0); j <= i; j++){
+            P[i * n + j] = P[j * n + i] = P[i * n + j] - k[i] * PHt[j];
+          }
+        }
+      }
+    }
+  }
+};
+
+/**
+ * @brief 標準的なKalman Filter
+ * 
+ * 標準的なKalman Filterを定義しています。
+ * 使用するためにはシステムの誤差共分散行列P、入力の誤差共分散行列Qを初期化時に指定する必要があります。
+ * 初期化後はinit()を呼び出して初期化を完了させてください。
+ * 時間更新(Time Update)ではシステム方程式に関連する行列@f$ A @f$, @f$ B @f$ 
+ * またはそれをEuler積分した@f$ \Phi @f$または@f$ \Gamma @f$が必要です。
+ * @f$ A @f$, @f$ B @f$の定義は状態量@f$ x @f$、並びに入力@f$ u @f$に対して
  * @f[
  *    \frac{d}{dt} x = A x + B u
  * @f]
- * Œ`
+ * で定義され
  * @f[
  *    \Phi = \int_{t} A, \Gamma = \int_{t} B
  * @f]
- * łB
- * ϑXV(Measurement Update)ł͊ϑɊ֘As@f$ H @f$A
- * ϑ덷Us@f$ R @f$AтɊϑ@f$ z @f$KvƂ܂B
- * ̒`
+ * です。
+ * 観測更新(Measurement Update)では観測方程式に関連する行列@f$ H @f$、
+ * 観測誤差共分散行列@f$ R @f$、並びに観測量@f$ z @f$が必要とされます。
+ * これらの定義は
  * @f[
  *    z = H x + v
  * @f] 
- * łB
+ * です。
  * 
- * ȂAev[gFloatT͉Zx̌^w肵܂B
- * قǂ̂ƂȂAdouble𐄏܂B
+ * なお、テンプレートFloatTは演算精度の型を指定します。
+ * よほどのことがない限り、doubleを推奨します。
  * 
- * @param FloatT Zx
+ * @param FloatT 演算精度
  */
 template <class FloatT>
 class KalmanFilter{
   protected:
-    Matrix<FloatT> m_P; ///< J}tB^Ps(VXe덷Us)
-    Matrix<FloatT> m_Q; ///< J}tB^Qs(͌덷Us)
+    Matrix<FloatT> m_P; ///< カルマンフィルタのP行列(システム誤差共分散行列)
+    Matrix<FloatT> m_Q; ///< カルマンフィルタのQ行列(入力誤差共分散行列)
+    
+    typedef KalmanFilterKernel<FloatT> kernel_t;
+    KalmanFilterWorkspace<FloatT> m_work; ///< correct_sequential()の作業領域
     
   public:
     /**
-     * KalmanFilter̃RXgN^B
-     * 덷Us@f$ P @f$, @f$ Q @f$w肷Kv܂B
+     * KalmanFilterのコンストラクタ。
+     * 誤差共分散行列@f$ P @f$, @f$ Q @f$を指定する必要があります。
      * 
-     * @param P @f$ P @f$s
-     * @param Q @f$ Q @f$s
+     * @param P @f$ P @f$行列
+     * @param Q @f$ Q @f$行列
      */
     KalmanFilter(const Matrix<FloatT> &P,
-                 const Matrix<FloatT> &Q) : m_P(P), m_Q(Q) {
+                 const Matrix<FloatT> &Q) : m_P(P), m_Q(Q), m_work() {
     }
     
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
      * 
-     * @param orig Rs[
-     * @param deepcopy fB[vRs[쐬邩ǂ
+     * @param orig コピー元
+     * @param deepcopy ディープコピーを作成するかどうか
      */
     KalmanFilter(const KalmanFilter &orig, const bool deepcopy = false) :
       m_P(deepcopy ? orig.m_P.copy() : orig.m_P), 
-      m_Q(deepcopy ? orig.m_Q.copy() : orig.m_Q){
+      m_Q(deepcopy ? orig.m_Q.copy() : orig.m_Q), m_work(orig.m_work){
       //std::cerr << "KF" << std::endl;
       
     }
     
     /**
-     * KalmanFilter̃fXgN^B
+     * KalmanFilterのデストラクタ。
      * 
      */
     virtual ~KalmanFilter(){}
     
     /**
-     * tB^[ԍXV܂B
-     * Uno[W
+     * 推定フィルターを時間更新します。
+     * 離散系バージョン
      * @f[
      *   x_{k+1} = \Phi_{k+1,K} * x_{k} + \Gamma_{k} * u_{k}
      * @f]
      * 
-     * @param Phi @f$ \Phi @f$s
-     * @param Gamma @f$ \Gamma @f$s
+     * @param Phi @f$ \Phi @f$行列
+     * @param Gamma @f$ \Gamma @f$行列
      */
     virtual void predict(const Matrix<FloatT> &Phi, const Matrix<FloatT> &Gamma){
     
@@ -133,46 +384,46 @@ class KalmanFilter{
     }
     
     /**
-     * tB^[Euler@ɂĎԍXV܂B
-     * Ano[WB
+     * 推定フィルターをEuler法によって時間更新します。
+     * 連続系バージョン。
      * @f{gather*}
      *   \frac{d}{dt} x = A x + B u \\
      *   \Phi_{k+1,k} = I + A \Delta t \\
      *   \Gamma_{k} = B \Delta t
      * @f}
      * 
-     * @param A @f$ A @f$s
-     * @param B @f$ B @f$s
-     * @param delta ԊԊu 
+     * @param A @f$ A @f$行列
+     * @param B @f$ B @f$行列
+     * @param delta 時間間隔 
      */
     virtual void predict(const Matrix<FloatT> &A, const Matrix<FloatT> &B, const FloatT &delta){
       
-      //
+      //φ
       Matrix<FloatT> Phi = A * delta;
       for(unsigned i = 0; i < Phi.rows(); i++) Phi(i, i) += 1;
     
-      //
+      //Γ
       Matrix<FloatT> Gamma = B * delta;
       
       predict(Phi, Gamma);
     }
     
     /**
-     * tB^[ϑXV(C)A̍ۂ̃J}QC߂܂B
+     * フィルターを観測更新(修正)し、その際のカルマンゲインを求めます。
      * 
-     * @param H @f$ H @f$s(ϑs)
-     * @param R ϑľ덷Us@f$ R @f$
-     * @return (Matrix<FloatT>) J}QC@f$ K @f$
+     * @param H @f$ H @f$行列(観測行列)
+     * @param R 観測値の誤差共分散行列@f$ R @f$
+     * @return (Matrix<FloatT>) カルマンゲイン@f$ K @f$
      */
     virtual Matrix<FloatT> correct(const Matrix<FloatT> &H, const Matrix<FloatT> &R){
 
-      // J}QČvZ
+      // カルマンゲインの計算
       Matrix<FloatT> K(m_P * H.transpose() * ((H * m_P * H.transpose()) += R).inverse());
 #if DEBUG > 1
       std::cerr << "K:" << K << std::endl;
 #endif
 
-      // P XV
+      // P 更新
       m_P = (Matrix<FloatT>::getI(K.rows()) - K * H) * m_P;
 #if DEBUG
       std::cerr << "P:" << m_P << std::endl;
@@ -182,30 +433,63 @@ class KalmanFilter{
     }
     
     /**
-     * 덷Us@f$ P @f$Ԃ܂B
+     * フィルターを観測更新(修正)し、その際のカルマンゲインを求めます。
+     * @f$ R @f$が対角行列の場合、観測を1つずつ独立なスカラー観測として順次処理するため、
+     * 逆行列の計算が不要です。対角行列でない場合はcorrect()と同じです。
+     * 返却されるカルマンゲインは、全観測を一括して処理した場合と等価なものです。
      * 
-     * @return (const Matrix<FloatT> &) ݂@f$ P @f$s
+     * @param H @f$ H @f$行列(観測行列)
+     * @param R 観測値の誤差共分散行列@f$ R @f$
+     * @return (Matrix<FloatT>) カルマンゲイン@f$ K @f$
+     * @see KalmanFilterKernel::correct_sequential()
+     */
+    virtual Matrix<FloatT> correct_sequential(const Matrix<FloatT> &H, const Matrix<FloatT> &R){
+      if(!kernel_t::is_diagonal(R)){return correct(H, R);}
+      
+      const unsigned int n(m_P.rows()), p(H.rows());
+      FloatT *H_(m_work.reserve(p * n + p * 2 + n * 3)), *r(H_ + p * n);
+      kernel_t::serialize(H, H_);
+      for(unsigned int i(0); i < p; i++){r[i] = const_cast<Matrix<FloatT> &>(R)(i, i);}
+      
+      // Pは他と共有している場合のみ複製してから、in-placeに更新する
+      Matrix<FloatT> K(n, p);
+      kernel_t::correct_sequential(
+          kernel_t::writable_buffer(m_P), n, H_, r, p, kernel_t::buffer(K), r + p);
+#if DEBUG
+      std::cerr << "P:" << m_P << std::endl;
+#endif
+      
+      return K;
+    }
+    
+    /**
+     * 誤差共分散行列@f$ P @f$を返します。
+     * 返却値から作成したコピーは(シャローコピーであっても)、
+     * 以後の時間更新、観測更新によって書き換わることはありません。
+     * 派生クラスでin-placeに更新する場合は、KalmanFilterKernel::writable_buffer()を用います。
+     * 
+     * @return (const Matrix<FloatT> &) 現在の@f$ P @f$行列
      */
     virtual const Matrix<FloatT> &getP() const {return m_P;}
 
     /**
-     * 덷Us@f$ P @f$ݒ肵܂B
+     * 誤差共分散行列@f$ P @f$を設定します。
      *
-     * @param P V@f$ P @f$s
+     * @param P 新しい@f$ P @f$行列
      */
     virtual void setP(const Matrix<FloatT> &P){m_P = P;}
     
     /**
-     * 덷Us@f$ Q @f$Ԃ܂B
+     * 誤差共分散行列@f$ Q @f$を返します。
      * 
-     * @return (Matrix<FloatT>) ݂@f$ Q @f$s
+     * @return (Matrix<FloatT>) 現在の@f$ Q @f$行列
      */
     virtual const Matrix<FloatT> &getQ() const {return m_Q;}
 
     /**
-     * 덷Us@f$ Q @f$ݒ肵܂B
+     * 誤差共分散行列@f$ Q @f$を設定します。
      *
-     * @param Q V@f$ Q @f$s
+     * @param Q 新しい@f$ Q @f$行列
      */
     virtual void setQ(const Matrix<FloatT> &Q){m_Q = Q;}
 };
@@ -213,10 +497,10 @@ class KalmanFilter{
 /**
  * @brief Information Filter
  * 
- * Information Filter(Kalman FilterŃVXeUs񂪋tsɂȂ)`Ă܂B
- * gpł̎g͕WIKalman FilterƂȂς܂B
+ * Information Filter(Kalman Filterでシステム共分散行列が逆行列になる)を定義しています。
+ * 使用する上でその使い方は標準的なKalman Filterとなんら変わりません。
  * 
- * @param FloatT Zx
+ * @param FloatT 演算精度
  * @see KalmanFilter
  */
 template <class FloatT>
@@ -226,14 +510,14 @@ class InformationFilter : public KalmanFilter<FloatT>{
     bool need_update_P;
     
     /**
-     * 덷Us@f$ P @f$XV܂B
-     * @f$ P @f$̋ts@f$ I @f$@f$ P @f$𕜌Ă܂B
-     * sƂɂătB^[̐ۂ܂B
+     * 誤差共分散行列@f$ P @f$を更新します。
+     * @f$ P @f$の逆行列@f$ I @f$から@f$ P @f$を復元しています。
+     * これを行うことによってフィルター内部の整合性が保たれます。
      * 
      */
     void updateP(){
       if(!need_update_P){return;}
-      //PXV
+      //P更新
       KalmanFilter<FloatT>::m_P = m_I.inverse();
       need_update_P = false;
 #if DEBUG
@@ -243,9 +527,9 @@ class InformationFilter : public KalmanFilter<FloatT>{
     
   public:
     /**
-     * 덷Us@f$ P @f$Ԃ܂B
+     * 誤差共分散行列@f$ P @f$を返します。
      * 
-     * @return (Matrix<FloatT>) ݂@f$ P @f$s
+     * @return (Matrix<FloatT>) 現在の@f$ P @f$行列
      */
     const Matrix<FloatT> &getP() const {
       const_cast<InformationFilter *>(this)->updateP();
@@ -253,9 +537,9 @@ class InformationFilter : public KalmanFilter<FloatT>{
     }
 
     /**
-     * 덷Us@f$ P @f$ݒ肵܂B
+     * 誤差共分散行列@f$ P @f$を設定します。
      *
-     * @param P V@f$ P @f$s
+     * @param P 新しい@f$ P @f$行列
      */
     void setP(const Matrix<FloatT> &P){
       m_I = P.inverse();
@@ -263,11 +547,11 @@ class InformationFilter : public KalmanFilter<FloatT>{
     }
   
     /**
-     * UDKalmanFilter̃RXgN^B
-     * 덷Us@f$ P @f$, @f$ Q @f$w肷Kv܂B
+     * UD分解KalmanFilterのコンストラクタ。
+     * 誤差共分散行列@f$ P @f$, @f$ Q @f$を指定する必要があります。
      * 
-     * @param P @f$ P @f$s
-     * @param Q @f$ Q @f$s
+     * @param P @f$ P @f$行列
+     * @param Q @f$ Q @f$行列
      */
     InformationFilter(
         const Matrix<FloatT> &P, const Matrix<FloatT> &Q)
@@ -275,10 +559,10 @@ class InformationFilter : public KalmanFilter<FloatT>{
     }
     
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
      * 
-     * @param orig Rs[
-     * @param deepcopy fB[vRs[쐬邩ǂ
+     * @param orig コピー元
+     * @param deepcopy ディープコピーを作成するかどうか
      */
     InformationFilter(
         const InformationFilter &orig, const bool deepcopy = false)
@@ -289,7 +573,7 @@ class InformationFilter : public KalmanFilter<FloatT>{
     }
     
     /**
-     * fXgN^
+     * デストラクタ
      * 
      */
     ~InformationFilter(){}
@@ -297,14 +581,14 @@ class InformationFilter : public KalmanFilter<FloatT>{
     using KalmanFilter<FloatT>::predict;
 
     /**
-     * tB^[ԍXV܂B
-     * Uno[W
+     * 推定フィルターを時間更新します。
+     * 離散系バージョン
      * @f[
      *   x_{k+1} = \Phi_{k+1,K} * x_{k} + \Gamma_{k} * u_{k}
      * @f]
      * 
-     * @param Phi @f$ \Phi @f$s
-     * @param Gamma @f$ \Gamma @f$s
+     * @param Phi @f$ \Phi @f$行列
+     * @param Gamma @f$ \Gamma @f$行列
      */
     void predict(const Matrix<FloatT> &Phi, const Matrix<FloatT> &Gamma){
      
@@ -320,7 +604,7 @@ class InformationFilter : public KalmanFilter<FloatT>{
             * (m_I + Phi.transpose() * inv_additive_term * Phi).inverse()
             * Phi.transpose() * inv_additive_term;
 
-      //sP̍XV
+      //行列Pの更新
       need_update_P = true;
 
 #if DEBUG
@@ -329,12 +613,12 @@ class InformationFilter : public KalmanFilter<FloatT>{
     }
     
     /**
-     * tB^[ϑXV(C)A̍ۂ̃J}QC߂܂B
-     * IUD𗘗pĂ܂B
+     * フィルターを観測更新(修正)し、その際のカルマンゲインを求めます。
+     * 内部的にUD分解を利用しています。
      * 
-     * @param H @f$ H @f$s(ϑs)
-     * @param R ϑľ덷Us@f$ R @f$
-     * @return (Matrix<FloatT>) J}QC@f$ K @f$
+     * @param H @f$ H @f$行列(観測行列)
+     * @param R 観測値の誤差共分散行列@f$ R @f$
+     * @return (Matrix<FloatT>) カルマンゲイン@f$ K @f$
      */
     Matrix<FloatT> correct(const Matrix<FloatT> &H, const Matrix<FloatT> &R){
 #if DEBUG
@@ -347,10 +631,10 @@ class InformationFilter : public KalmanFilter<FloatT>{
       
       m_I += H_trans * R_inv * H;
       
-      // J}QC
+      // カルマンゲイン
       Matrix<FloatT> K(m_I.inverse() * H_trans * R_inv);
       
-      //sP̍XV
+      //行列Pの更新
       need_update_P = true;
 
 #if DEBUG
@@ -362,68 +646,151 @@ class InformationFilter : public KalmanFilter<FloatT>{
     }
     
     /**
-     * 덷Us@f$ P @f$̋ts@f$ I @f$Ԃ܂B
+     * フィルターを観測更新(修正)し、その際のカルマンゲインを求めます。
+     * Information Filterでは観測更新に@f$ HPH^{T} + R @f$の逆行列を必要としないため、
+     * correct()と同じです。
      * 
-     * @return (const Matrix<FloatT> &) s@f$ I @f$
+     * @param H @f$ H @f$行列(観測行列)
+     * @param R 観測値の誤差共分散行列@f$ R @f$
+     * @return (Matrix<FloatT>) カルマンゲイン@f$ K @f$
+     */
+    Matrix<FloatT> correct_sequential(const Matrix<FloatT> &H, const Matrix<FloatT> &R){
+      return correct(H, R);
+    }
+    
+    /**
+     * 誤差共分散行列@f$ P @f$の逆行列@f$ I @f$を返します。
+     * 
+     * @return (const Matrix<FloatT> &) 行列@f$ I @f$
      */
     const Matrix<FloatT> &getI(){return m_I;}
 };
 
 /**
- * @brief UDKalman Filter
+ * @brief UD分解Kalman Filter
+ * 
+ * UD分解Kalman Filterを定義しています。
+ * 演算精度をあげるために内部的にUD分解を利用していることが標準的なKalman Filterとの違いで、
+ * 使用する上でその使い方は標準的なKalman Filterとなんら変わりません。
  * 
- * UDKalman Filter`Ă܂B
- * Zx邽߂ɓIUD𗘗pĂ邱ƂWIKalman FilterƂ̈ႢŁA
- * gpł̎g͕WIKalman FilterƂȂς܂B
+ * 時間更新はThorntonの方法(MWGS)、観測更新はBiermanの方法によっており、
+ * いずれも事前に確保した作業領域上でin-placeに@f$ U @f$, @f$ D @f$を更新するため、
+ * カルマンゲインの返却を除き、ステップ毎のヒープ確保は発生しません。
+ * @f$ P @f$はgetP()が呼ばれた際に、更新があった場合のみ復元されます。
+ * なお@f$ Q @f$, @f$ R @f$はその対角成分のみが使用されます。
  * 
- * @param FloatT Zx
+ * @param FloatT 演算精度
  * @see KalmanFilter
  */
 template <class FloatT>
 class KalmanFilterUD : public KalmanFilter<FloatT>{
   protected:
+    typedef KalmanFilter<FloatT> super_t;
+    typedef KalmanFilterKernel<FloatT> kernel_t;
     Matrix<FloatT> m_U, m_D;
     bool need_update_P;
+    KalmanFilterWorkspace<FloatT> m_work;
     
     /**
-     * 덷Us@f$ P @f$XV܂B
-     * @f$ P @f$UDs񂩂@f$ P @f$𕜌Ă܂B
-     * sƂɂătB^[̐ۂ܂B
+     * 誤差共分散行列@f$ P @f$を更新します。
+     * @f$ P @f$をUD分解した行列から@f$ P @f$を復元しています。
+     * これを行うことによってフィルター内部の整合性が保たれます。
      * 
      */
     void updateP(){
       if(!need_update_P){return;}
-      //PXV
-      KalmanFilter<FloatT>::m_P = m_U * m_D * m_U.transpose();
+      //P更新, P = U * D * U^{T}、Uが上三角であることを利用
+      const unsigned int n(m_U.rows());
+      FloatT *P(kernel_t::writable_buffer(super_t::m_P)), 
+          *U(kernel_t::buffer(m_U)), *D(kernel_t::buffer(m_D));
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j <= i; j++){
+          FloatT sum(0);
+          for(unsigned int k(i); k < n; k++){
+            sum += U[i * n + k] * D[k * n + k] * U[j * n + k];
+          }
+          P[i * n + j] = P[j * n + i] = sum;
+        }
+      }
       need_update_P = false;
 #if DEBUG
-      std::cerr << "P:" << KalmanFilter<FloatT>::m_P << std::endl;
+      std::cerr << "P:" << super_t::m_P << std::endl;
 #endif
     }
     
+    /**
+     * 時間更新(Thorntonの方法)の本体
+     * 
+     * @param FU @f$ \Phi U @f$(n x n)
+     * @param Gamma @f$ \Gamma @f$(n x m)
+     * @param work 作業領域(n x (n + m) + (n + m) * 2)
+     */
+    void predict_kernel(const FloatT *FU, const FloatT *Gamma, FloatT *work){
+      const unsigned int n(m_U.rows()), m(super_t::m_Q.rows()), c(n + m);
+      FloatT *U(kernel_t::buffer(m_U)), *D(kernel_t::buffer(m_D));
+      FloatT *W(work), *Dw(work + n * c), *Z(Dw + c);
+      
+      // 行列W = [FU, Gamma], 対角行列Dw = diag(D, Q)
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j < n; j++){W[i * c + j] = FU[i * n + j];}
+        for(unsigned int j(0); j < m; j++){W[i * c + n + j] = Gamma[i * m + j];}
+        Dw[i] = D[i * n + i];
+      }
+      for(unsigned int j(0); j < m; j++){
+        Dw[n + j] = const_cast<Matrix<FloatT> &>(super_t::m_Q)(j, j);
+      }
+      
+      // 重み付きGram-Schmidt直交化
+      for(int j(n - 1); j > 0; j--){
+        FloatT *V(W + j * c);
+        FloatT D_jj(0);
+        for(unsigned int k(0); k < c; k++){
+          Z[k] = V[k] * Dw[k];
+          D_jj += Z[k] * V[k];
+        }
+        D[j * n + j] = D_jj;
+        for(int i(0); i < j; i++){
+          FloatT *W_i(W + i * c);
+          FloatT sum(0);
+          for(unsigned int k(0); k < c; k++){sum += W_i[k] * Z[k];}
+          FloatT U_ij(U[i * n + j] = sum / D_jj);
+          for(unsigned int k(0); k < c; k++){W_i[k] -= U_ij * V[k];}
+        }
+      }
+      {
+        FloatT D_00(0);
+        for(unsigned int k(0); k < c; k++){D_00 += W[k] * W[k] * Dw[k];}
+        D[0] = D_00;
+      }
+      
+      //行列Pの更新
+      need_update_P = true;
+    }
+    
   public:
     /**
-     * 덷Us@f$ P @f$Ԃ܂B
+     * 誤差共分散行列@f$ P @f$を返します。
      * 
-     * @return (Matrix<FloatT>) ݂@f$ P @f$s
+     * @return (Matrix<FloatT>) 現在の@f$ P @f$行列
      */
-    const Matrix<FloatT> &getP(){
+    const Matrix<FloatT> &getP() const {
       const_cast<KalmanFilterUD *>(this)->updateP();
-        return KalmanFilter<FloatT>::m_P;
+      return super_t::m_P;
     }
 
     /**
-     * 덷Us@f$ P @f$ݒ肵܂B
-     * Iɂ͌덷Us@f$ P @f$UDsǍvZɔ܂B
+     * 誤差共分散行列@f$ P @f$を設定します。
+     * 内部的には誤差共分散行列@f$ P @f$のUD分解を行い、後の計算に備えます。
      *
-     * @param P V@f$ P @f$s
+     * @param P 新しい@f$ P @f$行列
      */
     void setP(const Matrix<FloatT> &P){
+      kernel_t::assign(super_t::m_P, P);
       m_U = Matrix<FloatT>(P.rows(), P.columns());
       m_D = Matrix<FloatT>(P.rows(), P.columns());
 
-      // UD
-      Matrix<FloatT> UD(P.decomposeUD(false));
+      // UD分解
+      Matrix<FloatT> UD(super_t::m_P.decomposeUD(false));
 
       for(int i = 0; i < m_U.rows(); i++){
         m_D(i, i) = UD(i, i + m_U.columns());
@@ -431,6 +798,7 @@ class KalmanFilterUD : public KalmanFilter<FloatT>{
           m_U(i, j) = UD(i, j);
         }
       }
+      need_update_P = false;
 #if DEBUG
       std::cerr << "U:" << m_U << std::endl;
       std::cerr << "D:" << m_D << std::endl;
@@ -438,103 +806,74 @@ class KalmanFilterUD : public KalmanFilter<FloatT>{
     }
   
     /**
-     * UDKalmanFilter̃RXgN^B
-     * 덷Us@f$ P @f$, @f$ Q @f$w肷Kv܂B
+     * UD分解KalmanFilterのコンストラクタ。
+     * 誤差共分散行列@f$ P @f$, @f$ Q @f$を指定する必要があります。
      * 
-     * @param P @f$ P @f$s
-     * @param Q @f$ Q @f$s
+     * @param P @f$ P @f$行列
+     * @param Q @f$ Q @f$行列
      */
     KalmanFilterUD(const Matrix<FloatT> &P,
                    const Matrix<FloatT> &Q)
-        : KalmanFilter<FloatT>(P, Q), m_U(), m_D(), need_update_P(false){
+        : super_t(Matrix<FloatT>(), Q), m_U(), m_D(), need_update_P(false), m_work(){
       setP(P);
     }
     
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
+     * @f$ U @f$, @f$ D @f$はin-placeに更新されるため、常にディープコピーを作成します。
      * 
-     * @param orig Rs[
-     * @param deepcopy fB[vRs[쐬邩ǂ
+     * @param orig コピー元
+     * @param deepcopy ディープコピーを作成するかどうか(@f$ Q @f$にのみ適用)
      */
     KalmanFilterUD(const KalmanFilterUD &orig, const bool deepcopy = false) :
-      KalmanFilter<FloatT>(orig, deepcopy),
-      m_U(deepcopy ? orig.m_U.copy() : orig.m_U), 
-      m_D(deepcopy ? orig.m_D.copy() : orig.m_D),
-      need_update_P(orig.need_update_P){
+      super_t(orig, deepcopy),
+      m_U(orig.m_U.copy()), 
+      m_D(orig.m_D.copy()),
+      need_update_P(orig.need_update_P), m_work(orig.m_work){
+      super_t::m_P = orig.m_P.copy();
       //std::cerr << "KFUD" << std::endl;
     }
     
     /**
-     * KalmanFilter̃fXgN^B
+     * KalmanFilterのデストラクタ。
      * 
      */
     ~KalmanFilterUD(){}
-    
-    using KalmanFilter<FloatT>::predict;
 
     /**
-     * tB^[ԍXV܂B
-     * IUDpĂ܂B
-     * Uno[W
+     * 推定フィルターを時間更新します。
+     * 内部的にUD分解を活用しています。
+     * 離散系バージョン
      * @f[
      *   x_{k+1} = \Phi_{k+1,K} * x_{k} + \Gamma_{k} * u_{k}
      * @f]
      * 
-     * @param Phi @f$ \Phi @f$s
-     * @param Gamma @f$ \Gamma @f$s
+     * @param Phi @f$ \Phi @f$行列
+     * @param Gamma @f$ \Gamma @f$行列
      */
     void predict(const Matrix<FloatT> &Phi, const Matrix<FloatT> &Gamma){
      
 #if DEBUG     
-      KalmanFilter<FloatT>::predict(Phi, Gamma);
-      std::cerr << "predict_KF_P:" << KalmanFilter<FloatT>::m_P << std::endl;
+      super_t::predict(Phi, Gamma);
+      std::cerr << "predict_KF_P:" << super_t::m_P << std::endl;
 #endif
 
-      // sFU
-      Matrix<FloatT> FU(Phi * m_U);
+      const unsigned int n(m_U.rows()), m(super_t::m_Q.rows()), c(n + m);
+      FloatT *work(m_work.reserve(n * n * 2 + n * m + n * c + c * 2));
+      FloatT *Phi_(work), *FU(Phi_ + n * n), *Gamma_(FU + n * n);
+      FloatT *U(kernel_t::buffer(m_U));
+      kernel_t::serialize(Phi, Phi_);
+      kernel_t::serialize(Gamma, Gamma_);
       
-      // sW
-      Matrix<FloatT> W(Phi.rows(), KalmanFilter<FloatT>::m_P.columns() + Gamma.columns());
-      W.pivotMerge(0, 0, FU);
-      W.pivotMerge(0, Phi.rows(), Gamma);
-      
-      // sQ
-      Matrix<FloatT> Q(W.columns(), W.columns());
-      for(int i = 0; i < m_D.rows(); i++){
-        Q(i, i) = m_D(i, i);
-      }
-      for(int i = m_D.rows(); i < Q.rows(); i++){
-        Q(i, i) = KalmanFilter<FloatT>::m_Q(i - m_D.rows(), i - m_D.rows());
-      }
-
-#if DEBUG
-      std::cerr << "W:" << W << std::endl;
-      std::cerr << "Q:" << Q << std::endl;
-#endif
-      
-      for(int j = W.rows() - 1; j > 0; j--){
-        Matrix<FloatT> V(W.rowVector(j));
-        
-        Matrix<FloatT> Z(1, Q.columns()); // = V * QÂߓWJď
-        for(int i = 0; i < Z.columns(); i++){
-          Z(0, i) = V(0, i) * Q(i, i); 
-        }
-        
-        m_D(j, j) = (Z * V.transpose())(0, 0);
-        for(int i = 0; i < j; i++){
-          m_U(i, j) = (W.rowVector(i) * Z.transpose())(0, 0) / m_D(j, j);
-          W.rowVector(i) -= m_U(i, j) * V;
+      // 行列FU = Phi * U、Uが上三角であることを利用
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j < n; j++){
+          FloatT sum(0);
+          for(unsigned int k(0); k <= j; k++){sum += Phi_[i * n + k] * U[k * n + j];}
+          FU[i * n + j] = sum;
         }
       }
-      
-      // m_D(0, 0) = (W.rowVector(0) * Q * W.rowVector(0).transpose())(0, 0);
-      m_D(0, 0) = 0;
-      for(int j = 0; j < W.columns(); j++){
-        m_D(0, 0) += W(0, j) * W(0, j) * Q(j, j);
-      }
-
-      //sP̍XV
-      need_update_P = true;
+      predict_kernel(FU, Gamma_, Gamma_ + n * m);
 
 #if DEBUG
       std::cerr << "predict_UDKF_U:" << m_U << std::endl;
@@ -544,56 +883,101 @@ class KalmanFilterUD : public KalmanFilter<FloatT>{
     }
     
     /**
-     * tB^[ϑXV(C)A̍ۂ̃J}QC߂܂B
-     * IUD𗘗pĂ܂B
+     * 推定フィルターをEuler法によって時間更新します。
+     * 連続系バージョン。
      * 
-     * @param H @f$ H @f$s(ϑs)
-     * @param R ϑľ덷Us@f$ R @f$
-     * @return (Matrix<FloatT>) J}QC@f$ K @f$
+     * @param A @f$ A @f$行列
+     * @param B @f$ B @f$行列
+     * @param delta 時間間隔 
+     */
+    void predict(const Matrix<FloatT> &A, const Matrix<FloatT> &B, const FloatT &delta){
+      const unsigned int n(m_U.rows()), m(super_t::m_Q.rows()), c(n + m);
+      FloatT *work(m_work.reserve(n * n * 2 + n * m + n * c + c * 2));
+      FloatT *A_(work), *FU(A_ + n * n), *Gamma(FU + n * n);
+      FloatT *U(kernel_t::buffer(m_U));
+      kernel_t::serialize(A, A_);
+      kernel_t::serialize(B, Gamma);
+      for(unsigned int i(0); i < n * m; i++){Gamma[i] *= delta;}
+      
+      // 行列FU = (I + A * delta) * U = U + (A * U) * delta
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j < n; j++){
+          FloatT sum(0);
+          for(unsigned int k(0); k <= j; k++){sum += A_[i * n + k] * U[k * n + j];}
+          FU[i * n + j] = U[i * n + j] + sum * delta;
+        }
+      }
+      predict_kernel(FU, Gamma, Gamma + n * m);
+    }
+    
+    /**
+     * フィルターを観測更新(修正)し、その際のカルマンゲインを求めます。
+     * 内部的にUD分解を利用しています(Biermanの方法)。
+     * 観測は1つずつ順次処理されるため、@f$ R @f$は対角成分のみ使用されます。
+     * 返却されるカルマンゲインは、全観測を一括して処理した場合と等価なものです。
+     * 
+     * @param H @f$ H @f$行列(観測行列)
+     * @param R 観測値の誤差共分散行列@f$ R @f$
+     * @return (Matrix<FloatT>) カルマンゲイン@f$ K @f$
      */
     Matrix<FloatT> correct(const Matrix<FloatT> &H, const Matrix<FloatT> &R){
 #if DEBUG
-      std::cerr << "correct_KF_K:" << KalmanFilter<FloatT>::correct(H, R) << std::endl;
-      std::cerr << "correct_KF_P:" << KalmanFilter<FloatT>::m_P << std::endl;
+      std::cerr << "correct_KF_K:" << super_t::correct(H, R) << std::endl;
+      std::cerr << "correct_KF_P:" << super_t::m_P << std::endl;
 #endif
       
-      // J}QC
-      Matrix<FloatT> K(KalmanFilter<FloatT>::m_P.rows(), R.rows());
+      const unsigned int n(m_U.rows()), p(H.rows());
+      FloatT *work(m_work.reserve(p * n + n * 3 + p));
+      FloatT *H_(work), *f(H_ + p * n), *g(f + n), *k(g + n), *hK(k + n);
+      FloatT *U(kernel_t::buffer(m_U)), *D(kernel_t::buffer(m_D));
+      kernel_t::serialize(H, H_);
       
-      for(int k = 0; k < R.rows(); k++){
-        Matrix<FloatT> f(m_U.columns(), H.rows());
-        Matrix<FloatT> g(m_D.rows(), f.columns());
-        
-        // f̐
-        for(int i = 0; i < f.rows(); i++){
-          for(int j = 0; j <= i; j++){
-            f(i, 0) += const_cast<Matrix<FloatT> *>(&H)->operator()(k, j) * m_U(j, i);
-          }
-        }
+      // カルマンゲイン
+      Matrix<FloatT> K(n, p);
+      FloatT *K_(kernel_t::buffer(K));
+      
+      for(unsigned int r(0); r < p; r++){
+        const FloatT *h(H_ + r * n);
         
-        // g̐
-        for(int i = 0; i < g.rows(); i++){
-          g(i, 0) = m_D(i, i) * f(i, 0);
+        // f = U^{T} * h^{T}, g = D * f
+        for(unsigned int i(0); i < n; i++){
+          FloatT sum(0);
+          for(unsigned int j(0); j <= i; j++){sum += h[j] * U[j * n + i];}
+          f[i] = sum;
+          g[i] = D[i * n + i] * sum;
         }
         
-        FloatT r(const_cast<Matrix<FloatT> *>(&R)->operator()(k, k));
-        FloatT alpha = r + f(0, 0) * g(0, 0);
-        K(0, k) = g(0, 0);
-        m_D(0, 0) *= (r / alpha);
+        FloatT alpha(const_cast<Matrix<FloatT> &>(R)(r, r) + f[0] * g[0]);
+        D[0] *= (alpha - f[0] * g[0]) / alpha;
+        k[0] = g[0];
+        for(unsigned int i(1); i < n; i++){k[i] = FloatT(0);}
         
-        for(int j = 1; j < f.rows(); j++){
-          FloatT _alpha(alpha + f(j, 0) * g(j, 0));
-          m_D(j, j) *= (alpha / _alpha);
-          FloatT lambda(f(j, 0) / alpha);
-          Matrix<FloatT> _u(m_U.columnVector(j).copy());
-          m_U.columnVector(j) -= lambda * K.columnVector(k);
-          K.columnVector(k) += g(j, 0) * _u;
+        for(unsigned int j(1); j < n; j++){
+          FloatT _alpha(alpha + f[j] * g[j]);
+          D[j * n + j] *= (alpha / _alpha);
+          FloatT lambda(f[j] / alpha);
+          for(unsigned int i(0); i <= j; i++){
+            FloatT u_ij(U[i * n + j]);
+            U[i * n + j] -= lambda * k[i];
+            k[i] += g[j] * u_ij;
+          }
           alpha = _alpha;
         }
-        K.columnVector(k) /= alpha;
+        for(unsigned int i(0); i < n; i++){k[i] /= alpha;}
+        
+        // 一括処理と等価なゲインの合成, K = K - k * (h * K) + k * e_r^{T}
+        for(unsigned int j(0); j < r; j++){
+          FloatT sum(0);
+          for(unsigned int i(0); i < n; i++){sum += h[i] * K_[i * p + j];}
+          hK[j] = sum;
+        }
+        for(unsigned int i(0); i < n; i++){
+          for(unsigned int j(0); j < r; j++){K_[i * p + j] -= k[i] * hK[j];}
+          K_[i * p + r] = k[i];
+        }
       }
       
-      //sP̍XV
+      //行列Pの更新
       need_update_P = true;
 
 #if DEBUG
@@ -605,65 +989,689 @@ class KalmanFilterUD : public KalmanFilter<FloatT>{
     }
     
     /**
-     * 덷Us@f$ P @f$UD̍s@f$ U @f$Ԃ܂B
+     * フィルターを観測更新(修正)し、その際のカルマンゲインを求めます。
+     * Biermanの方法は元々観測を1つずつ順次処理するため、correct()と同じです。
+     * 
+     * @param H @f$ H @f$行列(観測行列)
+     * @param R 観測値の誤差共分散行列@f$ R @f$
+     * @return (Matrix<FloatT>) カルマンゲイン@f$ K @f$
+     */
+    Matrix<FloatT> correct_sequential(const Matrix<FloatT> &H, const Matrix<FloatT> &R){
+      return correct(H, R);
+    }
+    
+    /**
+     * 誤差共分散行列@f$ P @f$をUD分解したうちの行列@f$ U @f$を返します。
      * 
-     * @return (Matrix<FloatT>) s@f$ U @f$
+     * @return (Matrix<FloatT>) 行列@f$ U @f$
      */
     const Matrix<FloatT> &getU() const {return m_U;}
     
     /**
-     * 덷Us@f$ P @f$UD̍s@f$ D @f$Ԃ܂B
+     * 誤差共分散行列@f$ P @f$をUD分解したうちの行列@f$ D @f$を返します。
      * 
-     * @return (Matrix<FloatT>) s@f$ D @f$
+     * @return (Matrix<FloatT>) 行列@f$ D @f$
      */
     const Matrix<FloatT> &getD() const {return m_D;}
+    
+    /**
+     * UD分解済みの行列@f$ U @f$, @f$ D @f$を設定します。
+     * getU(), getD()で保存しておいた値から、分解をやり直さずに(丸め誤差なく)復元する場合に利用します。
+     * @f$ P @f$は必要になった時点で再計算します。
+     * 
+     * @param U 行列@f$ U @f$
+     * @param D 行列@f$ D @f$
+     */
+    void setUD(const Matrix<FloatT> &U, const Matrix<FloatT> &D){
+      kernel_t::assign(m_U, U);
+      kernel_t::assign(m_D, D);
+      kernel_t::assign(super_t::m_P, U);
+      need_update_P = true;
+    }
+};
+
+/**
+ * @brief Joseph形式のKalman Filter
+ * 
+ * 観測更新における誤差共分散行列の更新をJoseph形式
+ * @f[
+ *    P = (I - K H) P (I - K H)^{T} + K R K^{T}
+ * @f]
+ * で行うKalman Filterを定義しています。
+ * @f$ (I - K H) P @f$による更新と比べ、長時間の運用においても
+ * @f$ P @f$の対称性、正定値性が失われにくくなります。
+ * また演算は全て事前に確保した作業領域上でin-placeに行うため、
+ * カルマンゲインの返却を除き、ステップ毎のヒープ確保は発生しません。
+ * 使用する上でその使い方は標準的なKalman Filterとなんら変わりません。
+ * 
+ * @param FloatT 演算精度
+ * @see KalmanFilter
+ */
+template <class FloatT>
+class KalmanFilterJoseph : public KalmanFilter<FloatT>{
+  protected:
+    typedef KalmanFilter<FloatT> super_t;
+    typedef KalmanFilterKernel<FloatT> kernel_t;
+    KalmanFilterWorkspace<FloatT> m_work;
+    
+    /**
+     * 時間更新の本体
+     * @f$ P = \Phi P \Phi^{T} + \Gamma Q \Gamma^{T} @f$
+     * 
+     * @param Phi @f$ \Phi @f$(n x n)
+     * @param Gamma @f$ \Gamma @f$(n x m)
+     * @param work 作業領域(n x n + n x m)
+     */
+    void predict_kernel(const FloatT *Phi, const FloatT *Gamma, FloatT *work){
+      const unsigned int n(super_t::m_P.rows()), m(super_t::m_Q.rows());
+      FloatT *P(kernel_t::writable_buffer(super_t::m_P)), *Q(kernel_t::buffer(super_t::m_Q));
+      FloatT *T(work), *GQ(work + n * n);
+      
+      // T = Phi * P
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j < n; j++){
+          FloatT sum(0);
+          for(unsigned int k(0); k < n; k++){sum += Phi[i * n + k] * P[k * n + j];}
+          T[i * n + j] = sum;
+        }
+      }
+      // GQ = Gamma * Q
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j < m; j++){
+          FloatT sum(0);
+          for(unsigned int k(0); k < m; k++){sum += Gamma[i * m + k] * Q[k * m + j];}
+          GQ[i * m + j] = sum;
+        }
+      }
+      // P = T * Phi^{T} + GQ * Gamma^{T}, 対称性を利用して下三角のみ計算
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j <= i; j++){
+          FloatT sum(0);
+          for(unsigned int k(0); k < n; k++){sum += T[i * n + k] * Phi[j * n + k];}
+          for(unsigned int k(0); k < m; k++){sum += GQ[i * m + k] * Gamma[j * m + k];}
+          P[i * n + j] = P[j * n + i] = sum;
+        }
+      }
+    }
+    
+  public:
+    /**
+     * KalmanFilterJosephのコンストラクタ。
+     * 誤差共分散行列@f$ P @f$, @f$ Q @f$を指定する必要があります。
+     * 
+     * @param P @f$ P @f$行列
+     * @param Q @f$ Q @f$行列
+     */
+    KalmanFilterJoseph(const Matrix<FloatT> &P, const Matrix<FloatT> &Q)
+        : super_t(Matrix<FloatT>(), Matrix<FloatT>()), m_work() {
+      setP(P);
+      setQ(Q);
+    }
+    
+    /**
+     * コピーコンストラクタ
+     * 内部の行列はin-placeに更新されるため、常にディープコピーを作成します。
+     * 
+     * @param orig コピー元
+     * @param deepcopy 互換性のための引数(無視されます)
+     */
+    KalmanFilterJoseph(const KalmanFilterJoseph &orig, const bool deepcopy = false)
+        : super_t(orig, true), m_work(orig.m_work) {}
+    
+    /**
+     * デストラクタ
+     * 
+     */
+    ~KalmanFilterJoseph(){}
+    
+    /**
+     * 誤差共分散行列@f$ P @f$を設定します。
+     * 成分はコピーされ、以後引数の行列とは共有されません。
+     *
+     * @param P 新しい@f$ P @f$行列
+     */
+    void setP(const Matrix<FloatT> &P){kernel_t::assign(super_t::m_P, P);}
+    
+    /**
+     * 誤差共分散行列@f$ Q @f$を設定します。
+     * 成分はコピーされ、以後引数の行列とは共有されません。
+     *
+     * @param Q 新しい@f$ Q @f$行列
+     */
+    void setQ(const Matrix<FloatT> &Q){kernel_t::assign(super_t::m_Q, Q);}
+    
+    /**
+     * 推定フィルターを時間更新します。
+     * 離散系バージョン
+     * 
+     * @param Phi @f$ \Phi @f$行列
+     * @param Gamma @f$ \Gamma @f$行列
+     */
+    void predict(const Matrix<FloatT> &Phi, const Matrix<FloatT> &Gamma){
+      const unsigned int n(super_t::m_P.rows()), m(super_t::m_Q.rows());
+      FloatT *work(m_work.reserve((n * n + n * m) * 2));
+      kernel_t::serialize(Phi, work);
+      kernel_t::serialize(Gamma, work + n * n);
+      predict_kernel(work, work + n * n, work + n * n + n * m);
+    }
+    
+    /**
+     * 推定フィルターをEuler法によって時間更新します。
+     * 連続系バージョン。
+     * 
+     * @param A @f$ A @f$行列
+     * @param B @f$ B @f$行列
+     * @param delta 時間間隔 
+     */
+    void predict(const Matrix<FloatT> &A, const Matrix<FloatT> &B, const FloatT &delta){
+      const unsigned int n(super_t::m_P.rows()), m(super_t::m_Q.rows());
+      FloatT *work(m_work.reserve((n * n + n * m) * 2));
+      FloatT *Phi(work), *Gamma(work + n * n);
+      kernel_t::serialize(A, Phi);
+      kernel_t::serialize(B, Gamma);
+      for(unsigned int i(0); i < n * n; i++){Phi[i] *= delta;}
+      for(unsigned int i(0); i < n; i++){Phi[i * n + i] += 1;}
+      for(unsigned int i(0); i < n * m; i++){Gamma[i] *= delta;}
+      predict_kernel(Phi, Gamma, work + n * n + n * m);
+    }
+    
+    /**
+     * フィルターを観測更新(修正)し、その際のカルマンゲインを求めます。
+     * 
+     * @param H @f$ H @f$行列(観測行列)
+     * @param R 観測値の誤差共分散行列@f$ R @f$
+     * @return (Matrix<FloatT>) カルマンゲイン@f$ K @f$
+     * @throw MatrixException @f$ H P H^{T} + R @f$が正定値でない場合
+     */
+    Matrix<FloatT> correct(const Matrix<FloatT> &H, const Matrix<FloatT> &R){
+      const unsigned int n(super_t::m_P.rows()), p(H.rows());
+      FloatT *P(kernel_t::writable_buffer(super_t::m_P));
+      FloatT *work(m_work.reserve(p * n * 4 + p * p * 3 + n * n * 2));
+      FloatT *H_(work), *R_(H_ + p * n), *HP(R_ + p * p), *S(HP + p * n), 
+          *L(S + p * p), *Kt(L + p * p), *KR(Kt + p * n),
+          *IKH(KR + p * n), *T(IKH + n * n);
+      kernel_t::serialize(H, H_);
+      kernel_t::serialize(R, R_);
+      
+      // HP = H * P
+      for(unsigned int i(0); i < p; i++){
+        for(unsigned int j(0); j < n; j++){
+          FloatT sum(0);
+          for(unsigned int k(0); k < n; k++){sum += H_[i * n + k] * P[k * n + j];}
+          HP[i * n + j] = sum;
+        }
+      }
+      // S = HP * H^{T} + R
+      for(unsigned int i(0); i < p; i++){
+        for(unsigned int j(0); j < p; j++){
+          FloatT sum(R_[i * p + j]);
+          for(unsigned int k(0); k < n; k++){sum += HP[i * n + k] * H_[j * n + k];}
+          S[i * p + j] = sum;
+        }
+      }
+      
+      // K^{T} = S^{-1} * HP をコレスキー分解を用いて解く
+      if(!kernel_t::cholesky(S, L, p)){
+        throw MatrixException("Operation void!!");
+      }
+      for(unsigned int c(0); c < n; c++){
+        for(unsigned int i(0); i < p; i++){ // 前進代入
+          FloatT sum(HP[i * n + c]);
+          for(unsigned int k(0); k < i; k++){sum -= L[i * p + k] * Kt[k * n + c];}
+          Kt[i * n + c] = sum / L[i * p + i];
+        }
+        for(int i(p - 1); i >= 0; i--){ // 後退代入
+          FloatT sum(Kt[i * n + c]);
+          for(unsigned int k(i + 1); k < p; k++){sum -= L[k * p + i] * Kt[k * n + c];}
+          Kt[i * n + c] = sum / L[i * p + i];
+        }
+      }
+      
+      // IKH = I - K * H
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j < n; j++){
+          FloatT sum(i == j ? 1 : 0);
+          for(unsigned int k(0); k < p; k++){sum -= Kt[k * n + i] * H_[k * n + j];}
+          IKH[i * n + j] = sum;
+        }
+      }
+      // T = IKH * P
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j < n; j++){
+          FloatT sum(0);
+          for(unsigned int k(0); k < n; k++){sum += IKH[i * n + k] * P[k * n + j];}
+          T[i * n + j] = sum;
+        }
+      }
+      // KR = K * R
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j < p; j++){
+          FloatT sum(0);
+          for(unsigned int k(0); k < p; k++){sum += Kt[k * n + i] * R_[k * p + j];}
+          KR[i * p + j] = sum;
+        }
+      }
+      // P = T * IKH^{T} + KR * K^{T}, 対称性を利用して下三角のみ計算
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j <= i; j++){
+          FloatT sum(0);
+          for(unsigned int k(0); k < n; k++){sum += T[i * n + k] * IKH[j * n + k];}
+          for(unsigned int k(0); k < p; k++){sum += KR[i * p + k] * Kt[k * n + j];}
+          P[i * n + j] = P[j * n + i] = sum;
+        }
+      }
+      
+      Matrix<FloatT> K(n, p);
+      FloatT *K_(kernel_t::buffer(K));
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j < p; j++){
+          K_[i * p + j] = Kt[j * n + i];
+        }
+      }
+      return K;
+    }
+    
+    /**
+     * フィルターを観測更新(修正)し、その際のカルマンゲインを求めます。
+     * @f$ R @f$が対角行列の場合、観測を1つずつ独立なスカラー観測として順次処理し、
+     * Joseph形式で@f$ P @f$をin-placeに更新します。対角行列でない場合はcorrect()と同じです。
+     * 
+     * @param H @f$ H @f$行列(観測行列)
+     * @param R 観測値の誤差共分散行列@f$ R @f$
+     * @return (Matrix<FloatT>) カルマンゲイン@f$ K @f$
+     */
+    Matrix<FloatT> correct_sequential(const Matrix<FloatT> &H, const Matrix<FloatT> &R){
+      if(!kernel_t::is_diagonal(R)){return correct(H, R);}
+      
+      const unsigned int n(super_t::m_P.rows()), p(H.rows());
+      FloatT *work(m_work.reserve(p * n + p * 2 + n * 3));
+      FloatT *H_(work), *r(H_ + p * n);
+      kernel_t::serialize(H, H_);
+      for(unsigned int i(0); i < p; i++){r[i] = const_cast<Matrix<FloatT> &>(R)(i, i);}
+      
+      Matrix<FloatT> K(n, p);
+      kernel_t::correct_sequential(
+          kernel_t::writable_buffer(super_t::m_P), n, H_, r, p, kernel_t::buffer(K), r + p, true);
+      return K;
+    }
+};
+
+/**
+ * @brief 平方根Kalman Filter
+ * 
+ * 誤差共分散行列@f$ P @f$を@f$ P = S S^{T} @f$となる平方根@f$ S @f$で保持する
+ * Kalman Filterを定義しています。
+ * 時間更新は@f$ \begin{bmatrix} (\Phi S)^{T} \\ (\Gamma C_{Q})^{T} \end{bmatrix} @f$
+ * (@f$ C_{Q} C_{Q}^{T} = Q @f$)のHouseholder変換によるQR分解、
+ * 観測更新は@f$ R @f$のコレスキー分解で白色化した観測を1つずつ処理するPotterの方法によります。
+ * @f$ P @f$が数値的に正定値以外になり得ないため、KalmanFilterUDと同等の安定性が得られます。
+ * 演算は全て事前に確保した作業領域上でin-placeに行うため、
+ * カルマンゲインの返却を除き、ステップ毎のヒープ確保は発生しません。
+ * @f$ P @f$はgetP()が呼ばれた際に必要に応じて@f$ S @f$から復元されます。
+ * 
+ * @param FloatT 演算精度
+ * @see KalmanFilter
+ */
+template <class FloatT>
+class KalmanFilterSquareRoot : public KalmanFilter<FloatT>{
+  protected:
+    typedef KalmanFilter<FloatT> super_t;
+    typedef KalmanFilterKernel<FloatT> kernel_t;
+    Matrix<FloatT> m_S;   ///< @f$ P @f$の平方根
+    Matrix<FloatT> m_CQ;  ///< @f$ Q @f$のコレスキー分解
+    bool need_update_P;
+    KalmanFilterWorkspace<FloatT> m_work;
+    
+    /**
+     * 誤差共分散行列@f$ P = S S^{T} @f$を更新します。
+     * 
+     */
+    void updateP(){
+      if(!need_update_P){return;}
+      const unsigned int n(m_S.rows());
+      FloatT *P(kernel_t::writable_buffer(super_t::m_P)), *S(kernel_t::buffer(m_S));
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j <= i; j++){
+          FloatT sum(0);
+          for(unsigned int k(0); k < n; k++){sum += S[i * n + k] * S[j * n + k];}
+          P[i * n + j] = P[j * n + i] = sum;
+        }
+      }
+      need_update_P = false;
+    }
+    
+    /**
+     * 時間更新の本体
+     * 
+     * @param Phi @f$ \Phi @f$(n x n)
+     * @param Gamma @f$ \Gamma @f$(n x m)
+     * @param work 作業領域((n + m) x n + (n + m))
+     */
+    void predict_kernel(const FloatT *Phi, const FloatT *Gamma, FloatT *work){
+      const unsigned int n(m_S.rows()), m(m_CQ.rows()), rows(n + m);
+      FloatT *S(kernel_t::buffer(m_S)), *CQ(kernel_t::buffer(m_CQ));
+      FloatT *W(work), *v(work + rows * n);
+      
+      // W = [(Phi * S)^{T}; (Gamma * CQ)^{T}]
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j < n; j++){
+          FloatT sum(0);
+          for(unsigned int k(0); k < n; k++){sum += Phi[j * n + k] * S[k * n + i];}
+          W[i * n + j] = sum;
+        }
+      }
+      for(unsigned int i(0); i < m; i++){
+        for(unsigned int j(0); j < n; j++){
+          FloatT sum(0);
+          for(unsigned int k(0); k < m; k++){sum += Gamma[j * m + k] * CQ[k * m + i];}
+          W[(n + i) * n + j] = sum;
+        }
+      }
+      
+      // Householder変換によるQR分解、W = Q * [U; 0]
+      for(unsigned int j(0); j < n; j++){
+        FloatT norm2(0);
+        for(unsigned int i(j); i < rows; i++){norm2 += W[i * n + j] * W[i * n + j];}
+        if(norm2 == FloatT(0)){continue;}
+        FloatT alpha(std::sqrt(norm2));
+        if(W[j * n + j] > 0){alpha = -alpha;}
+        for(unsigned int i(j); i < rows; i++){v[i] = W[i * n + j];}
+        v[j] -= alpha;
+        FloatT v_norm2(norm2 - W[j * n + j] * W[j * n + j] + v[j] * v[j]);
+        W[j * n + j] = alpha;
+        for(unsigned int i(j + 1); i < rows; i++){W[i * n + j] = FloatT(0);}
+        for(unsigned int c(j + 1); c < n; c++){
+          FloatT s(0);
+          for(unsigned int i(j); i < rows; i++){s += v[i] * W[i * n + c];}
+          s *= FloatT(2) / v_norm2;
+          for(unsigned int i(j); i < rows; i++){W[i * n + c] -= s * v[i];}
+        }
+      }
+      
+      // S = U^{T}
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j < n; j++){
+          S[i * n + j] = (j <= i) ? W[j * n + i] : FloatT(0);
+        }
+      }
+      need_update_P = true;
+    }
+    
+  public:
+    /**
+     * 誤差共分散行列@f$ P @f$を返します。
+     * 
+     * @return (const Matrix<FloatT> &) 現在の@f$ P @f$行列
+     */
+    const Matrix<FloatT> &getP() const {
+      const_cast<KalmanFilterSquareRoot *>(this)->updateP();
+      return super_t::m_P;
+    }
+    
+    /**
+     * 誤差共分散行列@f$ P @f$を設定します。
+     * 内部的には@f$ P @f$のコレスキー分解を行い、後の計算に備えます。
+     *
+     * @param P 新しい@f$ P @f$行列
+     */
+    void setP(const Matrix<FloatT> &P){
+      kernel_t::assign(super_t::m_P, P);
+      kernel_t::assign(m_S, super_t::m_P);
+      kernel_t::cholesky(
+          kernel_t::buffer(super_t::m_P), kernel_t::buffer(m_S), P.rows());
+      need_update_P = false;
+    }
+    
+    /**
+     * 誤差共分散行列の平方根@f$ S @f$を返します。
+     * 
+     * @return (const Matrix<FloatT> &) @f$ P = S S^{T} @f$となる行列@f$ S @f$
+     */
+    const Matrix<FloatT> &getS() const {return m_S;}
+    
+    /**
+     * 誤差共分散行列の平方根@f$ S @f$を設定します。
+     * getS()で保存しておいた値から、分解をやり直さずに(丸め誤差なく)復元する場合に利用します。
+     * @f$ P @f$は必要になった時点で再計算します。
+     * 
+     * @param S 行列@f$ S @f$
+     */
+    void setS(const Matrix<FloatT> &S){
+      kernel_t::assign(m_S, S);
+      kernel_t::assign(super_t::m_P, S);
+      need_update_P = true;
+    }
+    
+    /**
+     * 誤差共分散行列@f$ Q @f$を設定します。
+     * 内部的には@f$ Q @f$のコレスキー分解を行い、後の計算に備えます。
+     *
+     * @param Q 新しい@f$ Q @f$行列
+     */
+    void setQ(const Matrix<FloatT> &Q){
+      kernel_t::assign(super_t::m_Q, Q);
+      kernel_t::assign(m_CQ, super_t::m_Q);
+      kernel_t::cholesky(
+          kernel_t::buffer(super_t::m_Q), kernel_t::buffer(m_CQ), Q.rows());
+    }
+    
+    /**
+     * KalmanFilterSquareRootのコンストラクタ。
+     * 誤差共分散行列@f$ P @f$, @f$ Q @f$を指定する必要があります。
+     * 
+     * @param P @f$ P @f$行列
+     * @param Q @f$ Q @f$行列
+     */
+    KalmanFilterSquareRoot(const Matrix<FloatT> &P, const Matrix<FloatT> &Q)
+        : super_t(Matrix<FloatT>(), Matrix<FloatT>()),
+        m_S(), m_CQ(), need_update_P(false), m_work() {
+      setP(P);
+      setQ(Q);
+    }
+    
+    /**
+     * コピーコンストラクタ
+     * 内部の行列はin-placeに更新されるため、常にディープコピーを作成します。
+     * 
+     * @param orig コピー元
+     * @param deepcopy 互換性のための引数(無視されます)
+     */
+    KalmanFilterSquareRoot(const KalmanFilterSquareRoot &orig, const bool deepcopy = false)
+        : super_t(orig, true),
+        m_S(orig.m_S.copy()), m_CQ(orig.m_CQ.copy()),
+        need_update_P(orig.need_update_P), m_work(orig.m_work) {}
+    
+    /**
+     * デストラクタ
+     * 
+     */
+    ~KalmanFilterSquareRoot(){}
+    
+    /**
+     * 推定フィルターを時間更新します。
+     * 離散系バージョン
+     * 
+     * @param Phi @f$ \Phi @f$行列
+     * @param Gamma @f$ \Gamma @f$行列
+     */
+    void predict(const Matrix<FloatT> &Phi, const Matrix<FloatT> &Gamma){
+      const unsigned int n(m_S.rows()), m(m_CQ.rows());
+      FloatT *work(m_work.reserve(n * n + n * m + (n + m) * (n + 1)));
+      kernel_t::serialize(Phi, work);
+      kernel_t::serialize(Gamma, work + n * n);
+      predict_kernel(work, work + n * n, work + n * n + n * m);
+    }
+    
+    /**
+     * 推定フィルターをEuler法によって時間更新します。
+     * 連続系バージョン。
+     * 
+     * @param A @f$ A @f$行列
+     * @param B @f$ B @f$行列
+     * @param delta 時間間隔 
+     */
+    void predict(const Matrix<FloatT> &A, const Matrix<FloatT> &B, const FloatT &delta){
+      const unsigned int n(m_S.rows()), m(m_CQ.rows());
+      FloatT *work(m_work.reserve(n * n + n * m + (n + m) * (n + 1)));
+      FloatT *Phi(work), *Gamma(work + n * n);
+      kernel_t::serialize(A, Phi);
+      kernel_t::serialize(B, Gamma);
+      for(unsigned int i(0); i < n * n; i++){Phi[i] *= delta;}
+      for(unsigned int i(0); i < n; i++){Phi[i * n + i] += 1;}
+      for(unsigned int i(0); i < n * m; i++){Gamma[i] *= delta;}
+      predict_kernel(Phi, Gamma, work + n * n + n * m);
+    }
+    
+    /**
+     * フィルターを観測更新(修正)し、その際のカルマンゲインを求めます。
+     * 
+     * @param H @f$ H @f$行列(観測行列)
+     * @param R 観測値の誤差共分散行列@f$ R @f$
+     * @return (Matrix<FloatT>) カルマンゲイン@f$ K @f$
+     * @throw MatrixException @f$ R @f$が正定値でない場合
+     */
+    Matrix<FloatT> correct(const Matrix<FloatT> &H, const Matrix<FloatT> &R){
+      const unsigned int n(m_S.rows()), p(H.rows());
+      FloatT *S(kernel_t::buffer(m_S));
+      FloatT *work(m_work.reserve(p * n * 2 + p * p * 2 + n * 2 + p));
+      FloatT *H_(work), *R_(H_ + p * n), *L(R_ + p * p), *Kw(L + p * p), 
+          *a(Kw + n * p), *k(a + n), *hK(k + n);
+      kernel_t::serialize(R, R_);
+      if(!kernel_t::cholesky(R_, L, p)){
+        throw MatrixException("Operation void!!");
+      }
+      
+      // 白色化 H_ = L^{-1} * H
+      kernel_t::serialize(H, H_);
+      for(unsigned int c(0); c < n; c++){
+        for(unsigned int i(0); i < p; i++){
+          FloatT sum(H_[i * n + c]);
+          for(unsigned int j(0); j < i; j++){sum -= L[i * p + j] * H_[j * n + c];}
+          H_[i * n + c] = sum / L[i * p + i];
+        }
+      }
+      
+      // 白色化した観測(分散1)を1つずつ処理、ゲインKwは全観測に対する等価なゲインとして合成
+      for(unsigned int i(0); i < n * p; i++){Kw[i] = FloatT(0);}
+      for(unsigned int r(0); r < p; r++){
+        const FloatT *h(H_ + r * n);
+        
+        // a = S^{T} * h^{T}, sigma = a^{T} * a + 1
+        FloatT sigma(1);
+        for(unsigned int i(0); i < n; i++){
+          FloatT sum(0);
+          for(unsigned int j(0); j < n; j++){sum += S[j * n + i] * h[j];}
+          a[i] = sum;
+          sigma += sum * sum;
+        }
+        
+        // k = S * a / sigma
+        for(unsigned int i(0); i < n; i++){
+          FloatT sum(0);
+          for(unsigned int j(0); j < n; j++){sum += S[i * n + j] * a[j];}
+          k[i] = sum / sigma;
+        }
+        
+        // S = S - gamma * k * a^{T}
+        FloatT gamma(FloatT(1) / (FloatT(1) + std::sqrt(FloatT(1) / sigma)));
+        for(unsigned int i(0); i < n; i++){
+          for(unsigned int j(0); j < n; j++){
+            S[i * n + j] -= gamma * k[i] * a[j];
+          }
+        }
+        
+        // Kw = Kw - k * (h * Kw) + k * e_r^{T}
+        for(unsigned int j(0); j < p; j++){
+          FloatT sum(0);
+          for(unsigned int i(0); i < n; i++){sum += h[i] * Kw[i * p + j];}
+          hK[j] = sum;
+        }
+        hK[r] -= 1;
+        for(unsigned int i(0); i < n; i++){
+          for(unsigned int j(0); j < p; j++){
+            Kw[i * p + j] -= k[i] * hK[j];
+          }
+        }
+      }
+      need_update_P = true;
+      
+      // K = Kw * L^{-1}
+      Matrix<FloatT> K(n, p);
+      FloatT *K_(kernel_t::buffer(K));
+      for(unsigned int i(0); i < n; i++){
+        for(int j(p - 1); j >= 0; j--){
+          FloatT sum(Kw[i * p + j]);
+          for(unsigned int l(j + 1); l < p; l++){sum -= K_[i * p + l] * L[l * p + j];}
+          K_[i * p + j] = sum / L[j * p + j];
+        }
+      }
+      return K;
+    }
+    
+    /**
+     * フィルターを観測更新(修正)し、その際のカルマンゲインを求めます。
+     * Potterの方法は元々観測を1つずつ順次処理するため、correct()と同じです。
+     * 
+     * @param H @f$ H @f$行列(観測行列)
+     * @param R 観測値の誤差共分散行列@f$ R @f$
+     * @return (Matrix<FloatT>) カルマンゲイン@f$ K @f$
+     */
+    Matrix<FloatT> correct_sequential(const Matrix<FloatT> &H, const Matrix<FloatT> &R){
+      return correct(H, R);
+    }
 };
 
 /**
  * @brief UnscentedKalman Filter
  * 
- * Unscented Kalman Filter`Ă܂B
+ * Unscented Kalman Filterを定義しています。
  * 
- * @param FloatT Zx
+ * 並列モード(parallel())を有効にし、かつOpenMP(-fopenmp等)を有効にしてコンパイルした場合、
+ * シグマポイントに対する関数オブジェクトの評価、ならびに共分散の計算をスレッドに分配します。
+ * この場合、関数オブジェクトは複数のスレッドから同時に呼び出されるため、
+ * 呼び出し間で状態を共有せず、また例外を送出しないようにしてください。
+ * 平均、共分散の計算は各シグマポイントを連続した配列として保持し、
+ * 内側のループをベクトル長方向の積和(ベクトル化可能)とすることで高速化しています。
+ * 
+ * @param FloatT 演算精度
  * @see KalmanFilter
  */
 template <class FloatT>
 class UnscentedKalmanFilter : public KalmanFilter<FloatT>{
   protected:
+    typedef KalmanFilterKernel<FloatT> kernel_t;
+    
     FloatT m_alpha, m_beta, m_kappa;
+    bool m_parallel;
     
     bool need_recalc_coef;
     FloatT gamma, lambda;
     unsigned n_a;
     FloatT weightM_0, weightC_0, weight_i;
-    Matrix<FloatT> m_sqrtQ;
+    Matrix<FloatT> m_sqrtQ, m_sqrtQ_neg;
+    KalmanFilterWorkspace<FloatT> m_work;
     
     /**
-     * Ussqrt(ɎƂȂ)߂܂B
+     * 共分散行列のsqrt(成分が常に実数となる)を求めます。
      * 
-     * @param cov Us
-     * @return (Matrix<FloatT>) sqrtꂽs
+     * @param cov 共分散行列
+     * @return (Matrix<FloatT>) sqrtされた行列
      */
     Matrix<FloatT> get_sqrt_cov(const Matrix<FloatT> &cov){
       Matrix<FloatT> sqrt_cov(cov.rows(), cov.columns());
       
-      if(cov.isDiagonal()){   // Ίps̏ꍇA
+      if(cov.isDiagonal()){   // 対角行列の場合、高速化
         for(int i(0); i < sqrt_cov.rows(); i++){
           sqrt_cov(i, i) = sqrt(const_cast<Matrix<FloatT> &>(cov)(i, i));
         }
-      }else{  // łȂꍇ͂܂߂ɌvZ
-        Matrix<Complex<FloatT> > sqrt_cov_C(cov.sqrt());
-        for(int i(0); i < sqrt_cov_C.rows(); i++){
-          for(int j(0); j < sqrt_cov_C.columns(); j++){
-            sqrt_cov(i, j) = sqrt_cov_C(i, j).real();
-          }
-        }
+      }else{  // そうでない場合はまじめに計算する(対称行列用の実数演算)
+        sqrt_cov = cov.sqrt_symmetric(false);
       }
       return sqrt_cov;
     }
     
     /**
-     * WȂǃtB^[ZɕKvȒl̃LbVXV܂B
+     * 係数などフィルター演算に必要な値のキャッシュを更新します。
      * 
      */
     void recalc_coef(){
@@ -678,41 +1686,113 @@ class UnscentedKalmanFilter : public KalmanFilter<FloatT>{
       weight_i = FloatT(1) / (gamma2 * 2);
       
       m_sqrtQ = get_sqrt_cov(KalmanFilter<FloatT>::m_Q);
+      m_sqrtQ_neg = -m_sqrtQ;
       
       need_recalc_coef = false;
     }
     
+    /**
+     * 並列に実行するかどうかを返します。
+     * 
+     * @return (bool) 並列に実行する場合true
+     */
+    bool run_parallel() const {
+#if defined(_OPENMP)
+      return m_parallel;
+#else
+      return false;
+#endif
+    }
+    
+    /**
+     * 重み付き平均を求めます。
+     * 
+     * @param values 値(n_sigma x n、シグマポイントごとに連続、先頭が中心)
+     * @param n_sigma シグマポイントの数
+     * @param n 値の大きさ
+     * @param mean 平均の書き出し先(n)
+     */
+    void weighted_mean(
+        const FloatT *values, const unsigned int &n_sigma, const unsigned int &n,
+        FloatT *mean) const {
+      for(unsigned int i(0); i < n; i++){mean[i] = weightM_0 * values[i];}
+      for(unsigned int k(1); k < n_sigma; k++){
+        const FloatT *v(values + k * n);
+        for(unsigned int i(0); i < n; i++){mean[i] += weight_i * v[i];}
+      }
+    }
+    
+    /**
+     * 重み付き共分散@f$ \sum_{k} w_{k} a_{k} b_{k}^{T} @f$を求めます。
+     * 
+     * @param a 偏差(n_sigma x n_a、シグマポイントごとに連続、先頭が中心)
+     * @param b 偏差(n_sigma x n_b、同上)
+     * @param n_sigma シグマポイントの数
+     * @param n_a aの大きさ
+     * @param n_b bの大きさ
+     * @param cov 共分散の書き出し先(n_a x n_b)
+     * @param symmetric aとbが同一の場合true、下三角のみ計算して複写します
+     */
+    void weighted_cov(
+        const FloatT *a, const FloatT *b, const unsigned int &n_sigma,
+        const unsigned int &n_a, const unsigned int &n_b,
+        FloatT *cov, const bool &symmetric) const {
+      // 行ごとに独立であるため、行単位で分配する
+#if defined(_OPENMP)
+#pragma omp parallel for if(run_parallel()) schedule(static)
+#endif
+      for(int i = 0; i < (int)n_a; i++){
+        FloatT *row(cov + i * n_b);
+        const unsigned int n_j(symmetric ? (i + 1) : n_b);
+        for(unsigned int j(0); j < n_j; j++){row[j] = FloatT(0);}
+        for(unsigned int k(0); k < n_sigma; k++){
+          FloatT coef((k == 0 ? weightC_0 : weight_i) * a[k * n_a + i]);
+          const FloatT *b_k(b + k * n_b);
+          for(unsigned int j(0); j < n_j; j++){row[j] += coef * b_k[j];}
+        }
+      }
+      if(symmetric){
+        for(unsigned int i(0); i < n_a; i++){
+          for(unsigned int j(i + 1); j < n_b; j++){
+            cov[i * n_b + j] = cov[j * n_b + i];
+          }
+        }
+      }
+    }
+    
   public:
     /**
-     * UnscentedKalmanFilter̃RXgN^B
-     * 덷Us@f$ P @f$, @f$ Q @f$w肷Kv܂B
+     * UnscentedKalmanFilterのコンストラクタ。
+     * 誤差共分散行列@f$ P @f$, @f$ Q @f$を指定する必要があります。
      * 
-     * @param P @f$ P @f$s
-     * @param Q @f$ Q @f$s
+     * @param P @f$ P @f$行列
+     * @param Q @f$ Q @f$行列
      */
     UnscentedKalmanFilter(const Matrix<FloatT> &P, const Matrix<FloatT> &Q)
         : KalmanFilter<FloatT>(P, Q),
-          m_alpha(1),   // typically 0.001 - 1 (P.239, ȉ) 
+          m_alpha(1),   // typically 0.001 - 1 (P.239, 以下同じ) 
           m_beta(2),    // the optiomal value for Gaussian distribution
           m_kappa(0),   // 0 or 3 - n_a
-          need_recalc_coef(true), m_sqrtQ(){
+          m_parallel(false),
+          need_recalc_coef(true), m_sqrtQ(), m_sqrtQ_neg(), m_work(){
     }
     
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
      * 
-     * @param orig Rs[
-     * @param deepcopy fB[vRs[쐬邩ǂ
+     * @param orig コピー元
+     * @param deepcopy ディープコピーを作成するかどうか
      */
     UnscentedKalmanFilter(const UnscentedKalmanFilter &orig, const bool deepcopy = false)
         : KalmanFilter<FloatT>(orig, deepcopy),
           m_alpha(orig.m_alpha), m_beta(orig.m_beta), m_kappa(orig.m_kappa), 
-          need_recalc_coef(true), m_sqrtQ(){
+          m_parallel(orig.m_parallel),
+          need_recalc_coef(true), m_sqrtQ(), m_sqrtQ_neg(), m_work(orig.m_work){
       //std::cerr << "UKF" << std::endl;
     }
     
     /**
-     * @f$ \alpha @f$ 擾܂
+     * @f$ \alpha @f$ を取得します
      * 
      * @return (FloatT &)
      */
@@ -722,7 +1802,7 @@ class UnscentedKalmanFilter : public KalmanFilter<FloatT>{
     }
     
     /**
-     * @f$ \beta @f$ 擾܂
+     * @f$ \beta @f$ を取得します
      * 
      * @return (FloatT &)
      */
@@ -732,7 +1812,7 @@ class UnscentedKalmanFilter : public KalmanFilter<FloatT>{
     } 
     
     /**
-     * @f$ \kappa @f$ 擾܂
+     * @f$ \kappa @f$ を取得します
      * 
      * @return (FloatT &)
      */
@@ -742,9 +1822,17 @@ class UnscentedKalmanFilter : public KalmanFilter<FloatT>{
     }
     
     /**
-     * 덷Us@f$ P @f$ݒ肵܂B
+     * 並列モードを取得します。
+     * OpenMPが無効な場合、設定にかかわらず逐次実行されます。
+     * 
+     * @return (bool &) 並列に実行する場合true
+     */
+    bool &parallel(){return m_parallel;}
+    
+    /**
+     * 誤差共分散行列@f$ P @f$を設定します。
      *
-     * @param P V@f$ P @f$s
+     * @param P 新しい@f$ P @f$行列
      */
     void setP(const Matrix<FloatT> &P){
       need_recalc_coef = true;
@@ -752,9 +1840,9 @@ class UnscentedKalmanFilter : public KalmanFilter<FloatT>{
     }
 
     /**
-     * 덷Us@f$ Q @f$ݒ肵܂B
+     * 誤差共分散行列@f$ Q @f$を設定します。
      *
-     * @param Q V@f$ Q @f$s
+     * @param Q 新しい@f$ Q @f$行列
      */
     void setQ(const Matrix<FloatT> &Q){
       need_recalc_coef = true;
@@ -762,18 +1850,32 @@ class UnscentedKalmanFilter : public KalmanFilter<FloatT>{
     }
     
     /**
-     * KalmanFilter̃fXgN^B
+     * KalmanFilterのデストラクタ。
      * 
      */
     ~UnscentedKalmanFilter(){}
     
   protected:
+    /**
+     * シグマポイントを求めます。
+     * 偏差には@f$ P = S S^{T} @f$となる@f$ S @f$の列を用います。
+     * @f$ S @f$は高速なコレスキー分解で求め、
+     * @f$ P @f$が正定値でない場合のみ対称行列の平方根で代用します。
+     * 
+     * @param state 状態量
+     * @param state_with_perturbation シグマポイントの格納先(2 n_a個)
+     */
     template <class StateValues>
     void get_perturbed_states(StateValues &state, StateValues *state_with_perturbation){
-      Matrix<Complex<FloatT> > sqrtP(KalmanFilter<FloatT>::m_P.sqrt());
+      Matrix<FloatT> sqrtP;
+      try{
+        sqrtP = KalmanFilter<FloatT>::m_P.decomposeCholesky(false);
+      }catch(MatrixException &){
+        sqrtP = KalmanFilter<FloatT>::m_P.sqrt_symmetric(false);
+      }
       for(unsigned k(0); k < n_a; k++){
         for(unsigned i(0); i < n_a; i++){
-          FloatT perturbation(sqrtP(i, k).real());
+          FloatT perturbation(sqrtP(i, k));
           state_with_perturbation[k][i] = state[i] + gamma * perturbation;
           state_with_perturbation[k + n_a][i] = state[i] - gamma * perturbation;
         }
@@ -782,63 +1884,71 @@ class UnscentedKalmanFilter : public KalmanFilter<FloatT>{
   
   public:
     /**
-     * ԗʂƃtB^[ԍXV܂B
+     * 状態量とフィルターを時間更新します。
      * 
-     * @param functor ԍXV֐(2܂3Ƃoperator()`Ă邱)
-     * @param state ԗ([]`Ă邱)
-     * @param input VXeւ̓
+     * @param functor 時間更新関数(2または3引数をとるoperator()が定義されていること)
+     * @param state 状態量([]が定義されていること)
+     * @param input システムへの入力
      */
     template <class TimeUpdateFunctor, class StateValues, class InputValues>
     void predict(TimeUpdateFunctor &functor, StateValues &state, InputValues &input){
       recalc_coef();
       
-      // ΍ꂽԗ(VO}|Cg)vZ
-      StateValues *state_sigma(new StateValues [n_a * 2]);
+      // 偏差分だけずれた状態量(シグマポイント)を計算、末尾は中心
+      const unsigned int n_sigma(n_a * 2 + 1);
+      StateValues *state_sigma(new StateValues [n_sigma]);
       get_perturbed_states(state, state_sigma);
       
-      // ̃Xebv̌vZmeaňvZ(ԗʂ̍XV)
-      StateValues state0_next = functor(state, input);
-      for(unsigned i(0); i < n_a; i++){
-        state[i] = weightM_0 * state0_next[i];
-      }
-      for(unsigned k(0); k < n_a; k++){
-        state_sigma[k] = functor(state_sigma[k], input, m_sqrtQ);
-        state_sigma[k + n_a] = functor(state_sigma[k + n_a], input, -m_sqrtQ);
-        for(unsigned i(0); i < n_a; i++){
-          state[i] += weight_i * state_sigma[k][i];
-          state[i] += weight_i * state_sigma[k + n_a][i];
+      // 次のステップの計算
+#if defined(_OPENMP)
+#pragma omp parallel if(run_parallel())
+#endif
+      {
+        // 参照カウンタを複数のスレッドで共有しないよう、スレッドごとに複製する
+        Matrix<FloatT> sqrtQ(run_parallel() ? m_sqrtQ.copy() : m_sqrtQ);
+        Matrix<FloatT> sqrtQ_neg(run_parallel() ? m_sqrtQ_neg.copy() : m_sqrtQ_neg);
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic)
+#endif
+        for(int k = 0; k < (int)n_sigma; k++){
+          if(k < (int)n_a){
+            state_sigma[k] = functor(state_sigma[k], input, sqrtQ);
+          }else if(k < (int)n_a * 2){
+            state_sigma[k] = functor(state_sigma[k], input, sqrtQ_neg);
+          }else{
+            state_sigma[k] = functor(state, input);
+          }
         }
       }
       
-      // cov̌vZ
+      // meanの計算(状態量の更新)とcovの計算
       {
-        Matrix<FloatT> P_vec(n_a, 1);
-        
-        // i = 0
-        for(unsigned i(0); i < n_a; i++){
-          P_vec(i, 0) = state0_next[i] - state[i];
+        FloatT *X(m_work.reserve(n_sigma * n_a + n_a));
+        FloatT *mean(X + n_sigma * n_a);
+        for(unsigned k(0); k < n_sigma; k++){
+          StateValues &sigma(state_sigma[k == 0 ? (n_sigma - 1) : (k - 1)]);
+          for(unsigned i(0); i < n_a; i++){X[k * n_a + i] = sigma[i];}
         }
-        KalmanFilter<FloatT>::m_P = P_vec * P_vec.transpose() * weightC_0;
-        
-        // i > 0
-        for(unsigned k(0); k < n_a * 2; k++){
-          for(unsigned i(0); i < n_a; i++){
-            P_vec(i, 0) = state_sigma[k][i] - state[i];
-          }
-          KalmanFilter<FloatT>::m_P += P_vec * P_vec.transpose() * weight_i;
+        weighted_mean(X, n_sigma, n_a, mean);
+        for(unsigned i(0); i < n_a; i++){state[i] = mean[i];}
+        for(unsigned k(0); k < n_sigma; k++){
+          for(unsigned i(0); i < n_a; i++){X[k * n_a + i] -= mean[i];}
         }
+        Matrix<FloatT> P(n_a, n_a);
+        weighted_cov(X, X, n_sigma, n_a, n_a, kernel_t::buffer(P), true);
+        KalmanFilter<FloatT>::m_P = P;
       }
       
       delete [] state_sigma;
     }
     
     /**
-     * ԗʂƃtB^[ϑXV(C)A̍ۂ̃J}QC߂܂B
+     * 状態量とフィルターを観測更新(修正)し、その際のカルマンゲインを求めます。
      * 
-     * @param functor ϑ(1Ƃoperator()`Ă邱)
-     * @param state ԗ([]`Ă邱)
-     * @param z ϑ([]Avariables`Ă邱)
-     * @return R ϑľ덷Us@f$ R @f$
+     * @param functor 観測方程式(1引数をとるoperator()が定義されていること)
+     * @param state 状態量([]が定義されていること)
+     * @param z 観測量([]、variablesが定義されていること)
+     * @return R 観測値の誤差共分散行列@f$ R @f$
      */
     template <class ObserverationFunctor, class StateValues, class ObservedValues>
     Matrix<FloatT> correct(ObserverationFunctor &functor, 
@@ -848,56 +1958,49 @@ class UnscentedKalmanFilter : public KalmanFilter<FloatT>{
       
       recalc_coef();
       
-      // ΍ꂽԗ(VO}|Cg)vZ
+      // 偏差分だけずれた状態量(シグマポイント)を計算
+      const unsigned int n_sigma(n_a * 2 + 1);
       StateValues *state_sigma(new StateValues [n_a * 2]);
       get_perturbed_states(state, state_sigma);
       
-      // \ϑʂ̌vZ
-      ObservedValues y_from_state0 = functor(state);
-      ObservedValues *y_from_sigma(new ObservedValues [n_a * 2]);
+      // 予測観測量の計算、末尾は中心
+      ObservedValues *y_from_sigma(new ObservedValues [n_sigma]);
+#if defined(_OPENMP)
+#pragma omp parallel for if(run_parallel()) schedule(dynamic)
+#endif
+      for(int k = 0; k < (int)n_sigma; k++){
+        y_from_sigma[k] = functor((k < (int)n_a * 2) ? state_sigma[k] : state);
+      }
       
       unsigned n_y(ObservedValues::variables());
       
-      // y_meaňvZ
-      ObservedValues y_mean;
-      for(unsigned i(0); i < n_y; i++){
-        y_mean[i] = weightM_0 * y_from_state0[i];
-      }
-      for(unsigned k(0); k < n_a; k++){
-        y_from_sigma[k] = functor(state_sigma[k]);
-        y_from_sigma[k + n_a] = functor(state_sigma[k + n_a]);
-        for(unsigned i(0); i < n_y; i++){
-          y_mean[i] += weight_i * y_from_sigma[k][i];
-          y_mean[i] += weight_i * y_from_sigma[k + n_a][i];
+      // y_meanの計算, P_yy, P_xyの計算
+      FloatT *X(m_work.reserve((n_a + n_y) * n_sigma + n_y));
+      FloatT *Y(X + n_a * n_sigma), *y_mean(Y + n_y * n_sigma);
+      for(unsigned k(0); k < n_sigma; k++){
+        ObservedValues &y(y_from_sigma[k == 0 ? (n_sigma - 1) : (k - 1)]);
+        for(unsigned i(0); i < n_y; i++){Y[k * n_y + i] = y[i];}
+        if(k == 0){
+          for(unsigned i(0); i < n_a; i++){X[i] = FloatT(0);}
+        }else{
+          StateValues &sigma(state_sigma[k - 1]);
+          for(unsigned i(0); i < n_a; i++){X[k * n_a + i] = sigma[i] - state[i];}
         }
       }
-      
-      // P_yy, P_xy̌vZ
-      Matrix<FloatT> P_y(n_y, 1);
-      for(unsigned i(0); i < n_y; i++){
-        P_y(i, 0) = y_from_state0[i] - y_mean[i];
+      weighted_mean(Y, n_sigma, n_y, y_mean);
+      for(unsigned k(0); k < n_sigma; k++){
+        for(unsigned i(0); i < n_y; i++){Y[k * n_y + i] -= y_mean[i];}
       }
       
-      Matrix<FloatT> P_yy(P_y * P_y.transpose() * weightC_0);
-      Matrix<FloatT> P_xy(KalmanFilter<FloatT>::m_P.rows(), P_yy.columns());
-      for(unsigned i(0); i < n_a * 2; i++){
-        Matrix<FloatT> P_x(P_xy.rows(), 1);
-        for(unsigned i2(0); i2 < n_a; i2++){
-          P_x(i2, 0) = state_sigma[i][i2] - state[i2];
-        }
-        for(unsigned i2(0); i2 < n_y; i2++){
-          P_y(i2, 0) = y_from_sigma[i][i2] - y_mean[i2];
-        }
-        
-        P_yy += P_y * P_y.transpose() * weight_i;
-        P_xy += P_x * P_y.transpose() * weight_i;
-      }
+      Matrix<FloatT> P_yy(n_y, n_y), P_xy(n_a, n_y);
+      weighted_cov(Y, Y, n_sigma, n_y, n_y, kernel_t::buffer(P_yy), true);
+      weighted_cov(X, Y, n_sigma, n_a, n_y, kernel_t::buffer(P_xy), false);
       P_yy += R;
       
-      // J}QC
+      // カルマンゲイン
       Matrix<FloatT> K(P_xy * P_yy.inverse());
       
-      // ԗ, P̏C
+      // 状態量, Pの修正
       Matrix<FloatT> delta_z(n_y, 1);
       for(unsigned i(0); i < n_y; i++){
         delta_z(i, 0) = const_cast<ObservedValues &>(z)[i] - y_mean[i];
@@ -48,6 +48,7 @@
 
 #include "util/comstream.h"
 #include "util/endian.h"
+#include "util/instrument.h"
 
 /**
  * Convert units from degrees to radians
@@ -79,6 +80,8 @@ struct GlobalOptions {
   int end_gpswn; ///< End GPS week
   bool est_bias; ///< True for performing bias estimation
   bool use_udkf; ///< True for UD Kalman filtering
+  bool use_josephkf; ///< True for Kalman filtering with Joseph form covariance update
+  bool use_srkf; ///< True for square root Kalman filtering
   bool use_magnet; ///< True for utilizing magnetic sensor
   FloatT mag_heading_accuracy_deg; ///< Accuracy of magnetic sensor in degrees
   FloatT yaw_correct_with_mag_when_speed_less_than_ms; ///< Threshold for yaw compensation; performing it when under this value [m/s], or ignored non-positive values
@@ -87,6 +90,8 @@ struct GlobalOptions {
   std::ostream *_out; ///< Pointer for output stream
   bool in_sylphide;   ///< True when inputs is Sylphide formated
   bool out_sylphide;  ///< True when outputs is Sylphide formated
+  bool com_buffered; ///< True when serial ports are opened with BufferedComportStreambuf
+  bool com_low_latency; ///< True when buffered serial ports are configured for low latency
   typedef std::map<const char *, std::iostream *> iostream_pool_t;
   iostream_pool_t iostream_pool;
 
@@ -106,6 +111,8 @@ struct GlobalOptions {
       start_gpswn(0), end_gpswn(0),
       est_bias(true),
       use_udkf(false),
+      use_josephkf(false),
+      use_srkf(false),
       use_magnet(false),
       mag_heading_accuracy_deg(3),
       yaw_correct_with_mag_when_speed_less_than_ms(5),
@@ -113,6 +120,7 @@ struct GlobalOptions {
       reduce_1pps_sync_error(true),
       _out(&(std::cout)),
       in_sylphide(false), out_sylphide(false),
+      com_buffered(false), com_low_latency(false),
       iostream_pool() {};
   virtual ~GlobalOptions(){
     for(int i(0); i < sizeof(init_attitude_deg) / sizeof(init_attitude_deg[0]); ++i){
@@ -143,7 +151,24 @@ struct GlobalOptions {
 #define COMPORT_PREFIX "COM"
 #else
 #define COMPORT_PREFIX "/dev/tty"
+#define COMPORT_PREFIX_PTY "/dev/pts/" // pseudo terminal
 #endif
+
+  static bool is_comport(const char *spec){
+    if(std::strstr(spec, COMPORT_PREFIX) == spec){return true;}
+#ifdef COMPORT_PREFIX_PTY
+    if(std::strstr(spec, COMPORT_PREFIX_PTY) == spec){return true;}
+#endif
+    return false;
+  }
+  
+  ComportStream *open_comport(const char *spec){
+    ComportStream *com(new ComportStream(spec, com_buffered));
+    if(com_low_latency && com->buffered()){
+      com->buffered()->config_low_latency();
+    }
+    return com;
+  }
   
   std::istream &spec2istream(
       const char *spec, 
@@ -156,7 +181,7 @@ struct GlobalOptions {
       setmode(fileno(stdin), O_BINARY);
 #endif
         return std::cin;
-      }else if(strstr(spec, COMPORT_PREFIX) == spec){
+      }else if(is_comport(spec)){
         std::cerr << spec << std::endl;
         // COM ports
         // COM_name[:baudrate] format is acceptable.
@@ -166,7 +191,7 @@ struct GlobalOptions {
           baudrate_spec++;
         }
         if(iostream_pool.find(spec) == iostream_pool.end()){
-          ComportStream *com_in = new ComportStream(spec);
+          ComportStream *com_in = open_comport(spec);
           if(baudrate_spec){set_baudrate(*com_in, baudrate_spec);}
           iostream_pool[spec] = com_in;
           return *com_in;
@@ -198,9 +223,9 @@ struct GlobalOptions {
       setmode(fileno(stdout), O_BINARY);
 #endif
         return std::cout;
-      }else if(std::strstr(spec, COMPORT_PREFIX) == spec){
+      }else if(is_comport(spec)){
         std::cerr << spec << std::endl;
-        // COM|[g
+        // COMポート
         // COM_name[:baudrate] format is acceptable.
         char *baudrate_spec((char *)std::strchr(spec, ':'));
         if(baudrate_spec){
@@ -208,7 +233,7 @@ struct GlobalOptions {
           baudrate_spec++;
         }
         if(iostream_pool.find(spec) == iostream_pool.end()){
-          ComportStream *com_out = new ComportStream(spec);
+          ComportStream *com_out = open_comport(spec);
           if(baudrate_spec){set_baudrate(*com_out, baudrate_spec);}
           iostream_pool[spec] = com_out;
           return *com_out;
@@ -266,7 +291,8 @@ struct GlobalOptions {
     const char *key_head;
     unsigned int key_length(get_key(spec, &key_head));
     if(key_length == 0){return NULL;}
-    if(std::strncmp(key, key_head, key_length) != 0){ // check same key?
+    if((std::strncmp(key, key_head, key_length) != 0)
+        || (key[key_length] != '\0')){ // check same key? (not a prefix of another one)
       return NULL;
     }
     return get_value(spec, key_length, accept_no_value);
@@ -294,7 +320,8 @@ struct GlobalOptions {
 
 #define CHECK_KEY(name) \
   (key_checked || \
-    (key_checked = (std::strncmp(key, #name, key_length) == 0)))
+    (key_checked = ((std::strncmp(key, #name, key_length) == 0) \
+        && (#name[key_length] == '\0'))))
 #define CHECK_ALIAS(name) CHECK_KEY(name)
 #define CHECK_OPTION(name, novalue, operation, disp) { \
   if(CHECK_KEY(name)){ \
@@ -376,6 +403,10 @@ if(key_checked){ \
     
     CHECK_OPTION_BOOL(use_udkf);
     
+    CHECK_OPTION_BOOL(use_josephkf);
+    
+    CHECK_OPTION_BOOL(use_srkf);
+    
     CHECK_OPTION_BOOL(use_magnet);
 
     CHECK_OPTION(mag_heading_accuracy_deg, false,
@@ -401,14 +432,41 @@ if(key_checked){ \
     }
     
     CHECK_OPTION_BOOL(in_sylphide);
+    
+    CHECK_OPTION_BOOL(com_buffered);
+    
+    CHECK_OPTION_BOOL(com_low_latency);
 
     CHECK_OPTION_BOOL(out_sylphide);
+
+#if defined(INSTRUMENT)
+    CHECK_OPTION(instrument_json, true,
+        Instrument::get().json() = is_true(value),
+        (Instrument::get().json() ? "on" : "off"));
+
+    CHECK_OPTION(instrument_interval, false,
+        Instrument::get().interval() = std::atof(value),
+        Instrument::get().interval() << " [s]");
+#endif
 #undef CHECK_OPTION_BOOL
 #undef CHECK_OPTION
     return false;
   }
 };
 
+/**
+ * Fixed layout record of a navigation solution,
+ * which is published to other processes, for example, through SharedMemoryRing.
+ */
+struct NAVRecord {
+  char mode[8]; ///< operation mode such as "TU" and "MU", null terminated
+  double itow; ///< GPS time of week [s]
+  double longitude, latitude; ///< [deg]
+  double height; ///< [m]
+  double v_north, v_east, v_down; ///< [m/s]
+  double heading, pitch, roll, azimuth; ///< [deg]
+};
+
 class NAVData {
   public:
     virtual float_sylph_t longitude() const = 0;
@@ -506,6 +564,28 @@ class NAVData {
       *(v_s16_t *)(&buf[28]) = le_char4_2_num<v_s16_t>(*(const char *)&theta);
       *(v_s16_t *)(&buf[30]) = le_char4_2_num<v_s16_t>(*(const char *)&phi);
     }
+    
+    /**
+     * Make fixed layout record
+     * 
+     */
+    void encode_record(
+        const float_sylph_t &itow, const char *mode,
+        NAVRecord &res) const {
+      std::strncpy(res.mode, mode, sizeof(res.mode) - 1);
+      res.mode[sizeof(res.mode) - 1] = '\0';
+      res.itow = itow;
+      res.longitude = rad2deg(longitude());
+      res.latitude = rad2deg(latitude());
+      res.height = height();
+      res.v_north = v_north();
+      res.v_east = v_east();
+      res.v_down = v_down();
+      res.heading = rad2deg(heading());
+      res.pitch = rad2deg(euler_theta());
+      res.roll = rad2deg(euler_phi());
+      res.azimuth = rad2deg(azimuth());
+    }
 };
 
 #endif
@@ -0,0 +1,171 @@
+/**
+ * @file Common part of micro-benchmarks
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Each benchmark is repeated until it has consumed at least min_time CPU seconds,
+ * and the results are written to stdout as CSV lines:
+ *   bench, (parameters), iterations, ns_per_op, allocs_per_op
+ * allocs_per_op counts every call of the global operator new.
+ * This header replaces the global operator new, therefore it must be included
+ * by exactly one translation unit of a benchmark program.
+ */
+
+#ifndef __BENCH_COMMON_H__
+#define __BENCH_COMMON_H__
+
+#include <iostream>
+#include <string>
+#include <exception>
+#include <new>
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+static unsigned long allocation_count(0);
+
+#if __cplusplus >= 201103L
+void *operator new(std::size_t size){
+#else
+void *operator new(std::size_t size) throw(std::bad_alloc){
+#endif
+  allocation_count++;
+  void *res(std::malloc(size ? size : 1));
+  if(!res){throw std::bad_alloc();}
+  return res;
+}
+#if __cplusplus >= 201103L
+void *operator new[](std::size_t size){
+#else
+void *operator new[](std::size_t size) throw(std::bad_alloc){
+#endif
+  return operator new(size);
+}
+void operator delete(void *ptr) throw(){std::free(ptr);}
+void operator delete[](void *ptr) throw(){std::free(ptr);}
+
+struct BenchOptions {
+  double min_time; ///< minimum CPU time [s] spent for each benchmark
+  const char *filter; ///< when non-NULL, only benchmarks whose names start with it are run
+  BenchOptions() : min_time(0.1), filter(NULL) {}
+  virtual ~BenchOptions(){}
+
+  /**
+   * @return (const char *) value when spec is "--key=value", otherwise NULL
+   */
+  static const char *get_value(const char *spec, const char *key){
+    if(std::strncmp(spec, "--", 2) != 0){return NULL;}
+    spec += 2;
+    unsigned int key_length(std::strlen(key));
+    if(std::strncmp(spec, key, key_length) != 0){return NULL;}
+    if(spec[key_length] != '='){return NULL;}
+    return spec + key_length + 1;
+  }
+
+  virtual bool check_spec(const char *spec){
+    const char *value;
+    if(value = get_value(spec, "min_time")){
+      min_time = std::atof(value);
+      return true;
+    }
+    if(value = get_value(spec, "filter")){
+      filter = value;
+      return true;
+    }
+    return false;
+  }
+};
+
+/**
+ * Linear congruential generator to make the inputs reproducible
+ * regardless of the implementation of std::rand().
+ */
+struct LCG {
+  unsigned long state;
+  LCG(const unsigned long &seed = 1) : state(seed) {}
+  double operator()(){ // [-1, 1)
+    state = (state * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+    return (double)state / 0x40000000UL - 1;
+  }
+};
+
+/**
+ * Run an operation repeatedly and emit a line.
+ * Operation must have "FloatT operator()()"
+ * whose return value is consumed to avoid the dead code elimination.
+ *
+ * @param options options
+ * @param name name of the benchmark
+ * @param params parameters of the benchmark, which are emitted in the CSV as they are
+ * @param op operation
+ */
+template <class FloatT, class Operation>
+void run_bench(
+    const BenchOptions &options,
+    const char *name, const std::string &params, Operation op){
+  if(options.filter
+      && (std::strncmp(name, options.filter, std::strlen(options.filter)) != 0)){
+    return;
+  }
+  volatile FloatT sink(0);
+  unsigned long iterations(1);
+  double elapsed;
+  unsigned long allocations;
+  try{
+    sink += op(); // warm up
+    while(true){
+      unsigned long allocations_before(allocation_count);
+      std::clock_t t0(std::clock());
+      for(unsigned long i(0); i < iterations; i++){
+        sink += op();
+      }
+      elapsed = (double)(std::clock() - t0) / CLOCKS_PER_SEC;
+      allocations = allocation_count - allocations_before;
+      if(elapsed >= options.min_time){break;}
+      iterations *= ((elapsed > 0) && (elapsed * 10 > options.min_time)) ? 2 : 10;
+    }
+  }catch(std::exception &e){
+    std::cerr << name << " (" << params << "): " << e.what() << std::endl;
+    return;
+  }
+  std::cout << name << ", "
+      << params << ", "
+      << iterations << ", "
+      << (elapsed * 1E9 / iterations) << ", "
+      << ((double)allocations / iterations) << std::endl;
+}
+
+#endif /* __BENCH_COMMON_H__ */
@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef __CALIBRATION_H__
+#define __CALIBRATION_H__
+
+/*
+ * IMU calibration of NinjaScan, shared by INS_GPS and log_CSV.
+ * float_sylph_t must be defined before inclusion.
+ */
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define CALIBRATION_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define CALIBRATION_SIMD_SSE2
+#endif
+
+#include "param/vector3.h"
+#include "util/instrument.h"
+
+struct StandardCalibration {
+
+  int index_base, index_temp_ch;
+  template <std::size_t N>
+  struct calibration_info_t {
+    float_sylph_t bias_tc[N];
+    float_sylph_t bias_base[N];
+    float_sylph_t sf[N];
+    float_sylph_t alignment[N][N];
+    float_sylph_t sigma[N];
+  };
+  calibration_info_t<3> accel, gyro;
+
+  /**
+   * Calibration of a sensor as a single affine transformation,
+   * res = gain * raw - offset - offset_tc * temperature,
+   * which is precomputed from bias, scale factor and misalignment.
+   */
+  struct composite_t {
+    float_sylph_t gain[3][3];
+    float_sylph_t offset[3];
+    float_sylph_t offset_tc[3];
+    composite_t() {}
+    composite_t(const calibration_info_t<3> &info) {
+      for(int i(0); i < 3; i++){
+        offset[i] = offset_tc[i] = 0;
+        for(int j(0); j < 3; j++){
+          gain[i][j] = info.alignment[i][j] / info.sf[j];
+          offset[i] += gain[i][j] * info.bias_base[j];
+          offset_tc[i] += gain[i][j] * info.bias_tc[j];
+        }
+      }
+    }
+  };
+  composite_t accel_composite, gyro_composite; ///< updated by check_spec()
+
+  static const char *get_value(const char *spec, const char *key){
+    int offset(std::strlen(key));
+    if(std::strncmp(spec, key, offset) != 0){return NULL;}
+    if((spec[offset] == '\0') || std::isgraph(spec[offset])){return NULL;} // no value or different key.
+    while(spec[++offset] != '\0'){
+      if(std::isgraph(spec[offset])){return &spec[offset];}
+    }
+    return NULL; // no value
+  }
+
+  bool check_spec_item(const char *line){
+    const char *value;
+    if(value = get_value(line, "index_base")){
+      index_base = std::atoi(value);
+      return true;
+    }
+    if(value = get_value(line, "index_temp_ch")){
+      index_temp_ch = std::atoi(value);
+      return true;
+    }
+#define TO_STRING(name) # name
+#define make_proc1(name, sensor, item) \
+if(value = get_value(line, TO_STRING(name))){ \
+  std::cerr << TO_STRING(name) << ":"; \
+  char *spec(const_cast<char *>(value)); \
+  for(int i(0); i < 3; i++){ \
+    sensor.item[i] = std::strtod(spec, &spec); \
+    std::cerr << " " << sensor.item[i]; \
+  } \
+  std::cerr << std::endl; \
+  return true; \
+}
+#define make_proc2(name, sensor, item) \
+if(value = get_value(line, TO_STRING(name))){ \
+  std::cerr << TO_STRING(name) << ": {"; \
+  char *spec(const_cast<char *>(value)); \
+  for(int i(0); i < 3; i++){ \
+    for(int j(0); j < 3; j++){ \
+      sensor.item[i][j] = std::strtod(spec, &spec); \
+    } \
+    std::cerr \
+        << std::endl << "{" \
+        << sensor.item[i][0] << ", " \
+        << sensor.item[i][1] << ", " \
+        << sensor.item[i][2] << "}"; \
+  } \
+  std::cerr << "}" << std::endl; \
+  return true; \
+}
+    make_proc1(acc_bias_tc, accel, bias_tc);
+    make_proc1(acc_bias, accel, bias_base);
+    make_proc1(acc_sf, accel, sf);
+    make_proc2(acc_mis, accel, alignment);
+    make_proc1(gyro_bias_tc, gyro, bias_tc);
+    make_proc1(gyro_bias, gyro, bias_base);
+    make_proc1(gyro_sf, gyro, sf);
+    make_proc2(gyro_mis, gyro, alignment);
+    make_proc1(sigma_accel, accel, sigma);
+    make_proc1(sigma_gyro, gyro, sigma);
+#undef make_proc1
+#undef make_proc2
+#undef TO_STRING
+
+    return false;
+  }
+
+  bool check_spec(const char *line){
+    if(!check_spec_item(line)){return false;}
+    accel_composite = composite_t(accel);
+    gyro_composite = composite_t(gyro);
+    return true;
+  }
+
+  /**
+   * Read a calibration file, each line of which is a spec of check_spec().
+   */
+  void load(std::istream &in){
+    char buf[1024];
+    while(!in.eof()){
+      in.getline(buf, sizeof(buf));
+      check_spec(buf);
+    }
+  }
+
+  template <class NumType, std::size_t N>
+  static void calibrate(
+      const NumType raw[],
+      const NumType &bias_mod,
+      const calibration_info_t<N> &info,
+      float_sylph_t (&res)[N]) {
+
+    // Temperature compensation
+    float_sylph_t bias[N];
+    for(int i(0); i < N; i++){
+      bias[i] = info.bias_base[i] + (info.bias_tc[i] * bias_mod);
+    }
+
+    // Convert raw values to physical quantity by using scale factor
+    float_sylph_t tmp[N];
+    for(int i(0); i < N; i++){
+      tmp[i] = (((float_sylph_t)raw[i] - bias[i]) / info.sf[i]);
+    }
+
+    // Misalignment compensation
+    for(int i(0); i < N; i++){
+      res[i] = 0;
+      for(int j(0); j < N; j++){
+        res[i] += info.alignment[i][j] * tmp[j];
+      }
+    }
+  }
+
+  /**
+   * Calibrate samples in batch with a composite calibration.
+   *
+   * @param info composite calibration
+   * @param raw raw values of X, Y and Z channels, each of which has n samples
+   * @param temperature raw values of temperature channel
+   * @param n number of samples
+   * @param res calibrated values of X, Y and Z, each of which has n samples
+   */
+  template <class FloatT>
+  static void calibrate(
+      const composite_t &info,
+      const int *const (&raw)[3], const int *temperature, const std::size_t &n,
+      FloatT *const (&res)[3]) {
+    for(std::size_t k(0); k < n; k++){
+      for(int i(0); i < 3; i++){
+        res[i][k] = (FloatT)(info.gain[i][0] * raw[0][k]
+            + info.gain[i][1] * raw[1][k]
+            + info.gain[i][2] * raw[2][k]
+            - (info.offset[i] + info.offset_tc[i] * temperature[k]));
+      }
+    }
+  }
+
+  /**
+   * Calibrate samples in batch with a composite calibration by using SIMD instructions,
+   * AVX (4 samples at once) or SSE2 (2 samples) when enabled by the compiler.
+   *
+   * @see calibrate(const composite_t &, const int *const (&)[3], const int *, const std::size_t &, FloatT *const (&)[3])
+   */
+  static void calibrate(
+      const composite_t &info,
+      const int *const (&raw)[3], const int *temperature, const std::size_t &n,
+      double *const (&res)[3]) {
+    std::size_t k(0);
+#if defined(CALIBRATION_SIMD_AVX)
+    for(; k + 4 <= n; k += 4){
+      __m256d x[3], t(_mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)&temperature[k])));
+      for(int j(0); j < 3; j++){
+        x[j] = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)&raw[j][k]));
+      }
+      for(int i(0); i < 3; i++){
+        __m256d sum(_mm256_add_pd(
+            _mm256_add_pd(
+              _mm256_mul_pd(_mm256_set1_pd(info.gain[i][0]), x[0]),
+              _mm256_mul_pd(_mm256_set1_pd(info.gain[i][1]), x[1])),
+            _mm256_mul_pd(_mm256_set1_pd(info.gain[i][2]), x[2])));
+        __m256d offset(_mm256_add_pd(
+            _mm256_set1_pd(info.offset[i]),
+            _mm256_mul_pd(_mm256_set1_pd(info.offset_tc[i]), t)));
+        _mm256_storeu_pd(&res[i][k], _mm256_sub_pd(sum, offset));
+      }
+    }
+#elif defined(CALIBRATION_SIMD_SSE2)
+    for(; k + 2 <= n; k += 2){
+      __m128d x[3], t(_mm_cvtepi32_pd(_mm_loadl_epi64((const __m128i *)&temperature[k])));
+      for(int j(0); j < 3; j++){
+        x[j] = _mm_cvtepi32_pd(_mm_loadl_epi64((const __m128i *)&raw[j][k]));
+      }
+      for(int i(0); i < 3; i++){
+        __m128d sum(_mm_add_pd(
+            _mm_add_pd(
+              _mm_mul_pd(_mm_set1_pd(info.gain[i][0]), x[0]),
+              _mm_mul_pd(_mm_set1_pd(info.gain[i][1]), x[1])),
+            _mm_mul_pd(_mm_set1_pd(info.gain[i][2]), x[2])));
+        __m128d offset(_mm_add_pd(
+            _mm_set1_pd(info.offset[i]),
+            _mm_mul_pd(_mm_set1_pd(info.offset_tc[i]), t)));
+        _mm_storeu_pd(&res[i][k], _mm_sub_pd(sum, offset));
+      }
+    }
+#endif
+    if(k < n){ // remaining samples
+      const int *const raw_remain[3] = {&raw[0][k], &raw[1][k], &raw[2][k]};
+      double *const res_remain[3] = {&res[0][k], &res[1][k], &res[2][k]};
+      calibrate<double>(info, raw_remain, &temperature[k], n - k, res_remain);
+    }
+  }
+
+  /**
+   * Samples in structure of arrays (SoA) layout for batch calibration.
+   */
+  struct batch_t {
+    std::vector<int> raw[7]; ///< accelerometer X, Y, Z, gyro X, Y, Z and temperature
+    std::vector<float_sylph_t> accel[3], gyro[3]; ///< results
+    std::size_t size() const {return raw[6].size();}
+    bool empty() const {return raw[6].empty();}
+    void clear(){
+      for(int i(0); i < 7; i++){raw[i].clear();}
+    }
+    Vector3<float_sylph_t> get_accel(const std::size_t &index) const {
+      return Vector3<float_sylph_t>(accel[0][index], accel[1][index], accel[2][index]);
+    }
+    Vector3<float_sylph_t> get_gyro(const std::size_t &index) const {
+      return Vector3<float_sylph_t>(gyro[0][index], gyro[1][index], gyro[2][index]);
+    }
+  };
+
+  /**
+   * Append a sample to a batch.
+   *
+   * @param batch batch
+   * @param raw_data raw values of all channels
+   */
+  void push_back(batch_t &batch, const int *raw_data) const {
+    for(int i(0); i < 6; i++){
+      batch.raw[i].push_back(raw_data[index_base + i]);
+    }
+    batch.raw[6].push_back(raw_data[index_temp_ch]);
+  }
+
+  /**
+   * Calibrate all samples of a batch with the composite calibrations,
+   * whose results are stored in batch.accel and batch.gyro.
+   * They may be different from ones of raw2accel() and raw2gyro() by rounding errors.
+   */
+  void calibrate(batch_t &batch) const {
+    INSTRUMENT_SCOPE("calibration_batch");
+    const std::size_t n(batch.size());
+    if(n == 0){return;}
+    for(int i(0); i < 3; i++){
+      batch.accel[i].resize(n);
+      batch.gyro[i].resize(n);
+    }
+    {
+      const int *const raw[3] = {&batch.raw[0][0], &batch.raw[1][0], &batch.raw[2][0]};
+      float_sylph_t *const res[3] = {&batch.accel[0][0], &batch.accel[1][0], &batch.accel[2][0]};
+      calibrate(accel_composite, raw, &batch.raw[6][0], n, res);
+    }
+    {
+      const int *const raw[3] = {&batch.raw[3][0], &batch.raw[4][0], &batch.raw[5][0]};
+      float_sylph_t *const res[3] = {&batch.gyro[0][0], &batch.gyro[1][0], &batch.gyro[2][0]};
+      calibrate(gyro_composite, raw, &batch.raw[6][0], n, res);
+    }
+  }
+
+  StandardCalibration() {}
+  ~StandardCalibration() {}
+
+  /**
+   * Set NinjaScan default calibration parameters
+   */
+  void set_default(){
+#define config(spec) check_spec(spec);
+    config("index_base 0");
+    config("index_temp_ch 8");
+    config("acc_bias 32768 32768 32768");
+    config("acc_bias_tc 0 0 0"); // No temperature compensation
+    config("acc_sf 4.1767576e+2 4.1767576e+2 4.1767576e+2"); // MPU-6000/9250 8[G] full scale; (1<<15)/(8*9.80665) [1/(m/s^2)]
+    config("acc_mis 1 0 0 0 1 0 0 0 1"); // No misalignment compensation
+    config("gyro_bias 32768 32768 32768");
+    config("gyro_bias_tc 0 0 0"); // No temperature compensation
+    config("gyro_sf 9.3873405e+2 9.3873405e+2 9.3873405e+2"); // MPU-6000/9250 2000[dps] full scale; (1<<15)/(2000/180*PI) [1/(rad/s)]
+    config("gyro_mis 1 0 0 0 1 0 0 0 1"); // No misalignment compensation
+    config("sigma_accel 0.05 0.05 0.05"); // approx. 150[mG] ? standard deviation
+    config("sigma_gyro 5e-3 5e-3 5e-3"); // approx. 0.3[dps] standard deviation
+#undef config
+  }
+
+  /**
+   * Get acceleration in m/s^2
+   */
+  Vector3<float_sylph_t> raw2accel(const int *raw_data) const{
+    INSTRUMENT_SCOPE("calibration_accel");
+    float_sylph_t res[3];
+    calibrate(
+        &raw_data[index_base], raw_data[index_temp_ch],
+        accel, res);
+    return Vector3<float_sylph_t>(res[0], res[1], res[2]);
+  }
+
+  /**
+   * Get angular speed in rad/sec
+   */
+  Vector3<float_sylph_t> raw2gyro(const int *raw_data) const{
+    INSTRUMENT_SCOPE("calibration_gyro");
+    float_sylph_t res[3];
+    calibrate(
+        &raw_data[index_base + 3], raw_data[index_temp_ch],
+        gyro, res);
+    return Vector3<float_sylph_t>(res[0], res[1], res[2]);
+  }
+
+  /**
+   * Accelerometer output variance in [m/s^2]^2
+   */
+  Vector3<float_sylph_t> sigma_accel() const{
+    return Vector3<float_sylph_t>(accel.sigma[0], accel.sigma[1], accel.sigma[2]);
+  }
+
+  /**
+   * Angular speed output variance in X, Y, Z axes, [rad/s]^2
+   */
+  Vector3<float_sylph_t> sigma_gyro() const{
+    return Vector3<float_sylph_t>(gyro.sigma[0], gyro.sigma[1], gyro.sigma[2]);
+  }
+};
+
+#endif /* __CALIBRATION_H__ */
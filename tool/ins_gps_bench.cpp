@@ -0,0 +1,446 @@
+/**
+ * @file Benchmark of INS/GPS integration per GPS epoch
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Usage: (exe) [--min_time=sec] [--filter=name] [--accuracy]
+ *
+ * The results are written to stdout as CSV:
+ *   bench, filter, states, mode, iterations, ns_per_op, allocs_per_op
+ * where mode is "batch" (joint update with the inverse of H P H^T + R)
+ * or "sequential" (each row of z is processed as a scalar measurement).
+ * "batch/K" means that the covariance time update is performed every K IMU samples
+ * (predict_interval() = K; 0 means only before the measurement update).
+ * For UnscentedKalmanFilter, mode is "serial" or "parallel" evaluation of the sigma points;
+ * "parallel" is effective only when built with OpenMP, for example,
+ *   make bench CPPFLAGS=-fopenmp LFLAGS=-fopenmp
+ *
+ * One operation of the "epoch" benchmarks is a time update over a GPS interval (1 s)
+ * followed by a measurement update of a stationary vehicle,
+ * so that the filter stays in steady state. "time_update" is the time update only,
+ * therefore the cost of the measurement update itself is their difference.
+ * "imu_epoch" is 100 time updates at 100 Hz followed by a measurement update.
+ * One operation of "calibration" is the calibration of 1000 IMU samples,
+ * whose mode is "scalar" (raw2accel() and raw2gyro() for each sample)
+ * or "batch" (StandardCalibration::calibrate() with SIMD instructions).
+ *
+ * With --accuracy, instead of the benchmarks, the multi-rate covariance time update
+ * is compared with the per-sample one, see Accuracy.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "navigation/INS_GPS2.h"
+#include "navigation/INS_GPS_BE.h"
+
+typedef double float_sylph_t;
+#include "calibration.h"
+
+#include "bench_common.h"
+
+struct Options : public BenchOptions {
+  bool accuracy;
+  Options() : BenchOptions(), accuracy(false) {}
+
+  bool check_spec(const char *spec){
+    if(std::strcmp(spec, "--accuracy") == 0){
+      accuracy = true;
+      return true;
+    }
+    return BenchOptions::check_spec(spec);
+  }
+} options;
+
+static const double gps_interval(1); // [s]
+static const double imu_interval(1E-2); // [s]
+
+static double deg2rad(const double &degrees){return degrees * M_PI / 180;}
+
+template <class INS_GPS>
+struct Epoch {
+  INS_GPS nav;
+  Vector3<double> accel, gyro;
+  GPS_UBLOX_3D<double> gps;
+  Vector3<double> lever_arm;
+  LCG rand;
+
+  Epoch(const bool &sequential, const unsigned int &predict_interval = 1)
+      : nav(), accel(0, 0, -9.80665), gyro(), lever_arm(0.5, 0, -0.2), rand(1) {
+    nav.sequential_correct() = sequential;
+    nav.predict_interval() = predict_interval;
+    nav.initPosition(deg2rad(35), deg2rad(139), 0);
+    nav.initVelocity(0, 0, 0);
+    nav.initAttitude(0, 0, 0);
+    {
+      Matrix<double> P(nav.getFilter().getP());
+      P(0, 0) = P(1, 1) = P(2, 2) = 1E+1;
+      P(3, 3) = P(4, 4) = P(5, 5) = 1E-8;
+      P(6, 6) = 1E+2;
+      P(7, 7) = P(8, 8) = P(9, 9) = 1E-4;
+      for(unsigned int i(10); i < P.rows(); i++){P(i, i) = 1E-4;}
+      nav.getFilter().setP(P);
+    }
+    {
+      Matrix<double> Q(nav.getFilter().getQ());
+      for(unsigned int i(0); i < 3; i++){Q(i, i) = 1E-4;}
+      for(unsigned int i(3); i < Q.rows(); i++){Q(i, i) = 1E-6;}
+      nav.getFilter().setQ(Q);
+    }
+    gps.v_n = gps.v_e = gps.v_d = 0;
+    gps.sigma_vel = 0.5;
+    gps.latitude = deg2rad(35);
+    gps.longitude = deg2rad(139);
+    gps.height = 0;
+    gps.sigma_2d = 3;
+    gps.sigma_height = 5;
+  }
+
+  void time_update(){
+    nav.update(accel, gyro, gps_interval);
+  }
+
+  struct time_update_op {
+    Epoch &e;
+    time_update_op(Epoch &_e) : e(_e) {}
+    double operator()() const {
+      e.time_update();
+      return e.nav[0];
+    }
+  };
+  struct gps_op {
+    Epoch &e;
+    gps_op(Epoch &_e) : e(_e) {}
+    double operator()() const {
+      e.time_update();
+      e.gps.v_n = e.rand() * 0.1; // small perturbation
+      e.nav.correct(e.gps);
+      return e.nav[0];
+    }
+  };
+  struct gps_lever_arm_op {
+    Epoch &e;
+    gps_lever_arm_op(Epoch &_e) : e(_e) {}
+    double operator()() const {
+      e.time_update();
+      e.gps.v_n = e.rand() * 0.1;
+      e.nav.correct(e.gps, e.lever_arm, e.gyro);
+      return e.nav[0];
+    }
+  };
+  struct imu_op {
+    Epoch &e;
+    imu_op(Epoch &_e) : e(_e) {}
+    double operator()() const {
+      for(int i(0); i < (int)(gps_interval / imu_interval); i++){
+        e.nav.update(e.accel, e.gyro, imu_interval);
+      }
+      e.gps.v_n = e.rand() * 0.1;
+      e.nav.correct(e.gps);
+      return e.nav[0];
+    }
+  };
+  struct yaw_op {
+    Epoch &e;
+    yaw_op(Epoch &_e) : e(_e) {}
+    double operator()() const {
+      e.time_update();
+      e.nav.correct_yaw(e.rand() * 1E-2, 1E-4);
+      return e.nav[0];
+    }
+  };
+
+  static void run_all(const char *filter_name){
+    const bool modes[] = {false, true};
+    for(unsigned int i(0); i < sizeof(modes) / sizeof(modes[0]); i++){
+      std::stringstream params;
+      params << filter_name << ", "
+          << INS_GPS::P_SIZE << ", "
+          << (modes[i] ? "sequential" : "batch");
+      {
+        Epoch e(modes[i]);
+        run_bench<double>(options, "time_update", params.str(), time_update_op(e));
+      }
+      {
+        Epoch e(modes[i]);
+        run_bench<double>(options, "gps_epoch", params.str(), gps_op(e));
+      }
+      {
+        Epoch e(modes[i]);
+        run_bench<double>(options, "gps_epoch_lever_arm", params.str(), gps_lever_arm_op(e));
+      }
+      {
+        Epoch e(modes[i]);
+        run_bench<double>(options, "yaw_epoch", params.str(), yaw_op(e));
+      }
+      {
+        Epoch e(modes[i]);
+        run_bench<double>(options, "imu_epoch", params.str(), imu_op(e));
+      }
+    }
+    const unsigned int intervals[] = {10, 100, 0};
+    for(unsigned int i(0); i < sizeof(intervals) / sizeof(intervals[0]); i++){
+      std::stringstream params;
+      params << filter_name << ", "
+          << INS_GPS::P_SIZE << ", "
+          << "batch/" << intervals[i];
+      Epoch e(false, intervals[i]);
+      run_bench<double>(options, "imu_epoch", params.str(), imu_op(e));
+    }
+  }
+};
+
+/**
+ * Accuracy of the multi-rate covariance time update against the per-sample one.
+ * The same inputs of a maneuvering vehicle (100 Hz IMU, 1 Hz GPS, 60 s) are
+ * given to the filters with various predict_interval(), and the worst differences
+ * from predict_interval() = 1 just after the measurement updates are written as CSV:
+ *   filter, states, predict_interval, sigma_error, velocity_error, heading_error
+ * where sigma_error is the maximum relative error of the standard deviations,
+ * i.e., square roots of the diagonal of P, velocity_error is in m/s, and heading_error is in deg.
+ */
+template <class INS_GPS>
+struct Accuracy {
+  struct result_t {
+    std::vector<double> sigma;
+    double v[3], heading;
+  };
+  typedef std::vector<result_t> results_t;
+
+  static results_t run(const unsigned int &predict_interval){
+    Epoch<INS_GPS> e(false, predict_interval);
+    results_t res;
+    double t(0);
+    for(int epoch(0); epoch < 60; epoch++){
+      for(int i(0); i < (int)(gps_interval / imu_interval); i++, t += imu_interval){
+        Vector3<double>
+            accel(0.5 * std::sin(t * 0.5), 0.2 * std::cos(t * 0.3), -9.80665),
+            gyro(0.05 * std::sin(t * 2), 0.02 * std::cos(t), 0.1);
+        e.nav.update(accel, gyro, imu_interval);
+      }
+      e.gps.v_n = e.rand() * 0.1;
+      e.gps.v_e = e.rand() * 0.1;
+      e.nav.correct(e.gps);
+      result_t item;
+      Matrix<double> P(e.nav.getFilter().getP());
+      for(unsigned int i(0); i < P.rows(); i++){
+        item.sigma.push_back(std::sqrt(P(i, i)));
+      }
+      item.v[0] = e.nav.v_north();
+      item.v[1] = e.nav.v_east();
+      item.v[2] = e.nav.v_down();
+      item.heading = e.nav.heading();
+      res.push_back(item);
+    }
+    return res;
+  }
+
+  static void run_all(const char *filter_name){
+    results_t reference(run(1));
+    const unsigned int intervals[] = {1, 2, 5, 10, 20, 50, 100, 0};
+    for(unsigned int i(0); i < sizeof(intervals) / sizeof(intervals[0]); i++){
+      results_t target(run(intervals[i]));
+      double sigma_error(0), velocity_error(0), heading_error(0);
+      for(unsigned int j(0); j < reference.size(); j++){
+        for(unsigned int k(0); k < reference[j].sigma.size(); k++){
+          sigma_error = std::max(sigma_error,
+              std::abs(target[j].sigma[k] / reference[j].sigma[k] - 1));
+        }
+        for(unsigned int k(0); k < 3; k++){
+          velocity_error = std::max(velocity_error,
+              std::abs(target[j].v[k] - reference[j].v[k]));
+        }
+        double heading_diff(target[j].heading - reference[j].heading);
+        heading_diff -= 2 * M_PI * std::floor(heading_diff / (2 * M_PI) + 0.5);
+        heading_error = std::max(heading_error, std::abs(heading_diff) * 180 / M_PI);
+      }
+      std::cout << filter_name << ", "
+          << INS_GPS::P_SIZE << ", "
+          << intervals[i] << ", "
+          << sigma_error << ", "
+          << velocity_error << ", "
+          << heading_error << std::endl;
+    }
+  }
+};
+
+/**
+ * Time update of UnscentedKalmanFilter with the INS mechanization as the system equation,
+ * whose cost is dominated by 2n+1 mechanization steps per IMU sample.
+ */
+struct UKF_Epoch {
+  struct input_t {
+    double accel[3], gyro[3];
+    double deltaT;
+  };
+  /**
+   * System equation, which must be safe to be called from multiple threads.
+   * Therefore vectors are constructed from the plain input in each call.
+   */
+  struct time_update_t {
+    INS<double> operator()(INS<double> &x, input_t &u) const {
+      INS<double> res(x, true);
+      res.update(
+          Vector3<double>(u.accel[0], u.accel[1], u.accel[2]),
+          Vector3<double>(u.gyro[0], u.gyro[1], u.gyro[2]),
+          u.deltaT);
+      return res;
+    }
+    INS<double> operator()(INS<double> &x, input_t &u, const Matrix<double> &sqrtQ) const {
+      return (*this)(x, u);
+    }
+  };
+
+  UnscentedKalmanFilter<double> ukf;
+  INS<double> x;
+  input_t u;
+  time_update_t f;
+
+  UKF_Epoch(const bool &parallel)
+      : ukf(Matrix<double>::getI(unsigned(INS<double>::STATE_VALUES)) * 1E-4,
+          Matrix<double>::getI(6) * 1E-6),
+        x(), f() {
+    ukf.parallel() = parallel;
+    x.initPosition(deg2rad(35), deg2rad(139), 0);
+    input_t _u = {{0, 0, -9.80665}, {0, 0, 0}, 1E-2};
+    u = _u;
+  }
+
+  struct predict_op {
+    UKF_Epoch &e;
+    predict_op(UKF_Epoch &_e) : e(_e) {}
+    double operator()() const {
+      e.ukf.predict(e.f, e.x, e.u);
+      return e.x[0];
+    }
+  };
+
+  static void run_all(){
+    const bool modes[] = {false, true};
+    for(unsigned int i(0); i < sizeof(modes) / sizeof(modes[0]); i++){
+      std::stringstream params;
+      params << "UKF, " << INS<double>::STATE_VALUES << ", "
+          << (modes[i] ? "parallel" : "serial");
+      UKF_Epoch e(modes[i]);
+      run_bench<double>(options, "ukf_time_update", params.str(), predict_op(e));
+    }
+  }
+};
+
+struct Calibration {
+  static const unsigned int samples = 1000;
+  StandardCalibration calibration;
+  std::vector<int> raw; ///< samples x 9 channels
+  StandardCalibration::batch_t batch;
+
+  Calibration() : calibration(), raw(samples * 9), batch() {
+    calibration.set_default();
+    LCG rand;
+    for(unsigned int i(0); i < raw.size(); i++){
+      raw[i] = 32768 + (int)(rand() * 4096);
+    }
+  }
+
+  struct scalar_op {
+    Calibration &e;
+    scalar_op(Calibration &_e) : e(_e) {}
+    double operator()() const {
+      double res(0);
+      for(unsigned int i(0); i < samples; i++){
+        res += e.calibration.raw2accel(&e.raw[i * 9])[0];
+        res += e.calibration.raw2gyro(&e.raw[i * 9])[0];
+      }
+      return res;
+    }
+  };
+  struct batch_op {
+    Calibration &e;
+    batch_op(Calibration &_e) : e(_e) {}
+    double operator()() const {
+      e.batch.clear();
+      for(unsigned int i(0); i < samples; i++){
+        e.calibration.push_back(e.batch, &e.raw[i * 9]);
+      }
+      e.calibration.calibrate(e.batch);
+      return e.batch.accel[0][0] + e.batch.gyro[0][0];
+    }
+  };
+
+  static void run_all(){
+    Calibration e;
+    run_bench<double>(options, "calibration", "Standard, 6, scalar", scalar_op(e));
+    run_bench<double>(options, "calibration", "Standard, 6, batch", batch_op(e));
+  }
+};
+
+template <template <class> class Filter>
+void run_filter(const char *filter_name){
+  if(options.accuracy){
+    Accuracy<INS_GPS2<double, Filter<double> > >::run_all(filter_name);
+    Accuracy<INS_GPS2_BiasEstimated<double, Filter<double> > >::run_all(filter_name);
+    return;
+  }
+  Epoch<INS_GPS2<double, Filter<double> > >::run_all(filter_name);
+  Epoch<INS_GPS2_BiasEstimated<double, Filter<double> > >::run_all(filter_name);
+}
+
+int main(int argc, char *argv[]){
+  for(int arg_index(1); arg_index < argc; arg_index++){
+    if(options.check_spec(argv[arg_index])){continue;}
+    std::cerr << "(error!) Unknown option: " << argv[arg_index] << std::endl;
+    return -1;
+  }
+
+  std::cout << std::setprecision(6);
+  if(options.accuracy){
+    std::cout << "filter, states, predict_interval, sigma_error, velocity_error, heading_error" << std::endl;
+    run_filter<KalmanFilter>("KF");
+    run_filter<KalmanFilterUD>("UD");
+    return 0;
+  }
+  std::cout << "bench, filter, states, mode, iterations, ns_per_op, allocs_per_op" << std::endl;
+  run_filter<KalmanFilter>("KF");
+  run_filter<KalmanFilterUD>("UD");
+  run_filter<KalmanFilterJoseph>("Joseph");
+  run_filter<KalmanFilterSquareRoot>("SquareRoot");
+  UKF_Epoch::run_all();
+  Calibration::run_all();
+
+  return 0;
+}
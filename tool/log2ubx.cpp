@@ -31,7 +31,7 @@
 
 #if defined(_MSC_VER) && _MSC_VER >= 1400
 #define _USE_MATH_DEFINES
-//#define _CRT_SECURE_NO_WARNINGS // sprintf_sւ̐~߂
+//#define _CRT_SECURE_NO_WARNINGS // sprintf_s等への推奨を止める
 #endif
 
 #include <iostream>
@@ -53,17 +53,17 @@ typedef double float_sylph_t;
 
 struct Options : public GlobalOptions<float_sylph_t> {
   typedef GlobalOptions<float_sylph_t> super_t;
-  bool log_is_ubx; ///< ubx2ubx邽߂̃tO
+  bool log_is_ubx; ///< ubx2ubxを実現するためのフラグ
   
   Options()
       : super_t(), log_is_ubx(false) {}
   ~Options(){}
   
   /**
-   * R}hɗ^ꂽݒǂ݉
+   * コマンドに与えられた設定を読み解く
    * 
-   * @param spec R}h
-   * @return (bool) ǂɃqbgꍇtrueAȂfalse
+   * @param spec コマンド
+   * @return (bool) 解読にヒットした場合はtrue、さもなければfalse
    */
   bool check_spec(const char *spec){
     using std::cerr;
@@ -109,17 +109,17 @@ double itow_0x0106(0);
 bool read_continue(true);
 
 /**
- * Gy[W(u-bloxGPS)̏p֐
- * Gy[W̓evalidateŊmFAsƁB
- * {class, id} = {0x01, 0x02}̂Ƃʒu
- * {class, id} = {0x01, 0x12}̂Ƃx
- * {class, id} = {0x01, 0x03}̂ƂM@
- * {class, id} = {0x01, 0x04}̂ƂDOP
- * {class, id} = {0x01, 0x06}̂Ƃ
- * {class, id} = {0x01, 0x30}̂Ƃq
- * {class, id} = {0x02, 0x10}̂Ƃ
+ * Gページ(u-bloxのGPS)の処理用関数
+ * Gページの内容が正しいかvalidateで確認した後、実処理を行うこと。
+ * {class, id} = {0x01, 0x02}のとき位置情報
+ * {class, id} = {0x01, 0x12}のとき速度情報
+ * {class, id} = {0x01, 0x03}のとき受信機状態
+ * {class, id} = {0x01, 0x04}のときDOP
+ * {class, id} = {0x01, 0x06}のとき解情報
+ * {class, id} = {0x01, 0x30}のとき衛星情報
+ * {class, id} = {0x02, 0x10}のとき生情報
  * 
- * @param obsrever Gy[W̃IuU[o[
+ * @param obsrever Gページのオブザーバー
  */
 void g_packet_handler(const G_Observer_t &observer){
   if(!observer.validate()){
@@ -147,9 +147,9 @@ void g_packet_handler(const G_Observer_t &observer){
 }
 
 /**
- * t@C̃Xg[y[WPʂŐ؂o֐
+ * ファイル等のストリームからページ単位で切り出す関数
  * 
- * @param in Xg[
+ * @param in ストリーム
  */
 void stream_processor(istream &in){
   char buffer[PAGE_SIZE];
@@ -162,8 +162,8 @@ void stream_processor(istream &in){
     read_count_max--;
   }
 
-  Processor_t processor(OBSERVER_SIZE);       // Xg[@𐶐
-  processor.set_g_handler(g_packet_handler);  // Gy[W̍ۂ̏o^
+  Processor_t processor(OBSERVER_SIZE);       // ストリーム処理機を生成
+  processor.set_g_handler(g_packet_handler);  // Gページの際の処理を登録
   
   int count(0);
 
@@ -203,7 +203,7 @@ int main(int argc, char *argv[]){
   
   options._out = NULL;
 
-  // ftHg̏o͐̎w
+  // デフォルトの出力先の指定
   if(!options._out){
     string out_fname(argv[1]);
     string::size_type index = out_fname.find_last_of('.');
@@ -215,7 +215,7 @@ int main(int argc, char *argv[]){
     options._out = &(options.spec2ostream(out_fname.c_str(), true));
   }
   
-  // SylphideProtocolŒĂꍇ͂ɑΉ
+  // SylphideProtocolで着ていた場合はそれに対応
   if(options.in_sylphide){
     SylphideIStream sylphide_in(options.spec2istream(argv[log_index]), PAGE_SIZE);
     stream_processor(sylphide_in);
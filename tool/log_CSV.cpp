@@ -31,7 +31,7 @@
 
 #if defined(_MSC_VER) && _MSC_VER >= 1400
 #define _USE_MATH_DEFINES
-//#define _CRT_SECURE_NO_WARNINGS // sprintf_sւ̐~߂
+//#define _CRT_SECURE_NO_WARNINGS // sprintf_s等への推奨を止める
 typedef __int64 int64_t;
 #endif
 
@@ -49,6 +49,7 @@ typedef __int64 int64_t;
 
 typedef double float_sylph_t;
 #include "analyze_common.h"
+#include "calibration.h"
 
 using namespace std;
 
@@ -61,7 +62,9 @@ struct Options : public GlobalOptions<float_sylph_t> {
   bool page_M;
   bool page_N;
   bool page_other;
-  int page_P_mode, page_F_mode, page_M_mode;
+  int page_A_mode, page_P_mode, page_F_mode, page_M_mode;
+  StandardCalibration calibration; ///< for calibrated outputs of A page
+  const char *calib_file; ///< IMU calibration file, same as INS_GPS
   int debug_level;
   struct {
     bool valid;
@@ -76,9 +79,11 @@ struct Options : public GlobalOptions<float_sylph_t> {
       page_A(false), page_G(false), page_F(false), 
       page_P(false), page_M(false), page_N(false),
       page_other(false),
+      page_A_mode(0),
       page_P_mode(5),
       page_F_mode(3),
       page_M_mode(0),
+      calibration(), calib_file(NULL),
       debug_level(0),
       use_calendar_time(false), localtime_correction_in_seconds(0) {
     gps_utc.valid = false;
@@ -111,10 +116,10 @@ struct Options : public GlobalOptions<float_sylph_t> {
   }
 
   /**
-   * R}hɗ^ꂽݒǂ݉
+   * コマンドに与えられた設定を読み解く
    * 
-   * @param spec R}h
-   * @return (bool) ǂɃqbgꍇtrueAȂfalse
+   * @param spec コマンド
+   * @return (bool) 解読にヒットした場合はtrue、さもなければfalse
    */
   bool check_spec(const char *spec){
 #define CHECK_OPTION(name, novalue, operation, disp) { \
@@ -125,6 +130,12 @@ struct Options : public GlobalOptions<float_sylph_t> {
     return true; \
   } \
 }
+    CHECK_OPTION(page_A_mode, false, // 1: calibrated acceleration [m/s^2] and angular speed [rad/s]
+        page_A_mode = atoi(value),
+        page_A_mode);
+    CHECK_OPTION(calib_file, false,
+        calib_file = value,
+        calib_file);
     CHECK_OPTION(page_P_mode, false,
         page_P_mode = atoi(value),
         page_P_mode);
@@ -200,25 +211,68 @@ class StreamProcessor : public SylphideProcessor<float_sylph_t> {
   
   public:
     /**
-     * Ay[W(ADϊ)̏p֐
-     * Ay[W̓evalidateŊmFAsƁB
+     * Aページ(AD変換結果)の処理用関数
+     * Aページの内容が正しいかvalidateで確認した後、実処理を行うこと。
      * 
-     * @param obsrever Ay[W̃IuU[o[
+     * @param obsrever Aページのオブザーバー
      */
     struct HandlerA {
       int count;
-      HandlerA() : count(0) {}
+      StandardCalibration::batch_t batch; ///< samples to be calibrated (page_A_mode = 1)
+      vector<float_sylph_t> batch_itow;
+      static const unsigned int batch_size = 0x100;
+      HandlerA() : count(0), batch(), batch_itow() {}
+      
+      /**
+       * 較正待ちのサンプルをまとめて較正して出力する
+       */
+      void flush(){
+        if(batch.empty()){return;}
+        options.calibration.calibrate(batch);
+        INSTRUMENT_SCOPE("output");
+        INSTRUMENT_COUNT("records", batch.size());
+        for(unsigned int i(0); i < batch.size(); i++){
+          options.out()
+              << (count++) << ", "
+              << options.str_time(batch_itow[i]);
+          for(int j(0); j < 3; j++){
+            options.out() << ", " << batch.accel[j][i];
+          }
+          for(int j(0); j < 3; j++){
+            options.out() << ", " << batch.gyro[j][i];
+          }
+          options.out() << endl;
+        }
+        batch.clear();
+        batch_itow.clear();
+      }
+      
       void operator()(const super_t::A_Observer_t &observer){
         if(!observer.validate()){return;}
         
         float_sylph_t current(StreamProcessor::get_corrected_ITOW(observer));
         if(!options.is_time_in_range(current)){return;}
         
+        A_Observer_t::values_t values(observer.fetch_values());
+        
+        if(options.page_A_mode == 1){ // 較正済みの加速度[m/s^2], 角速度[rad/s]
+          int ch[9];
+          for(int i(0); i < 8; i++){
+            ch[i] = values.values[i];
+          }
+          ch[8] = values.temperature;
+          options.calibration.push_back(batch, ch);
+          batch_itow.push_back(current);
+          if(batch.size() >= batch_size){flush();}
+          return;
+        }
+        
+        INSTRUMENT_SCOPE("output");
+        INSTRUMENT_COUNT("records", 1);
         options.out() 
             << (count++) << ", "
             << options.str_time(current) << ", ";
         
-        A_Observer_t::values_t values(observer.fetch_values());
         for(int i(0); i < 8; i++){
           options.out() << values.values[i] << ", ";
         }
@@ -227,12 +281,12 @@ class StreamProcessor : public SylphideProcessor<float_sylph_t> {
     } handler_A;
     
     /**
-     * Gy[W(u-bloxGPS)̏p֐
-     * Gy[W̓evalidateŊmFAsƁB
-     * {class, id} = {0x01, 0x02}̂Ƃʒu񂪓
-     * {class, id} = {0x01, 0x12}̂Ƃx񂪓
+     * Gページ(u-bloxのGPS)の処理用関数
+     * Gページの内容が正しいかvalidateで確認した後、実処理を行うこと。
+     * {class, id} = {0x01, 0x02}のとき位置情報が得られる
+     * {class, id} = {0x01, 0x12}のとき速度情報が得られる
      * 
-     * @param obsrever Gy[W̃IuU[o[
+     * @param obsrever Gページのオブザーバー
      */
     struct HandlerG {
       unsigned int itow_ms_0x0102, itow_ms_0x0112;
@@ -313,6 +367,8 @@ class StreamProcessor : public SylphideProcessor<float_sylph_t> {
           float_sylph_t current(1E-3 * itow_ms_0x0102);
           if(!options.is_time_in_range(current)){return;}
           
+          INSTRUMENT_SCOPE("output");
+          INSTRUMENT_COUNT("records", 1);
           options.out() << options.str_time(current) << ", "
               << position.latitude << ", "
               << position.longitude << ", "
@@ -328,10 +384,10 @@ class StreamProcessor : public SylphideProcessor<float_sylph_t> {
     } handler_G;
     
     /**
-     * Fy[W(FPGATuVXȅ)̏p֐
-     * Fy[W̓evalidateŊmFAsƁB
+     * Fページ(FPGAサブシステムからの情報)の処理用関数
+     * Fページの内容が正しいかvalidateで確認した後、実処理を行うこと。
      * 
-     * @param obsrever Fy[W̃IuU[o[
+     * @param obsrever Fページのオブザーバー
      */
     struct HandlerF {
       int count;
@@ -348,10 +404,10 @@ class StreamProcessor : public SylphideProcessor<float_sylph_t> {
         F_Observer_t::values_t values(observer.fetch_values());
         for(int i = 0; i < 8; i++){
           //if(values.servo_in[i] < 1000){values.servo_in[i] += 1000;}
-          if(options.page_F_mode & 0x01){ // rbg0͂\
+          if(options.page_F_mode & 0x01){ // ビット0が入力を表示
             options.out() << ", " << values.servo_in[i];
           }
-          if(options.page_F_mode & 0x02){ // rbg1o͂\
+          if(options.page_F_mode & 0x02){ // ビット1が出力を表示
             options.out() << ", " << values.servo_out[i];
           }
         }
@@ -393,10 +449,10 @@ class StreamProcessor : public SylphideProcessor<float_sylph_t> {
       }
 
       /**
-       * Py[W(GAf[^ZT̏)̏p֐
-       * Py[W̓evalidateŊmFAsƁB
+       * Pページ(エアデータセンサからの情報)の処理用関数
+       * Pページの内容が正しいかvalidateで確認した後、実処理を行うこと。
        * 
-       * @param obsrever Fy[W̃IuU[o[
+       * @param obsrever Fページのオブザーバー
        */
       void operator()(const P_Observer_t &observer){
         if(!observer.validate()){return;}
@@ -435,10 +491,10 @@ class StreamProcessor : public SylphideProcessor<float_sylph_t> {
     } handler_P;
     
     /**
-     * My[W(CZT̏)̏p֐
-     * My[W̓evalidateŊmFAsƁB
+     * Mページ(磁気センサからの情報)の処理用関数
+     * Mページの内容が正しいかvalidateで確認した後、実処理を行うこと。
      * 
-     * @param obsrever My[W̃IuU[o[
+     * @param obsrever Mページのオブザーバー
      */
     struct HandlerM {
       void operator()(const M_Observer_t &observer){
@@ -450,7 +506,7 @@ class StreamProcessor : public SylphideProcessor<float_sylph_t> {
         M_Observer_t::values_t values(observer.fetch_values());
 
         switch(options.page_M_mode){
-          case 1: // -atan2(y, x)[deg]\
+          case 1: // -atan2(y, x)した結果[deg]を表示
             for(int i(0), j(-3); i < 4; i++, j++){
               options.out() << options.str_time(current) << ", "
                    << j << ", "
@@ -470,10 +526,10 @@ class StreamProcessor : public SylphideProcessor<float_sylph_t> {
     } handler_M;
     
     /**
-     * Ny[W(q@)̏p֐
-     * Ny[W̓evalidateŊmFAsƁB
+     * Nページ(航法情報)の処理用関数
+     * Nページの内容が正しいかvalidateで確認した後、実処理を行うこと。
      * 
-     * @param obsrever Ny[W̃IuU[o[
+     * @param obsrever Nページのオブザーバー
      */
     struct HandlerN {
       void operator()(const N_Observer_t &observer){
@@ -506,7 +562,7 @@ class StreamProcessor : public SylphideProcessor<float_sylph_t> {
     
 #if 0
     /**
-     * SylphideProtocol`œĂCy[Wp̏
+     * SylphideProtocol形式で入ってくるCページ用の処理器
      * 
      */
     class SylphideStreamHandler 
@@ -523,7 +579,7 @@ class StreamProcessor : public SylphideProcessor<float_sylph_t> {
         ~SylphideStreamHandler() {}
         
         /**
-         * pPbgۂɌĂяo֐
+         * パケットが見つかった際に呼び出される関数
          * 
          */
         void operator()(const self_t &observer){
@@ -541,20 +597,37 @@ class StreamProcessor : public SylphideProcessor<float_sylph_t> {
     ~StreamProcessor(){}
     
     /**
-     * t@C̃Xg[1y[WPʂŏs֐
+     * ファイル等のストリームから1ページ単位で処理を行う関数
      * 
-     * @param in Xg[
-     * @return (bool) ǂ
+     * @param in ストリーム
+     * @return (bool) 処理が成功したかどうか
      */
     void process(istream &in){
       char buffer[PAGE_SIZE];
       
+      // Aページの出力は較正のため遅延するので、他の出力との順序を保つ場合は先に吐き出す
+      const bool flush_A_always(
+          options.page_G || options.page_F || options.page_P
+          || options.page_M || options.page_N || options.page_other
+          || options.use_calendar_time);
+      
       while(true){
         int read_count;
-        in.read(buffer, PAGE_SIZE);
-        read_count = in.gcount();
-        if(in.fail() || (read_count == 0)){return;}
+        {
+          INSTRUMENT_SCOPE("page_read");
+          in.read(buffer, PAGE_SIZE);
+          read_count = in.gcount();
+        }
+        if(in.fail() || (read_count == 0)){
+          handler_A.flush();
+          return;
+        }
+        if(flush_A_always && (buffer[0] != 'A')){
+          handler_A.flush();
+        }
         invoked++;
+        INSTRUMENT_COUNT("pages", 1);
+        INSTRUMENT_TICK();
       
         if(options.debug_level){
           cerr << "--read-- : " << invoked << " page" << endl;
@@ -572,6 +645,7 @@ class StreamProcessor : public SylphideProcessor<float_sylph_t> {
           }
         }
       
+        INSTRUMENT_SCOPE("decode");
         switch(buffer[0]){
 #define assign_case_cnd(type, mark, cnd) \
 case mark: if(cnd){ \
@@ -650,6 +724,19 @@ int main(int argc, char *argv[]){
     log_index = i;
   }
   
+  if(options.page_A_mode == 1){
+    options.calibration.set_default();
+    if(options.calib_file){
+      cerr << "IMU Calibration file (" << options.calib_file << ") reading..." << endl;
+      fstream fin(options.calib_file);
+      if(fin.fail()){
+        cerr << "Error: calibration file not found: " << options.calib_file << endl;
+        return -1;
+      }
+      options.calibration.load(fin);
+    }
+  }
+  
   options.out().precision(10);
   if(options.in_sylphide){
     SylphideIStream sylph_in(options.spec2istream(argv[log_index]), PAGE_SIZE);
@@ -0,0 +1,323 @@
+/**
+ * @file Overlapping Allan deviation of accelerometer and gyro
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Usage: (exe) [options] log.dat
+ *
+ * Computes overlapping Allan deviation of the calibrated acceleration [m/s^2]
+ * and angular speed [rad/s] in A pages for all six axes at octave-spaced tau,
+ * which is intended for a log of a static IMU.
+ * The samples are calibrated in the same way as INS_GPS (--calib_file),
+ * and streamed to the engine (util/allan_variance.h), therefore the memory usage
+ * does not depend on the length of the log.
+ * The sampling interval is estimated from the first and last time stamps.
+ * With --parallel, the axes are processed by multiple threads when built with OpenMP.
+ *
+ * The output is a calibration file:
+ *   lines beginning with '#': comments
+ *   tau [s], count, accel X, Y, Z [m/s^2], gyro X, Y, Z [rad/s]
+ *   sigma_accel X Y Z
+ *   sigma_gyro X Y Z
+ * where sigma_* are the deviations at the sampling interval, i.e., standard deviations
+ * of a sample, which are used as the process noise of INS_GPS.
+ * The other lines are ignored by StandardCalibration, therefore the output can be
+ * appended to a calibration file as it is.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#define IS_LITTLE_ENDIAN 1
+#include "SylphideProcessor.h"
+#include "SylphideStream.h"
+
+typedef double float_sylph_t;
+
+#include "analyze_common.h"
+#include "calibration.h"
+
+#include "util/allan_variance.h"
+
+using namespace std;
+
+struct Options : public GlobalOptions<float_sylph_t> {
+  typedef GlobalOptions<float_sylph_t> super_t;
+  const char *calib_file; ///< IMU calibration file, same as INS_GPS
+  unsigned long density; ///< see AllanVariance
+  bool parallel; ///< process axes in parallel
+
+  Options()
+      : super_t(), calib_file(NULL), density(256), parallel(false) {}
+  ~Options(){}
+
+  bool check_spec(const char *spec){
+#define CHECK_OPTION(name, novalue, operation, disp) { \
+  const char *value(get_value(spec, #name, novalue)); \
+  if(value){ \
+    {operation;} \
+    std::cerr << #name << ": " << disp << std::endl; \
+    return true; \
+  } \
+}
+    CHECK_OPTION(calib_file, false, calib_file = value, calib_file);
+    CHECK_OPTION(density, false, density = std::strtoul(value, NULL, 0), density);
+    CHECK_OPTION(parallel, true, parallel = is_true(value), (parallel ? "on" : "off"));
+#undef CHECK_OPTION
+    return super_t::check_spec(spec);
+  }
+} options;
+
+typedef SylphideProcessor<float_sylph_t> Processor_t;
+typedef Processor_t::A_Observer_t A_Observer_t;
+typedef AllanVariance<float_sylph_t> allan_t;
+
+StandardCalibration calibration;
+
+struct Analyzer {
+  StandardCalibration::batch_t batch; ///< samples to be calibrated
+  static const unsigned int batch_size = 0x1000;
+  vector<allan_t> axes; ///< accelerometer X, Y, Z and gyro X, Y, Z
+  float_sylph_t itow_first, itow_last;
+  unsigned long samples;
+  int bad_packet;
+
+  Analyzer()
+      : batch(), axes(6, allan_t(32, options.density)),
+      itow_first(0), itow_last(0), samples(0), bad_packet(0) {}
+
+  /**
+   * Calibrate the pending samples, and stream them to the engines.
+   */
+  void flush(){
+    if(batch.empty()){return;}
+    calibration.calibrate(batch);
+    const unsigned long n(batch.size());
+#if defined(_OPENMP)
+#pragma omp parallel for if(options.parallel)
+#endif
+    for(int i = 0; i < 6; i++){
+      const vector<float_sylph_t> &values((i < 3) ? batch.accel[i] : batch.gyro[i - 3]);
+      axes[i].push(&values[0], n);
+    }
+    batch.clear();
+  }
+
+  void operator()(const A_Observer_t &observer){
+    if(!observer.validate()){
+      bad_packet++;
+      return;
+    }
+    float_sylph_t itow(observer.fetch_ITOW());
+    if(!options.is_time_in_range(itow)){return;}
+    if(samples++ == 0){itow_first = itow;}
+    itow_last = itow;
+
+    A_Observer_t::values_t values(observer.fetch_values());
+    int ch[9];
+    for(int i(0); i < 8; i++){
+      ch[i] = values.values[i];
+    }
+    ch[8] = values.temperature;
+    calibration.push_back(batch, ch);
+    if(batch.size() >= batch_size){flush();}
+  }
+
+  /**
+   * @return (float_sylph_t) mean sampling interval [s]
+   */
+  float_sylph_t tau0() const {
+    if(samples < 2){return 0;}
+    float_sylph_t span(itow_last - itow_first);
+    if(span < 0){span += 60 * 60 * 24 * 7;} // week rollover
+    return span / (samples - 1);
+  }
+
+  /**
+   * Allan deviation at the specified tau, interpolated on log-log scale.
+   *
+   * @return (float_sylph_t) deviation, or zero when out of the computed range
+   */
+  float_sylph_t deviation(const int &axis, const float_sylph_t &tau) const {
+    const allan_t &target(axes[axis]);
+    for(unsigned int j(1); j < target.octave_size(); j++){
+      if(target.count(j) == 0){break;}
+      float_sylph_t tau_a(tau0() * target.m(j - 1)), tau_b(tau0() * target.m(j));
+      if(tau > tau_b){continue;}
+      if(tau < tau_a){break;}
+      float_sylph_t r(std::log(tau / tau_a) / std::log(tau_b / tau_a));
+      return std::exp(std::log(target.deviation(j - 1)) * (1 - r)
+          + std::log(target.deviation(j)) * r);
+    }
+    return 0;
+  }
+
+  /**
+   * @return (float_sylph_t) minimum of the Allan deviation
+   */
+  float_sylph_t deviation_min(const int &axis) const {
+    const allan_t &target(axes[axis]);
+    float_sylph_t res(target.deviation(0));
+    for(unsigned int j(1); j < target.octave_size(); j++){
+      if(target.count(j) == 0){break;}
+      if(target.deviation(j) < res){res = target.deviation(j);}
+    }
+    return res;
+  }
+
+  void print(ostream &out) const {
+    const float_sylph_t dt(tau0());
+    out << "# Overlapping Allan deviation: "
+        << samples << " samples, tau0 " << dt << " [s]" << endl;
+    out << "# tau [s], count, accel X, Y, Z [m/s^2], gyro X, Y, Z [rad/s]" << endl;
+    for(unsigned int j(0); j < axes[0].octave_size(); j++){
+      if(axes[0].count(j) == 0){break;}
+      out << (dt * axes[0].m(j)) << ", " << axes[0].count(j);
+      for(int i(0); i < 6; i++){
+        out << ", " << axes[i].deviation(j);
+      }
+      out << endl;
+    }
+    out << "# Random walk (deviation at tau = 1 [s]), accel [m/s/sqrt(s)], gyro [rad/sqrt(s)]:";
+    for(int i(0); i < 6; i++){
+      out << " " << deviation(i, 1);
+    }
+    out << endl;
+    out << "# Bias instability (minimum deviation / 0.664), accel [m/s^2], gyro [rad/s]:";
+    for(int i(0); i < 6; i++){
+      out << " " << (deviation_min(i) / 0.664);
+    }
+    out << endl;
+    out << "sigma_accel";
+    for(int i(0); i < 3; i++){
+      out << " " << axes[i].deviation(0);
+    }
+    out << endl;
+    out << "sigma_gyro";
+    for(int i(3); i < 6; i++){
+      out << " " << axes[i].deviation(0);
+    }
+    out << endl;
+  }
+};
+
+Analyzer *analyzer(NULL);
+
+void a_packet_handler(const A_Observer_t &observer){
+  (*analyzer)(observer);
+}
+
+/**
+ * Read a stream page by page.
+ *
+ * @param in stream
+ */
+void stream_processor(istream &in){
+  char buffer[PAGE_SIZE];
+
+  Processor_t processor(PAGE_SIZE * 32);
+  processor.set_a_handler(a_packet_handler);
+
+  while(!in.eof()){
+    in.read(buffer, sizeof(buffer));
+    if(in.gcount() < (int)sizeof(buffer)){
+      continue;
+    }
+    processor.process(buffer, sizeof(buffer));
+  }
+}
+
+int main(int argc, char *argv[]){
+
+  cerr << "NinjaScan Allan deviation analyzer of IMU." << endl;
+  cerr << "Usage: (exe) [options] log.dat" << endl;
+  if(argc < 2){
+    cerr << "(error!) Too few arguments; " << argc << " < min(2)" << endl;
+    return -1;
+  }
+
+  int log_index(0);
+  for(int i(1); i < argc; i++){
+    if(options.check_spec(argv[i])){continue;}
+    if(log_index){
+      cerr << "(error!) Unknown option!! : " << argv[i] << endl;
+      return -1;
+    }
+    log_index = i;
+  }
+  if(!log_index){
+    cerr << "(error!) No log file!!" << endl;
+    return -1;
+  }
+
+  calibration.set_default();
+  if(options.calib_file){
+    cerr << "IMU Calibration file (" << options.calib_file << ") reading..." << endl;
+    fstream fin(options.calib_file);
+    if(fin.fail()){
+      cerr << "(error!) calibration file not found: " << options.calib_file << endl;
+      return -1;
+    }
+    calibration.load(fin);
+  }
+
+  analyzer = new Analyzer();
+  if(options.in_sylphide){
+    SylphideIStream sylphide_in(options.spec2istream(argv[log_index]), PAGE_SIZE);
+    stream_processor(sylphide_in);
+  }else{
+    stream_processor(options.spec2istream(argv[log_index]));
+  }
+  analyzer->flush();
+
+  cerr << "A pages (good, bad): "
+      << analyzer->samples << ", " << analyzer->bad_packet << endl;
+  if(analyzer->samples < 3){
+    cerr << "(error!) Too few samples!!" << endl;
+    delete analyzer;
+    return -1;
+  }
+
+  options.out() << setprecision(10);
+  analyzer->print(options.out());
+
+  delete analyzer;
+  return 0;
+}
@@ -0,0 +1,505 @@
+/**
+ * @file Synthetic log.dat generator
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Usage: (exe) [options] [--out=log.dat]
+ *
+ * Emits a log.dat stream of a vehicle running at constant speed and height
+ * on a circle (or a straight line heading north when radius is not positive),
+ * which is decodable by log_CSV, log2ubx and INS_GPS with their default settings.
+ *   A page: accelerometer and gyro, NinjaScan default calibration (see INS_GPS.cpp)
+ *   G page: u-blox NAV-SOL, NAV-POSLLH, NAV-VELNED and NAV-STATUS
+ *   M page: HMC5883 (big endian) magnetometer
+ *   P page: MS5611 barometer with coefficients (log_CSV --page_P_mode=5)
+ *   N page: true navigation solution
+ * The rates are in pages per second (G: epochs per second), and zero disables the page.
+ * No G page is emitted during GPS outages, which start every outage_interval seconds.
+ * With probability of corruption, a bit of a page is flipped.
+ * The noises are generated by a fixed-seed generator, so that runs are reproducible.
+ * The number of pages is reported to stderr as "Total pages: n".
+ */
+
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+
+#define IS_LITTLE_ENDIAN 1
+#include "SylphideStream.h"
+#include "SylphideProcessor.h"
+
+typedef double float_sylph_t;
+#include "analyze_common.h"
+
+#include "navigation/WGS84.h"
+
+using namespace std;
+
+struct Options : public GlobalOptions<float_sylph_t> {
+  typedef GlobalOptions<float_sylph_t> super_t;
+  float_sylph_t duration; ///< [s]
+  float_sylph_t start_itow; ///< GPS time of week at the beginning [s]
+  int week; ///< GPS week number
+  unsigned long seed; ///< seed of noises
+  float_sylph_t rate_A, rate_G, rate_M, rate_P, rate_N; ///< [1/s]
+  float_sylph_t latitude, longitude; ///< Center of the trajectory [deg]
+  float_sylph_t height; ///< [m]
+  float_sylph_t radius; ///< [m]
+  float_sylph_t speed; ///< [m/s]
+  float_sylph_t outage_interval, outage_duration; ///< GPS outages [s]
+  float_sylph_t corruption; ///< Probability of a corrupted page
+
+  Options()
+      : super_t(),
+      duration(600), start_itow(100000), week(1900), seed(1),
+      rate_A(100), rate_G(5), rate_M(25), rate_P(25), rate_N(10),
+      latitude(35), longitude(139), height(100),
+      radius(500), speed(10),
+      outage_interval(0), outage_duration(0),
+      corruption(0) {}
+  ~Options(){}
+
+  bool check_spec(const char *spec){
+#define CHECK_OPTION(name, novalue, operation, disp) { \
+  const char *value(get_value(spec, #name, novalue)); \
+  if(value){ \
+    {operation;} \
+    std::cerr << #name << ": " << disp << std::endl; \
+    return true; \
+  } \
+}
+#define CHECK_OPTION_FLOAT(name, unit) \
+CHECK_OPTION(name, false, name = std::atof(value), name << unit);
+    CHECK_OPTION_FLOAT(duration, " [s]");
+    CHECK_OPTION_FLOAT(start_itow, " [s]");
+    CHECK_OPTION(week, false, week = std::atoi(value), week);
+    CHECK_OPTION(seed, false, seed = std::strtoul(value, NULL, 0), seed);
+    CHECK_OPTION_FLOAT(rate_A, " [Hz]");
+    CHECK_OPTION_FLOAT(rate_G, " [Hz]");
+    CHECK_OPTION_FLOAT(rate_M, " [Hz]");
+    CHECK_OPTION_FLOAT(rate_P, " [Hz]");
+    CHECK_OPTION_FLOAT(rate_N, " [Hz]");
+    CHECK_OPTION_FLOAT(latitude, " [deg]");
+    CHECK_OPTION_FLOAT(longitude, " [deg]");
+    CHECK_OPTION_FLOAT(height, " [m]");
+    CHECK_OPTION_FLOAT(radius, " [m]");
+    CHECK_OPTION_FLOAT(speed, " [m/s]");
+    CHECK_OPTION_FLOAT(outage_interval, " [s]");
+    CHECK_OPTION_FLOAT(outage_duration, " [s]");
+    CHECK_OPTION_FLOAT(corruption, "");
+#undef CHECK_OPTION_FLOAT
+#undef CHECK_OPTION
+    return super_t::check_spec(spec);
+  }
+
+  bool in_outage(const float_sylph_t &t) const {
+    if(outage_interval <= 0){return false;}
+    return (t - std::floor(t / outage_interval) * outage_interval)
+        >= (outage_interval - outage_duration);
+  }
+} options;
+
+struct Random {
+  unsigned long state;
+  Random(const unsigned long &seed) : state(seed) {}
+  float_sylph_t uniform(){ // [0, 1)
+    state = (state * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+    return (float_sylph_t)state / 0x80000000UL;
+  }
+  float_sylph_t gaussian(){ // Box-Muller
+    float_sylph_t u1(uniform()), u2(uniform());
+    return std::sqrt(-2 * std::log(1 - u1)) * std::cos(2 * M_PI * u2);
+  }
+};
+
+/**
+ * True state of the vehicle, which is a function of the elapsed time.
+ * The vehicle banks to perform a coordinated turn, and its pitch is zero.
+ */
+struct Trajectory : public NAVData {
+  float_sylph_t lat0, lng0, h0; ///< Center [rad], [rad], [m]
+  float_sylph_t omega; ///< turn rate [rad/s]
+  float_sylph_t lat, lng, h, v_n, v_e, psi, phi;
+  float_sylph_t accel_n[3]; ///< acceleration in the navigation (NED) frame [m/s^2]
+
+  Trajectory()
+      : lat0(deg2rad(options.latitude)), lng0(deg2rad(options.longitude)),
+      h0(options.height),
+      omega(options.radius > 0 ? (options.speed / options.radius) : 0) {
+    at(0);
+  }
+
+  void at(const float_sylph_t &t){
+    psi = std::atan2(std::sin(omega * t), std::cos(omega * t)); // [-pi, pi]
+    float_sylph_t north, east;
+    if(omega > 0){
+      north = options.radius * std::sin(psi);
+      east = -options.radius * std::cos(psi);
+    }else{
+      north = options.speed * t;
+      east = 0;
+    }
+    lat = lat0 + north / (WGS84::R_meridian(lat0) + h0);
+    lng = lng0 + east / ((WGS84::R_normal(lat0) + h0) * std::cos(lat0));
+    h = h0;
+    v_n = options.speed * std::cos(psi);
+    v_e = options.speed * std::sin(psi);
+    accel_n[0] = -options.speed * omega * std::sin(psi);
+    accel_n[1] = options.speed * omega * std::cos(psi);
+    accel_n[2] = 0;
+    phi = std::atan2(options.speed * omega, WGS84::gravity(lat));
+  }
+
+  /**
+   * Transform a vector from the navigation frame to the body frame.
+   */
+  void nav2body(const float_sylph_t (&v)[3], float_sylph_t (&res)[3]) const {
+    float_sylph_t x(std::cos(psi) * v[0] + std::sin(psi) * v[1]),
+        y(-std::sin(psi) * v[0] + std::cos(psi) * v[1]);
+    res[0] = x;
+    res[1] = std::cos(phi) * y + std::sin(phi) * v[2];
+    res[2] = -std::sin(phi) * y + std::cos(phi) * v[2];
+  }
+
+  void specific_force(float_sylph_t (&res)[3]) const {
+    float_sylph_t f[3] = {accel_n[0], accel_n[1], accel_n[2] - WGS84::gravity(lat)};
+    nav2body(f, res);
+  }
+
+  /**
+   * Angular speed with respect to the inertial frame,
+   * which includes the earth rotation and the transport rate.
+   */
+  void angular_speed(float_sylph_t (&res)[3]) const {
+    float_sylph_t r_m(WGS84::R_meridian(lat) + h), r_n(WGS84::R_normal(lat) + h);
+    float_sylph_t w[3] = {
+      WGS84::Omega_Earth * std::cos(lat) + v_e / r_n,
+      -v_n / r_m,
+      -WGS84::Omega_Earth * std::sin(lat) - v_e * std::tan(lat) / r_n + omega};
+    nav2body(w, res);
+  }
+
+  float_sylph_t longitude() const {return lng;}
+  float_sylph_t latitude() const {return lat;}
+  float_sylph_t height() const {return h;}
+  float_sylph_t v_north() const {return v_n;}
+  float_sylph_t v_east() const {return v_e;}
+  float_sylph_t v_down() const {return 0;}
+  float_sylph_t heading() const {return psi;}
+  float_sylph_t euler_phi() const {return phi;}
+  float_sylph_t euler_theta() const {return 0;}
+  float_sylph_t euler_psi() const {return psi;}
+  float_sylph_t azimuth() const {return 0;}
+};
+
+struct Generator {
+  ostream &out;
+  Random random;
+  Trajectory trajectory;
+  unsigned int a_sequence;
+  string ubx; ///< u-blox stream not yet written as G pages
+  unsigned long pages, pages_corrupted;
+
+  Generator(ostream &_out)
+      : out(_out), random(options.seed), trajectory(),
+      a_sequence(0), ubx(), pages(0), pages_corrupted(0) {}
+
+  static void put_le(char *buf, const unsigned int &value, const int &bytes){
+    for(int i(0); i < bytes; i++){
+      buf[i] = (char)((value >> (i * 8)) & 0xFF);
+    }
+  }
+  static void put_be(char *buf, const unsigned int &value, const int &bytes){
+    for(int i(0); i < bytes; i++){
+      buf[i] = (char)((value >> ((bytes - i - 1) * 8)) & 0xFF);
+    }
+  }
+  static void append_le(string &str, const long long &value, const int &bytes){
+    for(int i(0); i < bytes; i++){
+      str += (char)((value >> (i * 8)) & 0xFF);
+    }
+  }
+  static unsigned int itow_ms(const float_sylph_t &t){
+    return (unsigned int)std::floor((options.start_itow + t) * 1E3 + 0.5);
+  }
+
+  void write(char (&buf)[PAGE_SIZE]){
+    if((options.corruption > 0) && (random.uniform() < options.corruption)){
+      buf[(int)(random.uniform() * PAGE_SIZE)] ^= (char)(1 << (int)(random.uniform() * 8));
+      pages_corrupted++;
+    }
+    out.write(buf, PAGE_SIZE);
+    pages++;
+  }
+
+  void page_A(const float_sylph_t &t){
+    static const float_sylph_t
+        sf_accel(4.1767576e+2), sf_gyro(9.3873405e+2), // default calibration
+        sigma_accel(2E-2), sigma_gyro(2E-3);
+    trajectory.at(t);
+    float_sylph_t accel[3], gyro[3];
+    trajectory.specific_force(accel);
+    trajectory.angular_speed(gyro);
+
+    char buf[PAGE_SIZE] = {'A'};
+    buf[1] = (char)(a_sequence++ & 0xFF);
+    put_le(&buf[2], itow_ms(t), 4);
+    for(int i(0); i < 3; i++){
+      put_be(&buf[6 + (3 * i)],
+          32768 + (int)(sf_accel * (accel[i] + random.gaussian() * sigma_accel)), 3);
+      put_be(&buf[15 + (3 * i)],
+          32768 + (int)(sf_gyro * (gyro[i] + random.gaussian() * sigma_gyro)), 3);
+    }
+    write(buf);
+  }
+
+  void append_ubx(const unsigned char &mclass, const unsigned char &mid, const string &payload){
+    string packet;
+    packet += (char)mclass;
+    packet += (char)mid;
+    append_le(packet, payload.size(), 2);
+    packet += payload;
+    unsigned char ck_a(0), ck_b(0);
+    for(string::size_type i(0); i < packet.size(); i++){
+      ck_a += (unsigned char)packet[i];
+      ck_b += ck_a;
+    }
+    ubx += "\xB5\x62";
+    ubx += packet;
+    ubx += (char)ck_a;
+    ubx += (char)ck_b;
+  }
+
+  void page_G(const float_sylph_t &t){
+    if(options.in_outage(t)){return;}
+    static const float_sylph_t
+        sigma_horizontal(1.0), sigma_vertical(1.5), sigma_vel(0.05),
+        acc_horizontal(2.0), acc_vertical(3.0), acc_vel(0.2);
+    trajectory.at(t);
+    unsigned int itow(itow_ms(t));
+
+    float_sylph_t
+        lat(trajectory.lat + random.gaussian() * sigma_horizontal / WGS84::R_meridian(trajectory.lat)),
+        lng(trajectory.lng + random.gaussian() * sigma_horizontal
+          / (WGS84::R_normal(trajectory.lat) * std::cos(trajectory.lat))),
+        h(trajectory.h + random.gaussian() * sigma_vertical),
+        v_n(trajectory.v_n + random.gaussian() * sigma_vel),
+        v_e(trajectory.v_e + random.gaussian() * sigma_vel),
+        v_d(random.gaussian() * sigma_vel);
+
+    { // NAV-SOL
+      float_sylph_t n(WGS84::R_normal(lat)), e2(WGS84::epsilon_Earth * WGS84::epsilon_Earth);
+      float_sylph_t
+          s_lat(std::sin(lat)), c_lat(std::cos(lat)),
+          s_lng(std::sin(lng)), c_lng(std::cos(lng));
+      string payload;
+      append_le(payload, itow, 4);
+      append_le(payload, 0, 4); // fTOW
+      append_le(payload, options.week, 2);
+      payload += (char)0x03; // 3D fix
+      payload += (char)0x0D; // GPSfixOK, WKNSET, TOWSET
+      append_le(payload, (long long)(((n + h) * c_lat * c_lng) * 1E2), 4);
+      append_le(payload, (long long)(((n + h) * c_lat * s_lng) * 1E2), 4);
+      append_le(payload, (long long)(((n * (1 - e2) + h) * s_lat) * 1E2), 4);
+      append_le(payload, (long long)(acc_horizontal * 1E2), 4);
+      append_le(payload, (long long)((-s_lat * c_lng * v_n - s_lng * v_e - c_lat * c_lng * v_d) * 1E2), 4);
+      append_le(payload, (long long)((-s_lat * s_lng * v_n + c_lng * v_e - c_lat * s_lng * v_d) * 1E2), 4);
+      append_le(payload, (long long)((c_lat * v_n - s_lat * v_d) * 1E2), 4);
+      append_le(payload, (long long)(acc_vel * 1E2), 4);
+      append_le(payload, 150, 2); // PDOP
+      payload += (char)0;
+      payload += (char)8; // numSV
+      append_le(payload, 0, 4);
+      append_ubx(0x01, 0x06, payload);
+    }
+    { // NAV-POSLLH
+      string payload;
+      append_le(payload, itow, 4);
+      append_le(payload, (long long)std::floor(rad2deg(lng) * 1E7 + 0.5), 4);
+      append_le(payload, (long long)std::floor(rad2deg(lat) * 1E7 + 0.5), 4);
+      append_le(payload, (long long)std::floor(h * 1E3 + 0.5), 4);
+      append_le(payload, (long long)std::floor(h * 1E3 + 0.5), 4); // hMSL, geoid is ignored
+      append_le(payload, (long long)(acc_horizontal * 1E3), 4);
+      append_le(payload, (long long)(acc_vertical * 1E3), 4);
+      append_ubx(0x01, 0x02, payload);
+    }
+    { // NAV-VELNED
+      float_sylph_t speed_2d(std::sqrt(v_n * v_n + v_e * v_e));
+      float_sylph_t course(rad2deg(std::atan2(v_e, v_n)));
+      if(course < 0){course += 360;}
+      string payload;
+      append_le(payload, itow, 4);
+      append_le(payload, (long long)std::floor(v_n * 1E2 + 0.5), 4);
+      append_le(payload, (long long)std::floor(v_e * 1E2 + 0.5), 4);
+      append_le(payload, (long long)std::floor(v_d * 1E2 + 0.5), 4);
+      append_le(payload, (long long)(std::sqrt(speed_2d * speed_2d + v_d * v_d) * 1E2), 4);
+      append_le(payload, (long long)(speed_2d * 1E2), 4);
+      append_le(payload, (long long)(course * 1E5), 4);
+      append_le(payload, (long long)(acc_vel * 1E2), 4);
+      append_le(payload, 100000, 4); // cAcc, 1 [deg]
+      append_ubx(0x01, 0x12, payload);
+    }
+    { // NAV-STATUS
+      string payload;
+      append_le(payload, itow, 4);
+      payload += (char)0x03; // 3D fix
+      payload += (char)0x0D; // gpsFixOk, wknSet, towSet
+      payload += (char)0;
+      payload += (char)0;
+      append_le(payload, 30000, 4); // ttff
+      append_le(payload, (long long)((t + 60) * 1E3), 4); // msss
+      append_ubx(0x01, 0x03, payload);
+    }
+
+    // The last page of an epoch is padded, which is skipped by the decoders as out of frame.
+    for(string::size_type i(0); i < ubx.size(); i += (PAGE_SIZE - 1)){
+      char buf[PAGE_SIZE] = {'G'};
+      ubx.copy(&buf[1], PAGE_SIZE - 1, i);
+      write(buf);
+    }
+    ubx.clear();
+  }
+
+  void page_M(const float_sylph_t &t){
+    static const float_sylph_t
+        field[3] = {30000, -4000, 35000}, // [nT], around Japan
+        gain(1090E-5), // HMC5883 default gain [LSB/nT]
+        sigma(2);
+    char buf[PAGE_SIZE] = {'M', (char)0x80}; // big endian
+    put_le(&buf[4], itow_ms(t), 4);
+    for(int i(0); i < 4; i++){ // 4 samples, the last one is at itow
+      trajectory.at(t - (3 - i) / (options.rate_M * 4));
+      float_sylph_t mag[3];
+      trajectory.nav2body(field, mag);
+      for(int j(0); j < 3; j++){
+        put_be(&buf[8 + (6 * i) + (2 * j)],
+            (unsigned int)(int)std::floor(mag[j] * gain + random.gaussian() * sigma + 0.5), 2);
+      }
+    }
+    write(buf);
+  }
+
+  void page_P(const float_sylph_t &t){
+    static const unsigned int coef[6] = {40127, 36924, 23317, 23282, 33464, 28312}; // typical values in datasheet
+    static const float_sylph_t sigma(2); // [Pa]
+    char buf[PAGE_SIZE] = {'P'};
+    put_le(&buf[4], itow_ms(t), 4);
+    for(int i(0); i < 2; i++){ // 2 samples, the last one is at itow
+      trajectory.at(t - (1 - i) / (options.rate_P * 2));
+      // At 20 [degC], that is, dT = 0
+      float_sylph_t pressure(101325 * std::pow(1 - 2.25577E-5 * trajectory.h, 5.25588)
+          + random.gaussian() * sigma);
+      long long off((long long)coef[1] << 16), sens((long long)coef[0] << 15);
+      long long d1(((((long long)pressure << 15) + off) << 21) / sens);
+      put_be(&buf[8 + (6 * i)], (unsigned int)d1, 3);
+      put_be(&buf[11 + (6 * i)], coef[4] << 8, 3);
+    }
+    for(int i(0); i < 6; i++){
+      put_be(&buf[20 + (2 * i)], coef[i], 2);
+    }
+    write(buf);
+  }
+
+  void page_N(const float_sylph_t &t){
+    trajectory.at(t);
+    char buf[PAGE_SIZE];
+    trajectory.encode_N0(options.start_itow + t, buf);
+    write(buf);
+  }
+
+  void run(){
+    typedef void (Generator::*page_t)(const float_sylph_t &);
+    static const page_t page[] = {
+      &Generator::page_A, &Generator::page_G, &Generator::page_M,
+      &Generator::page_P, &Generator::page_N};
+    const float_sylph_t rate[] = {
+      options.rate_A, options.rate_G, options.rate_M,
+      options.rate_P, options.rate_N};
+    static const int types(sizeof(page) / sizeof(page[0]));
+    unsigned long index[types] = {0};
+
+    // Emit pages in order of time; on a tie, in order of A, G, M, P, N.
+    while(true){
+      int next(-1);
+      float_sylph_t next_t(options.duration);
+      for(int i(0); i < types; i++){
+        if(rate[i] <= 0){continue;}
+        float_sylph_t t(index[i] / rate[i]);
+        if(t < next_t){
+          next = i;
+          next_t = t;
+        }
+      }
+      if(next < 0){break;}
+      (this->*page[next])(next_t);
+      index[next]++;
+    }
+  }
+};
+
+int main(int argc, char *argv[]){
+  cerr << "NinjaScan synthetic log generator." << endl;
+  cerr << "Usage: " << argv[0] << " [options] [--out=log.dat]" << endl;
+
+  for(int arg_index(1); arg_index < argc; arg_index++){
+    if(options.check_spec(argv[arg_index])){continue;}
+    cerr << "(error!) Unknown option: " << argv[arg_index] << endl;
+    return -1;
+  }
+
+  if(options._out == &cout){
+    cerr << "out: ";
+    options._out = &(options.spec2ostream("-"));
+  }
+
+  ostream *out(&options.out());
+  if(options.out_sylphide){
+    out = new SylphideOStream(options.out(), PAGE_SIZE);
+  }
+
+  Generator generator(*out);
+  generator.run();
+  out->flush();
+
+  if(out != &options.out()){
+    delete out;
+  }
+
+  cerr << "Corrupted pages: " << generator.pages_corrupted << endl;
+  cerr << "Total pages: " << generator.pages << endl;
+
+  return 0;
+}
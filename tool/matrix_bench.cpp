@@ -0,0 +1,222 @@
+/**
+ * @file Micro-benchmark for the matrix library
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Usage: (exe) [--min_time=sec] [--max_size=n] [--filter=name]
+ *
+ * Each benchmark is repeated until it has consumed at least min_time CPU seconds,
+ * and the results are written to stdout as CSV:
+ *   bench, type, size, iterations, ns_per_op, allocs_per_op
+ * allocs_per_op counts every call of the global operator new.
+ * The inputs are generated by a fixed-seed generator, so that runs are reproducible.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+#include "param/matrix.h"
+
+#include "bench_common.h"
+
+struct Options : public BenchOptions {
+  unsigned int max_size;
+  Options() : BenchOptions(), max_size(32) {}
+
+  bool check_spec(const char *spec){
+    const char *value;
+    if(value = get_value(spec, "max_size")){
+      max_size = std::atoi(value);
+      return true;
+    }
+    return BenchOptions::check_spec(spec);
+  }
+} options;
+
+template <class FloatT>
+struct Inputs {
+  typedef Matrix<FloatT> mat_t;
+  unsigned int size;
+  mat_t a, b;
+  mat_t spd; ///< symmetric positive definite
+  mat_t large; ///< (size * 2) x (size * 2), whose partial is benchmarked
+  Inputs(const unsigned int &n) : size(n) {
+    LCG rand(n);
+    a = mat_t(n, n);
+    b = mat_t(n, n);
+    for(unsigned int i(0); i < n; i++){
+      for(unsigned int j(0); j < n; j++){
+        a(i, j) = rand();
+        b(i, j) = rand();
+      }
+      a(i, i) += n; // diagonally dominant, then regular
+    }
+    spd = a * a.transpose();
+    large = mat_t(n * 2, n * 2);
+    for(unsigned int i(0); i < n * 2; i++){
+      for(unsigned int j(0); j < n * 2; j++){
+        large(i, j) = rand();
+      }
+    }
+  }
+};
+
+template <class FloatT>
+struct type_name_t {static const char *get();};
+template <>
+const char *type_name_t<float>::get(){return "float";}
+template <>
+const char *type_name_t<double>::get(){return "double";}
+
+template <class FloatT, class Operation>
+void run(const char *name, const Inputs<FloatT> &in, Operation op){
+  std::stringstream params;
+  params << type_name_t<FloatT>::get() << ", " << in.size;
+  run_bench<FloatT>(options, name, params.str(), op);
+}
+
+template <class FloatT>
+struct Operations {
+  typedef Inputs<FloatT> in_t;
+  typedef Matrix<FloatT> mat_t;
+
+  struct multiply {
+    const in_t &in;
+    multiply(const in_t &_in) : in(_in) {}
+    FloatT operator()() const {return (in.a * in.b)(0, 0);}
+  };
+  struct multiply_transposed { // with Array2D_Transpose
+    const in_t &in;
+    multiply_transposed(const in_t &_in) : in(_in) {}
+    FloatT operator()() const {return (in.a * in.b.transpose())(0, 0);}
+  };
+  struct multiply_partial { // with Array2D_Partial
+    const in_t &in;
+    multiply_partial(const in_t &_in) : in(_in) {}
+    FloatT operator()() const {
+      return (in.a * in.large.partial(in.size, in.size, 1, 1))(0, 0);
+    }
+  };
+  struct transpose_copy {
+    const in_t &in;
+    transpose_copy(const in_t &_in) : in(_in) {}
+    FloatT operator()() const {return in.a.transpose().copy()(0, 0);}
+  };
+  struct partial_copy {
+    const in_t &in;
+    partial_copy(const in_t &_in) : in(_in) {}
+    FloatT operator()() const {
+      return in.large.partial(in.size, in.size, 1, 1).copy()(0, 0);
+    }
+  };
+  struct inverse {
+    const in_t &in;
+    inverse(const in_t &_in) : in(_in) {}
+    FloatT operator()() const {return in.a.inverse()(0, 0);}
+  };
+  struct decomposeLU {
+    const in_t &in;
+    decomposeLU(const in_t &_in) : in(_in) {}
+    FloatT operator()() const {return in.a.decomposeLU()(0, 0);}
+  };
+  struct decomposeUD {
+    const in_t &in;
+    decomposeUD(const in_t &_in) : in(_in) {}
+    FloatT operator()() const {return in.spd.decomposeUD()(0, 0);}
+  };
+  struct hessenberg {
+    const in_t &in;
+    hessenberg(const in_t &_in) : in(_in) {}
+    FloatT operator()() const {return in.a.hessenberg()(0, 0);}
+  };
+  struct eigen {
+    const in_t &in;
+    eigen(const in_t &_in) : in(_in) {}
+    FloatT operator()() const {return in.spd.eigen()(0, in.size).real();}
+  };
+  struct eigen_symmetric {
+    const in_t &in;
+    eigen_symmetric(const in_t &_in) : in(_in) {}
+    FloatT operator()() const {return in.spd.eigen_symmetric()(0, in.size);}
+  };
+  struct decomposeCholesky {
+    const in_t &in;
+    decomposeCholesky(const in_t &_in) : in(_in) {}
+    FloatT operator()() const {return in.spd.decomposeCholesky()(0, 0);}
+  };
+  struct sqrt_symmetric {
+    const in_t &in;
+    sqrt_symmetric(const in_t &_in) : in(_in) {}
+    FloatT operator()() const {return in.spd.sqrt_symmetric()(0, 0);}
+  };
+
+  static void run_all(const unsigned int &n){
+    in_t in(n);
+    run("multiply", in, multiply(in));
+    run("multiply_transposed", in, multiply_transposed(in));
+    run("multiply_partial", in, multiply_partial(in));
+    run("transpose_copy", in, transpose_copy(in));
+    run("partial_copy", in, partial_copy(in));
+    run("inverse", in, inverse(in));
+    run("decomposeLU", in, decomposeLU(in));
+    run("decomposeUD", in, decomposeUD(in));
+    run("hessenberg", in, hessenberg(in));
+    run("eigen", in, eigen(in));
+    run("eigen_symmetric", in, eigen_symmetric(in));
+    run("decomposeCholesky", in, decomposeCholesky(in));
+    run("sqrt_symmetric", in, sqrt_symmetric(in));
+  }
+};
+
+int main(int argc, char *argv[]){
+  for(int arg_index(1); arg_index < argc; arg_index++){
+    if(options.check_spec(argv[arg_index])){continue;}
+    std::cerr << "(error!) Unknown option: " << argv[arg_index] << std::endl;
+    return -1;
+  }
+
+  static const unsigned int sizes[] = {3, 4, 6, 8, 10, 12, 16, 24, 32};
+
+  std::cout << std::setprecision(6);
+  std::cout << "bench, type, size, iterations, ns_per_op, allocs_per_op" << std::endl;
+  for(unsigned int i(0); i < sizeof(sizes) / sizeof(sizes[0]); i++){
+    if(sizes[i] > options.max_size){break;}
+    Operations<float>::run_all(sizes[i]);
+    Operations<double>::run_all(sizes[i]);
+  }
+
+  return 0;
+}
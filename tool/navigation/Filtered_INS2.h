@@ -20,12 +20,12 @@
 #define __FILTERED_INS2_H__
 
 /** @file
- * @brief q@u(INS)Ƃ̓̋n(Multiplicative)
+ * @brief 慣性航法装置(INS)との統合の橋渡し(Multiplicative)
  * 
- * q@u(INS)Ƒ̍q@u
- * J}tB^ʂē̂ɕKvƂȂ
- * s񉉎ZɂċLqt@CB
- * NH[^jI̐`͐ώZ^(Multiplicative)ōsĂ܂B
+ * 慣性航法装置(INS)と他の航法装置を
+ * カルマンフィルタを通じて統合するのに必要となる
+ * 行列演算について記述したファイル。
+ * クォータニオンの線形化は積算型(Multiplicative)で行っています。
  */
 
 #include "INS.h"
@@ -38,12 +38,12 @@ class Filtered_INS2_Property {
 #if defined(_MSC_VER)
         = 10
 #endif
-        ; ///< Ps(VXe덷Us)̑傫
+        ; ///< P行列(システム誤差共分散行列)の大きさ
     static const unsigned Q_SIZE
 #if defined(_MSC_VER)
         = 7
 #endif
-        ; ///< Qs(͌덷Us)̑傫
+        ; ///< Q行列(入力誤差共分散行列)の大きさ
 };
 
 #if !defined(_MSC_VER)
@@ -53,12 +53,12 @@ const unsigned Filtered_INS2_Property::Q_SIZE = 7;
 #endif
 
 /**
- * @brief ̍q@u𓝍ׂINSgNX(Multiplicative)
+ * @brief 他の航法装置を統合する為のINS拡張クラス(Multiplicative)
  * 
- * J}tB^ʂāAINS𑼂̍q@uƓŝ
- * KvƂȂ鏔s񉉎ZɂĒ`INSgNXB
- * ANH[^jI̐`͐ώZ^(Multiplicative)ōsĂ܂B
- * Ȃ킿
+ * カルマンフィルタを通じて、INSを他の航法装置と統合を行うのに
+ * 必要となる諸行列演算について定義をしたINS拡張クラス。
+ * ただし、クォータニオンの線形化は積算型(Multiplicative)で行っています。
+ * すなわち
  * @f[
  *    \Tilde{q} + \Delta \Tilde{q}
  *      \equiv \begin{Bmatrix} 
@@ -69,10 +69,10 @@ const unsigned Filtered_INS2_Property::Q_SIZE = 7;
  *          \vec{q}
  *        \end{Bmatrix} 
  * @f]
- * Œ`Ă܂B
+ * で定義されています。
  * 
- * @param FloatT Zx
- * @param Filter J}tB^
+ * @param FloatT 演算精度
+ * @param Filter カルマンフィルタ(KalmanFilter, KalmanFilterUD, KalmanFilterJoseph, KalmanFilterSquareRoot等)
  */
 template <class FloatT, typename Filter = KalmanFilterUD<FloatT> >
 class Filtered_INS2 : public INS<FloatT>, public Filtered_INS2_Property {
@@ -81,23 +81,33 @@ class Filtered_INS2 : public INS<FloatT>, public Filtered_INS2_Property {
     using Filtered_INS2_Property::Q_SIZE;
     
   protected:
-    Filter m_filter;  ///< J}tB^{
+    Filter m_filter;  ///< カルマンフィルタ本体
+    bool m_sequential_correct; ///< 観測を1つずつ順次処理するかどうか
     
-#define R_STRICT ///< ȗaɌvZ邩̃XCb`ȀꍇvZ
+    unsigned m_predict_interval; ///< 共分散の時間更新を行うサンプル間隔、0の場合は観測更新の直前のみ
+    unsigned m_predict_pending; ///< 共分散の時間更新に未反映のサンプル数
+    Matrix<FloatT> m_A_sum; ///< 未反映の@f$ \sum A \Delta t @f$
+    Matrix<FloatT> m_B_sum; ///< 未反映の@f$ \sum B \Delta t @f$
+    FloatT m_predict_deltaT; ///< 未反映の時間間隔の合計
+    Matrix<FloatT> m_Phi; ///< まとめて時間更新する際の@f$ \Phi @f$
+    Matrix<FloatT> m_Gamma; ///< まとめて時間更新する際の@f$ \Gamma @f$
+    KalmanFilterWorkspace<FloatT> m_predict_work; ///< 時間更新の積算用の作業領域
+    
+#define R_STRICT ///< 曲率半径を厳密に計算するかのスイッチ、この場合計算する
     
     using INS<FloatT>::get;
     
     /**
-     * q@(VXe)ɂāA
-     * ̏ԗʂ̌덷ɑ΂Đ`ꍇ̎A
-     * Ȃ킿덷VXeɂs AԂ܂B
-     * ڂgetA(const Vector3<FloatT> &, const Vector3<FloatT> &)QƂĂB  
+     * 慣性航法方程式(所謂システム方程式)において、
+     * その状態量の誤差に対して線形化した場合の式、
+     * すなわち誤差システム方程式における行列 Aを返します。
+     * 詳しくはgetA(const Vector3<FloatT> &, const Vector3<FloatT> &)を参照してください。  
      * 
-     * @param accel x
-     * @param gyro px
+     * @param accel 加速度
+     * @param gyro 角速度
      * @param dcm_e2n @f$ \mathrm{DCM} \left( \Tilde{q}_{e}^{n} \right) @f$
      * @param dcm_n2b @f$ \mathrm{DCM} \left( \Tilde{q}_{n}^{b} \right) @f$
-     * @return (Matrix<FloatT>) As
+     * @return (Matrix<FloatT>) A行列
      * @see getA(const Vector3<FloatT> &, const Vector3<FloatT> &)
      */
     Matrix<FloatT> getA(
@@ -115,7 +125,7 @@ class Filtered_INS2 : public INS<FloatT>, public Filtered_INS2_Property {
 #define ALREADY_POW2_DEFINED
 #endif
 
-      //sǍvZ
+      //行列Aの計算
       FloatT A_serialized[P_SIZE][P_SIZE] = {{FloatT(0)}};
 #define A(i, j) A_serialized[i][j]
       {
@@ -180,7 +190,7 @@ class Filtered_INS2 : public INS<FloatT>, public Filtered_INS2_Property {
           //A(2, 9) = 0;
         }
         
-#define CENTRIPETAL ///< S͌덷l邩̃XCb`Ȁꍇl
+#define CENTRIPETAL ///< 求心力誤差を考慮するかのスイッチ、この場合考慮する
 #ifdef CENTRIPETAL
         {
 #define by_delta_r(i, j) A(i + 0, j + 3)
@@ -287,19 +297,19 @@ class Filtered_INS2 : public INS<FloatT>, public Filtered_INS2_Property {
     }
     
     /**
-     * q@(VXe)ɂāA
-     * ̏ԗʂ̌덷ɑ΂Đ`ꍇ̎A
-     * Ȃ킿덷VXe
+     * 慣性航法方程式(所謂システム方程式)において、
+     * その状態量の誤差に対して線形化した場合の式、
+     * すなわち誤差システム方程式
      * @f[
      *    \frac{d}{dt} \Bar{x} = A \Bar{x} + B \Bar{u}
      * @f]
-     * ɂs AԂ܂B
-     * ̎ɂ @f$ \Bar{x} @f$͏ԗʁA܂葬xEʒuEpǍ덷A
-     * @f$ \Bar{u} @f$͓́AȂ킿xpx(AĂł͏d͂)Ǎ덷\܂B  
+     * における行列 Aを返します。
+     * この式において @f$ \Bar{x} @f$は状態量、つまり速度・位置・姿勢、の誤差、
+     * @f$ \Bar{u} @f$は入力、すなわち加速度や角速度(、加えてここでは重力も)、の誤差を表します。  
      * 
-     * @param accel x
-     * @param gyro px
-     * @return (Matrix<FloatT>) As
+     * @param accel 加速度
+     * @param gyro 角速度
+     * @return (Matrix<FloatT>) A行列
      */
     Matrix<FloatT> getA(
         const Vector3<FloatT> &accel, 
@@ -308,15 +318,15 @@ class Filtered_INS2 : public INS<FloatT>, public Filtered_INS2_Property {
     }
     
     /**
-     * q@(VXe)ɂāA
-     * ̏ԗʂ̌덷ɑ΂Đ`ꍇ̎A
-     * Ȃ킿덷VXeɂs BԂ܂B
-     * ڂgetB(const Vector3<FloatT> &, const Vector3<FloatT> &)QƂĂB  
+     * 慣性航法方程式(所謂システム方程式)において、
+     * その状態量の誤差に対して線形化した場合の式、
+     * すなわち誤差システム方程式における行列 Bを返します。
+     * 詳しくはgetB(const Vector3<FloatT> &, const Vector3<FloatT> &)を参照してください。  
      * 
-     * @param accel x
-     * @param gyro px
+     * @param accel 加速度
+     * @param gyro 角速度
      * @param dcm_n2b @f$ \mathrm{DCM} \left( \Tilde{q}_{n}^{b} \right) @f$
-     * @return (Matrix<FloatT>) As
+     * @return (Matrix<FloatT>) A行列
      * @see getB(const Vector3<FloatT> &, const Vector3<FloatT> &)
      */
     Matrix<FloatT> getB(
@@ -326,7 +336,7 @@ class Filtered_INS2 : public INS<FloatT>, public Filtered_INS2_Property {
 
 #define dcm_n2b(r, c) (const_cast<Matrix<FloatT> *>(&dcm_n2b))->operator()(r, c)
 
-      //sB̌vZ
+      //行列Bの計算
       FloatT B_serialized[P_SIZE][Q_SIZE] = {{FloatT(0)}};
 #define B(i, j) B_serialized[i][j]
       {
@@ -342,7 +352,7 @@ class Filtered_INS2 : public INS<FloatT>, public Filtered_INS2_Property {
         B(2, 1) = dcm_n2b(1, 2);
         B(2, 2) = dcm_n2b(2, 2);
         
-        B(2, 6) = FloatT(1); // d͌덷Ẑ
+        B(2, 6) = FloatT(1); // 重力誤差Zのみ
     
         B(7, 3) = dcm_n2b(0, 0) / 2;
         B(7, 4) = dcm_n2b(1, 0) / 2;
@@ -366,19 +376,19 @@ class Filtered_INS2 : public INS<FloatT>, public Filtered_INS2_Property {
     }
     
     /**
-     * q@(VXe)ɂāA
-     * ̏ԗʂ̌덷ɑ΂Đ`ꍇ̎A
-     * Ȃ킿덷VXe
+     * 慣性航法方程式(所謂システム方程式)において、
+     * その状態量の誤差に対して線形化した場合の式、
+     * すなわち誤差システム方程式
      * @f[
      *    \frac{d}{dt} \Bar{x} = A \Bar{x} + B \Bar{u}
      * @f]
-     * ɂs BԂ܂B
-     * ̎ɂ @f$ \Bar{x} @f$͏ԗʁA܂葬xEʒuEpǍ덷A
-     * @f$ \Bar{u} @f$͓́AȂ킿xpx(AĂł͏d͂)Ǎ덷\܂B  
+     * における行列 Bを返します。
+     * この式において @f$ \Bar{x} @f$は状態量、つまり速度・位置・姿勢、の誤差、
+     * @f$ \Bar{u} @f$は入力、すなわち加速度や角速度(、加えてここでは重力も)、の誤差を表します。  
      * 
-     * @param accel x
-     * @param gyro px
-     * @return (Matrix<FloatT>) Bs
+     * @param accel 加速度
+     * @param gyro 角速度
+     * @return (Matrix<FloatT>) B行列
      */
     Matrix<FloatT> getB(
         const Vector3<FloatT> &accel, 
@@ -389,85 +399,253 @@ class Filtered_INS2 : public INS<FloatT>, public Filtered_INS2_Property {
   public:
     
     /**
-     * RXgN^B
-     * sP(VXe덷Us)
-     * Q(͌덷Us)̍쐬͓Iɍs܂B
+     * コンストラクタ。
+     * 行列P(システム誤差共分散行列)や
+     * Q(入力誤差共分散行列)の作成は内部的に行われます。
      * 
      */
     Filtered_INS2() 
         : INS<FloatT>(), 
-          m_filter(Matrix<FloatT>::getI(P_SIZE), Matrix<FloatT>::getI(Q_SIZE)){
+          m_filter(Matrix<FloatT>::getI(P_SIZE), Matrix<FloatT>::getI(Q_SIZE)),
+          m_sequential_correct(false),
+          m_predict_interval(1), m_predict_pending(0), m_A_sum(), m_B_sum(), m_predict_deltaT(0),
+          m_Phi(), m_Gamma(), m_predict_work() {
     }
     
     /**
-     * RXgN^B
-     * sP(VXe덷Us)
-     * Q(͌덷Us)w肵ď܂B
+     * コンストラクタ。
+     * 行列P(システム誤差共分散行列)や
+     * Q(入力誤差共分散行列)を指定して初期化を完了します。
      * 
-     * @param P Ps(VXe덷Us)
-     * @param Q Qs(͌덷Us)
+     * @param P P行列(システム誤差共分散行列)
+     * @param Q Q行列(入力誤差共分散行列)
      */
     Filtered_INS2(const Matrix<FloatT> &P, const Matrix<FloatT> &Q) 
-        : INS<FloatT>(), m_filter(P, Q) {}
+        : INS<FloatT>(), m_filter(P, Q), m_sequential_correct(false),
+          m_predict_interval(1), m_predict_pending(0), m_A_sum(), m_B_sum(), m_predict_deltaT(0),
+          m_Phi(), m_Gamma(), m_predict_work() {}
     
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
      * 
-     * @param orig Rs[
-     * @param deepcopy fB[vRs[쐬邩ǂ
+     * @param orig コピー元
+     * @param deepcopy ディープコピーを作成するかどうか
      */
     Filtered_INS2(const Filtered_INS2 &orig, const bool deepcopy = false)
         : INS<FloatT>(orig, deepcopy),
-          m_filter(orig.m_filter, deepcopy){
+          m_filter(orig.m_filter, deepcopy),
+          m_sequential_correct(orig.m_sequential_correct),
+          m_predict_interval(orig.m_predict_interval),
+          m_predict_pending(orig.m_predict_pending),
+          m_A_sum(orig.m_predict_pending ? orig.m_A_sum.copy() : Matrix<FloatT>()),
+          m_B_sum(orig.m_predict_pending ? orig.m_B_sum.copy() : Matrix<FloatT>()),
+          m_predict_deltaT(orig.m_predict_deltaT),
+          m_Phi(), m_Gamma(), m_predict_work() {
     }
     
     virtual ~Filtered_INS2(){}
 
   protected:
     /**
-     * ԍXVɂČ㏈邽߂̃R[obN֐B
-     * ftHgł͉܂B
+     * 時間更新において後処理をするためのコールバック関数。
+     * デフォルトでは何もしません。
      * 
-     * @param A As
-     * @param B Bs
-     * @param deltaT ԊԊu
+     * @param A A行列
+     * @param B B行列
+     * @param deltaT 時間間隔
      */
     virtual inline void before_update_INS(
         const Matrix<FloatT> &A, const Matrix<FloatT> &B, 
         const FloatT &deltaT
       ){}
+    
+    /**
+     * カルマンフィルタを時間更新します。
+     * 共分散の時間更新の間隔が2以上(または0)の場合、
+     * @f$ A \Delta t @f$と@f$ B \Delta t @f$を積算するのみで、
+     * 時間更新は指定サンプル数に達した時点、もしくは観測更新の直前にまとめて行います。
+     * 
+     * @param A A行列
+     * @param B B行列
+     * @param deltaT 時間間隔
+     * @see flush_predict()
+     */
+    inline void predict_filter(const Matrix<FloatT> &A, const Matrix<FloatT> &B, const FloatT &deltaT){
+      if(m_predict_interval == 1){
+        m_filter.predict(A, B, deltaT);
+        before_update_INS(A, B, deltaT);
+        return;
+      }
+      typedef KalmanFilterKernel<FloatT> kernel_t;
+      const unsigned n(A.rows()), m(B.columns());
+      if(m_predict_pending == 0){
+        kernel_t::assign(m_A_sum, A);
+        kernel_t::assign(m_B_sum, B);
+        FloatT *A_sum(kernel_t::buffer(m_A_sum)), *B_sum(kernel_t::buffer(m_B_sum));
+        for(unsigned i(0); i < n * n; i++){A_sum[i] *= deltaT;}
+        for(unsigned i(0); i < n * m; i++){B_sum[i] *= deltaT;}
+        m_predict_deltaT = deltaT;
+      }else{
+        FloatT *work(m_predict_work.reserve(n * (n + m)));
+        kernel_t::serialize(A, work);
+        kernel_t::serialize(B, work + n * n);
+        FloatT *A_sum(kernel_t::buffer(m_A_sum)), *B_sum(kernel_t::buffer(m_B_sum));
+        for(unsigned i(0); i < n * n; i++){A_sum[i] += work[i] * deltaT;}
+        for(unsigned i(0); i < n * m; i++){B_sum[i] += work[n * n + i] * deltaT;}
+        m_predict_deltaT += deltaT;
+      }
+      if((++m_predict_pending == m_predict_interval) && (m_predict_interval > 0)){
+        flush_predict();
+      }
+    }
+    
+    /**
+     * 行列の積@f$ C = A B @f$を求めます。
+     * 
+     * @param A 行列(n x n)
+     * @param B 行列(n x m)
+     * @param C 書き出し先(n x m)、A, Bと重なってはいけません
+     * @param n 大きさ
+     * @param m Bの列数
+     */
+    static void multiply(
+        const FloatT *A, const FloatT *B, FloatT *C,
+        const unsigned &n, const unsigned &m){
+      for(unsigned i(0); i < n; i++){
+        for(unsigned j(0); j < m; j++){
+          FloatT sum(0);
+          for(unsigned k(0); k < n; k++){sum += A[i * n + k] * B[k * m + j];}
+          C[i * m + j] = sum;
+        }
+      }
+    }
+    
+    /**
+     * 行列指数関数@f$ e^{X} @f$を、スケーリングとスクエアリングにより計算します。
+     * @f$ X / 2^{s} @f$の無限大ノルムを1/2以下にしてから4次までのTaylor展開を求め、
+     * それを@f$ s @f$回2乗します。
+     * 
+     * @param X 正方行列(n x n)
+     * @param res 書き出し先(n x n)
+     * @param n 大きさ
+     * @param work 作業領域(n x n)
+     */
+    static void exp_matrix(const FloatT *X, FloatT *res, const unsigned &n, FloatT *work){
+      FloatT norm(0);
+      for(unsigned i(0); i < n; i++){
+        FloatT row(0);
+        for(unsigned j(0); j < n; j++){row += std::abs(X[i * n + j]);}
+        if(row > norm){norm = row;}
+      }
+      unsigned squaring(0);
+      FloatT scale(1);
+      for(; norm * scale > FloatT(0.5); squaring++){scale /= 2;}
+      
+      // Horner法 I + Y (I + Y/2 (I + Y/3 (I + Y/4)))、Y = X / 2^s
+      for(unsigned i(0); i < n * n; i++){res[i] = FloatT(0);}
+      for(unsigned i(0); i < n; i++){res[i * n + i] = FloatT(1);}
+      for(unsigned k(4); k > 0; k--){
+        multiply(X, res, work, n, n);
+        for(unsigned i(0); i < n * n; i++){res[i] = work[i] * scale / k;}
+        for(unsigned i(0); i < n; i++){res[i * n + i] += FloatT(1);}
+      }
+      for(; squaring > 0; squaring--){
+        multiply(res, res, work, n, n);
+        for(unsigned i(0); i < n * n; i++){res[i] = work[i];}
+      }
+    }
+    
+  public:
+    /**
+     * 積算済みで未反映の時間更新をカルマンフィルタに反映します。
+     * @f$ K @f$サンプル分の@f$ S_{A} = \sum A \Delta t @f$, @f$ S_{B} = \sum B \Delta t @f$から
+     * @f{gather*}
+     *   \Phi = e^{S_{A}} = \left( e^{S_{A}/2} \right)^{2} \\
+     *   \Gamma = e^{S_{A}/2} \frac{S_{B}}{\sqrt{K}}
+     * @f}
+     * として時間更新します。
+     * @f$ \Gamma Q \Gamma^{T} @f$は、1サンプルごとに加わる@f$ (B \Delta t) Q (B \Delta t)^{T} @f$の
+     * @f$ K @f$回分を、区間の中点に集約したものに相当します。
+     * before_update_INS()には@f$ \Phi = I + A \Delta t, \Gamma = B \Delta t @f$となる
+     * 等価な@f$ A, B @f$と、時間間隔の合計が渡されます。
+     */
+    void flush_predict(){
+      if(m_predict_pending == 0){return;}
+      typedef KalmanFilterKernel<FloatT> kernel_t;
+      const unsigned n(m_A_sum.rows()), m(m_B_sum.columns());
+      if(!m_Phi.storage()){
+        m_Phi = Matrix<FloatT>(n, n);
+        m_Gamma = Matrix<FloatT>(n, m);
+      }
+      FloatT *work(m_predict_work.reserve(n * n * 3));
+      FloatT *X(work), *Phi_half(work + n * n);
+      {
+        const FloatT *A_sum(kernel_t::buffer(m_A_sum));
+        for(unsigned i(0); i < n * n; i++){X[i] = A_sum[i] / 2;}
+      }
+      exp_matrix(X, Phi_half, n, work + n * n * 2);
+      FloatT *Phi(kernel_t::buffer(m_Phi)), *Gamma(kernel_t::buffer(m_Gamma));
+      multiply(Phi_half, Phi_half, Phi, n, n);
+      multiply(Phi_half, kernel_t::buffer(m_B_sum), Gamma, n, m);
+      {
+        FloatT k(FloatT(1) / std::sqrt(FloatT(m_predict_pending)));
+        for(unsigned i(0); i < n * m; i++){Gamma[i] *= k;}
+      }
+      m_predict_pending = 0;
+      m_filter.predict(m_Phi, m_Gamma);
       
-  public:    
+      // 等価なA = (Phi - I) / deltaT, B = Gamma / deltaT
+      // 時間間隔の合計が0の場合は、Phi - I, Gammaともに0であるため除算しない
+      FloatT deltaT(m_predict_deltaT);
+      for(unsigned i(0); i < n; i++){Phi[i * n + i] -= FloatT(1);}
+      if(deltaT != FloatT(0)){
+        for(unsigned i(0); i < n * n; i++){Phi[i] /= deltaT;}
+        for(unsigned i(0); i < n * m; i++){Gamma[i] /= deltaT;}
+      }
+      before_update_INS(m_Phi, m_Gamma, deltaT);
+    }
+    
+    /**
+     * 共分散の時間更新を行うサンプル間隔を取得、設定します。
+     * 1(デフォルト)の場合、毎サンプル時間更新します。
+     * 2以上の場合、そのサンプル数ごとに積算した@f$ \Phi @f$とプロセスノイズでまとめて時間更新します。
+     * 0の場合、観測更新の直前(もしくはgetFilter()の呼び出し時)にのみ時間更新します。
+     * 状態量(航法解)自体は常に毎サンプル更新されます。
+     * 
+     * @return (unsigned &) サンプル間隔
+     */
+    unsigned &predict_interval(){return m_predict_interval;}
+    
+
     /**
-     * ԍXV(Time Update)
+     * 時間更新(Time Update)
      * 
-     * @param accel x
-     * @param gyro px
-     * @param deltaT ԊԊu
+     * @param accel 加速度
+     * @param gyro 角速度
+     * @param deltaT 時間間隔
      */
     void update(const Vector3<FloatT> &accel, const Vector3<FloatT> &gyro, const FloatT &deltaT){
       
-      // ]švZ
+      // 回転行列の計算
       Matrix<FloatT> dcm_e2n((this->q_e2n).getDCM());
       Matrix<FloatT> dcm_n2b((this->q_n2b).getDCM());
     
       Matrix<FloatT> A(getA(accel, gyro, dcm_e2n, dcm_n2b));
       Matrix<FloatT> B(getB(accel, gyro, dcm_n2b));
-      m_filter.predict(A, B, deltaT);
-      before_update_INS(A, B, deltaT);
+      predict_filter(A, B, deltaT);
       INS<FloatT>::update(accel, gyro, deltaT);
     }
   
   protected:
     /**
-     * ϑXV(Measurement Update)ɂČ㏈邽߂̃R[obN֐B
-     * ftHgł͉܂B
+     * 観測更新(Measurement Update)において後処理をするためのコールバック関数。
+     * デフォルトでは何もしません。
      * 
-     * @param H Hs
-     * @param R Rs
-     * @param K KsAJ}QC
-     * @param v (z - H x)łEKFx[ł邽zɓ
-     * @param x_hat C
+     * @param H H行列
+     * @param R R行列
+     * @param K K行列、カルマンゲイン
+     * @param v (z - H x)ここではEKFでxがゼロであるためzに等しい
+     * @param x_hat 修正量
      */
     virtual inline void before_correct_INS(
         const Matrix<FloatT> &H,
@@ -478,28 +656,29 @@ class Filtered_INS2 : public INS<FloatT>, public Filtered_INS2_Property {
       ){}
       
     /**
-     * Kalman Filterɂēꂽ@f$ \Hat{x} @f$𗘗pāAINSC܂B
+     * Kalman Filterによって得られた@f$ \Hat{x} @f$を利用して、INSを修正します。
      * 
-     * @param x_hat Kalman Filterɂēꂽx_hat
+     * @param x_hat Kalman Filterによって得られたx_hat
      */
     inline void correct_INS(Matrix<FloatT> &x_hat){
       
-      // x
+      // 速度
       for(unsigned i = 0; i < 3; i++){(*this)[i] -= x_hat(i, 0);}
       
-      // 2DʒuC
+      // 2D位置修正
 #ifndef pow2
 #define pow2(x) ((x) * (x))
 #else
 #define ALREADY_POW2_DEFINED
 #endif
+      // 補正量は丸め誤差程度と小さいことがあるため、倍精度の位置に対して行う(INS::m_position_precise参照)
       Quaternion<FloatT> delta_q_e2n(1, -x_hat(3, 0), -x_hat(4, 0), -x_hat(5, 0));
-      (this->q_e2n) = delta_q_e2n * (this->q_e2n);
+      INS<FloatT>::rotate_position(delta_q_e2n);
       
-      // zʒu
-      (*this)[7] -= x_hat(6, 0);
+      // z位置
+      INS<FloatT>::add_position(Quaternion<FloatT>(0, 0, 0, 0), -x_hat(6, 0));
       
-      // pC
+      // 姿勢修正
       Quaternion<FloatT> delta_q_n2b(1, -x_hat(7, 0), -x_hat(8, 0), -x_hat(9, 0));
       (this->q_n2b) = delta_q_n2b * (this->q_n2b);
 #ifdef ALREADY_POW2_DEFINED
@@ -513,30 +692,58 @@ class Filtered_INS2 : public INS<FloatT>, public Filtered_INS2_Property {
       INS<FloatT>::recalc();
     }
 
+    /**
+     * カルマンフィルタを観測更新し、カルマンゲインを求めます。
+     * 順次処理モードの場合、@f$ R @f$が対角行列であれば観測を1つずつスカラー観測として処理します。
+     * 
+     * @param H 観測行列
+     * @param R 誤差共分散行列
+     * @return (Matrix<FloatT>) カルマンゲイン
+     * @see KalmanFilter::correct_sequential()
+     */
+    inline Matrix<FloatT> correct_filter(const Matrix<FloatT> &H, const Matrix<FloatT> &R){
+      flush_predict();
+      return m_sequential_correct ? m_filter.correct_sequential(H, R) : m_filter.correct(H, R);
+    }
+
   public:
     /**
-     * ϑXV(Measurement Update)܂B
+     * 観測更新(Measurement Update)します。
      * 
-     * @param H ϑs
-     * @param z ϑ
-     * @param R 덷Us
+     * @param H 観測行列
+     * @param z 観測量
+     * @param R 誤差共分散行列
      */
     void correct(const Matrix<FloatT> &H, const Matrix<FloatT> &z, const Matrix<FloatT> &R){
             
-      // Cʂ̌vZ
-      Matrix<FloatT> K(m_filter.correct(H, R)); //J}QC
+      // 修正量の計算
+      Matrix<FloatT> K(correct_filter(H, R)); //カルマンゲイン
       Matrix<FloatT> x_hat(K * z);
       before_correct_INS(H, R, K, z, x_hat);
       
       correct_INS(x_hat);
     }
     /**
-     * tB^[擾܂B
-     * PsQs񂪗~ꍇgetFilter().getP()ȂǂƂĂB
+     * フィルターを取得します。
+     * P行列やQ行列が欲しい場合はgetFilter().getP()などとしてください。
+     * 未反映の時間更新がある場合、それを反映してから返します。
+     * 
+     * @return (Filter &) フィルター
+     * @see flush_predict()
+     */
+    Filter &getFilter(){
+      flush_predict();
+      return m_filter;
+    }
+    
+    /**
+     * 観測更新の順次処理モードを取得、設定します。
+     * trueの場合、対角行列である@f$ R @f$を伴う観測更新では、
+     * 観測を1つずつ独立なスカラー観測として処理するため、逆行列の計算が不要となります。
      * 
-     * @return (Filter &) tB^[
+     * @return (bool &) 順次処理する場合true
      */
-    Filter &getFilter(){return m_filter;}
+    bool &sequential_correct(){return m_sequential_correct;}
 };
 
 #endif /* __FILTERED_INS2_H__ */
@@ -24,7 +24,7 @@
 #include "navigation/Filtered_INS2.h"
 #include "algorithm/kalman.h"
 
-#define BIAS_EST_MODE 2 // [_܂
+#define BIAS_EST_MODE 2 // 初期ゼロ点推定含む
 #define ZERO_CONST_ALPHA 0 //(FloatT(1) / 1E4) // 0
 
 #ifndef BIAS_EST_MODE
@@ -40,7 +40,7 @@ class Filtered_INS_BiasEstimated : public FINS{
     Vector3<FloatT> m_bias_accel;
     Vector3<FloatT> m_bias_gyro;
     FloatT m_deltaT_sum;
-    Vector3<FloatT> m_beta_accel, m_beta_gyro; // x[^̏C!!
+    Vector3<FloatT> m_beta_accel, m_beta_gyro; // ベータの修正を!!
     
 #if BIAS_EST_MODE == 1
     Vector3<FloatT> previous_modified_bias_accel;
@@ -66,7 +66,7 @@ class Filtered_INS_BiasEstimated : public FINS{
 #if defined(_MSC_VER)
         = FINS::STATE_VALUES + 6
 #endif
-        ; ///< ԗʂ̐
+        ; ///< 状態量の数
     virtual unsigned state_values() const {return STATE_VALUES;}
     
     Filtered_INS_BiasEstimated() 
@@ -84,14 +84,14 @@ class Filtered_INS_BiasEstimated : public FINS{
 #endif
         {
       
-      // Us̏
+      // 共分散行列の初期化
     }
     
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
      * 
-     * @param orig Rs[
-     * @param deepcopy fB[vRs[쐬邩ǂ
+     * @param orig コピー元
+     * @param deepcopy ディープコピーを作成するかどうか
      */
     Filtered_INS_BiasEstimated(
         const Filtered_INS_BiasEstimated &orig, 
@@ -140,26 +140,64 @@ class Filtered_INS_BiasEstimated : public FINS{
         default: return INS<FloatT>::operator[](index);
       }
     }
+    
+    static const unsigned AUX_VALUES = 1
+#if BIAS_EST_MODE == 1
+        + 6
+#elif BIAS_EST_MODE == 2
+        + 7
+#endif
+        ; ///< 状態量以外の内部状態の数
+    
+    /**
+     * 状態量以外の内部状態(バイアスの減衰に用いる積算時間など)を返します。
+     * 状態量(operator[]())と合わせて保存、復元することで、処理を途中から再開できます。
+     * 内訳はBIAS_EST_MODEによります。
+     * 
+     * @param index 内部状態番号、0～(AUX_VALUES - 1)
+     * @return 内部状態(への参照、代入も可)
+     */
+    FloatT &aux(const unsigned &index){
+      switch(index){
+#if BIAS_EST_MODE == 1
+        case 1: return previous_modified_bias_accel[0];
+        case 2: return previous_modified_bias_accel[1];
+        case 3: return previous_modified_bias_accel[2];
+        case 4: return previous_modified_bias_gyro[0];
+        case 5: return previous_modified_bias_gyro[1];
+        case 6: return previous_modified_bias_gyro[2];
+#elif BIAS_EST_MODE == 2
+        case 1: return previous_delteT_sum;
+        case 2: return drift_bias_accel[0];
+        case 3: return drift_bias_accel[1];
+        case 4: return drift_bias_accel[2];
+        case 5: return drift_bias_gyro[0];
+        case 6: return drift_bias_gyro[1];
+        case 7: return drift_bias_gyro[2];
+#endif
+        case 0: default: return m_deltaT_sum;
+      }
+    }
 
     using FINS::before_update_INS;
     
     /**
-     * ԍXV
+     * 時間更新
      * 
-     * @param accel xv̒l
-     * @param gyro WC̒l
-     * @param deltaT ԊԊu
+     * @param accel 加速度計の値
+     * @param gyro ジャイロの値
+     * @param deltaT 時間間隔
      */
     void update(const Vector3<FloatT> &accel, const Vector3<FloatT> &gyro, const FloatT &deltaT){
       
-      // ܂oCAX
+      // まずバイアス除去
       Vector3<FloatT> _accel(accel + m_bias_accel);
       Vector3<FloatT> _gyro(gyro + m_bias_gyro);
       
       Matrix<FloatT> orig_A(FINS::getA(_accel, _gyro));
       Matrix<FloatT> orig_B(FINS::getB(_accel, _gyro));
       
-      // KFp̍svZ
+      // KF用の行列計算
       Matrix<FloatT> A(P_SIZE, P_SIZE);
       {
         A.pivotMerge(0, 0, orig_A);
@@ -185,61 +223,60 @@ class Filtered_INS_BiasEstimated : public FINS{
       //cout << "A:" << A << endl;
       //cout << "B:" << B << endl;
       
-      // ˂
-      FINS::m_filter.predict(A, B, deltaT);
-      before_update_INS(A, B, deltaT);
+      // 突っ込む
+      FINS::predict_filter(A, B, deltaT);
       INS<FloatT>::update(_accel, _gyro, deltaT);
       
-      // Ԃ𑫂
+      // 時間を足す
       m_deltaT_sum += deltaT;
     }
     
     /**
-     * C܂B
+     * 修正します。
      * 
-     * @param H ϑs
-     * @param z ϑ
-     * @param R 덷Us
+     * @param H 観測行列
+     * @param z 観測量
+     * @param R 誤差共分散行列
      */
     void correct(const Matrix<FloatT> &H, const Matrix<FloatT> &z, const Matrix<FloatT> &R){
       
 #if BIAS_EST_MODE == 0
-      { //1
-        // oCAX炵Ă
+      { //その1
+        // バイアスを減らしておく
         for(unsigned i = 0; i < Vector3<FloatT>::OUT_OF_INDEX; i++){
           m_bias_accel[i] *= exp(-m_beta_accel[i] * m_deltaT_sum);
           m_bias_gyro[i] *= exp(-m_beta_gyro[i] * m_deltaT_sum);
         }
         m_deltaT_sum = 0;
         
-        // ˂
+        // 突っ込む
         FINS::correct(H, z, R);
       }
 
 #elif BIAS_EST_MODE == 1
-      { // 2
+      { // その2
         Vector3<FloatT> _bias_accel(m_bias_accel.copy());
         Vector3<FloatT> _bias_gyro(m_bias_gyro.copy());
         
-        // ˂
+        // 突っ込む
         FINS::correct(H, z, R);
         
         _bias_accel -= m_bias_accel;
         _bias_gyro -= m_bias_gyro;
         
-        // oCAX炵Ă
+        // バイアスを減らしておく
         m_bias_accel -= previous_modified_bias_accel * exp(-m_beta_accel * m_deltaT_sum);
         m_bias_gyro -= previous_modified_bias_gyro * exp(-m_beta_gyro * m_deltaT_sum);
         m_deltaT_sum = 0;
         
-        // ۑĂ
+        // 保存しておく
         previous_modified_bias_accel = _bias_accel;
         previous_modified_bias_gyro = _bias_gyro;
       }
 
 #elif BIAS_EST_MODE == 2
-      { // 3A[_܂
-        // oCAX炵Ă
+      { // その3、初期ゼロ点推定含む
+        // バイアスを減らしておく
         for(unsigned i = 0; i < Vector3<FloatT>::OUT_OF_INDEX; i++){
           {
             FloatT delta_drift_accel(
@@ -261,15 +298,15 @@ class Filtered_INS_BiasEstimated : public FINS{
         Vector3<FloatT> before_correct_bias_accel(m_bias_accel.copy());
         Vector3<FloatT> before_correct_bias_gyro(m_bias_gyro.copy());
         
-        // ˂
+        // 突っ込む
         FINS::correct(H, z, R);
         
-        // Cʂ̕z
+        // 修正量の分配
         {
           Vector3<FloatT> delta_bias_accel(m_bias_accel - before_correct_bias_accel);
           Vector3<FloatT> delta_bias_gyro(m_bias_gyro - before_correct_bias_gyro);
           
-          // 萔̒͂
+          // 時定数の調整はここで
 #ifndef ZERO_CONST_ALPHA
 #define ZERO_CONST_ALPHA (FloatT(1) / 1000) // [sec]
 #endif
@@ -277,7 +314,7 @@ class Filtered_INS_BiasEstimated : public FINS{
           drift_bias_gyro += delta_bias_gyro * (1 - std::exp(-m_deltaT_sum * ZERO_CONST_ALPHA));
         }
         
-        // ̕ۑ
+        // 時刻の保存
         previous_delteT_sum = m_deltaT_sum;
       }
 #endif
@@ -20,9 +20,9 @@
 #define __INS_H__
 
 /** @file
- * @brief q@u(INS)
+ * @brief 慣性航法装置(INS)
  * 
- * q@u(INS)ɂċLqt@CB
+ * 慣性航法装置(INS)について記述したファイル。
  */
 
 #include <cmath>
@@ -31,11 +31,14 @@
   #define M_PI 3.1415926535897932384626433832795
 #endif
 
+#include <limits>
+
 #include "param/vector3.h"
 #include "param/quaternion.h"
+#include "algorithm/integral.h"
 #include "WGS84.h"
 
-typedef WGS84 Earth; ///< nf
+typedef WGS84 Earth; ///< 地球モデル
 
 #ifdef pow2
 #define POW2_ALREADY_DEFINED
@@ -45,64 +48,91 @@ typedef WGS84 Earth; ///< 
 
 
 /**
- * @brief Xgbv_Eq@u(INS)
+ * @brief ストラップダウン慣性航法装置(INS)
  * 
- * Xgbv_Eq@u(INS)̓LqNXB
- * xApx͂ƂāAq@A
- * ʒuAxAp߂܂B
+ * ストラップダウン慣性航法装置(INS)の動作を記述したクラス。
+ * 加速度、角速度を入力として、慣性航法方程式を解き、
+ * 位置、速度、姿勢を求めます。
  * 
- * @param FloatT ZxAʏdouble
+ * @param FloatT 演算精度、通常はdouble。
+ * floatの場合も位置の積分はdoubleで行います(m_position_precise参照)。
  */
 template <class FloatT>
 class INS{
+  public:
+    typedef FloatT float_t; ///< 演算精度
+    
+    /**
+     * 慣性航法方程式の積分方法
+     */
+    enum mechanization_t {
+      MECHANIZATION_EULER, ///< オイラー法(1次)、デフォルト
+      MECHANIZATION_RK4, ///< Runge-Kutta法(4次)、区間中の入力は一定とみなす
+      MECHANIZATION_INCREMENT ///< 区間の速度、角度増分による更新、INS_ConingScullingと組み合わせて使用
+    };
+  
   protected:
-    Vector3<FloatT> v_2e_4n;      ///< n-frameɂ鑬x @f$ \vec{v}_{e}^{n} @f$
-    FloatT v_N,                   ///< k̑x @f$ V_{N} @f$
-           v_E;                   ///< ̑x @f$ V_{E} @f$
+    Vector3<FloatT> v_2e_4n;      ///< n-frameにおける速度 @f$ \vec{v}_{e}^{n} @f$
+    FloatT v_N,                   ///< 北方向の速度 @f$ V_{N} @f$
+           v_E;                   ///< 東方向の速度 @f$ V_{E} @f$
     
-    Quaternion<FloatT> q_e2n;    ///< @f$ \Tilde{q}_{e}^{n} @f$AȂ킿݂̌oxAܓxAAzimuthp
-    FloatT h;                     ///< ݂̍x[m]
-    FloatT phi,                   ///< ܓx @f$ \phi @f$
-           lambda,                ///< ox @f$ \lambda @f$
-           alpha;                 ///< Azimuthp @f$ \alpha @f$
+    Quaternion<FloatT> q_e2n;    ///< @f$ \Tilde{q}_{e}^{n} @f$、すなわち現在の経度、緯度、Azimuth角
+    FloatT h;                     ///< 現在の高度[m]
     
-    Quaternion<FloatT> q_n2b;    ///< n-frame -> b-frmaeAȂ킿݂̎p
+    /**
+     * FloatTがdoubleより低精度の場合に用いる、倍精度の位置(q_e2n[0-3], h)。
+     * 1回の更新での位置の増分はFloatTの丸め誤差程度と小さく、そのまま加えると失われるため、
+     * 位置の積分や補正(rotate_position())はこちらで行い、q_e2n, hにはその丸めた値を設定します。
+     * q_e2n, hの成分が外部(初期化、状態量の設定など)で書き換えられ、丸めた値と一致しなくなった場合は、
+     * その成分のみそちらに合わせ直します。
+     */
+    double m_position_precise[5];
+    static const bool use_position_precise
+        = (std::numeric_limits<FloatT>::digits < std::numeric_limits<double>::digits);
+    
+    FloatT phi,                   ///< 緯度 @f$ \phi @f$
+           lambda,                ///< 経度 @f$ \lambda @f$
+           alpha;                 ///< Azimuth角 @f$ \alpha @f$
+    
+    Quaternion<FloatT> q_n2b;    ///< n-frame -> b-frmae、すなわち現在の姿勢
     
     Vector3<FloatT> omega_e2i_4e; ///< Earth Rate @f$ \Omega_{e/i}^{e} @f$
   
     Vector3<FloatT> omega_e2i_4n; ///< @f$ \vec{\omega}_{e/i}^{n} @f$
     Vector3<FloatT> omega_n2e_4n; ///< @f$ \vec{\omega}_{n/e}^{n} @f$
     
+    mechanization_t m_mechanization; ///< 積分方法
+    
   public:
-    static const unsigned STATE_VALUES = 12; ///< ԗʂ̐
+    static const unsigned STATE_VALUES = 12; ///< 状態量の数
     virtual unsigned state_values() const {return STATE_VALUES;}
     
     /**
-     * ]猻݈ʒu܂ł̋Ԃ܂B
-     * ŕ\
+     * 回転軸から現在位置までの距離を返します。
+     * 数式で表すと
      * @f[
      *    \left( R_{\mathrm{normal}} \left( \phi \right) + h \right) \cos{\phi} 
      * @f]
      * 
-     * @return (FloatT) ]猻݈ʒu܂ł̋
+     * @return (FloatT) 回転軸から現在位置までの距離
      */
     FloatT beta() const{return (Earth::R_normal(phi) + h) * std::cos(phi);}
   
   private:
     /**
-     * ܓx @f$ \phi @f$ @f$ \Tilde{q}_{e}^{n} @f$XV܂B
-     * IB
+     * 緯度 @f$ \phi @f$を @f$ \Tilde{q}_{e}^{n} @f$から更新します。
+     * 内部的。
      * 
-     * @return (FloatT) XVꂽܓx 
+     * @return (FloatT) 更新された緯度 
      */
     inline FloatT update_phi(){
       return phi = std::asin(FloatT(1) - (pow2(q_e2n.get(0)) + pow2(q_e2n.get(3))) * 2);
     }
     /**
-     * ox @f$ \lambda @f$ @f$ \Tilde{q}_{e}^{n} @f$XV܂B
-     * IB
+     * 経度 @f$ \lambda @f$を @f$ \Tilde{q}_{e}^{n} @f$から更新します。
+     * 内部的。
      * 
-     * @return (FloatT) XVꂽox 
+     * @return (FloatT) 更新された経度 
      */
     inline FloatT update_lambda(){
       return lambda = std::atan2(
@@ -110,10 +140,10 @@ class INS{
           (-q_e2n.get(0) * q_e2n.get(2) - q_e2n.get(1) * q_e2n.get(3)));
     }
     /**
-     * AWXp @f$ \alpha @f$ @f$ \Tilde{q}_{e}^{n} @f$XV܂B
-     * IB
+     * アジムス角 @f$ \alpha @f$を @f$ \Tilde{q}_{e}^{n} @f$から更新します。
+     * 内部的。
      * 
-     * @return (FloatT) XVꂽAWXp 
+     * @return (FloatT) 更新されたアジムス角 
      */
     inline FloatT update_alpha(){
       return alpha = std::atan2(
@@ -121,38 +151,38 @@ class INS{
           (q_e2n.get(1) * q_e2n.get(3) - q_e2n.get(0) * q_e2n.get(2)));
     }
     /**
-     * kx @f$ V_{N} @f$ @f$ \vec{v}_{e}^{n} @f$XV܂B
-     * IB
+     * 北方向速度 @f$ V_{N} @f$を @f$ \vec{v}_{e}^{n} @f$から更新します。
+     * 内部的。
      * 
      * @param calpha cos(alpha)
      * @param salpha sin(alpha)
-     * @return (FloatT) XVꂽkx 
+     * @return (FloatT) 更新された北方向速度 
      */
     inline FloatT update_v_N(const FloatT &calpha, const FloatT &salpha){
       return v_N = v_2e_4n.get(0) * calpha - v_2e_4n.get(1) * salpha;
     }
     /**
-     * x @f$ V_{E} @f$ @f$ \vec{v}_{e}^{n} @f$XV܂B
-     * IB
+     * 東方向速度 @f$ V_{E} @f$を @f$ \vec{v}_{e}^{n} @f$から更新します。
+     * 内部的。
      * 
      * @param calpha cos(alpha)
      * @param salpha sin(alpha)
-     * @return (FloatT) XVꂽx
+     * @return (FloatT) 更新された東方向速度
      */
     inline FloatT update_v_E(const FloatT &calpha, const FloatT &salpha){
       return v_E = v_2e_4n.get(0) * salpha + v_2e_4n.get(1) * calpha;
     }
     
     /**
-     * ݈ʒuł@f$ \vec{\omega}_{e/i}^{n} @f$߂܂B
-     * IB
+     * 現在位置上での@f$ \vec{\omega}_{e/i}^{n} @f$を求めます。
+     * 内部的。
      */
     inline void update_omega_e2i_4n(){
       omega_e2i_4n = (q_e2n.conj() * omega_e2i_4e * q_e2n).vector();
     }
     /**
-     * ݈ʒuł@f$ \vec{\omega}_{n/e}^{n} @f$߂܂B
-     * IB
+     * 現在位置上での@f$ \vec{\omega}_{n/e}^{n} @f$を求めます。
+     * 内部的。
      *
      * @param calpha cos(alpha)
      * @param salpha sin(alpha)
@@ -165,78 +195,162 @@ class INS{
       omega_n2e_4n[1] = -omega_n2e_4g_0 * salpha + omega_n2e_4g_1 * calpha;
     }
     /**
-     * ݈ʒuł@f$ \vec{\omega}_{n/e}^{n} @f$߂܂B
-     * IB
+     * 現在位置上での@f$ \vec{\omega}_{n/e}^{n} @f$を求めます。
+     * 内部的。
      */
     inline void update_omega_n2e_4n(){
       update_omega_n2e_4n(std::cos(alpha), std::sin(alpha));
     }
   protected:
     /**
-     * tяČvZčŐV̏Ԃɕۂ܂B
+     * 倍精度の位置の成分を返します。
+     * 丸めた値がq_e2n, hの対応する成分と一致しない場合は、そちらの値を返します。
+     * 
+     * @param i 0-3はq_e2nの成分、4は高度
+     * @return (double) 倍精度の値
+     */
+    double position_precise(const int &i) const {
+      FloatT v((i < 4) ? q_e2n.get(i) : h);
+      return (use_position_precise && (FloatT(m_position_precise[i]) == v))
+          ? m_position_precise[i] : double(v);
+    }
+    
+    /**
+     * 倍精度の位置をq_e2n, hに合わせます。
+     * 
+     * @param force 丸めた値が一致している成分も合わせる場合true
+     */
+    void sync_position_precise(const bool &force = false){
+      for(int i(0); i < 5; i++){
+        m_position_precise[i] = force
+            ? double((i < 4) ? q_e2n.get(i) : h)
+            : position_precise(i);
+      }
+    }
+    
+    /**
+     * 位置に増分を加えます。
      * 
-     * @param regularize ̃NH[^jI𐳋K(m1ɂ)ǂ
+     * @param delta_q_e2n @f$ \Tilde{q}_{e}^{n} @f$の増分
+     * @param delta_h 高度の増分
+     */
+    void add_position(const Quaternion<FloatT> &delta_q_e2n, const FloatT &delta_h){
+      if(!use_position_precise){
+        q_e2n += delta_q_e2n;
+        h += delta_h;
+        return;
+      }
+      sync_position_precise();
+      for(int i(0); i < 4; i++){
+        q_e2n[i] = FloatT(m_position_precise[i] += delta_q_e2n.get(i));
+      }
+      h = FloatT(m_position_precise[4] += delta_h);
+    }
+    
+    /**
+     * 位置を@f$ \Tilde{q}_{e}^{n} \leftarrow \Delta \Tilde{q}_{e}^{n} \Tilde{q}_{e}^{n} @f$として回転します。
+     * 補正量はFloatTの丸め誤差程度と小さいことがあるため、積は倍精度の位置に対して求めます。
+     * 
+     * @param delta_q_e2n 回転を表すクォータニオン
+     */
+    void rotate_position(const Quaternion<FloatT> &delta_q_e2n){
+      if(!use_position_precise){
+        q_e2n = delta_q_e2n * q_e2n;
+        return;
+      }
+      sync_position_precise();
+      const double
+          a0(delta_q_e2n.get(0)), a1(delta_q_e2n.get(1)),
+          a2(delta_q_e2n.get(2)), a3(delta_q_e2n.get(3));
+      double *b(m_position_precise);
+      double res[4] = {
+        a0 * b[0] - a1 * b[1] - a2 * b[2] - a3 * b[3],
+        a0 * b[1] + a1 * b[0] + a2 * b[3] - a3 * b[2],
+        a0 * b[2] - a1 * b[3] + a2 * b[0] + a3 * b[1],
+        a0 * b[3] + a1 * b[2] - a2 * b[1] + a3 * b[0]};
+      for(int i(0); i < 4; i++){
+        q_e2n[i] = FloatT(b[i] = res[i]);
+      }
+    }
+    
+    /**
+     * 付帯情報を再計算して最新の状態に保ちます。
+     * 
+     * @param regularize 内部のクォータニオンを正規化(ノルムを1にする)かどうか
      */
     inline void recalc(const bool regularize = true){
-      //K
+      //正規化
       if(regularize){
-        q_e2n = q_e2n.regularize();
+        if(use_position_precise){
+          sync_position_precise();
+          double norm(0);
+          for(int i(0); i < 4; i++){norm += pow2(m_position_precise[i]);}
+          norm = std::sqrt(norm);
+          for(int i(0); i < 4; i++){
+            q_e2n[i] = FloatT(m_position_precise[i] /= norm);
+          }
+        }else{
+          q_e2n = q_e2n.regularize();
+        }
         q_n2b = q_n2b.regularize();
       }
       
-      //ܓxAoxAAzimuthp̍XV
+      //緯度、経度、Azimuth角の更新
       update_phi();
       update_lambda();
       update_alpha();
       
       FloatT ca(std::cos(alpha)), sa(std::sin(alpha));
 
-      //v_north, v_east̍XV
+      //v_north, v_eastの更新
       update_v_N(ca, sa);
       update_v_E(ca, sa);
       
-      //_{e/i}^{n}
+      //ω_{e/i}^{n}
       update_omega_e2i_4n();
       
-      //_{n/e}^{n}
+      //ω_{n/e}^{n}
       update_omega_n2e_4n(ca, sa);
     }
     
   public:
     /**
-     * ʒu܂B
+     * 位置を初期化します。
+     * FloatTによらず、倍精度で与えます(m_position_precise参照)。
      * 
-     * @param latitude ܓx @f$ \phi @f$
-     * @param longitude ox @f$ \lambda @f$
-     * @param height x @f$ h @f$
+     * @param latitude 緯度 @f$ \phi @f$
+     * @param longitude 経度 @f$ \lambda @f$
+     * @param height 高度 @f$ h @f$
      */
-    void initPosition(const FloatT &latitude, const FloatT &longitude, const FloatT &height){
+    void initPosition(const double &latitude, const double &longitude, const double &height){
       using std::cos;
       using std::sin;
       phi = latitude;
       lambda = longitude;
       alpha = 0;
 
-      FloatT cl(cos(lambda / 2)), sl(sin(lambda / 2));
-      FloatT cp(cos(-phi / 2)), sp(sin(-phi / 2));
-      FloatT sqrt2(std::sqrt(2.));
+      double cl(cos(longitude / 2)), sl(sin(longitude / 2));
+      double cp(cos(-latitude / 2)), sp(sin(-latitude / 2));
+      double sqrt2(std::sqrt(2.));
 
-      q_e2n[0] = cl * (cp + sp) / sqrt2;
-      q_e2n[1] = sl * (cp - sp) / sqrt2;
-      q_e2n[2] = -cl * (cp - sp) / sqrt2;
-      q_e2n[3] = sl * (cp + sp) / sqrt2;
-      h = height;
+      m_position_precise[0] = cl * (cp + sp) / sqrt2;
+      m_position_precise[1] = sl * (cp - sp) / sqrt2;
+      m_position_precise[2] = -cl * (cp - sp) / sqrt2;
+      m_position_precise[3] = sl * (cp + sp) / sqrt2;
+      m_position_precise[4] = height;
+      for(int i(0); i < 4; i++){q_e2n[i] = FloatT(m_position_precise[i]);}
+      h = FloatT(height);
       
       update_omega_e2i_4n();
       update_omega_n2e_4n();
     }
     
     /**
-     * x܂B
+     * 速度を初期化します。
      * 
-     * @param v_north kx @f$ V_{N} @f$
-     * @param v_east x @f$ V_{E} @f$
-     * @param v_down x @f$ V_{D} @f$
+     * @param v_north 北方向速度 @f$ V_{N} @f$
+     * @param v_east 東方向速度 @f$ V_{E} @f$
+     * @param v_down 下方向速度 @f$ V_{D} @f$
      */
     void initVelocity(const FloatT &v_north, const FloatT &v_east, const FloatT &v_down){
       v_2e_4n[0] = v_N = v_north;
@@ -248,13 +362,13 @@ class INS{
     
   protected:
     /**
-     * IC[pquarternionɕϊ܂B
+     * オイラー角からquarternionに変換します。
      * 
-     * @param yaw [@f$ \Psi @f$
-     * @param pitch sb`@f$ \Theta @f$
-     * @param roll [@f$ \Phi @f$
-     * @param res ʂi[
-     * @return (Quaternion<FloatT>) ϊ
+     * @param yaw ヨー@f$ \Psi @f$
+     * @param pitch ピッチ@f$ \Theta @f$
+     * @param roll ロール@f$ \Phi @f$
+     * @param res 結果を格納する先
+     * @return (Quaternion<FloatT>) 変換結果
      */
     static Quaternion<FloatT> &euler2q_internal(
         const FloatT &yaw, const FloatT &pitch, const FloatT &roll,
@@ -274,12 +388,12 @@ class INS{
     
   public:
     /**
-     * IC[pquarternionɕϊ܂B
+     * オイラー角からquarternionに変換します。
      * 
-     * @param yaw [@f$ \Psi @f$
-     * @param pitch sb`@f$ \Theta @f$
-     * @param roll [@f$ \Phi @f$
-     * @return (Quaternion<FloatT>) ϊ
+     * @param yaw ヨー@f$ \Psi @f$
+     * @param pitch ピッチ@f$ \Theta @f$
+     * @param roll ロール@f$ \Phi @f$
+     * @return (Quaternion<FloatT>) 変換結果
      */
     static Quaternion<FloatT> euler2q(
         const FloatT &yaw, const FloatT &pitch, const FloatT &roll){
@@ -288,40 +402,40 @@ class INS{
     }
     
     /**
-     * p܂B
+     * 姿勢を初期化します。
      * 
-     * @param yaw [@f$ \Psi @f$
-     * @param pitch sb`@f$ \Theta @f$
-     * @param roll [@f$ \Phi @f$
+     * @param yaw ヨー@f$ \Psi @f$
+     * @param pitch ピッチ@f$ \Theta @f$
+     * @param roll ロール@f$ \Phi @f$
      */
     void initAttitude(const FloatT &yaw, const FloatT &pitch, const FloatT &roll){
       euler2q_internal(yaw, pitch, roll, q_n2b);
     }
     
     /**
-     * p܂B
+     * 姿勢を初期化します。
      * 
-     * @param q p킷quarternion
+     * @param q 姿勢をあらわすquarternion
      */
     void initAttitude(const Quaternion<FloatT> &q){
       q_n2b = q.copy();
     }
   
     /**
-     * RXgN^
+     * コンストラクタ
      * 
      */
-    INS() : omega_e2i_4e(0, 0, Earth::Omega_Earth){
+    INS() : omega_e2i_4e(0, 0, Earth::Omega_Earth), m_mechanization(MECHANIZATION_EULER){
       initPosition(0, 0, 0);
       initVelocity(0, 0, 0);
       initAttitude(0, 0, 0); 
     }
     
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
      * 
-     * @param orig Rs[
-     * @param deepcopy fB[vRs[쐬邩ǂ
+     * @param orig コピー元
+     * @param deepcopy ディープコピーを作成するかどうか
      */
     INS(const INS &orig, const bool deepcopy = false) :
       v_2e_4n(deepcopy ? orig.v_2e_4n.copy() : orig.v_2e_4n), 
@@ -331,28 +445,32 @@ class INS{
       q_n2b(deepcopy ? orig.q_n2b.copy() : orig.q_n2b), 
       omega_e2i_4e(deepcopy ? orig.omega_e2i_4e.copy() : orig.omega_e2i_4e), 
       omega_e2i_4n(deepcopy ? orig.omega_e2i_4n.copy() : orig.omega_e2i_4n), 
-      omega_n2e_4n(deepcopy ? orig.omega_n2e_4n.copy() : orig.omega_n2e_4n){
+      omega_n2e_4n(deepcopy ? orig.omega_n2e_4n.copy() : orig.omega_n2e_4n),
+      m_mechanization(orig.m_mechanization){
+      for(int i(0); i < 5; i++){
+        m_position_precise[i] = orig.m_position_precise[i];
+      }
     }
     
     /**
-     * fXgN^
+     * デストラクタ
      * 
      */
     virtual ~INS(){}
     
     /**
-     * ԗʂ֒ڃANZXB
-     * CfbNXw肵ČĂяo܂B
-     * CfbNX
-     *    0`2: @f$ \vec{v}_{e}^{n} @f$,
-     *    3`6: @f$ \Tilde{q}_{e}^{n} @f$,
+     * 状態量へ直接アクセス。
+     * インデックスを指定して呼び出します。
+     * インデックスは
+     *    0～2: @f$ \vec{v}_{e}^{n} @f$,
+     *    3～6: @f$ \Tilde{q}_{e}^{n} @f$,
      *    7: @f$ h @f$,
-     *    8`11: @f$ \Tilde{q}_{n}^{b} @f$
-     * łB
-     * ԗʂOύXۂ͕Krecalc()邱ƁB
+     *    8～11: @f$ \Tilde{q}_{n}^{b} @f$
+     * です。
+     * 状態量を外部から変更した際は必ずrecalc()をすること。
      * 
-     * @param index ԗʔԍ
-     * @return ԗ(ւ̎QƁA)
+     * @param index 状態量番号
+     * @return 状態量(への参照、代入も可)
      * @see recalc()
      */
     virtual FloatT &operator[](const unsigned &index){
@@ -368,7 +486,7 @@ class INS{
         case 9:  return q_n2b[1];
         case 10: return q_n2b[2];
         case 11: return q_n2b[3];
-        case 0: default: return v_2e_4n[0]; // CfbNX͈͊ȌꍇA[0]̗vfԂ
+        case 0: default: return v_2e_4n[0]; // インデックス範囲外の場合、[0]の要素を返す
       }
     }
     
@@ -381,16 +499,123 @@ class INS{
     }
     
     /**
-     * INSXV܂B
-     * Iɂ̓IC[ϕ(1)𗘗pĂ܂B
+     * 状態量を倍精度で取得します。
+     * 位置(インデックス3-7)は、FloatTによらず丸める前の値を返します(m_position_precise参照)。
      * 
-     * @param accel x
-     * @param gyro px
-     * @param deltaT O̍XV̎ԊԊu
+     * @param index インデックス
+     * @return (double) 状態量
      */
-    virtual void update(const Vector3<FloatT> &accel, const Vector3<FloatT> &gyro, const FloatT &deltaT){
+    double get_precise(const unsigned &index) const {
+      return ((index >= 3) && (index <= 7)) ? position_precise(index - 3) : double(get(index));
+    }
+    
+    /**
+     * 状態量を倍精度で設定します。
+     * 位置(インデックス3-7)は、丸める前の値も保持します。
+     * get_precise()と組み合わせることで、精度を落とさずに状態を保存、復元できます。
+     * 
+     * @param index インデックス
+     * @param v 状態量
+     */
+    void set_precise(const unsigned &index, const double &v){
+      (*this)[index] = FloatT(v);
+      if(use_position_precise && (index >= 3) && (index <= 7)){
+        m_position_precise[index - 3] = v;
+      }
+    }
+    
+    /**
+     * 状態量をまとめて設定し、付帯情報を再計算(recalc())します。
+     * 保存しておいた状態量から処理を再開する場合などに利用します。
+     * 
+     * @param values 状態量、要素数はstate_values()
+     */
+    void set_states(const FloatT *values){
+      for(unsigned i(0); i < state_values(); i++){
+        (*this)[i] = values[i];
+      }
+      recalc(false);
+    }
+    
+    /**
+     * 倍精度の状態量をまとめて設定し、付帯情報を再計算(recalc())します。
+     * get_precise()で保存しておいた状態量から、精度を落とさずに処理を再開する場合に利用します。
+     * 
+     * @param values 状態量、要素数はstate_values()
+     * @see set_precise()
+     */
+    void set_states_precise(const double *values){
+      for(unsigned i(0); i < state_values(); i++){
+        set_precise(i, values[i]);
+      }
+      recalc(false);
+    }
+    
+    /**
+     * 積分方法を取得、設定します。
+     * 
+     * @return (mechanization_t &) 積分方法
+     * @see update()
+     */
+    mechanization_t &mechanization(){return m_mechanization;}
+    
+    /**
+     * 状態量(速度、位置、高度、姿勢)の組。
+     * その時間微分の表現にも用い、nextByRK4()で積分するための演算を備えます。
+     * 各要素はディープコピーされた独立のものとして扱います。
+     */
+    struct state_t {
+      Vector3<FloatT> v_2e_4n;
+      Quaternion<FloatT> q_e2n;
+      FloatT h;
+      Quaternion<FloatT> q_n2b;
+      
+      state_t operator*(const FloatT &t) const {
+        state_t res = {v_2e_4n * t, q_e2n * t, h * t, q_n2b * t};
+        return res;
+      }
+      state_t operator/(const FloatT &t) const {return operator*(FloatT(1) / t);}
+      state_t operator+(const state_t &another) const {
+        state_t res = {
+            v_2e_4n + another.v_2e_4n, q_e2n + another.q_e2n,
+            h + another.h, q_n2b + another.q_n2b};
+        return res;
+      }
+    };
+    
+  protected:
+    /**
+     * 現在の状態量を返します。
+     * 
+     * @return (state_t) 状態量(ディープコピー)
+     */
+    state_t get_state() const {
+      state_t res = {v_2e_4n.copy(), q_e2n.copy(), h, q_n2b.copy()};
+      return res;
+    }
+    
+    /**
+     * 状態量を設定します。付帯情報の再計算(recalc())は行いません。
+     * 
+     * @param state 状態量
+     */
+    void set_state(const state_t &state){
+      v_2e_4n = state.v_2e_4n.copy();
+      q_e2n = state.q_e2n.copy();
+      h = state.h;
+      q_n2b = state.q_n2b.copy();
+    }
+    
+    /**
+     * 現在の状態量における慣性航法方程式の時間微分を求めます。
+     * 
+     * @param accel 加速度
+     * @param gyro 角速度
+     * @return (state_t) 時間微分
+     */
+    state_t differential(const Vector3<FloatT> &accel, const Vector3<FloatT> &gyro) const {
       
-      //x̉^
+      //速度の運動方程式
       Vector3<FloatT> delta_v_2e_4n((q_n2b * accel * q_n2b.conj()).vector());
       delta_v_2e_4n[2] += Earth::gravity(phi);
       delta_v_2e_4n -= (omega_e2i_4n * 2 + omega_n2e_4n) * v_2e_4n;
@@ -401,68 +626,237 @@ class INS{
                     0
                   );*/
       Vector3<FloatT> centripetal_f(
-                    q_e2n[1] * q_e2n[3] + q_e2n[0] * q_e2n[2],
-                    q_e2n[3] * q_e2n[2] - q_e2n[1] * q_e2n[0],
+                    q_e2n.get(1) * q_e2n.get(3) + q_e2n.get(0) * q_e2n.get(2),
+                    q_e2n.get(3) * q_e2n.get(2) - q_e2n.get(1) * q_e2n.get(0),
                     0
-                  ); // v
+                  ); // 符号要検討
       centripetal_f *= (pow2(Earth::Omega_Earth) * (Earth::R_normal(phi) + h) * 2);
       delta_v_2e_4n -= (q_e2n.conj() * centripetal_f * q_e2n).vector();
       
-      //ʒủ^
+      //位置の運動方程式
       Quaternion<FloatT> delta_q_e2n(q_e2n * omega_n2e_4n);
       delta_q_e2n /= 2;
-      FloatT delta_h(v_2e_4n[2] * -1);
+      FloatT delta_h(v_2e_4n.get(2) * -1);
       
-      //p̉^
+      //姿勢の運動方程式
       Quaternion<FloatT> dot_q_n2b(0, omega_e2i_4n + omega_n2e_4n);
       dot_q_n2b *= q_n2b;
       dot_q_n2b -= q_n2b * gyro;
       dot_q_n2b /= (-2);
       
-      //XV
-      v_2e_4n += delta_v_2e_4n * deltaT;
-      q_e2n += delta_q_e2n * deltaT;
-      h += delta_h * deltaT;
-      q_n2b += dot_q_n2b * deltaT;
+      state_t res = {delta_v_2e_4n, delta_q_e2n, delta_h, dot_q_n2b};
+      return res;
+    }
+    
+    /**
+     * nextByRK4()に与える差分方程式。
+     * 途中の状態量での微分を求めるため、INS自身の状態量を一時的に書き換えます。
+     */
+    struct differential_functor_t {
+      INS<FloatT> &ins;
+      const Vector3<FloatT> &accel, &gyro;
+      state_t operator()(const FloatT &t, const state_t &state) const {
+        ins.set_state(state);
+        ins.recalc(false);
+        return ins.differential(accel, gyro);
+      }
+    };
+    
+    /**
+     * 回転ベクトルを回転を表すクォータニオンに変換します。
+     * 
+     * @param v 回転ベクトル
+     * @return (Quaternion<FloatT>) @f$ \left( \cos \frac{|v|}{2}, \frac{v}{|v|} \sin \frac{|v|}{2} \right) @f$
+     */
+    static Quaternion<FloatT> rotation2q(const Vector3<FloatT> &v){
+      FloatT theta2(v.abs2());
+      if(theta2 < FloatT(1E-12)){ // 級数展開
+        return Quaternion<FloatT>(FloatT(1) - theta2 / 8, v * (FloatT(0.5) - theta2 / 48));
+      }
+      FloatT theta(std::sqrt(theta2));
+      return Quaternion<FloatT>(std::cos(theta / 2), v * (std::sin(theta / 2) / theta));
+    }
+    
+    /**
+     * オイラー積分(1次)によりINSを更新します。
+     * 
+     * @param accel 加速度
+     * @param gyro 角速度
+     * @param deltaT 前回の更新からの時間間隔
+     */
+    void update_Euler(const Vector3<FloatT> &accel, const Vector3<FloatT> &gyro, const FloatT &deltaT){
+      state_t d(differential(accel, gyro));
+      
+      //更新
+      v_2e_4n += d.v_2e_4n * deltaT;
+      add_position(d.q_e2n * deltaT, d.h * deltaT);
+      q_n2b += d.q_n2b * deltaT;
       
-      //tI̍ČvZ
+      //付随的情報の再計算
       recalc();
     }
     
-    FloatT v_north() const{return v_N;}            /**< kxԂ܂B @return (FloatT) kx */
-    FloatT v_east() const{return v_E;}             /**< xԂ܂B @return (FloatT) x */
-    FloatT v_down() const{return v_2e_4n.get(2);}  /**< xԂ܂B @return (FloatT) x */
+    /**
+     * Runge-Kutta法(4次)によりINSを更新します。
+     * 区間中の加速度、角速度は一定とみなします。
+     * 
+     * @param accel 加速度
+     * @param gyro 角速度
+     * @param deltaT 前回の更新からの時間間隔
+     */
+    void update_RK4(const Vector3<FloatT> &accel, const Vector3<FloatT> &gyro, const FloatT &deltaT){
+      state_t state(get_state());
+      differential_functor_t f = {*this, accel, gyro};
+      state_t delta(deltaByRK4(f, FloatT(0), state, deltaT));
+      set_state(state);
+      v_2e_4n += delta.v_2e_4n;
+      add_position(delta.q_e2n, delta.h);
+      q_n2b += delta.q_n2b;
+      recalc();
+    }
     
-    FloatT latitude() const{return phi;}           /**< ܓxԂ܂B @return (FloatT) ܓx */
-    FloatT longitude() const{return lambda;}       /**< oxԂ܂B @return (FloatT) ox */
-    FloatT height() const{return h;}               /**< xԂ܂B @return (FloatT) x */
-    FloatT azimuth() const{return alpha;}          /**< AWXpԂ܂B @return (FloatT) AWXp */
+    /**
+     * 区間の速度増分、角度増分によりINSを更新します。
+     * 姿勢は回転ベクトル@f$ \vec{\phi} = \vec{\omega} \Delta t @f$と
+     * n-frameの回転@f$ \vec{\zeta} = (\vec{\omega}_{e/i}^{n} + \vec{\omega}_{n/e}^{n}) \Delta t @f$により
+     * @f$ \Tilde{q}_{n}^{b} \leftarrow \Tilde{q}(-\vec{\zeta}) \Tilde{q}_{n}^{b} \Tilde{q}(\vec{\phi}) @f$、
+     * 速度は比力の増分@f$ \Delta \vec{v}^{b} = \vec{a} \Delta t @f$を区間始点の姿勢でn-frameに変換し、
+     * n-frameの回転を@f$ - \frac{1}{2} \vec{\zeta} \times @f$で補償したものに、
+     * 重力、コリオリ力、遠心力の寄与を加えて更新します。
+     * 位置、高度は区間前後の速度の平均により更新します。
+     * 
+     * @param accel 速度増分を時間間隔で割ったもの、区間中のb-frameの回転(スカリング)補償済みであること
+     * @param gyro 角度増分(回転ベクトル)を時間間隔で割ったもの、コーニング補償済みであること
+     * @param deltaT 前回の更新からの時間間隔
+     * @see INS_ConingSculling
+     */
+    void update_increment(const Vector3<FloatT> &accel, const Vector3<FloatT> &gyro, const FloatT &deltaT){
+      Vector3<FloatT> zeta((omega_e2i_4n + omega_n2e_4n) * deltaT);
+      
+      // 速度
+      Vector3<FloatT> delta_v_4n((q_n2b * (accel * deltaT) * q_n2b.conj()).vector());
+      delta_v_4n -= (zeta * delta_v_4n) / 2;
+      state_t d(differential(Vector3<FloatT>(), gyro)); // 比力を除いた寄与
+      FloatT v_down_previous(v_2e_4n[2]);
+      v_2e_4n += (delta_v_4n += d.v_2e_4n * deltaT);
+      
+      // 位置、高度(台形則)
+      {
+        FloatT ca(std::cos(alpha)), sa(std::sin(alpha));
+        update_v_N(ca, sa);
+        update_v_E(ca, sa);
+        update_omega_n2e_4n(ca, sa);
+      }
+      Quaternion<FloatT> delta_q_e2n(q_e2n * omega_n2e_4n);
+      delta_q_e2n /= 2;
+      add_position(
+          (delta_q_e2n += d.q_e2n) * (deltaT / 2),
+          -(v_down_previous + v_2e_4n[2]) * (deltaT / 2));
+      
+      // 姿勢
+      q_n2b = rotation2q(-zeta) * q_n2b * rotation2q(gyro * deltaT);
+      
+      //付随的情報の再計算
+      recalc();
+    }
     
-    Quaternion<FloatT> n2b() const{return q_n2b.copy();}  /**< pNH[^jIŕԂ܂B @return (FloatT) p */
+  public:
+    /**
+     * INSを更新します。
+     * 積分方法はmechanization()により選択され、デフォルトはオイラー積分(1次)です。
+     * 
+     * @param accel 加速度
+     * @param gyro 角速度
+     * @param deltaT 前回の更新からの時間間隔
+     * @see mechanization()
+     */
+    virtual void update(const Vector3<FloatT> &accel, const Vector3<FloatT> &gyro, const FloatT &deltaT){
+      switch(m_mechanization){
+        case MECHANIZATION_RK4: update_RK4(accel, gyro, deltaT); break;
+        case MECHANIZATION_INCREMENT: update_increment(accel, gyro, deltaT); break;
+        case MECHANIZATION_EULER: default: update_Euler(accel, gyro, deltaT); break;
+      }
+    }
+    
+    FloatT v_north() const{return v_N;}            /**< 北方向速度を返します。 @return (FloatT) 北方向速度 */
+    FloatT v_east() const{return v_E;}             /**< 東方向速度を返します。 @return (FloatT) 東方向速度 */
+    FloatT v_down() const{return v_2e_4n.get(2);}  /**< 下方向速度を返します。 @return (FloatT) 下方向速度 */
+    
+    FloatT latitude() const{return phi;}           /**< 緯度を返します。 @return (FloatT) 緯度 */
+    FloatT longitude() const{return lambda;}       /**< 経度を返します。 @return (FloatT) 経度 */
+    FloatT height() const{return h;}               /**< 高度を返します。 @return (FloatT) 高度 */
+    FloatT azimuth() const{return alpha;}          /**< アジムス角を返します。 @return (FloatT) アジムス角 */
     
-    /* IC[pւ̕ϊ */
     /**
-     * [pԂ܂B
-     * @param q ϊ
-     * @return (FloatT) [p
+     * 倍精度の緯度を返します。
+     * FloatTがdoubleより低精度の場合、丸める前の位置から求めます。
+     * 
+     * @return (double) 緯度
+     */
+    double latitude_precise() const {
+      if(!use_position_precise){return phi;}
+      double q0(position_precise(0)), q3(position_precise(3));
+      return std::asin(1. - (pow2(q0) + pow2(q3)) * 2);
+    }
+    /**
+     * 倍精度の経度を返します。
+     * 
+     * @return (double) 経度
+     * @see latitude_precise()
+     */
+    double longitude_precise() const {
+      if(!use_position_precise){return lambda;}
+      double q[4];
+      for(int i(0); i < 4; i++){q[i] = position_precise(i);}
+      return std::atan2((q[0] * q[1] - q[2] * q[3]), (-q[0] * q[2] - q[1] * q[3]));
+    }
+    /**
+     * 倍精度のAzimuth角を返します。
+     * 
+     * @return (double) Azimuth角
+     * @see latitude_precise()
+     */
+    double azimuth_precise() const {
+      if(!use_position_precise){return alpha;}
+      double q[4];
+      for(int i(0); i < 4; i++){q[i] = position_precise(i);}
+      return std::atan2((-q[0] * q[1] - q[2] * q[3]), (q[1] * q[3] - q[0] * q[2]));
+    }
+    /**
+     * 倍精度の高度を返します。
+     * 
+     * @return (double) 高度
+     * @see latitude_precise()
+     */
+    double height_precise() const {
+      return use_position_precise ? position_precise(4) : h;
+    }
+    
+    Quaternion<FloatT> n2b() const{return q_n2b.copy();}  /**< 姿勢をクォータニオンで返します。 @return (FloatT) 姿勢 */
+    
+    /* オイラー角への変換 */
+    /**
+     * ヨー角を返します。
+     * @param q 変換元
+     * @return (FloatT) ヨー角
      */
     static FloatT q2psi(const Quaternion<FloatT> &q){
       return std::atan2((q.get(1) * q.get(2) + q.get(0) * q.get(3)) * 2,
                       (pow2(q.get(0)) + pow2(q.get(1)) - pow2(q.get(2)) - pow2(q.get(3))));
     }
     /**
-     * sb`pԂ܂B
-     * @param q ϊ
-     * @return (FloatT) sb`p
+     * ピッチ角を返します。
+     * @param q 変換元
+     * @return (FloatT) ピッチ角
      */
     static FloatT q2theta(const Quaternion<FloatT> &q){
       return std::asin((q.get(0) * q.get(2) - q.get(1) * q.get(3)) * 2);
     }
     
     /**
-     * [pԂ܂B
-     * @param q ϊ
-     * @return (FloatT) [p
+     * ロール角を返します。
+     * @param q 変換元
+     * @return (FloatT) ロール角
      */
     static FloatT q2phi(const Quaternion<FloatT> &q){
       return std::atan2((q.get(2) * q.get(3) + q.get(0) * q.get(1)) * 2,
@@ -470,28 +864,28 @@ class INS{
     }
     
     /**
-     * [pԂ܂B
-     * @return (FloatT) [p
+     * ヨー角を返します。
+     * @return (FloatT) ヨー角
      */
     FloatT euler_psi() const{return q2psi(q_n2b);}
     
     /**
-     * sb`pԂ܂B
-     * @return (FloatT) sb`p
+     * ピッチ角を返します。
+     * @return (FloatT) ピッチ角
      */
     FloatT euler_theta() const{return q2theta(q_n2b);}
     
     /**
-     * [pԂ܂B
-     * @return (FloatT) [p
+     * ロール角を返します。
+     * @return (FloatT) ロール角
      */
     FloatT euler_phi() const{return q2phi(q_n2b);}
 
     /**
-     * [p␳܂B
-     * ␳̃[p @f$ \psi + \delta \psi @f$ ɂȂ܂B
+     * ヨー角を補正します。
+     * 補正後のヨー角は @f$ \psi + \delta \psi @f$ になります。
      *
-     * @param delta_psi [p␳
+     * @param delta_psi ヨー角補正量
      */
     void mod_euler_psi(const FloatT &delta_psi){
       FloatT delta_psi_h(delta_psi / 2);
@@ -500,37 +894,37 @@ class INS{
     }
 
     /**
-     * sb`p␳܂B
-     * ␳̃sb`p @f$ \theta + \delta \theta @f$ ɂȂ܂B
+     * ピッチ角を補正します。
+     * 補正後のピッチ角は @f$ \theta + \delta \theta @f$ になります。
      *
-     * @param delta_theta sb`p␳
+     * @param delta_theta ピッチ角補正量
      */
     void mod_euler_theta(const FloatT &delta_theta){
       FloatT delta_theta_h(delta_theta / 2);
       FloatT c_theta(std::cos(delta_theta_h)), s_theta(std::sin(delta_theta_h));
       FloatT roll(euler_phi());
       if(false){
-        // ^ʖڂɌvZ
+        // 真面目に計算させる
         FloatT roll_h(roll / 2);
         FloatT c_roll(std::cos(roll_h)), s_roll(std::sin(roll_h));
         Quaternion<FloatT> roll_q_conj(c_roll, -s_roll, 0, 0);
         Quaternion<FloatT> roll_q(c_roll, s_roll, 0, 0);
         Quaternion<FloatT> delta_q(std::cos(delta_theta_h), 0, std::sin(delta_theta_h), 0);
-        q_n2b *= roll_q_conj; // [LZ
-        q_n2b *= delta_q; // sb`
-        q_n2b *= roll_q; // [
+        q_n2b *= roll_q_conj; // ロールキャンセル
+        q_n2b *= delta_q; // ピッチ増加
+        q_n2b *= roll_q; // ロール
       }else{
-        // sb`]̂ƍl΂悭AڌvZƈȉ̂悤ɂȂ
+        // ピッチ増加分を回転させたものと考えればよく、直接計算すると以下のようになる
         Quaternion<FloatT> delta_q(c_theta, 0, s_theta * std::cos(roll), -s_theta * std::sin(roll));
         q_n2b *= delta_q;
       }
     }
 
     /**
-     * [p␳܂B
-     * ␳̃[p @f$ \phi + \delta \phi @f$ ɂȂ܂B
+     * ロール角を補正します。
+     * 補正後のロール角は @f$ \phi + \delta \phi @f$ になります。
      *
-     * @param delta_phi [p␳
+     * @param delta_phi ロール角補正量
      */
     void mod_euler_phi(const FloatT &delta_phi){
       FloatT delta_phi_h(delta_phi / 2);
@@ -539,46 +933,46 @@ class INS{
     }
 
     /**
-     * [pƃAWXp𑫂킹wfBO(^ʊp)Ԃ܂B
-     * @return (FloatT) wfBO
+     * ヨー角とアジムス角を足し合わせたヘディング(真方位角)を返します。
+     * @return (FloatT) ヘディング
      */
     FloatT heading() const{
       FloatT _heading(euler_psi() + azimuth());
       return _heading > M_PI ? (_heading - (2 * M_PI)) : (_heading < -M_PI ? (_heading + (2 * M_PI)) : _heading);
     }
     
-    Vector3<FloatT> omega_e2i() const{return omega_e2i_4n.copy();} /**< @f$ \vec{\omega}_{e/i}^{n} @f$ Ԃ܂B @return @f$ \vec{\omega}_{e/i}^{n} @f$ */
-    Vector3<FloatT> omega_n2e() const{return omega_n2e_4n.copy();} /**< @f$ \vec{\omega}_{n/e}^{n} @f$ Ԃ܂B @return @f$ \vec{\omega}_{n/e}^{n} @f$ */
+    Vector3<FloatT> omega_e2i() const{return omega_e2i_4n.copy();} /**< @f$ \vec{\omega}_{e/i}^{n} @f$ を返します。 @return @f$ \vec{\omega}_{e/i}^{n} @f$ */
+    Vector3<FloatT> omega_n2e() const{return omega_n2e_4n.copy();} /**< @f$ \vec{\omega}_{n/e}^{n} @f$ を返します。 @return @f$ \vec{\omega}_{n/e}^{n} @f$ */
     
     /**
-     * 鋗̈ܐ̈ړɑ΂āA݈ʒuɂܓx̕ω߂܂B
-     * ŕ\ƁA
+     * ある距離の緯線方向の移動に対して、現在位置における緯度の変化を求めます。
+     * 式で表すと、
      * @f[
      *    \frac{x}{R_{\mathrm{meridian}} \left( \phi \right)}
-     * @f]B
-     * ŁAx͖ł̂ƂĂ܂B
+     * @f]。
+     * ここで、高度は無視できるものとしています。
      * 
-     * @return (FloatT) ܓx̕ω
+     * @return (FloatT) 緯度の変化
      */
     FloatT meter2lat(const FloatT &distance) const{return distance / Earth::R_meridian(phi);}
     /**
-     * 鋗̌öړɑ΂āA݈ʒuɂox̕ω߂܂B
-     * ŕ\ƁA
+     * ある距離の経線方向の移動に対して、現在位置における経度の変化を求めます。
+     * 式で表すと、
      * @f[
      *    \frac{x}{\beta \left( \phi \right)}
-     * @f]B
-     * ŁAx͖ł̂ƂĂ܂B
+     * @f]。
+     * ここで、高度は無視できるものとしています。
      * 
-     * @return (FloatT) ox̕ω
+     * @return (FloatT) 経度の変化
      */
     FloatT meter2long(const FloatT &distance) const{return distance / beta();}
     
     /**
-     * ݂AzimuthpɁAẅܓxAox@f$ \Tilde{q}_{e}^{n} @f$vZ܂B
+     * 現在のAzimuth角を元に、指定の緯度、経度で@f$ \Tilde{q}_{e}^{n} @f$を計算します。
      * 
-     * @param latitude ܓx
-     * @param longitude ox
-     * @return 
+     * @param latitude 緯度
+     * @param longitude 経度
+     * @return 結果
      */ 
     Quaternion<FloatT> e2n(const FloatT &latitude, const FloatT &longitude) const{
       using std::cos;
@@ -593,13 +987,39 @@ class INS{
           sin((longitude + alpha) / 2) * (clat - slat) / sqrt2);
       return q;
     }
+    
+    /**
+     * 現在の@f$ \Tilde{q}_{e}^{n} @f$から、指定の緯度、経度での@f$ \Tilde{q}_{e}^{n} @f$
+     * (e2n()参照)を引いた差を求めます。
+     * 差は位置の誤差程度と小さいため、FloatTによらず倍精度の位置で計算してから丸めます。
+     * 
+     * @param latitude 緯度
+     * @param longitude 経度
+     * @return 結果
+     */
+    Quaternion<FloatT> e2n_difference(const double &latitude, const double &longitude) const{
+      using std::cos;
+      using std::sin;
+      using std::sqrt;
+      double azimuth(azimuth_precise());
+      double clat(cos(latitude / 2)), slat(sin(latitude / 2));
+      double sqrt2(sqrt(2.));
+      double q[4] = {
+          cos((longitude + azimuth) / 2) * (clat - slat) / sqrt2,
+          sin((longitude - azimuth) / 2) * (clat + slat) / sqrt2,
+         -cos((longitude - azimuth) / 2) * (clat + slat) / sqrt2,
+          sin((longitude + azimuth) / 2) * (clat - slat) / sqrt2};
+      return Quaternion<FloatT>(
+          position_precise(0) - q[0], position_precise(1) - q[1],
+          position_precise(2) - q[2], position_precise(3) - q[3]);
+    }
 
     /**
-     * ݂̏ԗʂ₷`ŏo͂܂B
+     * 現在の状態量を見やすい形で出力します。
      * 
-     * @param out o̓Xg[
-     * @param ins o͑Ώ
-     * @return (ostream) o̓Xg[
+     * @param out 出力ストリーム
+     * @param ins 出力対象
+     * @return (ostream) 出力ストリーム
      */
     friend std::ostream &operator<<(std::ostream &out, const INS<FloatT> &ins){
       for(unsigned i = 0; i < ins.state_values(); i++){
@@ -609,6 +1029,115 @@ class INS{
     }
 };
 
+/**
+ * @brief コーニング、スカリング補償付きの増分積算
+ * 
+ * IMUのサンプル(マイナー区間)を積算し、航法の更新(メジャー区間)ごとの
+ * 角度増分(回転ベクトル)、速度増分を求めます。
+ * 航法の更新をIMUのサンプルレートより低いレートで行う際に、
+ * 区間中のb-frameの回転による誤差(コーニング、スカリング)を補償するために用います。
+ * 補償には直前の1サンプルを併用する2サンプルアルゴリズムを用いています。
+ * 結果はmean_accel(), mean_gyro(), deltaT()として、
+ * 積分方法をMECHANIZATION_INCREMENTにしたINSのupdate()に与えます。
+ * 
+ * @param FloatT 演算精度、通常はdouble
+ */
+template <class FloatT>
+class INS_ConingSculling {
+  protected:
+    Vector3<FloatT> alpha; ///< 角度増分の和 @f$ \vec{\alpha} @f$
+    Vector3<FloatT> upsilon; ///< 速度増分の和 @f$ \vec{\upsilon} @f$
+    Vector3<FloatT> beta; ///< コーニング補償量 @f$ \vec{\beta} @f$
+    Vector3<FloatT> sculling; ///< スカリング補償量
+    Vector3<FloatT> previous_delta_theta; ///< 直前のサンプルの角度増分
+    Vector3<FloatT> previous_delta_v; ///< 直前のサンプルの速度増分
+    FloatT m_deltaT; ///< 積算した時間間隔
+    unsigned m_samples; ///< 積算したサンプル数
+    
+  public:
+    INS_ConingSculling()
+        : alpha(), upsilon(), beta(), sculling(),
+        previous_delta_theta(), previous_delta_v(),
+        m_deltaT(0), m_samples(0) {}
+    
+    /**
+     * サンプルを積算します。
+     * 角度増分@f$ \Delta \vec{\theta} @f$, 速度増分@f$ \Delta \vec{v} @f$に対し、
+     * @f{gather*}
+     *   \vec{\beta} \leftarrow \vec{\beta}
+     *     + \frac{1}{2} \left( \vec{\alpha} + \frac{1}{6} \Delta \vec{\theta}_{-1} \right) \times \Delta \vec{\theta} \\
+     *   \Delta \vec{v}_{\mathrm{scul}} \leftarrow \Delta \vec{v}_{\mathrm{scul}}
+     *     + \frac{1}{2} \left( \vec{\alpha} + \frac{1}{6} \Delta \vec{\theta}_{-1} \right) \times \Delta \vec{v}
+     *     + \frac{1}{2} \left( \vec{\upsilon} + \frac{1}{6} \Delta \vec{v}_{-1} \right) \times \Delta \vec{\theta}
+     * @f}
+     * とした後、@f$ \vec{\alpha}, \vec{\upsilon} @f$に加えます。
+     * 時間間隔が0以下のサンプルは増分を持たないため、積算せずに無視します。
+     * 
+     * @param accel 加速度
+     * @param gyro 角速度
+     * @param deltaT 時間間隔
+     */
+    void add(const Vector3<FloatT> &accel, const Vector3<FloatT> &gyro, const FloatT &deltaT){
+      if(!(deltaT > 0)){return;}
+      Vector3<FloatT> delta_theta(gyro * deltaT), delta_v(accel * deltaT);
+      Vector3<FloatT> alpha_(alpha + previous_delta_theta / 6), upsilon_(upsilon + previous_delta_v / 6);
+      { // 2次の項
+        Vector3<FloatT> phi(alpha + delta_theta / 2);
+        sculling += (beta * delta_v) += (phi * (phi * delta_v)) / 2;
+      }
+      beta += (alpha_ * delta_theta) / 2;
+      sculling += ((alpha_ * delta_v) += (upsilon_ * delta_theta)) / 2;
+      alpha += delta_theta;
+      upsilon += delta_v;
+      previous_delta_theta = delta_theta;
+      previous_delta_v = delta_v;
+      m_deltaT += deltaT;
+      m_samples++;
+    }
+    
+    /**
+     * 積算をやり直します。
+     * 直前のサンプルは次の区間の補償に用いるため保持されます。
+     */
+    void reset(){
+      alpha = Vector3<FloatT>();
+      upsilon = Vector3<FloatT>();
+      beta = Vector3<FloatT>();
+      sculling = Vector3<FloatT>();
+      m_deltaT = 0;
+      m_samples = 0;
+    }
+    
+    const unsigned &samples() const {return m_samples;} ///< 積算したサンプル数
+    const FloatT &deltaT() const {return m_deltaT;} ///< 積算した時間間隔
+    
+    /**
+     * コーニング補償済みの角度増分(回転ベクトル)を返します。
+     * 
+     * @return (Vector3<FloatT>) @f$ \vec{\alpha} + \vec{\beta} @f$
+     */
+    Vector3<FloatT> delta_theta() const {return alpha + beta;}
+    
+    /**
+     * 回転、スカリング補償済みの速度増分(区間始点のb-frame)を返します。
+     * 
+     * @return (Vector3<FloatT>)
+     * @f$ \vec{\upsilon} + \frac{1}{2} \vec{\alpha} \times \vec{\upsilon} + \Delta \vec{v}_{\mathrm{scul}} @f$
+     */
+    Vector3<FloatT> delta_v() const {return (upsilon + (alpha * upsilon) / 2) += sculling;}
+    
+    /**
+     * INS::update()に与える加速度、角速度を返します。
+     * 積算した時間間隔が0の場合は0を返します。
+     */
+    Vector3<FloatT> mean_accel() const {
+      return (m_deltaT > 0) ? (delta_v() / m_deltaT) : Vector3<FloatT>();
+    }
+    Vector3<FloatT> mean_gyro() const { ///< @see mean_accel()
+      return (m_deltaT > 0) ? (delta_theta() / m_deltaT) : Vector3<FloatT>();
+    }
+};
+
 #ifdef POW2_ALREADY_DEFINED
 #undef POW2_ALREADY_DEFINED
 #else
@@ -22,10 +22,10 @@
 /** @file
  * @brief INS/GPS(Multiplicative)
  * 
- * q@u(INS)GPS̓Loose-couplingŋLqt@CB
- * INŠ덷vZ͐ώZ^(Multiplicative)𗘗pĂ܂B
+ * 慣性航法装置(INS)とGPSの統合をLoose-couplingで記述したファイル。
+ * INSの誤差計算は積算型(Multiplicative)を利用しています。
  * 
- * INS/GPS̓ɗpGPS̊ef[^^ɂĂINS_GPS.hQƂĂB
+ * INS/GPSの統合に用いるGPSの各データ型についてはINS_GPS.hを参照してください。
  * 
  * @see Filtered_INS2.h
  * @see INS_GPS2.h
@@ -42,33 +42,33 @@
 #endif
 
 /**
- * @brief GPS̃f[^^(u-blox)
+ * @brief GPSのデータ型(u-blox)
  *
- * u-blox GPSł̃f[^^B3ʂ̏ꍇB
+ * u-blox GPSでのデータ型。3次元測位の場合。
  *
- * @param FloatT Zx
+ * @param FloatT 演算精度
  */
 template <class FloatT>
 struct GPS_UBLOX_3D{
-  FloatT v_n,          ///< kx
-         v_e,          ///< x
-         v_d;          ///< x
-  FloatT sigma_vel;    ///< xxNg̐Βl̐덷
-  FloatT latitude,     ///< ܓx
-         longitude,    ///< ox
-         height;       ///< x
-  FloatT sigma_2d,     ///< ʏ̐덷
-         sigma_height; ///< x̐덷
+  FloatT v_n,          ///< 北方向速度
+         v_e,          ///< 東方向速度
+         v_d;          ///< 下方向速度
+  FloatT sigma_vel;    ///< 速度ベクトルの絶対値の推定誤差
+  double latitude,     ///< 緯度、FloatTによらず倍精度
+         longitude,    ///< 経度、FloatTによらず倍精度
+         height;       ///< 高度、FloatTによらず倍精度
+  FloatT sigma_2d,     ///< 水平面上の推定誤差
+         sigma_height; ///< 高度方向の推定誤差
 
   struct sigma_vel_ned_t {
     FloatT n, e, d;
   };
   /**
-   * TODO: v
+   * TODO: 要検討
    *
-   * NEDɕx덷߂܂B
+   * NED成分に分解した速度誤差を求めます。
    *
-   * @return (sigma_vel_ned_t) NEDɕx덷
+   * @return (sigma_vel_ned_t) NED成分に分解した速度誤差
    */
   sigma_vel_ned_t sigma_vel_ned() const {
     FloatT v2((v_n * v_n) + (v_e * v_e) + (v_d * v_d));
@@ -103,12 +103,12 @@ struct CorrectInfo {
 /**
  * @brief INS/GPS(Multiplicative)
  * 
- * INS/GPS Loose-couplingJ}tB^ŎNXB
- * INS̃VXe덷͐ώZ^ŕ\Ă܂B
+ * INS/GPS Loose-couplingをカルマンフィルタで実現したクラス。
+ * INSのシステム誤差方程式は積算型で表現されています。
  * 
- * @param FloatT Zx
- * @param Filter J}tB^
- * @param FINS ̍q@u𓝍ׂINSgNX
+ * @param FloatT 演算精度
+ * @param Filter カルマンフィルタ
+ * @param FINS 他の航法装置を統合する為のINS拡張クラス
  * @see Filtered_INS2
  */
 template <
@@ -118,27 +118,27 @@ template <
 >
 class INS_GPS2 : public FINS{
   public:
-    INS_GPS2() : FINS(){} /**< RXgN^ */
+    INS_GPS2() : FINS(){} /**< コンストラクタ */
     
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
      * 
-     * @param orig Rs[
-     * @param deepcopy fB[vRs[쐬邩ǂ
+     * @param orig コピー元
+     * @param deepcopy ディープコピーを作成するかどうか
      */
     INS_GPS2(const INS_GPS2 &orig, const bool deepcopy = false) :
       FINS(orig, deepcopy){
       
     }
     
-    ~INS_GPS2(){}         /**< fXgN^ */
+    ~INS_GPS2(){}         /**< デストラクタ */
     
     using FINS::correct;
     
     /**
-     * ϑXV(Measurement Update)s܂B
+     * 観測更新(Measurement Update)を行います。
      * 
-     * @param info C
+     * @param info 修正情報
      */
     void correct(const CorrectInfo<FloatT> &info){
       FINS::correct(info.H, info.z, info.R);
@@ -148,11 +148,11 @@ class INS_GPS2 : public FINS{
     using FINS::get;
     
     /**
-     * 3DʎɂϑXV(Measurement Update)p̏߂܂B
-     * u-bloxpB
+     * 3D測位時における観測更新(Measurement Update)用の情報を求めます。
+     * u-blox用。
      * 
-     * @param gps GPSo̓f[^
-     * @return (CorrectInfo) ϑXVp̃f[^
+     * @param gps GPS出力データ
+     * @return (CorrectInfo) 観測更新用のデータ
      */
     CorrectInfo<FloatT> correct_info(const GPS_UBLOX_3D<FloatT> &gps) const {
       using std::cos;
@@ -161,28 +161,29 @@ class INS_GPS2 : public FINS{
       
       //cout << "__correct__" << endl;
       
-      Quaternion<FloatT> q_e2n_gps(INS<FloatT>::e2n(gps.latitude, gps.longitude));
+      // 位置の差はFloatTによらず倍精度で求める
+      Quaternion<FloatT> q_e2n_diff(INS<FloatT>::e2n_difference(gps.latitude, gps.longitude));
       
       //cout << "__correct__" << endl;
       
-      //ϑz
+      //観測量z
       FloatT z_serialized[8][1];
 #define z(i, j) z_serialized[i][j]
       {
         z(0, 0) = get(0) - (gps.v_n * cos(azimuth) + gps.v_e * sin(azimuth));
         z(1, 0) = get(1) - (gps.v_n * -sin(azimuth) + gps.v_e * cos(azimuth));
         z(2, 0) = get(2) - gps.v_d;
-        z(3, 0) = get(3) - q_e2n_gps[0];
-        z(4, 0) = get(4) - q_e2n_gps[1];
-        z(5, 0) = get(5) - q_e2n_gps[2];
-        z(6, 0) = get(6) - q_e2n_gps[3];
-        z(7, 0) = get(7) - gps.height;
+        z(3, 0) = q_e2n_diff[0];
+        z(4, 0) = q_e2n_diff[1];
+        z(5, 0) = q_e2n_diff[2];
+        z(6, 0) = q_e2n_diff[3];
+        z(7, 0) = INS<FloatT>::height_precise() - gps.height;
       }
 #undef z
 #define z_size (sizeof(z_serialized) / sizeof(z_serialized[0]))
       Matrix<FloatT> z(z_size, 1, (FloatT *)z_serialized);
       
-      //sH̍쐬
+      //行列Hの作成
       FloatT H_serialized[z_size][P_SIZE] = {{FloatT(0)}};
 #define H(i, j) H_serialized[i][j]
       {
@@ -214,7 +215,7 @@ class INS_GPS2 : public FINS{
       FloatT lat_sigma(INS<FloatT>::meter2lat(gps.sigma_2d));
       FloatT long_sigma(INS<FloatT>::meter2long(gps.sigma_2d));
       
-      //ϑl덷sR
+      //観測値誤差行列R
       FloatT R_serialized[z_size][z_size] = {{FloatT(0)}};
 #define R(i, j) R_serialized[i][j]
       {
@@ -246,24 +247,24 @@ class INS_GPS2 : public FINS{
     }
     
     /**
-     * 3DʎɂϑXV(Measurement Update)s܂B
-     * u-bloxpB
+     * 3D測位時における観測更新(Measurement Update)を行います。
+     * u-blox用。
      * 
-     * @param gps GPSo̓f[^
+     * @param gps GPS出力データ
      */
     void correct(const GPS_UBLOX_3D<FloatT> &gps){
       correct(correct_info(gps));
     }
     
     /**
-     * 3DʎɂϑXV(Measurement Update)p̏߂܂B
-     * u-bloxpB
-     * lever arm effectlB
+     * 3D測位時における観測更新(Measurement Update)用の情報を求めます。
+     * u-blox用。
+     * lever arm effectを考慮。
      * 
-     * @param gps GPSo̓f[^
-     * @param lever_arm_b lever arm̑傫
-     * @param omega_b2i_4b ϑ̃WC̒l
-     * @return (CorrectInfo) ϑXVp̃f[^
+     * @param gps GPS出力データ
+     * @param lever_arm_b lever armの大きさ
+     * @param omega_b2i_4b 観測時のジャイロの値
+     * @return (CorrectInfo) 観測更新用のデータ
      */
     CorrectInfo<FloatT> correct_info(const GPS_UBLOX_3D<FloatT> &gps, 
         const Vector3<FloatT> &lever_arm_b,
@@ -271,7 +272,7 @@ class INS_GPS2 : public FINS{
                    
       FloatT azimuth(INS<FloatT>::azimuth());
       
-      // ʒu֌W
+      // 位置関係
       Vector3<FloatT> lever_arm_n(
         ((INS<FloatT>::q_n2b) * lever_arm_b * (INS<FloatT>::q_n2b).conj()).vector());
       Vector3<FloatT> lever_arm_g(
@@ -315,12 +316,12 @@ class INS_GPS2 : public FINS{
         coefficient_pos_lever_g(1, 2) = INS<FloatT>::meter2long((-s_alpha * lever_arm_n[1] + c_alpha * lever_arm_n[0]) * -2);
       }
       
-      Quaternion<FloatT> q_e2n_gps(
-          INS<FloatT>::e2n(
+      Quaternion<FloatT> q_e2n_diff(
+          INS<FloatT>::e2n_difference(
               gps.latitude + lever_lat, 
               gps.longitude + lever_long));
       
-      // x̏C
+      // 速度の修正項
       Vector3<FloatT> omega_b2n_4b(
           omega_b2i_4b - INS<FloatT>::omega_e2i_4n + INS<FloatT>::omega_n2e_4n
         );
@@ -332,7 +333,7 @@ class INS_GPS2 : public FINS{
       //Matrix<FloatT> coefficient_vel_omega(omega_b2n_4n.skewMatrix());
       //Matrix<FloatT> coefficient_vel_lever(-lever_arm_n.skewMatrix());
       
-      //ϑz
+      //観測量z
       FloatT z_serialized[8][1];
 #define z(i, j) z_serialized[i][j]
       {
@@ -342,17 +343,17 @@ class INS_GPS2 : public FINS{
             - ((gps.v_n * -sin(azimuth) + gps.v_e * cos(azimuth)) - v_induced[1]);
         z(2, 0) = get(2) 
             - (gps.v_d - v_induced[2]);
-        z(3, 0) = get(3) - q_e2n_gps[0];
-        z(4, 0) = get(4) - q_e2n_gps[1];
-        z(5, 0) = get(5) - q_e2n_gps[2];
-        z(6, 0) = get(6) - q_e2n_gps[3];
-        z(7, 0) = get(7) - (gps.height - lever_arm_g[2]);
+        z(3, 0) = q_e2n_diff[0];
+        z(4, 0) = q_e2n_diff[1];
+        z(5, 0) = q_e2n_diff[2];
+        z(6, 0) = q_e2n_diff[3];
+        z(7, 0) = INS<FloatT>::height_precise() - (gps.height - lever_arm_g[2]);
       }
 #undef z
 #define z_size (sizeof(z_serialized) / sizeof(z_serialized[0]))
       Matrix<FloatT> z(z_size, 1, (FloatT *)z_serialized);
       
-      //sH̍쐬
+      //行列Hの作成
       Matrix<FloatT> H(z_size, P_SIZE);
       {
         H(0, 0) = 1;
@@ -389,7 +390,7 @@ class INS_GPS2 : public FINS{
       FloatT lat_sigma = FINS::meter2lat(gps.sigma_2d);
       FloatT long_sigma = FINS::meter2long(gps.sigma_2d);
       
-      //ϑl덷sR
+      //観測値誤差行列R
       FloatT R_serialized[z_size][z_size] = {{FloatT(0)}};
 #define R(i, j) R_serialized[i][j]
       {
@@ -411,7 +412,7 @@ class INS_GPS2 : public FINS{
         
         R(7, 7) = pow2(gps.sigma_height);
         
-        // xɂɃomega_{b/i}^{n}̉e
+        // 速度項にさらにΔomega_{b/i}^{n}の影響を加える
       }
 #undef R
       Matrix<FloatT> R(z_size, z_size, (FloatT *)R_serialized);
@@ -432,13 +433,13 @@ class INS_GPS2 : public FINS{
     }
     
     /**
-     * 3DʎɂϑXV(Measurement Update)s܂B
-     * u-bloxpB
-     * lever arm effectlB
+     * 3D測位時における観測更新(Measurement Update)を行います。
+     * u-blox用。
+     * lever arm effectを考慮。
      * 
-     * @param gps GPSo̓f[^
-     * @param lever_arm_b lever arm̑傫
-     * @param omega_b2i_4b ϑ̃WC̒l
+     * @param gps GPS出力データ
+     * @param lever_arm_b lever armの大きさ
+     * @param omega_b2i_4b 観測時のジャイロの値
      */
     void correct(const GPS_UBLOX_3D<FloatT> &gps, 
         const Vector3<FloatT> &lever_arm_b,
@@ -447,18 +448,18 @@ class INS_GPS2 : public FINS{
     }
 
     /**
-     * [pCtB^ʂčs܂B
+     * ヨー角修正をフィルタを通して行います。
      *
-     * @param delta_psi ݃[pƂ̍ [rad]
-     * @param sigma2_delta_psi delta_psi̊m炵(U) [rad^2]
+     * @param delta_psi 現在ヨー角との差分 [rad]
+     * @param sigma2_delta_psi delta_psiの確からしさ(分散) [rad^2]
      */
     void correct_yaw(const FloatT &delta_psi, const FloatT &sigma2_delta_psi){
-      //ϑz
+      //観測量z
       FloatT z_serialized[1][1] = {{-delta_psi}};
 #define z_size (sizeof(z_serialized) / sizeof(z_serialized[0]))
       Matrix<FloatT> z(z_size, 1, (FloatT *)z_serialized);
 
-      //sH̍쐬
+      //行列Hの作成
       FloatT H_serialized[z_size][P_SIZE] = {{FloatT(0)}};
 #define H(i, j) H_serialized[i][j]
       {
@@ -467,15 +468,15 @@ class INS_GPS2 : public FINS{
 #undef H
       Matrix<FloatT> H(z_size, P_SIZE, (FloatT *)H_serialized);
 
-      //ϑl덷sR
+      //観測値誤差行列R
       FloatT R_serialized[z_size][z_size] = {{sigma2_delta_psi}};
       Matrix<FloatT> R(z_size, z_size, (FloatT *)R_serialized);
 #undef z_size
 
-      // Cʂ̌vZ
-      Matrix<FloatT> K(FINS::m_filter.correct(H, R)); //J}QC
+      // 修正量の計算
+      Matrix<FloatT> K(FINS::correct_filter(H, R)); //カルマンゲイン
       Matrix<FloatT> x_hat(K * z);
-      //before_correct_INS(H, R, K, z, x_hat); // [␳ꃂ[hȂ߁A͌ĂяoȂ
+      //before_correct_INS(H, R, K, z, x_hat); // ヨーだけ補正する特殊モードなため、これは呼び出さない
       FINS::correct_INS(x_hat);
     }
 };
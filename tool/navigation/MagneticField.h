@@ -89,7 +89,7 @@ class MagneticFieldGeneric {
       
       FloatT slat(sin(latitude_rad));
       FloatT clat(cos(latitude_rad));
-      // ܓx̕␳
+      // 緯度の補正
       {
         FloatT latitude_deg(latitude_rad / M_PI * 180);
         if((90.0 - latitude_deg) < 1E-3){
@@ -107,7 +107,7 @@ class MagneticFieldGeneric {
       FloatT sd(0), cd(1);
       FloatT aa, bb, cc, dd, r, rr;
       
-      // TODO: WGS84xnSւ̕ϊ(Ǝv)
+      // TODO: WGS84高度から地球中心距離への変換(だと思う)
       {
         static const FloatT a2(40680631.59);            /* WGS84 */
         static const FloatT b2(40408299.98);            /* WGS84 */
@@ -186,10 +186,279 @@ class MagneticFieldGeneric {
       
       return res;
     }
+    
+    /**
+     * 複数の地点における磁場をまとめて求めます。
+     * 地図の作成等、多数の地点を評価する場合に使用します。
+     * OpenMPが有効な場合、並列に計算します。
+     * 
+     * @param model 磁場モデル
+     * @param latitude_rad 緯度[rad]の配列
+     * @param longitude_rad 経度[rad]の配列
+     * @param height_meter_wgs84 高度[m]の配列
+     * @param res 結果の書き出し先
+     * @param n 地点の数
+     */
+    static void filed_components(
+        const model_t &model,
+        const FloatT *latitude_rad, const FloatT *longitude_rad,
+        const FloatT *height_meter_wgs84,
+        filed_components_res_t *res, const int &n){
+#if defined(_OPENMP)
+#pragma omp parallel for if(n > 0x100)
+#endif
+      for(int i = 0; i < n; i++){
+        res[i] = filed_components(model,
+            latitude_rad[i], longitude_rad[i], height_meter_wgs84[i]);
+      }
+    }
 };
 
 typedef MagneticFieldGeneric<double> MagneticField;
 
+/**
+ * @brief 磁場モデルのキャッシュ
+ * 
+ * 緯度、経度、高度方向に区切った直方体(タイル)の頂点で磁場モデルを評価しておき、
+ * タイル内の磁場を3重線形補間で求めます。
+ * 移動体がタイルから出た場合にのみ、磁場モデルを再評価します。
+ * 
+ * タイル作成時には中心、面の中心、辺の中点(頂点は評価値そのもの)で磁場モデルと補間値を比較し、
+ * 差が許容誤差を超える場合はタイルを半分の大きさにして作り直します。
+ * 比較に用いた点は半分の大きさのタイルの頂点となるため、再評価しません。
+ * 分割の上限まで許容誤差を満たせない場合は、そのタイル内では磁場モデルを直接評価します。
+ * 次のタイルは、前回許容誤差を満たした大きさから作成を始めます。
+ * 
+ * @param FloatT 演算精度
+ */
+template <class FloatT>
+class MagneticFieldCacheGeneric {
+  public:
+    typedef MagneticFieldGeneric<FloatT> field_t;
+    typedef typename field_t::model_t model_t;
+    typedef typename field_t::filed_components_res_t res_t;
+    
+  protected:
+    const model_t *model;
+    FloatT m_tolerance; ///< 許容誤差[nT]、0以下の場合はキャッシュを使用しない
+    FloatT tile_size[3]; ///< タイルの既定の大きさ(緯度[rad]、経度[rad]、高度[m])
+    int max_divide; ///< タイルを分割する回数の上限
+    
+    bool valid; ///< タイルが有効な場合true
+    bool direct; ///< 許容誤差を満たせなかったタイルの場合true、タイル内では磁場モデルを直接評価する
+    FloatT origin[3]; ///< タイルの原点(各方向の最小値)
+    FloatT size[3]; ///< タイルの大きさ
+    FloatT accepted_size[3]; ///< 前回許容誤差を満たしたタイルの大きさ、次のタイルはこの大きさから作成する
+    res_t corner[8]; ///< 頂点での磁場、添字のビット0, 1, 2がそれぞれ緯度、経度、高度方向の上端を表す
+    unsigned int m_evaluations; ///< 磁場モデルを評価した回数
+    
+    res_t evaluate(const FloatT &latitude, const FloatT &longitude, const FloatT &height){
+      m_evaluations++;
+      return field_t::filed_components(*model, latitude, longitude, height);
+    }
+    
+    /**
+     * タイル内の位置における補間値を求めます。
+     * 
+     * @param ratio タイル内の位置(各方向0から1)
+     * @return (res_t) 補間値
+     */
+    res_t interpolate(const FloatT (&ratio)[3]) const {
+      res_t res = {0, 0, 0};
+      for(int i(0); i < 8; i++){
+        FloatT weight(1);
+        for(int j(0); j < 3; j++){
+          weight *= ((i >> j) & 1) ? ratio[j] : (1 - ratio[j]);
+        }
+        res.north += corner[i].north * weight;
+        res.east += corner[i].east * weight;
+        res.down += corner[i].down * weight;
+      }
+      return res;
+    }
+    
+    bool contains(const FloatT (&position)[3]) const {
+      if(!valid){return false;}
+      for(int i(0); i < 3; i++){
+        FloatT offset(position[i] - origin[i]);
+        if((offset < 0) || (offset > size[i])){return false;}
+      }
+      return true;
+    }
+    
+    /**
+     * 指定の位置を含むタイルを作成します。
+     * 
+     * タイルを各方向に2分割した3x3x3の格子点で磁場モデルを評価し、
+     * 頂点以外の19点で補間値との差を確認します。
+     * 許容誤差を超える場合は、位置を含む半分の大きさのタイルに移ります。
+     * その頂点は格子点に含まれるため、新たに評価するのは内部の格子点のみです。
+     * 
+     * @param position 位置(緯度[rad]、経度[rad]、高度[m])
+     */
+    void build(const FloatT (&position)[3]){
+      using std::floor;
+      using std::abs;
+      for(int i(0); i < 3; i++){
+        size[i] = accepted_size[i];
+        // 原点を格子に揃え、隣接するタイルの頂点を一致させる
+        origin[i] = floor(position[i] / size[i]) * size[i];
+      }
+      for(int i(0); i < 8; i++){
+        corner[i] = evaluate(
+            origin[0] + (((i >> 0) & 1) ? size[0] : 0),
+            origin[1] + (((i >> 1) & 1) ? size[1] : 0),
+            origin[2] + (((i >> 2) & 1) ? size[2] : 0));
+      }
+      valid = true;
+      direct = false;
+      for(int divide(0); ; divide++){
+        // 格子点の評価と誤差の確認、添字は各方向0(原点), 1(中点), 2(上端)
+        res_t grid[3][3][3];
+        bool within(true);
+        for(int a(0); a < 3; a++){
+          for(int b(0); b < 3; b++){
+            for(int c(0); c < 3; c++){
+              if((a != 1) && (b != 1) && (c != 1)){ // 頂点
+                grid[a][b][c] = corner[(a >> 1) | ((b >> 1) << 1) | ((c >> 1) << 2)];
+                continue;
+              }
+              const FloatT ratio[3] = {FloatT(0.5) * a, FloatT(0.5) * b, FloatT(0.5) * c};
+              grid[a][b][c] = evaluate(
+                  origin[0] + size[0] * ratio[0],
+                  origin[1] + size[1] * ratio[1],
+                  origin[2] + size[2] * ratio[2]);
+              if(!within){continue;}
+              res_t interpolated(interpolate(ratio));
+              if((abs(interpolated.north - grid[a][b][c].north) > m_tolerance)
+                  || (abs(interpolated.east - grid[a][b][c].east) > m_tolerance)
+                  || (abs(interpolated.down - grid[a][b][c].down) > m_tolerance)){
+                within = false;
+              }
+            }
+          }
+        }
+        if(within){
+          for(int i(0); i < 3; i++){accepted_size[i] = size[i];}
+          break;
+        }
+        if(divide >= max_divide){
+          // 許容誤差を満たせないため、このタイル内では直接評価する
+          direct = true;
+          break;
+        }
+        
+        // 位置を含む半分の大きさのタイルに移る
+        int offset[3];
+        for(int i(0); i < 3; i++){
+          size[i] /= 2;
+          offset[i] = ((position[i] - origin[i]) >= size[i]) ? 1 : 0;
+          origin[i] += size[i] * offset[i];
+        }
+        for(int i(0); i < 8; i++){
+          corner[i] = grid
+              [offset[0] + ((i >> 0) & 1)]
+              [offset[1] + ((i >> 1) & 1)]
+              [offset[2] + ((i >> 2) & 1)];
+        }
+      }
+    }
+    
+  public:
+    /**
+     * コンストラクタ
+     * 
+     * @param _model 磁場モデル
+     * @param tolerance 許容誤差[nT]、0以下の場合はキャッシュを使用しない
+     * @param tile_latitude_rad タイルの緯度方向の大きさ[rad]
+     * @param tile_longitude_rad タイルの経度方向の大きさ[rad]
+     * @param tile_height_meter タイルの高度方向の大きさ[m]
+     * @param _max_divide タイルを分割する回数の上限
+     */
+    MagneticFieldCacheGeneric(
+        const model_t &_model,
+        const FloatT &tolerance = 1,
+        const FloatT &tile_latitude_rad = M_PI / 180 / 10,
+        const FloatT &tile_longitude_rad = M_PI / 180 / 10,
+        const FloatT &tile_height_meter = 1000,
+        const int &_max_divide = 4)
+        : model(&_model), m_tolerance(tolerance), max_divide(_max_divide),
+        valid(false), direct(false), m_evaluations(0) {
+      tile_size[0] = tile_latitude_rad;
+      tile_size[1] = tile_longitude_rad;
+      tile_size[2] = tile_height_meter;
+      invalidate();
+    }
+    
+    /**
+     * 許容誤差を返します。
+     * 変更した場合はinvalidate()を呼び出してください。
+     * 
+     * @return (FloatT &) 許容誤差[nT]
+     */
+    FloatT &tolerance(){return m_tolerance;}
+    
+    /**
+     * 磁場モデルを変更します。
+     * 
+     * @param _model 磁場モデル
+     */
+    void set_model(const model_t &_model){
+      model = &_model;
+      invalidate();
+    }
+    
+    /**
+     * タイルを破棄し、次回の呼び出しで既定の大きさから作り直させます。
+     */
+    void invalidate(){
+      valid = false;
+      for(int i(0); i < 3; i++){accepted_size[i] = tile_size[i];}
+    }
+    
+    /**
+     * 現在のタイルが許容誤差を満たせず、磁場モデルを直接評価しているかを返します。
+     * 
+     * @return (bool) 直接評価している場合true
+     */
+    bool direct_evaluation() const {return valid && direct;}
+    
+    /**
+     * 磁場モデルを評価した回数を返します。
+     * 
+     * @return (unsigned int) 評価回数
+     */
+    unsigned int evaluations() const {return m_evaluations;}
+    
+    /**
+     * 指定の位置における磁場を求めます。
+     * 
+     * @param latitude_rad 緯度[rad]
+     * @param longitude_rad 経度[rad]
+     * @param height_meter_wgs84 高度[m]
+     * @return (res_t) 磁場
+     */
+    res_t operator()(
+        const FloatT &latitude_rad, const FloatT &longitude_rad,
+        const FloatT &height_meter_wgs84){
+      if(m_tolerance <= 0){
+        return evaluate(latitude_rad, longitude_rad, height_meter_wgs84);
+      }
+      const FloatT position[3] = {latitude_rad, longitude_rad, height_meter_wgs84};
+      if(!contains(position)){build(position);}
+      if(direct){
+        return evaluate(latitude_rad, longitude_rad, height_meter_wgs84);
+      }
+      FloatT ratio[3];
+      for(int i(0); i < 3; i++){
+        ratio[i] = (position[i] - origin[i]) / size[i];
+      }
+      return interpolate(ratio);
+    }
+};
+
+typedef MagneticFieldCacheGeneric<double> MagneticFieldCache;
+
 /* IGRF11 is the eleventh generation standard main field model adopted
  * by the International Association of Geomagnetism and Aeronomy (IAGA).
  * This is a degree and order 10 model from 1900 to 1995 and a degree and
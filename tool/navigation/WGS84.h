@@ -35,29 +35,29 @@
 #include <cmath>
 
 /** @file
- * @brief nfWGS84
+ * @brief 地球モデルWGS84
  * 
- * n̕f̂ЂƂłWGS84ɂċLqt@CB
+ * 地球の物理モデルのひとつであるWGS84について記述したファイル。
  */
 
 /**
- * @brief nfWGS84
+ * @brief 地球モデルWGS84
  * 
- * nfłWGS84\NXB
+ * 地球モデルであるWGS84を表現するクラス。
  * 
- * ɗaяd͂̌vZł܂B
+ * 極率半径および重力の計算ができます。
  */
 template <class FloatT>
 class WGS84Generic{
   public:
-    static const FloatT R_e;            ///< ԓa[m]
-    static const FloatT F_e;            ///< n̝G
-    static const FloatT Omega_Earth;    ///< n]x
-    static const FloatT Omega_Earth_IAU;///< n]x(IAU, GRS67)
-    static const FloatT mu_Earth;       ///< nd͒萔[m^3/s^2]
-    static const FloatT epsilon_Earth;  ///< ΐS
-    static const FloatT g_WGS0;         ///< ԓd
-    static const FloatT g_WGS1;         ///< d͌萔
+    static const FloatT R_e;            ///< 赤道半径[m]
+    static const FloatT F_e;            ///< 地球の扁平率
+    static const FloatT Omega_Earth;    ///< 地球自転速度
+    static const FloatT Omega_Earth_IAU;///< 地球自転速度(IAU, GRS67)
+    static const FloatT mu_Earth;       ///< 地球重力定数[m^3/s^2]
+    static const FloatT epsilon_Earth;  ///< 第一偏心性
+    static const FloatT g_WGS0;         ///< 赤道上重力
+    static const FloatT g_WGS1;         ///< 重力公式定数
 
 #ifndef pow2
 #define pow2(x) ((x) * (x))
@@ -65,10 +65,10 @@ class WGS84Generic{
 #define ALREADY_POW2_DEFINED
 #endif
     /**
-     * k(Ȃ킿o)̋ɗa߂܂B
+     * 南北方向(すなわち経線上)の極率半径を求めます。
      * 
-     * @param latitude ܓx[rad]
-     * @return (FloatT) k̋ɗa[m]
+     * @param latitude 緯度[rad]
+     * @return (FloatT) 南北方向の極率半径[m]
      */
     static FloatT R_meridian(const FloatT &latitude){
       return R_e * (1. - pow2(epsilon_Earth))
@@ -76,20 +76,20 @@ class WGS84Generic{
     }
     
     /**
-     * ̋ɗa߂܂B
+     * 東西方向の極率半径を求めます。
      * 
-     * @param latitude ܓx[rad]
-     * @return (FloatT) ̋ɗa[m]
+     * @param latitude 緯度[rad]
+     * @return (FloatT) 東西方向の極率半径[m]
      */
     static FloatT R_normal(const FloatT &latitude){
       return R_e / std::sqrt(1. - pow2(epsilon_Earth) * pow2(std::sin(latitude)));  
     }
     
     /**
-     * d͂߂܂
+     * 重力を求めます
      * 
-     * @param latitude ܓx[rad]
-     * @return d[m/s^2]
+     * @param latitude 緯度[rad]
+     * @return 重力[m/s^2]
      */
     static FloatT gravity(const FloatT &latitude){
       return g_WGS0 * (1. + g_WGS1 * pow2(std::sin(latitude)))
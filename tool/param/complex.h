@@ -33,38 +33,38 @@
 #define __COMPLEX_H
 
 /** @file
- * @brief fCu
+ * @brief 複素数ライブラリ
  *
- * f`CuB
- * NĂ悤ȊɂȂƎvB
+ * 複素数を定義したライブラリ。
+ * 多分誰が作っても似たような感じになると思われる。
  */
 
 /**
- * @brief fɊւO
+ * @brief 複素数に関わる例外
  *
- * ComplexNX̗ONXB
- * ƂāAZȂꍇȂǁB
+ * Complexクラスの例外クラス。
+ * 例として、演算が成立しない場合など。
  *
  */
 class ComplexException: public std::exception{
   private:
-    std::string what_str;  ///< G[e
+    std::string what_str;  ///< エラー内容
   public:
     /**
-     * RXgN^
+     * コンストラクタ
      *
-     * @param what_arg G[e
+     * @param what_arg エラー内容
      */
     ComplexException(const std::string &what_arg): what_str(what_arg){}
     /**
-     * fXgN^
+     * デストラクタ
      *
      */
     ~ComplexException() throw() {}
     /**
-     * G[e擾܂B
+     * エラー内容を取得します。
      *
-     * @return (chsr *) G[e
+     * @return (chsr *) エラー内容
      */
     const char *what() const throw(){
       return what_str.c_str();
@@ -74,79 +74,79 @@ class ComplexException: public std::exception{
 #include <cmath>
 
 /**
- * @brief f
+ * @brief 複素数
  *
- * f킷NXłB
+ * 複素数をあらわすクラスです。
  *
- * @param FloatT ZxAdoubleȂ
+ * @param FloatT 演算精度、doubleなど
  */
 template <class FloatT>
 class Complex{
   private:
-    FloatT m_Real; ///< 
-    FloatT m_Imaginary; ///< 
+    FloatT m_Real; ///< 実部
+    FloatT m_Imaginary; ///< 虚部
   public:
   	/**
-  	 * RXgN^B
+  	 * コンストラクタ。
   	 *
-  	 * @param real 
-  	 * @param imaginary 
+  	 * @param real 実数部
+  	 * @param imaginary 虚数部
   	 */
     Complex(const FloatT &real, const FloatT &imaginary)
        : m_Real(real), m_Imaginary(imaginary){}
     /**
-     * RXgN^B
-     * 0ŏ܂B
+     * コンストラクタ。
+     * 虚数部は0で初期化されます。
      *
-     * @param real 
+     * @param real 実数部
      */
     Complex(const FloatT &real) : m_Real(real), m_Imaginary(0){}
     /**
-     * RXgN^B
-     * AƂ0ɏ܂B
+     * コンストラクタ。
+     * 実数部、虚数部ともに0に初期化されます。
      *
      */
     Complex() : m_Real(0), m_Imaginary(0){}
     /**
-     * fXgN^B
+     * デストラクタ。
      *
      */
     ~Complex(){}
 
     /**
-     * Ԃ܂B
+     * 実数部を返します。
      *
-     * @return (FloatT) 
+     * @return (FloatT) 実数部
      */
     FloatT &real(){return m_Real;}
     /**
-     * Ԃ܂B
+     * 虚数部を返します。
      *
-     * @return (FloatT) 
+     * @return (FloatT) 虚数部
      */
     FloatT &imaginary(){return m_Imaginary;}
 
     /**
-     * Βl̓Ԃ܂B
-     * pow(real(), 2) + pow(imaginary(), 2)Ă܂B
+     * 絶対値の二乗を返します。
+     * pow(real(), 2) + pow(imaginary(), 2)をしています。
      *
-     * @return (FloatT) Βl̓
+     * @return (FloatT) 絶対値の二乗
      * @see pow(FloatT, FloatT)
      */
     FloatT abs2() const {return pow(m_Real, 2) + pow(m_Imaginary, 2);}
     /**
-     * ΒlԂ܂B
-     * sqrt(abs2())Ă܂B
+     * 絶対値を返します。
+     * sqrt(abs2())をしています。
      *
-     * @return (FloatT) Βl
+     * @return (FloatT) 絶対値
      * @see abs2()
      * @see sqrt()
      */
     FloatT abs() const {return ::sqrt(abs2());}
     /**
-     * ΊpԂ܂B
+     * 偏角を返します。
      *
-     * @return (double) Ίp
+     * @return (double) 偏角
      */
     double arg() const {
       if((m_Real == FloatT(0)) && (m_Imaginary == FloatT(0))){
@@ -155,19 +155,19 @@ class Complex{
       return atan2(m_Imaginary, m_Real);
     }
     /**
-     * w悵܂B
-     * `ƂāAf
+     * 指定乗します。
+     * ただし定義として、複素数が
      * @f[
      *    a + b i = r e^{i \theta}
      * @f]
-     * Ƃ킳ƂA
+     * とあらわされるとき、
      * @f[
      *    (a + b i)^{n} = r^{n} e^{i \theta n}
      * @f]
-     * Ƃ܂B
+     * とします。
      *
-     * @param factor 搔
-     * @return (Complex<FloatT>) 
+     * @param factor 乗数
+     * @return (Complex<FloatT>) 結果
      */
     Complex<FloatT> power(const FloatT &factor) const {
     	if((m_Imaginary == FloatT(0)) && (m_Real >= FloatT(0))){
@@ -180,9 +180,9 @@ class Complex{
     }
 
     /**
-     * ߂܂B`powerɏ]܂B
+     * 平方根を求めます。定義はpowerに従います。
      *
-     * @return (Complex<FloatT>) 
+     * @return (Complex<FloatT>) 結果
      * @see power
      */
     Complex<FloatT> sqrt() const {
@@ -190,9 +190,9 @@ class Complex{
     }
 
     /**
-     * 𕡑fԂ܂B
+     * 共役複素数を返します。
      *
-     * @return (Complex<FloatT>) 𕡑f
+     * @return (Complex<FloatT>) 共役複素数
      */
     Complex<FloatT> conjugate() const {
       Complex<FloatT> result = *this;
@@ -201,9 +201,9 @@ class Complex{
     }
 
     /**
-     * ǂׂ܂B
+     * 等しいかどうか調べます。
      *
-     * @return (bool) ꍇtrue
+     * @return (bool) 等しい場合true
      */
     bool operator==(const Complex<FloatT> &complex) const{
       return m_Real == const_cast<Complex *>(&complex)->real() ?
@@ -211,62 +211,62 @@ class Complex{
       					false;
     }
     /**
-     * Ȃׂ܂B
+     * 等しくないか調べます。
      *
-     * @return (bool) Ȃꍇtrue
+     * @return (bool) 等しくない場合true
      */
     bool operator!=(const Complex<FloatT> &complex) const{
       return !(*this == complex);
     }
 
     /**
-     * Zs܂BjIłB
+     * 加算を行います。破壊的です。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 加算結果
      */
     Complex<FloatT> &operator+=(const FloatT &scalar){
       m_Real += scalar;
       return *this;
     }
     /**
-     * Zs܂B
+     * 加算を行います。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 加算結果
      */
     Complex<FloatT> operator+(const FloatT &scalar) const{
       Complex<FloatT> result = *this;
       return (result += scalar);
     }
     /**
-     * Zs܂B
+     * 加算を行います。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 加算結果
      */
     friend Complex<FloatT> operator+(const FloatT &scalar, const Complex<FloatT> complex){return (complex + scalar);}
 
     /**
-     * Zs܂BjIłB
+     * 減算を行います。破壊的です。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 減算結果
      */
     Complex<FloatT> &operator-=(const FloatT &scalar){return (*this) += (-scalar);}
     /**
-     * Zs܂B
+     * 減算を行います。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 減算結果
      */
     Complex<FloatT> operator-(const FloatT &scalar) const{return (*this) + (-scalar);}
     /**
-     * Zs܂B
+     * 減算を行います。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 減算結果
      */
     friend Complex<FloatT> operator-(const FloatT &scalar, const Complex<FloatT> complex){return (complex - scalar);}
 
     /**
-     * Zs܂BjIłB
+     * 乗算を行います。破壊的です。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 乗算結果
      */
     Complex<FloatT> &operator *=(const FloatT &scalar){
       m_Real *= scalar;
@@ -274,45 +274,45 @@ class Complex{
       return *this;
     }
     /**
-     * Zs܂B
+     * 乗算を行います。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 乗算結果
      */
     Complex<FloatT> operator*(const FloatT &scalar) const{
       Complex<FloatT> result(*this);
       return (result *= scalar);
     }
     /**
-     * Zs܂B
+     * 乗算を行います。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 乗算結果
      */
     friend Complex<FloatT> operator*(const FloatT &scalar, const Complex<FloatT> complex){return (complex * scalar);}
 
     /**
-     * Zs܂BjIłB
+     * 除算を行います。破壊的です。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 除算結果
      */
     Complex<FloatT> &operator/=(const FloatT &scalar){return (*this) *= (1/scalar);}
     /**
-     * Zs܂B
+     * 除算を行います。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 除算結果
      */
     Complex<FloatT> operator/(const FloatT &scalar) const{return (*this) * (1/scalar);}
 
     /**
-     * P}CiXIy[^B
+     * 単項マイナスオペレータ。
      *
-     * @return (Complex<FloatT>) 
+     * @return (Complex<FloatT>) 結果
      */
     Complex<FloatT> operator -() const{return ((*this) * -1);}
 
     /**
-     * Zs܂BjIłB
+     * 加算を行います。破壊的です。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 加算結果
      */
     Complex<FloatT> &operator+=(const Complex<FloatT> &complex){
       m_Real += (const_cast<Complex *>(&complex))->real();
@@ -320,9 +320,9 @@ class Complex{
       return *this;
     }
     /**
-     * Zs܂B
+     * 加算を行います。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 加算結果
      */
     Complex<FloatT> operator+(const Complex<FloatT> &complex) const{
       Complex<FloatT> result = *this;
@@ -330,26 +330,26 @@ class Complex{
     }
 
     /**
-     * Zs܂BjIłB
+     * 減算を行います。破壊的です。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 減算結果
      */
     Complex<FloatT> &operator-=(const Complex<FloatT> &complex){
       return ((*this) += (-complex));
     }
     /**
-     * Zs܂B
+     * 減算を行います。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 減算結果
      */
     Complex<FloatT> operator-(const Complex<FloatT> &complex) const{
       return ((-complex) += (*this));
     }
 
     /**
-     * Zs܂B
+     * 乗算を行います。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 乗算結果
      */
     Complex<FloatT> operator*(const Complex<FloatT> &complex) const{
       Complex<FloatT> result(m_Real * (const_cast<Complex *>(&complex))->real()
@@ -359,9 +359,9 @@ class Complex{
       return result;
     }
     /**
-     * Zs܂BjIłB
+     * 乗算を行います。破壊的です。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 乗算結果
      */
     Complex<FloatT> &operator*=(const Complex<FloatT> &complex){
       Complex<FloatT> copy = *this;
@@ -375,17 +375,17 @@ class Complex{
     }
 
     /**
-     * Zs܂BjIłB
+     * 除算を行います。破壊的です。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 除算結果
      */
     Complex<FloatT> &operator/=(const Complex<FloatT> &complex){
       return (*this) *= (complex.conjugate() / complex.abs2());
     }
     /**
-     * Zs܂B
+     * 除算を行います。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 除算結果
      */
     Complex<FloatT> operator/(const Complex<FloatT> &complex) const{
       Complex<FloatT> copy = (*this);
@@ -393,19 +393,19 @@ class Complex{
     }
 
     /**
-     * Zs܂B
+     * 除算を行います。
      *
-     * @return (Complex<FloatT>) Z
+     * @return (Complex<FloatT>) 除算結果
      */
     friend Complex<FloatT> operator/(const FloatT &scalar, const Complex<FloatT> complex){
       return Complex<FloatT>(scalar) / complex;
     }
 
     /**
-     * ݂₷`ŕfo͂܂B
+     * みやすい形で複素数を出力します。
      *
-     * @param out o̓Xg[
-     * @param complex o͂镡f
+     * @param out 出力ストリーム
+     * @param complex 出力する複素数
      */
     friend std::ostream &operator<<(std::ostream &out, const Complex<FloatT> &complex){
       out << (const_cast<Complex *>(&complex))->real() << " + "
@@ -414,31 +414,31 @@ class Complex{
     }
 
     /**
-     * e̎w߂܂B
+     * eの指数乗を求めます。
      *
-     * @param imaginary 
-     * @return (Complex<FloatT>) 
+     * @param imaginary 虚部
+     * @return (Complex<FloatT>) 結果
      */
     static Complex<FloatT> exp(const FloatT &imaginary){
       return Complex<FloatT>(cos(imaginary), sin(imaginary));
     }
 
     /**
-     * e̎w߂܂B
+     * eの指数乗を求めます。
      *
-     * @param real 
-     * @param imaginary 
-     * @return (Complex<FloatT>) 
+     * @param real 実部
+     * @param imaginary 虚部
+     * @return (Complex<FloatT>) 結果
      */
     static Complex<FloatT> exp(const FloatT &real, const FloatT &imaginary){
       return Complex<FloatT>::exp(imaginary) *= ::exp(real);
     }
 
     /**
-     * e̎w߂܂B
+     * eの指数乗を求めます。
      *
-     * @param complex f
-     * @return (Complex<FloatT>) 
+     * @param complex 複素数
+     * @return (Complex<FloatT>) 結果
      */
     static Complex<FloatT> exp(const Complex<FloatT> &complex){
       return Complex<FloatT>::exp(
@@ -448,12 +448,12 @@ class Complex{
 };
 
 /**
- * exp̕fg
+ * expの複素数拡張
  *
- * @param real 
- * @param imaginary 
- * @param FloatT Zx
- * @return (Complex<FloatT>) 
+ * @param real 実部
+ * @param imaginary 虚部
+ * @param FloatT 演算精度
+ * @return (Complex<FloatT>) 結果
  */
 template <class FloatT>
 inline Complex<FloatT> iexp(const FloatT &real, const FloatT &imaginary){
@@ -461,10 +461,10 @@ inline Complex<FloatT> iexp(const FloatT &real, const FloatT &imaginary){
 }
 
 /**
- * exp̕fg
- * @param imaginary 
- * @param FloatT Zx
- * @return (Complex<FloatT>) 
+ * expの複素数拡張
+ * @param imaginary 虚部
+ * @param FloatT 演算精度
+ * @return (Complex<FloatT>) 結果
  */
 template <class FloatT>
 inline Complex<FloatT> iexp(const FloatT &imaginary){
@@ -472,11 +472,11 @@ inline Complex<FloatT> iexp(const FloatT &imaginary){
 }
 
 /**
- * exp̕fg
+ * expの複素数拡張
  *
- * @param complex f
- * @param FloatT Zx
- * @return (Complex<FloatT>) 
+ * @param complex 複素数
+ * @param FloatT 演算精度
+ * @return (Complex<FloatT>) 結果
  */
 template <class FloatT>
 inline Complex<FloatT> exp(const Complex<FloatT> &complex){
@@ -484,11 +484,11 @@ inline Complex<FloatT> exp(const Complex<FloatT> &complex){
 }
 
 /**
- * pow̕fg
+ * powの複素数拡張
  *
- * @param complex f
- * @param FloatT Zx
- * @return (Complex<FloatT>) 
+ * @param complex 複素数
+ * @param FloatT 演算精度
+ * @return (Complex<FloatT>) 結果
  */
 template <class FloatT>
 inline Complex<FloatT> pow(const Complex<FloatT> &complex, const FloatT &factor){
@@ -496,11 +496,11 @@ inline Complex<FloatT> pow(const Complex<FloatT> &complex, const FloatT &factor)
 }
 
 /**
- * sqrt̕fg
+ * sqrtの複素数拡張
  *
- * @param complex f
- * @param FloatT Zx
- * @return (Complex<FloatT>) 
+ * @param complex 複素数
+ * @param FloatT 演算精度
+ * @return (Complex<FloatT>) 結果
  */
 template <class FloatT>
 inline Complex<FloatT> sqrt(const Complex<FloatT> &complex){
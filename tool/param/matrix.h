@@ -33,15 +33,15 @@
 #define __MATRIX_H
 
 /** @file
- * @brief s񃉃Cu
+ * @brief 行列ライブラリ
  *
- * 萻̍s`CuB
- * V[Rs[ϋɓIɗpĂ̂œ]u╔sł̓Rs[𐶐ȂA
- * ȂĂƎv܂B
+ * お手製の行列を定義したライブラリ。
+ * シャローコピーを積極的に利用しているので転置や部分行列ではコピーを生成しない分、
+ * 早くなっていると思われます。
  *
- * Zxŏdꍇ́AETpublas
- * p邱ƂĂB
- * C^[tFCX͑̎ĂƎv̂ŁAڐA͊ȒPȂ͂łB
+ * しかし演算速度を最重視する場合は、ETを活用したublas等を
+ * 利用することを検討してください。
+ * インターフェイスは大体似ていると思うので、移植は簡単なはずです。
  *
  * @see <a href="http://www.boost.org/libs/numeric/ublas/doc/index.htm">boost::ublas</a>
  */
@@ -52,10 +52,10 @@
 #include <exception>
 
 /**
- * @brief sɊւO
+ * @brief 行列に関わる例外
  *
- * MatrixNX̗ONXB
- * ƂāAZȂꍇȂǁB
+ * Matrixクラスの例外クラス。
+ * 例として、演算が成立しない場合など。
  *
  */
 class MatrixException: public std::exception{
@@ -63,20 +63,20 @@ class MatrixException: public std::exception{
     std::string what_str;
   public:
     /**
-     * RXgN^B
+     * コンストラクタ。
      *
-     * @param what_arg G[e
+     * @param what_arg エラー内容
      */
     MatrixException(const std::string &what_arg) : what_str(what_arg){}
     /**
-     * fXgN^B
+     * デストラクタ。
      *
      */
     ~MatrixException() throw(){}
     /**
-     * G[e擾܂B
+     * エラー内容を取得します。
      *
-     * @return (chsr *) G[e
+     * @return (chsr *) エラー内容
      */
     const char *what() const throw(){
       return what_str.c_str();
@@ -84,23 +84,23 @@ class MatrixException: public std::exception{
 };
 
 /**
- * @brief s̕ۊǕ@ɊւO
+ * @brief 行列の保管方法に関する例外
  *
- * ۑNX̗ONXB
- * ƂāAȂꍇȂǁB
+ * 保存クラスの例外クラス。
+ * 例として、メモリが足りない場合など。
  *
  */
 class StorageException: public MatrixException{
   public:
     /**
-     * RXgN^B
+     * コンストラクタ。
      *
-     * @param what_arg G[e
+     * @param what_arg エラー内容
      */
     StorageException(const std::string &what_arg)
         : MatrixException(what_arg) {}
     /**
-     * fXgN^B
+     * デストラクタ。
      *
      */
     ~StorageException() throw(){}
@@ -111,6 +111,8 @@ class StorageException: public MatrixException{
 #include <ostream>
 #include <iterator>
 #include <algorithm>
+#include <utility>
+#include <new>
 #include "param/complex.h"
 
 template <class T>
@@ -123,25 +125,25 @@ template <class T>
 void array2d_clear(T &t){t = T(0);}
 
 /**
- * ssp̓ꉻ
+ * 行列内行列用の特殊化
  * 
  */
 template <class T>
 void array2d_clear(Matrix<T> &t){t = Matrix<T>();}
 
 /**
- * @brief 2z̒ۃNX
+ * @brief 2次元配列の抽象クラス
  *
- * 2z̒ۃNXłB
- * 2zɂvfA܂͗vfւ̃ANZXȂǂ̃C^[tFCX`Ă܂B
+ * 2次元配列の抽象クラスです。
+ * 2次元配列における要素数、または要素へのアクセスなどのインターフェイスを定義しています。
  *
- * @param T ZxAdoubleȂǁB
+ * @param T 演算精度、doubleなど。
  */
 template<class T>
 class Array2D{
   protected:
-    unsigned int m_rows;    ///< s
-    unsigned int m_columns; ///< 
+    unsigned int m_rows;    ///< 行数
+    unsigned int m_columns; ///< 列数
     
     typedef Array2D<T> self_t;
     typedef Array2D<T> root_t;
@@ -151,44 +153,52 @@ class Array2D{
     typedef T content_t;
 
     /**
-     * V[Rs[܂B
+     * シャローコピーをします。
      *
-     * @return (Array2D *) g
+     * @return (Array2D *) 自分自身
      */
     virtual self_t *shallow_copy() const = 0;
 
     /**
-     * Array2DNX̃RXgN^B
-     * w̍sTCYAw̗TCYŉzI2z𐶐܂B
+     * Array2Dクラスのコンストラクタ。
+     * 指定の行サイズ、指定の列サイズで仮想的な2次元配列を生成します。
      *
-     * @param rows s
-     * @param columns 
+     * @param rows 行数
+     * @param columns 列数
      */
     Array2D(const unsigned int &rows, const unsigned int &columns)
         : m_rows(rows), m_columns(columns){}
 
     /**
-     * Array2DNX̃fXgN^B
+     * Array2Dクラスのデストラクタ。
 
      */
     virtual ~Array2D(){/*std::cout << "~Array2D() called" << std::std::endl;*/}
 
     /**
-     * 2z𕡐(fB[vRs[)܂B
+     * 2次元配列を複製(ディープコピー)します。
      *
-     * @return storage_t>) Rs[
+     * @return storage_t>) コピー
      */
     virtual root_t *copy() const throw(StorageException) = 0;
 
     /**
-     * 2zɗƂ݂܂B
+     * 値セマンティクス(MATRIX_NO_FLY_WEIGHT)における複製を行います。
+     * 既定ではシャローコピーであり、実体を持つ2次元配列はディープコピーします。
+     *
+     * @return (Array2D *) コピー
+     */
+    virtual root_t *value_copy() const {return shallow_copy();}
+
+    /**
+     * 密2次元配列に落とし込みます。
      *
      * @return (Array2D_Dense<T>)
      */
     virtual dense_t dense() const = 0;
 
     /**
-     * 2z̃TCY𒲐܂B
+     * 2次元配列のサイズを調整します。
      *
      */
     /*virtual void *resize(const unsigned int &rows,
@@ -198,24 +208,24 @@ class Array2D{
     }*/
 
     /**
-     * sԂ܂B
+     * 行数を返します。
      *
-     * @return (int) s
+     * @return (int) 行数
      */
     unsigned int rows() const{return m_rows;}
     /**
-     * 񐔂Ԃ܂B
+     * 列数を返します。
      *
-     * @return (int) 
+     * @return (int) 列数
      */
     unsigned int columns() const{return m_columns;}
 
     /**
-     * w肵s񐬕Ԃ܂B
+     * 指定した行列成分を返します。
      *
-     * @param row sCfbNX(Jnԍ0`)
-     * @param column CfbNX(Jnԍ0`)
-     * @return (T) 
+     * @param row 行インデックス(開始番号は0～)
+     * @param column 列インデックス(開始番号は0～)
+     * @return (T) 成分
      */
     virtual T &operator()(
         const unsigned int &row,
@@ -301,7 +311,7 @@ class Array2D{
     }
     
     /**
-     * vf̃[NAs܂B
+     * 要素のゼロクリアを行います。
      *
      */
     void clear(){
@@ -320,14 +330,289 @@ class Array2D{
 template <class T>
 void array2d_copy(Array2D_Dense<T> *dist, const T *src);
 
+#ifndef ARRAY2D_DENSE_POOL_MAX_SIZE
+#define ARRAY2D_DENSE_POOL_MAX_SIZE 1024 ///< プールの対象とする最大要素数
+#endif
+
+#ifndef ARRAY2D_DENSE_POOL_MAX_CACHED
+#define ARRAY2D_DENSE_POOL_MAX_CACHED 64 ///< 要素数ごとにフリーリストに保持する最大ブロック数
+#endif
+
+#ifndef ARRAY2D_DENSE_POOL_TLS
+#if defined(__GNUC__)
+#define ARRAY2D_DENSE_POOL_TLS __thread
+#elif defined(_MSC_VER)
+#define ARRAY2D_DENSE_POOL_TLS __declspec(thread)
+#else
+#define ARRAY2D_DENSE_POOL_TLS
+#endif
+#endif
+
+/**
+ * @brief 密2次元配列用のメモリプール
+ *
+ * Array2D_Denseが使用する成分用メモリと参照カウンタを1回のヒープ確保で用意し、
+ * 要素数ごとのフリーリスト(サイズクラス)によって再利用するためのクラス。
+ * フリーリストはスレッドごとに独立しています。
+ * 既定では無効であり、その場合は従来通りnew/deleteを都度行います。
+ * 有効にするにはScopeを生成してください。
+ * フィルタの1ステップ(予測、修正)ごとに生成することを想定しており、
+ * 最も外側のScopeの破棄時にフリーリストは解放されます。
+ * また、フリーリストに保持するブロック数は要素数ごとに
+ * ARRAY2D_DENSE_POOL_MAX_CACHEDまでに制限されます。
+ * スレッドごとに独立しているため、OpenMP等のワーカースレッドで
+ * 使用する場合は、そのスレッド内でScopeを生成する必要があります。
+ *
+ * @param T 演算精度、doubleなど。
+ */
+template <class T>
+class Array2D_Dense_Pool {
+  public:
+    /**
+     * @brief 確保単位
+     *
+     * 参照カウンタと成分用メモリの組であり、成分用メモリはこの直後に配置されます。
+     * 参照カウンタへのポインタからブロックを復元するため、refは先頭に置きます。
+     */
+    struct block_t {
+      int ref;            ///< 参照カウンタ
+      unsigned int size;  ///< 要素数
+      T *values;          ///< 成分用メモリ
+      block_t *next;      ///< フリーリストにおける次のブロック
+    };
+
+    /**
+     * @brief 統計情報
+     *
+     */
+    struct stats_t {
+      unsigned long requested;  ///< 確保要求数
+      unsigned long reused;     ///< プールから再利用した数
+      unsigned long released;   ///< 解放要求数
+      unsigned long cached;     ///< プールへ返却した数
+      unsigned long purged;     ///< プールへ返却した後に解放した数
+      /**
+       * 回避できたヒープ確保の回数を返します。
+       *
+       * @return (unsigned long) 回避回数
+       */
+      unsigned long allocations_avoided() const {return reused;}
+      /**
+       * 回避できたヒープ解放の回数を返します。
+       * 返却後に再利用されたブロックのみが対象であり、
+       * 返却後にpurge()で解放されたブロックは含みません。
+       *
+       * @return (unsigned long) 回避回数
+       */
+      unsigned long frees_avoided() const {return reused;}
+      stats_t operator-(const stats_t &another) const {
+        stats_t res = {
+          requested - another.requested,
+          reused - another.reused,
+          released - another.released,
+          cached - another.cached,
+          purged - another.purged};
+        return res;
+      }
+      stats_t &operator+=(const stats_t &another){
+        requested += another.requested;
+        reused += another.reused;
+        released += another.released;
+        cached += another.cached;
+        purged += another.purged;
+        return *this;
+      }
+    };
+
+  protected:
+    /**
+     * 成分用メモリの先頭までの大きさを返します。
+     * 成分の整列のため、long doubleの大きさの整数倍とします。
+     *
+     * @return (std::size_t) 大きさ
+     */
+    static std::size_t header_size(){
+      return ((sizeof(block_t) + sizeof(long double) - 1) / sizeof(long double))
+          * sizeof(long double);
+    }
+
+    /**
+     * ブロックをヒープから確保します。
+     * 成分はデフォルト初期化されます。
+     *
+     * @param size 要素数
+     * @return (block_t *) ブロック
+     */
+    static block_t *create(const unsigned int &size){
+      // bad_alloc例外がでるので調べる必要はない
+      char *mem(static_cast<char *>(::operator new(header_size() + sizeof(T) * size)));
+      block_t *block(reinterpret_cast<block_t *>(mem));
+      block->size = size;
+      block->values = reinterpret_cast<T *>(mem + header_size());
+      unsigned int i(0);
+      try{
+        for(; i < size; i++){new(block->values + i) T;}
+      }catch(...){
+        while(i > 0){block->values[--i].~T();}
+        ::operator delete(mem);
+        throw;
+      }
+      return block;
+    }
+
+    /**
+     * ブロックをヒープに返却します。
+     *
+     * @param block ブロック
+     */
+    static void destroy(block_t *block){
+      for(unsigned int i(0); i < block->size; i++){block->values[i].~T();}
+      ::operator delete(block);
+    }
+
+    struct state_t {
+      bool enabled;
+      stats_t stats;
+      block_t *heads[ARRAY2D_DENSE_POOL_MAX_SIZE + 1];
+      unsigned int counts[ARRAY2D_DENSE_POOL_MAX_SIZE + 1]; ///< フリーリストの長さ
+    };
+    static state_t &state(){
+      static ARRAY2D_DENSE_POOL_TLS state_t _state; // ゼロ初期化される
+      return _state;
+    }
+
+  public:
+    /**
+     * プールが有効かどうかを返します。
+     *
+     * @return (bool) 有効な場合true
+     */
+    static bool enabled(){return state().enabled;}
+
+    /**
+     * 現在のスレッドにおける累積の統計情報を返します。
+     *
+     * @return (stats_t) 統計情報
+     */
+    static stats_t stats(){return state().stats;}
+
+    /**
+     * 現在のスレッドのフリーリストに保持しているブロック数を返します。
+     *
+     * @return (unsigned int) ブロック数
+     */
+    static unsigned int cached_blocks(){
+      state_t &s(state());
+      unsigned int res(0);
+      for(unsigned int i(0); i <= ARRAY2D_DENSE_POOL_MAX_SIZE; i++){
+        res += s.counts[i];
+      }
+      return res;
+    }
+
+    /**
+     * ブロックを確保します。
+     * 参照カウンタは1に初期化されます。
+     *
+     * @param size 要素数
+     * @param values 確保した成分用メモリの格納先
+     * @return (int *) 参照カウンタ
+     */
+    static int *allocate(const unsigned int &size, T *&values){
+      state_t &s(state());
+      s.stats.requested++;
+      block_t *block;
+      if(s.enabled && (size <= ARRAY2D_DENSE_POOL_MAX_SIZE) && s.heads[size]){
+        block = s.heads[size];
+        s.heads[size] = block->next;
+        s.counts[size]--;
+        s.stats.reused++;
+      }else{
+        block = create(size);
+      }
+      block->ref = 1;
+      values = block->values;
+      return &(block->ref);
+    }
+
+    /**
+     * 参照カウンタが0となったブロックを解放します。
+     * プールが有効で、フリーリストが上限に達していない場合は
+     * フリーリストに返却します。
+     *
+     * @param ref 参照カウンタ
+     */
+    static void release(int *ref){
+      state_t &s(state());
+      s.stats.released++;
+      block_t *block(reinterpret_cast<block_t *>(ref));
+      if(s.enabled && (block->size <= ARRAY2D_DENSE_POOL_MAX_SIZE)
+          && (s.counts[block->size] < ARRAY2D_DENSE_POOL_MAX_CACHED)){
+        block->next = s.heads[block->size];
+        s.heads[block->size] = block;
+        s.counts[block->size]++;
+        s.stats.cached++;
+      }else{
+        destroy(block);
+      }
+    }
+
+    /**
+     * フリーリストに保持しているブロックを全て解放します。
+     *
+     */
+    static void purge(){
+      state_t &s(state());
+      for(unsigned int i(0); i <= ARRAY2D_DENSE_POOL_MAX_SIZE; i++){
+        while(s.heads[i]){
+          block_t *block(s.heads[i]);
+          s.heads[i] = block->next;
+          destroy(block);
+          s.stats.purged++;
+        }
+        s.counts[i] = 0;
+      }
+    }
+
+    /**
+     * @brief プールの有効範囲
+     *
+     * 生成から破棄までの間、現在のスレッドのプールを有効にします。
+     * 入れ子にすることもでき、破棄時には生成前の状態に戻します。
+     * 最も外側のScopeの破棄時にはフリーリストを解放します。
+     * 生成時にenableをfalseとした場合は何もしません。
+     */
+    class Scope {
+      protected:
+        bool m_enable;
+        bool m_previous;
+        stats_t m_base;
+      public:
+        Scope(const bool &enable = true)
+            : m_enable(enable), m_previous(state().enabled), m_base(state().stats) {
+          if(m_enable){state().enabled = true;}
+        }
+        ~Scope(){
+          if(!m_enable){return;}
+          if(!(state().enabled = m_previous)){purge();}
+        }
+        /**
+         * Scope生成以降の統計情報を返します。
+         *
+         * @return (stats_t) 統計情報
+         */
+        stats_t stats() const {return state().stats - m_base;}
+    };
+};
+
 /**
- * @brief gl܂2z
+ * @brief 中身が詰まった2次元配列
  *
- * gl܂2z\NXB
- * I1zł̃̈͊mۂĂ܂B
- * Ȃ킿isj񐬕(i, j0琔Ƃ)́A[i * rows + j]ԋp܂B
+ * 中身が詰まった2次元配列を表現するクラス。
+ * 内部的に1次元配列でこれらのメモリ領域は確保されています。
+ * すなわちi行j列成分(i, jが0から数えるとして)は、[i * rows + j]が返却されます。
  *
- * @param T ZxAdoubleȂǁB
+ * @param T 演算精度、doubleなど。
  */
 template <class T>
 class Array2D_Dense : public Array2D<T> {
@@ -335,15 +620,16 @@ class Array2D_Dense : public Array2D<T> {
     typedef Array2D_Dense<T> self_t;
     typedef Array2D<T> super_t;
     typedef Array2D<T> root_t;
+    typedef Array2D_Dense_Pool<T> pool_t;
     
-    T *m_Values; ///< mۂ
-    int *ref;   ///< QƃJE^
+    T *m_Values; ///< 確保したメモリ
+    int *ref;   ///< 参照カウンタ
 
   public:
     /**
-     * Pz񉻂̂Ԃ܂B
+     * 単純配列化したものを返します。
      *
-     * @return (T *) Pz
+     * @return (T *) 単純配列
      */
     T *buffer() const {return m_Values;}
     
@@ -351,10 +637,10 @@ class Array2D_Dense : public Array2D<T> {
     using root_t::columns;
     
     /**
-     * 2z𕡐(fB[vRs[)܂B
+     * 2次元配列を複製(ディープコピー)します。
      *
-     * @return (Array2D<T>) Rs[
-     * @throw StorageException ̊mۂɎsƂ
+     * @return (Array2D<T>) コピー
+     * @throw StorageException メモリの確保に失敗したとき
      */
     root_t *copy() const throw(StorageException){
       self_t *array(
@@ -364,27 +650,41 @@ class Array2D_Dense : public Array2D<T> {
     }
 
     /**
-     * 2zɗƂ݂܂B
+     * 密2次元配列に落とし込みます。
      *
      * @return (Array2D_Dense<T>)
      */
     self_t dense() const {return self_t(*this);}
 
     /**
-     * V[Rs[܂B
-     * QƃJE^̃CNgɍs܂B
+     * シャローコピーをします。
+     * 参照カウンタのインクリメントも同時に行います。
      *
-     * @return (Array2D_Dense *)g
+     * @return (Array2D_Dense *)自分自身
      */
     root_t *shallow_copy() const {return new self_t(*this);}
 
     /**
-     * w肵s񐬕Ԃ܂B
+     * 成分用メモリを他の2次元配列と共有しているかどうかを返します。
      *
-     * @param row sCfbNX(Jnԍ0`)
-     * @param column CfbNX(Jnԍ0`)
-     * @return (T) 
-     * @throw StorageException QƃCfbNXs̏ꍇ
+     * @return (bool) 共有している場合true
+     */
+    bool shared() const {return ref && ((*ref) > 1);}
+
+    /**
+     * 値セマンティクスにおける複製として、ディープコピーをします。
+     *
+     * @return (Array2D<T>) コピー
+     */
+    root_t *value_copy() const {return copy();}
+
+    /**
+     * 指定した行列成分を返します。
+     *
+     * @param row 行インデックス(開始番号は0～)
+     * @param column 列インデックス(開始番号は0～)
+     * @return (T) 成分
+     * @throw StorageException 参照インデックスが不正の場合
      */
     T &operator()(
         const unsigned int &row,
@@ -396,77 +696,70 @@ class Array2D_Dense : public Array2D<T> {
     }
 
     /**
-     * Array2D_DenseNX̃RXgN^B
-     * w̍sTCYAw̗TCY2z𐶐܂B
+     * Array2D_Denseクラスのコンストラクタ。
+     * 指定の行サイズ、指定の列サイズで2次元配列を生成します。
      *
-     * @param rows s
-     * @param columns 
-     * @throw StorageException mۂłȂꍇ
+     * @param rows 行数
+     * @param columns 列数
+     * @throw StorageException メモリが確保できなかった場合
      */
     Array2D_Dense<T>(
         const unsigned int &rows,
         const unsigned int &columns) throw(StorageException)
         : super_t(rows, columns),
-        m_Values(new T[rows * columns]),
-        ref(new int(0)) {
-      // bad_allocOł̂ŒׂKv͂Ȃ
-      // if(!m_Values || !ref){throw StorageException("Lack of memory!!");}
-      (*ref)++;
-    }
+        m_Values(NULL),
+        ref(pool_t::allocate(rows * columns, m_Values)) {}
 
     /**
-     * Array2D_DenseNX̃RXgN^B
-     * w̍sTCYAw̗TCY2z𐶐܂B
-     * ܂serilaizedɂĎw肳ꂽlŐ܂
+     * Array2D_Denseクラスのコンストラクタ。
+     * 指定の行サイズ、指定の列サイズで2次元配列を生成します。
+     * また成分はserilaizedによって指定された値で生成されます
      *
-     * @param rows s
-     * @param columns 
-     * @param serialized 
-     * @throw StorageException mۂłȂꍇ
+     * @param rows 行数
+     * @param columns 列数
+     * @param serialized 成分
+     * @throw StorageException メモリが確保できなかった場合
      */
     Array2D_Dense<T>(
         const unsigned int &rows,
         const unsigned int &columns,
         const T *serialized) throw(StorageException)
         : super_t(rows, columns),
-        m_Values(new T[rows * columns]), ref(new int(0)) {
-      // bad_allocOł̂ŒׂKv͂Ȃ
-      //if(!m_Values || !ref){throw StorageException("Lack of memory!!");}
-      (*ref)++;
+        m_Values(NULL),
+        ref(pool_t::allocate(rows * columns, m_Values)) {
       array2d_copy(this, serialized);
     }
 
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
      *
-     * @param array Rs[
+     * @param array コピー元
      */
     Array2D_Dense(const self_t &array)
         : super_t(array.m_rows, array.m_columns){
       if(m_Values = array.m_Values){(*(ref = array.ref))++;}
     }
     /**
-     * fXgN^B
-     * QƃJE^ZƋɁAJE^0̏ꍇA
-     * mۂdeleteɂĉ܂B
+     * デストラクタ。
+     * 参照カウンタを減算すると共に、もしカウンタが0の場合、
+     * 確保したメモリを解放(またはプールに返却)します。
      */
     ~Array2D_Dense(){
       if(ref && ((--(*ref)) <= 0)){
         //std::cout << "Trashed" << std::endl;
-        delete [] m_Values;
-        delete ref;
+        pool_t::release(ref);
       }
     }
 
     /**
-     * ZqB
-     * ȃV[Rs[s܂B
+     * 代入演算子。
+     * 高速なシャローコピーを行います。
      *
-     * @return (Array2D_Dense<T>) g
+     * @return (Array2D_Dense<T>) 自分自身
      */
     self_t &operator=(const self_t &array){
       if(this != &array){
-        if(ref && ((--(*ref)) <= 0)){delete ref; delete [] m_Values;}
+        if(ref && ((--(*ref)) <= 0)){pool_t::release(ref);}
         if(m_Values = array.m_Values){
           super_t::m_rows = array.m_rows;
           super_t::m_columns = array.m_columns;
@@ -520,7 +813,7 @@ void array2d_copy(Array2D_Dense<T> *dist, const T *src){
 }
 
 /**
- * ssp2zRs[邽߂̓ꉻ
+ * 行列内行列用の2次元配列をコピーするための特殊化
  *
  */
 template <class T>
@@ -534,15 +827,51 @@ void array2d_copy(
 }
 
 /**
- * @brief ʂ2zɈϏs2z
+ * @brief 行列の複製方法
  *
- * ʂ2zɈϏs2z`NXB
- * ႦΓ]usȂǂ̓CfbNX]û݂ŎԂRs[ȂƂ
- * I[o[wbhƂȂ܂B
- * ŁÂ悤ȍs݂̑̂ւNXԂɒp邱Ƃɂ
- * Zɏ邱Ƃ\ɂȂ܂B
+ * Matrixのコピーコンストラクタ、代入演算子における2次元配列の複製方法を定義します。
+ * 既定では参照カウンタを利用したシャローコピーです。
  *
- * @param T ZxAdoubleȂǁB
+ * @param T 演算精度、doubleなど。
+ * @see MATRIX_NO_FLY_WEIGHT
+ */
+template <class T>
+struct Array2D_Duplicator {
+  static Array2D<T> *duplicate(const Array2D<T> *storage){
+    return storage ? storage->shallow_copy() : NULL;
+  }
+};
+
+/**
+ * 行列を値セマンティクスとするための特殊化を行います。
+ * 密行列はコピーの度にディープコピーされ、参照カウンタが共有されなくなるため、
+ * copy()の呼び忘れによる意図しない書き換えや、スレッド間での共有がなくなります。
+ * 参照カウンタは成分用メモリと同じブロックにあるため(@see Array2D_Dense_Pool)、
+ * そのための追加のヒープ確保はありません。
+ * ただし転置行列、部分行列などは元の行列への参照であるため、従来通りシャローコピーです。
+ * Matrix<float_t>が使用される前に宣言する必要があります。
+ *
+ * @param float_t 演算精度、doubleなど。
+ * @see Array2D::value_copy()
+ */
+#define MATRIX_NO_FLY_WEIGHT(float_t) \
+template <> \
+struct Array2D_Duplicator<float_t> { \
+  static Array2D<float_t> *duplicate(const Array2D<float_t> *storage){ \
+    return storage ? storage->value_copy() : NULL; \
+  } \
+}
+
+/**
+ * @brief 別の2次元配列に委譲を行う2次元配列
+ *
+ * 別の2次元配列に委譲を行う2次元配列を定義したクラス。
+ * 例えば転置行列などはインデックスを転置するのみで実態をコピーしなおすことは
+ * オーバーヘッドとなります。
+ * そこで、このような行列の操作のみを入れ替えるクラスを間に中継させることによって
+ * 演算を高速に処理することが可能になります。
+ *
+ * @param T 演算精度、doubleなど。
  */
 template<class T>
 class Array2D_Delegate : public Array2D<T>{
@@ -557,26 +886,26 @@ class Array2D_Delegate : public Array2D<T>{
 
   protected:
     /**
-     * ϏԂ܂B
+     * 委譲先を返します。
      *
-     * @return (Array2D<T>) Ϗ
+     * @return (Array2D<T>) 委譲先
      */
     root_t &getTarget() const{return *m_target;}
 
   public:
     /**
-     * ϏԂ܂B
+     * 委譲先を返します。
      *
-     * @return (Array2D<T>) Ϗ
+     * @return (Array2D<T>) 委譲先
      */
     const root_t *getParent() const{return m_target;}
 
     /**
-     * Array2D_Partial(2z)NX̃RXgN^B
+     * Array2D_Partial(部分2次元配列)クラスのコンストラクタ。
      *
-     * @param rows s
-     * @param columns 
-     * @param array ̔z
+     * @param rows 行数
+     * @param columns 列数
+     * @param array 元の配列
      */
     Array2D_Delegate(
         const unsigned int &rows, const unsigned int &columns,
@@ -584,10 +913,10 @@ class Array2D_Delegate : public Array2D<T>{
         : super_t(rows, columns), m_target(array.shallow_copy()){}
 
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
      *
-     * @param array Rs[
-     * @throw StorageException Rs[ɂĂȂ炩̗Oꍇ
+     * @param array コピー元
+     * @throw StorageException コピーにおいてなんらかの例外が発生した場合
      */
     Array2D_Delegate(
         const self_t &array) throw(StorageException)
@@ -595,17 +924,17 @@ class Array2D_Delegate : public Array2D<T>{
         m_target(array.m_target->shallow_copy()){}
 
     /**
-     * fXgN^B
+     * デストラクタ。
      */
     ~Array2D_Delegate(){delete m_target;}
 
     /**
-     * w肵s񐬕Ԃ܂B
+     * 指定した行列成分を返します。
      *
-     * @param row sCfbNX(Jnԍ0`)
-     * @param column CfbNX(Jnԍ0`)
-     * @return (T) 
-     * @throw StorageException CfbNXs̏ꍇ
+     * @param row 行インデックス(開始番号は0～)
+     * @param column 列インデックス(開始番号は0～)
+     * @return (T) 成分
+     * @throw StorageException インデックスが不正の場合
      */
     T &operator()(
         const unsigned int &row,
@@ -628,7 +957,7 @@ class Array2D_Delegate : public Array2D<T>{
     };
     
     /**
-     * 2zɗƂ݂܂B
+     * 密2次元配列に落とし込みます。
      *
      * @return (Array2D_Dense<T>)
      */
@@ -649,11 +978,11 @@ class Array2D_Delegate : public Array2D<T>{
     }
 
     /**
-     * (fB[vRs[)܂B
-     * ͒PȖ2zɂȂ܂B
+     * 複製(ディープコピー)します。
+     * 複製後は単純な密2次元配列になります。
      *
-     * @return (root_t) Rs[
-     * @throw StorageException mۂłȂꍇ
+     * @return (root_t) コピー
+     * @throw StorageException メモリが確保できなかった場合等
      */
     root_t *copy() const throw(StorageException){
       return dense().shallow_copy();
@@ -661,48 +990,48 @@ class Array2D_Delegate : public Array2D<T>{
 };
 
 /**
- * @brief ]q2z
+ * @brief 余因子2次元配列
  *
- * ]q2z킷NXB
+ * 余因子2次元配列をあらわすクラス。
  *
- * @param T ZxAdoubleȂ
+ * @param T 演算精度、doubleなど
  */
 template<class T>
 class Array2D_CoFactor : public Array2D_Delegate<T>{
 
   private:
-    unsigned int m_RowCoFactor;     ///< ]qw肷錳̍sł̍sCfbNX
-    unsigned int m_ColumnCoFactor;  ///< ]qw肷錳̍sł̗CfbNX
+    unsigned int m_RowCoFactor;     ///< 余因子を指定する元の行列での行インデックス
+    unsigned int m_ColumnCoFactor;  ///< 余因子を指定する元の行列での列インデックス
 
   protected:
     /**
-     * ]qsԂ܂B
+     * 余因子行を返します。
      *
-     * @return (int) sCfbNX
+     * @return (int) 行インデックス
      */
     unsigned int row_cofactor() const{return m_RowCoFactor;}
     /**
-     * ]qԂ܂B
+     * 余因子列を返します。
      *
-     * @return (int) CfbNX
+     * @return (int) 列インデックス
      */
     unsigned int column_cofactor() const{return m_ColumnCoFactor;}
 
   public:
     /**
-     * V[Rs[܂B
+     * シャローコピーをします。
      *
-     * @return (Array2D *)g
+     * @return (Array2D *)自分自身
      */
     Array2D<T> *shallow_copy() const{return new Array2D_CoFactor(*this);}
 
     /**
-     * Array2D_Partial(2z)NX̃RXgN^B
+     * Array2D_Partial(部分2次元配列)クラスのコンストラクタ。
      *
-     * @param array ̔z
-     * @param rowCoFactor ]qƂȂ錳2zł̍sCfbNX
-     * @param columnCoFactor CfbNX
-     * @throw StorageException 炩̗Oꍇ
+     * @param array 元の配列
+     * @param rowCoFactor 余因子となる元の2次元配列上での行インデックス
+     * @param columnCoFactor 同じく列インデックス
+     * @throw StorageException 何らかの例外が発生した場合
      */
     Array2D_CoFactor(const Array2D<T> &array,
                     const unsigned int &rowCoFactor,
@@ -711,9 +1040,9 @@ class Array2D_CoFactor : public Array2D_Delegate<T>{
                          m_RowCoFactor(rowCoFactor), m_ColumnCoFactor(columnCoFactor){}
 
     /**
-     * Rs[RXgN^B
+     * コピーコンストラクタ。
      *
-     * @param array Rs[
+     * @param array コピー元
      * @throw StorageException
      */
     Array2D_CoFactor(const Array2D_CoFactor &array) throw(StorageException)
@@ -721,12 +1050,12 @@ class Array2D_CoFactor : public Array2D_Delegate<T>{
         m_RowCoFactor(array.row_cofactor()), m_ColumnCoFactor(array.column_cofactor()){}
 
     /**
-     * w肵s񐬕Ԃ܂B
+     * 指定した行列成分を返します。
      *
-     * @param row sCfbNX(Jnԍ0`)
-     * @param column CfbNX(Jnԍ0`)
-     * @return (T) 
-     * @throw StorageException CfbNXsȏꍇȂ
+     * @param row 行インデックス(開始番号は0～)
+     * @param column 列インデックス(開始番号は0～)
+     * @return (T) 成分
+     * @throw StorageException インデックスが不正な場合など
      */
     T &operator()(
         const unsigned int &row,
@@ -737,50 +1066,50 @@ class Array2D_CoFactor : public Array2D_Delegate<T>{
 };
 
 /**
- * @brief ]u2z
+ * @brief 転置2次元配列
  *
- * ]u2z킷NX
- * vf߂ۂɌ̍s̍sƗւėvf𒊏o邱Ƃɂ
- * ]u\ɎĂ܂B
+ * 転置2次元配列をあらわすクラス
+ * 要素を求める際に元の行列の行と列を入れ替えて要素を抽出することによって
+ * 転置表現を高速に実現しています。
  *
- * @param T Zx
+ * @param T 演算精度
  */
 template<class T>
 class Array2D_Transpose : public Array2D_Delegate<T>{
 
   public:
     /**
-     * V[Rs[܂B
+     * シャローコピーをします。
      *
-     * @return (Array2D *)g
+     * @return (Array2D *)自分自身
      */
     Array2D<T> *shallow_copy() const{return new Array2D_Transpose(*this);}
 
     /**
-     * Array2D_Transpose(]u2z)NX̃RXgN^B
+     * Array2D_Transpose(転置2次元配列)クラスのコンストラクタ。
      *
-     * @param array ̔z
+     * @param array 元の配列
      * @throw StorageException
      */
     Array2D_Transpose(const Array2D<T> &array) throw(StorageException)
                        : Array2D_Delegate<T>(array.columns(), array.rows(), array){}
 
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
      *
-     * @param array Rs[
+     * @param array コピー元
      * @throw StorageException
      */
     Array2D_Transpose(const Array2D_Transpose &array) throw(StorageException)
       : Array2D_Delegate<T>(array){}
 
     /**
-     * w肵s񐬕Ԃ܂B
+     * 指定した行列成分を返します。
      *
-     * @param row sCfbNX(Jnԍ0`)
-     * @param column CfbNX(Jnԍ0`)
-     * @return (T) 
-     * @throw StorageException CfbNXsȏꍇȂ
+     * @param row 行インデックス(開始番号は0～)
+     * @param column 列インデックス(開始番号は0～)
+     * @return (T) 成分
+     * @throw StorageException インデックスが不正な場合など
      */
     T &operator()(
         const unsigned int &row,
@@ -789,9 +1118,9 @@ class Array2D_Transpose : public Array2D_Delegate<T>{
     }
     
     /**
-     * 2zɗƂ݂܂B
-     * ۂ͋KNX̊֐ Array2D_Delegate<T>::dense() ĂяoĂ邾ŁA
-     * ꉻ̂߂̃Gg|CgłB
+     * 密2次元配列に落とし込みます。
+     * 実際は規定クラスの関数 Array2D_Delegate<T>::dense() を呼び出しているだけで、
+     * 特殊化のためのエントリポイントです。
      *
      * @return (Array2D_Dense<T> *)
      */
@@ -801,50 +1130,50 @@ class Array2D_Transpose : public Array2D_Delegate<T>{
 };
 
 /**
- * @brief 2z
+ * @brief 部分2次元配列
  *
- * 2z킷NXB
+ * 部分2次元配列をあらわすクラス。
  *
- * @param T ZxAdoubleȂ
+ * @param T 演算精度、doubleなど
  */
 template<class T>
 class Array2D_Partial : public Array2D_Delegate<T>{
 
   private:
-    unsigned int m_RowOffset;     ///< s񂪊Jn錳̍sł̍sCfbNX
-    unsigned int m_ColumnOffset;  ///< s񂪊Jn錳̍sł̗CfbNX
+    unsigned int m_RowOffset;     ///< 部分行列が開始する元の行列での行インデックス
+    unsigned int m_ColumnOffset;  ///< 部分行列が開始する元の行列での列インデックス
 
   protected:
     /**
-     * ItZbgsԂ܂B
+     * オフセット行を返します。
      *
-     * @return (int) s
+     * @return (int) 行数
      */
     unsigned int row_offset() const{return m_RowOffset;}
     /**
-     * ItZbgԂ܂B
+     * オフセット列を返します。
      *
-     * @return (int) 
+     * @return (int) 列数
      */
     unsigned int column_offset() const{return m_ColumnOffset;}
 
   public:
     /**
-     * V[Rs[܂B
+     * シャローコピーをします。
      *
-     * @return (Array2D *)g
+     * @return (Array2D *)自分自身
      */
     Array2D<T> *shallow_copy() const{return new Array2D_Partial(*this);}
 
     /**
-     * Array2D_Partial(2z)NX̃RXgN^B
+     * Array2D_Partial(部分2次元配列)クラスのコンストラクタ。
      *
-     * @param rows s
-     * @param columns 
-     * @param array ̔z
-     * @param rowOffset 2z(0,0)ƂȂ錳2z̃s{bg̍sCfbNX
-     * @param columnOffset CfbNX
-     * @throw StorageException 炩̗Oꍇ
+     * @param rows 行数
+     * @param columns 列数
+     * @param array 元の配列
+     * @param rowOffset 部分2次元配列で(0,0)となる元の2次元配列のピボットの行インデックス
+     * @param columnOffset 同じく列インデックス
+     * @throw StorageException 何らかの例外が発生した場合
      */
     Array2D_Partial(const unsigned int &rows,
                     const unsigned int &columns,
@@ -855,9 +1184,9 @@ class Array2D_Partial : public Array2D_Delegate<T>{
                          m_RowOffset(rowOffset), m_ColumnOffset(columnOffset){}
 
     /**
-     * Rs[RXgN^B
+     * コピーコンストラクタ。
      *
-     * @param array Rs[
+     * @param array コピー元
      * @throw StorageException
      */
     Array2D_Partial(const Array2D_Partial &array) throw(StorageException)
@@ -865,12 +1194,12 @@ class Array2D_Partial : public Array2D_Delegate<T>{
         m_RowOffset(array.row_offset()), m_ColumnOffset(array.column_offset()){}
 
     /**
-     * w肵s񐬕Ԃ܂B
+     * 指定した行列成分を返します。
      *
-     * @param row sCfbNX(Jnԍ0`)
-     * @param column CfbNX(Jnԍ0`)
-     * @return (T) 
-     * @throw StorageException CfbNXsȏꍇȂ
+     * @param row 行インデックス(開始番号は0～)
+     * @param column 列インデックス(開始番号は0～)
+     * @return (T) 成分
+     * @throw StorageException インデックスが不正な場合など
      */
     T &operator()(
         const unsigned int &row,
@@ -890,18 +1219,18 @@ template <class T>
 class PartialMatrix;
 
 /**
- * @brief s
+ * @brief 行列
  *
- * s`NXB
- * lXȍs̉Z`Ă܂B
+ * 行列を定義したクラス。
+ * 様々な行列の演算を定義しています。
  *
- * ȂAIɎQƃJE^𗘗pCgEGCgȎɂȂĂ邽߁A
- * ≉Z񐔂ߖ񂳂邱Ƃ@̂܂B
- * ̂߂ɖIcopy()\bhgpȂƃfB[vRs[Ȃ̂ŁA
- * ėpsۂ͒ӂĂB
+ * なお、内部的に参照カウンタを利用したライトウエイトな実装になっているため、
+ * メモリや演算回数が節約されることが機体されます。
+ * そのために明示的にcopy()メソッドを使用しないとディープコピーがされないので、
+ * 再利用を行う際は注意してください。
  *
- * @see Array2D Iɗp2z`NXB
- * @param T Zx
+ * @see Array2D 内部的に利用する2次元配列を定義したクラス。
+ * @param T 演算精度
  */
 template <class T>
 class Matrix{
@@ -910,13 +1239,13 @@ class Matrix{
     typedef Array2D<T> storage_t;
 
   protected:
-    storage_t *m_Storage; ///< Iɗp2z̃
+    storage_t *m_Storage; ///< 内部的に利用する2次元配列のメモリ
 
     /**
-     * MatrixNX̃RXgN^B
-     * Xg[Ww肵ĐVs܂B
+     * Matrixクラスのコンストラクタ。
+     * ストレージを指定して新しく行列を作ります。
      *
-     * @param storage Xg[W
+     * @param storage ストレージ
      */
     Matrix(const storage_t *storage) : m_Storage(const_cast<storage_t *>(storage)){}
     
@@ -925,12 +1254,12 @@ class Matrix{
     }
 
     /**
-     * MatrixNX쐬wp֐B
-     * w̍sAw̗񐔂ōs𐶐܂A
-     * ɂĂ͏sȂߕsłB
+     * Matrixクラスを作成するヘルパ関数。
+     * 指定の行数、指定の列数で行列を生成しますが、
+     * 成分については初期化を行わないため不定です。
      *
-     * @param rows s
-     * @param columns 
+     * @param rows 行数
+     * @param columns 列数
      * @throw MatrixException
      */
     static self_t naked(
@@ -942,26 +1271,26 @@ class Matrix{
   public:
 
     /**
-     * Iȕۑ`Ԃ܂B
+     * 内部的な保存形式を返します。
      *
-     * @return (const storage_t *) Xg[W
+     * @return (const storage_t *) ストレージ
      */
     const storage_t *storage() const{return m_Storage;}
 
     /**
-     * MatrixNX̃RXgN^B
-     * I2zp̃mۂȂԂŏ܂B
+     * Matrixクラスのコンストラクタ。
+     * 内部的な2次元配列用のメモリを確保しない状態で初期化を完了します。
      *
      */
     Matrix() : m_Storage(NULL){}
 
     /**
-     * MatrixNX̃RXgN^B
-     * w̍sAw̗񐔂ōs𐶐܂B
-     * ܂ׂ͂T(0)ŏ܂B
+     * Matrixクラスのコンストラクタ。
+     * 指定の行数、指定の列数で行列を生成します。
+     * また成分はすべてT(0)で初期化されます。
      *
-     * @param rows s
-     * @param columns 
+     * @param rows 行数
+     * @param columns 列数
      * @throw MatrixException
      */
     Matrix(
@@ -970,13 +1299,13 @@ class Matrix{
         : m_Storage(new Array2D_Dense<T>(rows, columns)){m_Storage->clear();}
 
     /**
-     * MatrixNX̃RXgN^B
-     * w̍sAw̗񐔂ōs𐶐܂B
-     * ܂seializedŕ܂B
+     * Matrixクラスのコンストラクタ。
+     * 指定の行数、指定の列数で行列を生成します。
+     * また成分はseializedで復元されます。
      *
-     * @param rows s
-     * @param columns 
-     * @param serialized 
+     * @param rows 行数
+     * @param columns 列数
+     * @param serialized 成分
      * @throw MatrixException
      */
     Matrix(
@@ -986,48 +1315,86 @@ class Matrix{
         : m_Storage(new Array2D_Dense<T>(rows, columns, serialized)){}
 
     /**
-     * Rs[RXgN^B
-     * V[Rs[𐶐܂B
+     * コピーコンストラクタ。
+     * シャローコピーを生成します。
      *
-     * @param matrix Rs[
+     * @param matrix コピー元
+     * @see Array2D_Duplicator
      */
-    Matrix(const self_t &matrix) : m_Storage(matrix.m_Storage->shallow_copy()){}
+    Matrix(const self_t &matrix)
+        : m_Storage(Array2D_Duplicator<T>::duplicate(matrix.m_Storage)){}
+
+#if __cplusplus >= 201103L
     /**
-     * fXgN^B
+     * ムーブコンストラクタ。
+     * 2次元配列の所有権を移すため、参照カウンタの操作は行われません。
+     * 移動元は内部的な2次元配列を持たない状態、すなわちMatrix()で生成したものと
+     * 同じ状態になり、代入と破棄のみが可能です。
+     *
+     * @param matrix 移動元
+     */
+    Matrix(self_t &&matrix) : m_Storage(matrix.m_Storage){
+      matrix.m_Storage = NULL;
+    }
+#endif
+    /**
+     * デストラクタ。
      */
     virtual ~Matrix(){delete m_Storage;}
 
   protected:
     /**
-     * ZqT|[g邽߂̊֐
-     * Iɂ̓V[Rs[sĂ܂B
+     * 代入演算子をサポートするための関数
+     * 内部的にはシャローコピーを行っています。
      *
-     * @return (self_t) g
+     * @return (self_t) 自分自身
      */
     virtual self_t &substitute(const self_t &matrix){
       if(this != &matrix){
         delete m_Storage;
-        if(matrix.m_Storage){
-          m_Storage = matrix.m_Storage->shallow_copy();
-        }
+        m_Storage = Array2D_Duplicator<T>::duplicate(matrix.m_Storage);
       }
       return *this;
     }
 
+#if __cplusplus >= 201103L
+    /**
+     * ムーブ代入をサポートするための関数
+     * 2次元配列を交換します。
+     *
+     * @return (self_t) 自分自身
+     */
+    virtual self_t &substitute(self_t &&matrix){
+      std::swap(m_Storage, matrix.m_Storage);
+      return *this;
+    }
+#endif
+
   public:
     /**
-     * ZqB
+     * 代入演算子。
      *
-     * @return (self_t) g
+     * @return (self_t) 自分自身
      */
     self_t &operator=(const self_t &matrix){
       return substitute(matrix);
     }
 
+#if __cplusplus >= 201103L
+    /**
+     * ムーブ代入演算子。
+     *
+     * @return (self_t) 自分自身
+     */
+    self_t &operator=(self_t &&matrix){
+      return substitute(std::move(matrix));
+    }
+#endif
+
     /**
-     * s𕡐(fB[vRs[)܂B
+     * 行列を複製(ディープコピー)します。
      *
-     * @return (self_t) Rs[
+     * @return (self_t) コピー
      * @throw MatrixException
      */
     self_t copy() const throw(MatrixException){
@@ -1035,25 +1402,25 @@ class Matrix{
     }
 
     /**
-     * sԂ܂B
+     * 行数を返します。
      *
-     * @return (int) s
+     * @return (int) 行数
      */
     unsigned int rows() const{return m_Storage->rows();}
     /**
-     * 񐔂Ԃ܂B
+     * 列数を返します。
      *
-     * @return (int) 
+     * @return (int) 列数
      */
     unsigned int columns() const{return m_Storage->columns();}
 
     /**
-     * w肵s񐬕Ԃ܂B
+     * 指定した行列成分を返します。
      *
-     * @param row sCfbNX(Jnԍ0`)
-     * @param column CfbNX(Jnԍ0`)
-     * @return (T) 
-     * @throw MatrixException CfbNXsȏꍇȂ
+     * @param row 行インデックス(開始番号は0～)
+     * @param column 列インデックス(開始番号は0～)
+     * @return (T) 成分
+     * @throw MatrixException インデックスが不正な場合など
      */
     T &operator()(
         const unsigned int &row,
@@ -1061,22 +1428,22 @@ class Matrix{
       return m_Storage->operator()(row, column);
     }
     /**
-     * w肵s񐬕Ԃ܂B(Matlab)
+     * 指定した行列成分を返します。(Matlab風味)
      *
-     * @param row sԍ(Jnԍ1`)
-     * @param column ԍ(Jnԍ1`)
-     * @return (T) 
-     * @throw MatrixException ԍsȏꍇȂ
+     * @param row 行番号(開始番号は1～)
+     * @param column 列番号(開始番号は1～)
+     * @return (T) 成分
+     * @throw MatrixException 番号が不正な場合など
      */
     T &index(const int &row, const int &column) throw(MatrixException){
       return (*this)(row - 1, column - 1);
     }
     
     /**
-     * s̓eAׂ܂
+     * 行列の内容が等しいか、調べます
      * 
-     * @param matrix rʂ̍s
-     * @return (bool) s񂪓ꍇtrueAȊOfalse
+     * @param matrix 比較する別の行列
+     * @return (bool) 行列が等しい場合true、以外false
      */
     bool operator==(const self_t &matrix) const {
       if(m_Storage != matrix.m_Storage){
@@ -1101,9 +1468,9 @@ class Matrix{
     }
 
     /**
-     * vf[NA܂
+     * 要素をゼロクリアします
      *
-     * @return (self_t) [NAꂽg
+     * @return (self_t) ゼロクリアされた自分自身
      */
     self_t &clear(){
       m_Storage->clear();
@@ -1111,10 +1478,10 @@ class Matrix{
     }
 
     /**
-     * w̃XJ[s𐶐܂B
+     * 指定のスカラー行列を生成します。
      *
-     * @param size w̍s()
-     * @param scalar l
+     * @param size 指定の行数(列数)
+     * @param scalar 値
      */
     static self_t getScalar(const unsigned int &size, const T &scalar){
       self_t result(size, size);
@@ -1123,34 +1490,34 @@ class Matrix{
     }
 
     /**
-     * w̒Pʍs𐶐܂B
+     * 指定の単位行列を生成します。
      *
-     * @param size w̍s()
+     * @param size 指定の行数(列数)
      */
     static self_t getI(const unsigned int &size){
       return getScalar(size, T(1));
     }
 
     /**
-     * s]u܂B
-     * ]uꂽs͂Ƃ̍sƃNĂ܂B
-     * Ƃ̍sƂ̐؂藣sɂtranspose().copy()ƂĂB
+     * 行列を転置します。
+     * 転置された行列はもとの行列とリンクしています。
+     * もとの行列との切り離しを行うにはtranspose().copy()としてください。
      *
-     * @return (TransposedMatrix<T>) ]us
+     * @return (TransposedMatrix<T>) 転置行列
      */
     TransposedMatrix<T> transpose() const{
       return TransposedMatrix<T>(*this);
     }
 
     /**
-     * w肵sԂ܂B
+     * 指定した部分行列を返します。
      *
-     * @param rowSize sTCY
-     * @param columnSize TCY
-     * @param rowOffset JnsCfbNX
-     * @param columnOffset JnCfbNX
-     * @return (PartialMatrix<T>) s
-     * @throw MatrixException CfbNXsȏꍇ
+     * @param rowSize 行サイズ
+     * @param columnSize 列サイズ
+     * @param rowOffset 開始行インデックス
+     * @param columnOffset 開始列インデックス
+     * @return (PartialMatrix<T>) 部分行列
+     * @throw MatrixException インデックスが不正な場合
      *
      */
     PartialMatrix<T> partial(
@@ -1166,22 +1533,22 @@ class Matrix{
     }
 
     /**
-     * w肵s̍sxNgԂ܂B
+     * 指定した行の行ベクトルを返します。
      *
-     * @param row sCfbNX
-     * @return (self_t) sxNg
-     * @throw MatrixException CfbNXsȏꍇ
+     * @param row 行インデックス
+     * @return (self_t) 行ベクトル
+     * @throw MatrixException インデックスが不正な場合
      */
     PartialMatrix<T> rowVector(const unsigned int &row) const throw(MatrixException){
       if(row >= rows()){throw MatrixException("Index Incorrect!!");}
       return PartialMatrix<T>(*this, 1, columns(), row, 0);
     }
     /**
-     * w肵̗xNgԂ܂B
+     * 指定した列の列ベクトルを返します。
      *
-     * @param column CfbNX
-     * @return (self_t) xNg
-     * @throw MatrixException CfbNXsȏꍇ
+     * @param column 列インデックス
+     * @return (self_t) 列ベクトル
+     * @throw MatrixException インデックスが不正な場合
      */
     PartialMatrix<T> columnVector(const unsigned int &column) const throw(MatrixException){
       if(column >= columns()){throw MatrixException("Index Incorrect!!");}
@@ -1189,12 +1556,12 @@ class Matrix{
     }
 
     /**
-     * sւ܂BjI\bhłB
+     * 行を入れ替えます。破壊的メソッドです。
      *
-     * @param row1 sCfbNX1
-     * @param row2 sCfbNX2
-     * @return (self_t) g
-     * @throw MatrixException CfbNXsȏꍇ
+     * @param row1 行インデックス1
+     * @param row2 行インデックス2
+     * @return (self_t) 自分自身
+     * @throw MatrixException インデックスが不正な場合
      */
     self_t &exchangeRows(const unsigned int &row1, const unsigned int &row2) throw(MatrixException){
       if(row1 >= rows() || row2 >= rows()){throw MatrixException("Index incorrect");}
@@ -1208,12 +1575,12 @@ class Matrix{
     }
 
     /**
-     * ւ܂BjI\bhłB
+     * 列を入れ替えます。破壊的メソッドです。
      *
-     * @param column1 CfbNX1
-     * @param column2 CfbNX2
-     * @return (self_t) g
-     * @throw MatrixException CfbNXsȏꍇ
+     * @param column1 列インデックス1
+     * @param column2 列インデックス2
+     * @return (self_t) 自分自身
+     * @throw MatrixException インデックスが不正な場合
      */
     self_t &exchangeColumns(const unsigned int &column1, const unsigned int &column2){
       if(column1 >= columns() || column2 >= columns()){throw MatrixException("Index incorrect");}
@@ -1227,16 +1594,16 @@ class Matrix{
     }
 
     /**
-     * s񂩂ǂׂ܂B
+     * 正方行列かどうか調べます。
      *
-     * @return (bool) słꍇtrueAȊȌꍇfalse
+     * @return (bool) 正方行列である場合true、それ以外の場合false
      */
     bool isSquare() const{return rows() == columns();}
 
     /**
-     * Ίps񂩂ǂׂ܂
+     * 対角行列かどうか調べます
      *
-     * @return (bool) ΊpsłꍇtrueAȊȌꍇfalse
+     * @return (bool) 対角行列である場合true、それ以外の場合false
      */
     bool isDiagonal() const{
       if(isSquare()){
@@ -1253,9 +1620,9 @@ class Matrix{
     }
 
     /**
-     * Ώ̍s񂩂ǂׂ܂B
+     * 対称行列かどうか調べます。
      *
-     * @return (bool) Ώ̍słꍇtrueAȊȌꍇfalse
+     * @return (bool) 対称行列である場合true、それ以外の場合false
      */
     bool isSymmetric() const{
     	if(isSquare()){
@@ -1269,20 +1636,20 @@ class Matrix{
     }
 
     /**
-     * s̑傫قȂ邩ׂ
+     * 行列の大きさが異なるか調べる
      *
-     * @param matrix rΏ
-     * @return (bool) قȂĂꍇtrue
+     * @param matrix 比較対象
+     * @return (bool) 異なっている場合true
      */
     bool isDifferentSize(const self_t &matrix) const{
       return (rows() != matrix.rows()) || (columns() != matrix.columns());
     }
 
     /**
-     * s̃g[XԂ܂B
+     * 行列のトレースを返します。
      *
-     * @param do_check s񂩂𒲂ׂAftHgtrue
-     * @return (T) g[X
+     * @param do_check 正方行列かを調べる、デフォルトtrue
+     * @return (T) トレース
      */
     T trace(bool do_check = true) const throw(MatrixException) {
       if(do_check && !isSquare()){throw MatrixException("Operation void!!");}
@@ -1301,10 +1668,10 @@ class Matrix{
     };
 
     /**
-     * s̐SĂw{܂BjI\bhłB
+     * 行列の成分全てを指定倍します。破壊的メソッドです。
      *
-     * @param scalar {
-     * @return (self_t) g
+     * @param scalar 倍数
+     * @return (self_t) 自分自身
      */
     self_t &operator*=(const T &scalar){
 #ifdef USE_ARRAY2D_ITERATOR
@@ -1320,40 +1687,40 @@ class Matrix{
       return *this;
     }
     /**
-     * s̐SĂw{܂B
+     * 行列の成分全てを指定倍します。
      *
-     * @param scalar {
-     * @return (self_t) 
+     * @param scalar 倍数
+     * @return (self_t) 結果
      */
     self_t operator*(const T &scalar) const{return (copy() *= scalar);}
     /**
-     * s̐SĂw{܂B
+     * 行列の成分全てを指定倍します。
      *
-     * @param scalar {
-     * @param matrix s
-     * @return (self_t) 
+     * @param scalar 倍数
+     * @param matrix 行列
+     * @return (self_t) 結果
      */
     friend self_t operator*(const T &scalar, const self_t &matrix){return matrix * scalar;}
     /**
-     * s̐SĂZ܂BjI\bhłB
+     * 行列の成分全てを除算します。破壊的メソッドです。
      *
-     * @param scalar {
-     * @return (self_t) g
+     * @param scalar 倍数
+     * @return (self_t) 自分自身
      */
     self_t &operator/=(const T &scalar){return (*this) *= (1 / scalar);}
     /**
-     * s̐SĂZ܂B
+     * 行列の成分全てを除算します。
      *
-     * @param scalar {
-     * @return (self_t) 
+     * @param scalar 倍数
+     * @return (self_t) 結果
      */
     self_t operator/(const T &scalar) const{return (copy() /= scalar);}
     /**
-     * s̐SĂZ܂B
+     * 行列の成分全てを除算します。
      *
-     * @param scalar {
-     * @param matrix s
-     * @return (self_t) 
+     * @param scalar 倍数
+     * @param matrix 行列
+     * @return (self_t) 結果
      */
     friend self_t operator/(const T &scalar, const self_t &matrix){return matrix / scalar;}
     
@@ -1368,10 +1735,10 @@ class Matrix{
     };
     
     /**
-     * s𐬕ƂɉZ܂BjI\bhłB
+     * 行列を成分ごとに加算します。破壊的メソッドです。
      *
-     * @param matrix s
-     * @return (self_t) g
+     * @param matrix 加える行列
+     * @return (self_t) 自分自身
      */
     self_t &operator+=(const self_t &matrix){
       if(isDifferentSize(matrix)){throw MatrixException("Operation void!!");}
@@ -1389,10 +1756,10 @@ class Matrix{
     }
 
     /**
-     * s𐬕ƂɉZ܂B
+     * 行列を成分ごとに加算します。
      *
-     * @param matrix s
-     * @return (self_t) 
+     * @param matrix 加える行列
+     * @return (self_t) 結果
      */
     self_t operator+(const self_t &matrix) const{return (copy() += matrix);}
     
@@ -1407,10 +1774,10 @@ class Matrix{
     };
     
     /**
-     * s𐬕ƂɌZ܂B
+     * 行列を成分ごとに減算します。
      *
-     * @param matrix s
-     * @return (self_t) g
+     * @param matrix 引く行列
+     * @return (self_t) 自分自身
      */
     self_t &operator-=(const self_t &matrix){
     	if(isDifferentSize(matrix)){throw MatrixException("Operation void!!");}
@@ -1428,19 +1795,19 @@ class Matrix{
     }
 
     /**
-     * s𐬕ƂɌZ܂B
+     * 行列を成分ごとに減算します。
      *
-     * @param matrix s
-     * @return (self_t) 
+     * @param matrix 引く行列
+     * @return (self_t) 結果
      */
     self_t operator-(const self_t &matrix) const{return (copy() -= matrix);}
 
     /**
-     * sZ܂B
+     * 行列を乗算します。
      *
-     * @param matrix s
-     * @return (self_t) 
-     * @throw MatrixException s̐ώZȂꍇ(Iyhs̗񐔂s̍sƓȂ)
+     * @param matrix かける行列
+     * @return (self_t) 結果
+     * @throw MatrixException 行列の積算が成立しない場合(オペランド行列の列数が引数行列の行数と等しくない)
      */
     self_t operator*(const self_t &matrix) const throw(MatrixException){
       if(columns() != matrix.rows()){
@@ -1463,22 +1830,22 @@ class Matrix{
     }
     
     /**
-     * sZ܂B(]uso[W)
+     * 行列を乗算します。(転置行列バージョン)
      *
-     * @param matrix s
-     * @return (self_t) 
-     * @throw MatrixException s̐ώZȂꍇ(Iyhs̗񐔂s̍sƓȂ)
+     * @param matrix かける行列
+     * @return (self_t) 結果
+     * @throw MatrixException 行列の積算が成立しない場合(オペランド行列の列数が引数行列の行数と等しくない)
      */
     self_t operator*(const TransposedMatrix<T> &matrix) const throw(MatrixException){
       return operator*((const self_t &)matrix);
     }
     
     /**
-     * sZ܂BjI\bhłB
+     * 行列を乗算します。破壊的メソッドです。
      *
-     * @param matrix s
-     * @return (self_t) g
-     * @throw MatrixException s̐ώZȂꍇ(Iyhs̗񐔂s̍sƓȂ)
+     * @param matrix かける行列
+     * @return (self_t) 自分自身
+     * @throw MatrixException 行列の積算が成立しない場合(オペランド行列の列数が引数行列の行数と等しくない)
      */
     template <class RhsMatrix>
     self_t &operator*=(const RhsMatrix &matrix) throw(MatrixException){
@@ -1486,19 +1853,19 @@ class Matrix{
     }
 
     /**
-     * PZq-B
-     * ʂ matrix * -1ƓłB
+     * 単項演算子-。
+     * 効果は matrix * -1と同じです。
      *
      * @return (self_t) -matrix
      */
     self_t operator-() const{return (copy() *= -1);}
 
     /**
-     * s(]qs)߂܂B
+     * 補行列(余因子行列)を求めます。
      *
-     * @param row sCfbNX
-     * @param column CfbNX
-     * @return (CoMatrix) s
+     * @param row 行インデックス
+     * @param column 列インデックス
+     * @return (CoMatrix) 補行列
      */
     CoMatrix<T> coMatrix(
         const unsigned int &row,
@@ -1510,11 +1877,11 @@ class Matrix{
     }
 
     /**
-     * s񎮂vZ܂B
+     * 行列式を計算します。
      *
-     * @param do_check s`FbNs(ftHgtrue)
-     * @return (T) 
-     * @throw MatrixException sł͂Ȃs񎮂vZ邱ƂłȂꍇ
+     * @param do_check 正方行列チェックを行うか(デフォルトtrue)
+     * @return (T) 結果
+     * @throw MatrixException 正方行列ではなく行列式を計算することができない場合
      */
     T determinant(bool do_check = true) const throw(MatrixException){
       if(do_check && !isSquare()){throw MatrixException("Operation void!!");}
@@ -1535,11 +1902,11 @@ class Matrix{
     }
 
     /**
-     * LUsł邱ƗpĐ^(Ax = y)x܂B
+     * LU行列であること利用して線型方程式(Ax = y)のxを解きます。
      *
-     * @param y E
-     * @param do_check LUςݍs̒`𖞂Ă邩AmF
-     * @return (Matrix<T2>) x()
+     * @param y 右辺
+     * @param do_check LU分解済み行列の定義を満たしているか、確認する
+     * @return (Matrix<T2>) x(解)
      */
     template <class T2>
     Matrix<T2> solve_linear_eq_with_LU(
@@ -1568,7 +1935,7 @@ class Matrix{
       }
 
 
-      // L(Ux) = y  y' = (Ux)܂
+      // L(Ux) = y で y' = (Ux)をまず解く
       Matrix<T2> y_copy(y.copy());
       Matrix<T2> y_prime(Matrix<T2>::naked(y.rows(), 1));
       for(unsigned i(0); i < rows(); i++){
@@ -1578,7 +1945,7 @@ class Matrix{
         }
       }
 
-      // Ux = y' x
+      // 続いてUx = y'で xを解く
       Matrix<T2> x(Matrix<T2>::naked(y.rows(), 1));
       for(unsigned i(rows()); i > 0;){
         i--;
@@ -1593,13 +1960,13 @@ class Matrix{
     }
 
     /**
-     * LU܂B
-     * (0, 0)`(n-1, n-1):  Ls
-     * (0, n)`(n-1, 2n-1): Us
+     * LU分解をします。
+     * (0, 0)～(n-1, n-1):  L行列
+     * (0, n)～(n-1, 2n-1): U行列
      *
-     * @param do_check Ώ̍s`FbNs(ftHgtrue)
-     * @return (self_t) LU
-     * @throw MatrixException sł͂ȂLUvZ邱ƂłȂꍇ
+     * @param do_check 対称行列チェックを行うか(デフォルトtrue)
+     * @return (self_t) LU分解
+     * @throw MatrixException 正方行列ではなくLU分解を計算することができない場合
      */
    	self_t decomposeLU(bool do_check = true) const throw(MatrixException){
    		if(do_check && !isSquare()){throw MatrixException("Operation void!!");}
@@ -1630,13 +1997,13 @@ class Matrix{
    	}
 
     /**
-     * UD܂B
-     * (0, 0)`(n-1,n-1):  Us
-     * (0, n)`(n-1,2n-1): Ds
+     * UD分解をします。
+     * (0, 0)～(n-1,n-1):  U行列
+     * (0, n)～(n-1,2n-1): D行列
      *
-     * @param do_check Ώ̍s`FbNs(ftHgtrue)
-     * @return (self_t) UD
-     * @throw MatrixException Ώ̍sł͂ȂUDvZ邱ƂłȂꍇ
+     * @param do_check 対称行列チェックを行うか(デフォルトtrue)
+     * @return (self_t) UD分解
+     * @throw MatrixException 対称行列ではなくUD分解を計算することができない場合
      */
     self_t decomposeUD(bool do_check = true) const throw(MatrixException){
       if(do_check && !isSymmetric()){throw MatrixException("Operation void");}
@@ -1660,16 +2027,82 @@ class Matrix{
     }
 
     /**
-     * ts߂܂B
+     * コレスキー分解をします。
+     * 正定値対称行列@f$ A @f$を@f$ A = L L^{T} @f$となる下三角行列@f$ L @f$に分解します。
+     * @f$ L @f$は@f$ A @f$の平方根の一種であり、sqrt()よりも高速に求まります。
      *
-     * @return (self_t) ts
-     * @throw MatrixException sł͂ȂtsvZ邱ƂłȂꍇ
+     * @param do_check 対称行列チェックを行うか(デフォルトtrue)
+     * @return (self_t) 下三角行列@f$ L @f$
+     * @throw MatrixException 対称行列ではない、または正定値ではない場合
+     */
+    self_t decomposeCholesky(bool do_check = true) const throw(MatrixException){
+      if(do_check && !isSymmetric()){throw MatrixException("Operation void");}
+      self_t L(rows(), columns());
+      for(unsigned int j(0); j < rows(); j++){
+        T sum((*const_cast<Matrix *>(this))(j, j));
+        for(unsigned int k(0); k < j; k++){
+          sum -= L(j, k) * L(j, k);
+        }
+        if(!(sum > T(0))){throw MatrixException("Not positive definite");}
+        T L_jj(L(j, j) = std::sqrt(sum));
+        for(unsigned int i(j + 1); i < rows(); i++){
+          T sum2((*const_cast<Matrix *>(this))(i, j));
+          for(unsigned int k(0); k < j; k++){
+            sum2 -= L(i, k) * L(j, k);
+          }
+          L(i, j) = sum2 / L_jj;
+        }
+      }
+      return L;
+    }
+
+    /**
+     * コレスキー分解の結果であること利用して線型方程式(L L^{T} X = Y)のXを解きます。
+     * 逆行列を求めずに@f$ A^{-1} Y @f$を計算する用途に使用します。
+     * 例えば A.decomposeCholesky().solve_linear_eq_with_Cholesky(Y) とします。
+     *
+     * @param y 右辺、複数列でもよい
+     * @return (Matrix<T2>) X(解)
+     * @throw MatrixException 大きさが合わない場合
+     * @see decomposeCholesky()
+     */
+    template <class T2>
+    Matrix<T2> solve_linear_eq_with_Cholesky(const Matrix<T2> &y)
+        const throw(MatrixException) {
+      if((!isSquare()) || (y.rows() != rows())){
+        throw MatrixException("Operation void!!");
+      }
+      self_t &L(*const_cast<self_t *>(this));
+      Matrix<T2> x(y.copy());
+      for(unsigned k(0); k < x.columns(); k++){
+        // L y' = y で y'をまず解く
+        for(unsigned i(0); i < rows(); i++){
+          T2 sum(x(i, k));
+          for(unsigned j(0); j < i; j++){sum -= L(i, j) * x(j, k);}
+          x(i, k) = sum / L(i, i);
+        }
+        // 続いてL^{T} x = y'で xを解く
+        for(unsigned i(rows()); i > 0;){
+          i--;
+          T2 sum(x(i, k));
+          for(unsigned j(i + 1); j < rows(); j++){sum -= L(j, i) * x(j, k);}
+          x(i, k) = sum / L(i, i);
+        }
+      }
+      return x;
+    }
+
+    /**
+     * 逆行列を求めます。
+     *
+     * @return (self_t) 逆行列
+     * @throw MatrixException 正方行列ではなく逆行列を計算することができない場合
      */
     self_t inverse() const throw(MatrixException){
 
       if(!isSquare()){throw MatrixException("Operation void!!");}
 
-      //N[(x)
+      //クラメール(遅い)
       /*
       self_t result(rows(), columns());
       T det;
@@ -1682,12 +2115,12 @@ class Matrix{
       return result.transpose() / det;
       */
 
-      //KEX@
+      //ガウス消去法
 
       self_t left(copy());
       self_t right(self_t::getI(rows()));
       for(unsigned int i = 0; i < rows(); i++){
-        if(left(i, i) == T(0)){ //(i, i)݂悤ɕבւ
+        if(left(i, i) == T(0)){ //(i, i)が存在するように並べ替え
           for(unsigned int j = i+1; j <= rows(); j++){
             if(j == rows()){throw MatrixException("Operation void!! ; Invert matrix not exist");}
             if(left(j, i) != T(0)){
@@ -1716,34 +2149,34 @@ class Matrix{
 
       return right;
 
-      //LU
+      //LU分解
       /*
       */
     }
     /**
-     * ts܂BjI\bhłB
+     * 逆行列をかけます。破壊的メソッドです。
      *
-     * @param matrix s
-     * @return (self_t) g
-     * @throw MatrixException tsvZ邱ƂłȂꍇ
+     * @param matrix 行列
+     * @return (self_t) 自分自身
+     * @throw MatrixException 逆行列を計算することができない場合
      */
     self_t &operator/=(const self_t &matrix) throw(MatrixException){return (*this) *= matrix.inverse();}
     /**
-     * ts܂B
+     * 逆行列をかけます。
      *
-     * @param matrix s
-     * @return (self_t) 
-     * @throw MatrixException tsvZ邱ƂłȂꍇ
+     * @param matrix 行列
+     * @return (self_t) 結果
+     * @throw MatrixException 逆行列を計算することができない場合
      */
     self_t operator/(const self_t &matrix) const throw(MatrixException){return (copy() /= matrix);}
 
     /**
-     * s{bgw肵āAZ܂B
-     * jIłB
+     * ピボットを指定して、加算します。
+     * 破壊的です。
      *
-     * @param row sCfbNX
-     * @param column CfbNX
-     * @param matrix s
+     * @param row 行インデックス
+     * @param column 列インデックス
+     * @param matrix 足す行列
      */
     self_t &pivotMerge(const int &row, const int &column, const self_t &matrix){
       for(unsigned int i = 0; i < matrix.rows(); i++){
@@ -1759,22 +2192,22 @@ class Matrix{
     }
 
     /**
-     * s{bgw肵āAZ܂B
+     * ピボットを指定して、加算します。
      *
-     * @param row sCfbNX
-     * @param column CfbNX
-     * @param matrix s
+     * @param row 行インデックス
+     * @param column 列インデックス
+     * @param matrix 足す行列
      */
     self_t pivotAdd(const int &row, const int &column, const self_t &matrix) const{
       return copy().pivotMerge(row, column, matrix);
     }
 
     /**
-     * nEXz_[ϊăwbZxNs𓾂܂B
+     * ハウスホルダー変換をしてヘッセンベルク行列を得ます。
      *
-     * @param transform ϊɗps̐ςi[|C^
-     * @return (self_t) wbZxNs
-     * @throw MatrixException sł͂ȂvZ邱ƂłȂꍇ
+     * @param transform 変換に用いた行列の積を格納するポインタ
+     * @return (self_t) ヘッセンベルク行列
+     * @throw MatrixException 正方行列ではなく計算することができない場合
      */
     self_t hessenberg(Matrix *transform) const throw(MatrixException){
     	if(!isSquare()){throw MatrixException("Operation void!!");}
@@ -1806,7 +2239,7 @@ class Matrix{
         if(transform){(*transform) *= P;}
     	}
 
-    	//[
+    	//ゼロ処理
     	bool sym = isSymmetric();
     	for(unsigned int j = 0; j < columns() - 2; j++){
     		for(unsigned int i = j + 2; i < rows(); i++){
@@ -1819,19 +2252,19 @@ class Matrix{
     }
 
     /**
-     * nEXz_[ϊăwbZxNs𓾂܂B
+     * ハウスホルダー変換をしてヘッセンベルク行列を得ます。
      *
-     * @return (self_t) wbZxNs
+     * @return (self_t) ヘッセンベルク行列
      */
     self_t hessenberg() const throw(MatrixException){return hessenberg(NULL);}
 
     /**
-     * 2šŗLl߂܂B
+     * 2次小行列の固有値を求めます。
      *
-     * @param row 2s̍㍀̍sCfbNX
-     * @param column 2s̍㍀̗CfbNX
-     * @param upper (ŗLl1)
-     * @param lower (ŗLl2)
+     * @param row 2次小行列の左上項の行インデックス
+     * @param column 2次小行列の左上項の列インデックス
+     * @param upper 結果(固有値1)
+     * @param lower 結果(固有値2)
      */
     void eigen22(const int &row, const int &column, Complex<T> &upper, Complex<T> &lower) const throw(MatrixException){
       T a((*const_cast<Matrix *>(this))(row, column)),
@@ -1851,16 +2284,16 @@ class Matrix{
     }
 
     /**
-     * ŗLlAŗLxNg߂܂B
-     * ԋplMatrix<Complex<T> >^ŁA
-     * (0,0)`(n-1,n-1)vfŗLxNg̍s
-     * (0,n)`(n-1,n)vfΉŗLl̗xNg
-     * ɂȂĂ܂B
-     * (ŗLxNg1,ŗLxNg2,c,ŗLxNgn,ŗLl)n~(n+1)s
+     * 固有値、固有ベクトルを求めます。
+     * 返却値はMatrix<Complex<T> >型で、
+     * (0,0)～(n-1,n-1)要素が固有ベクトルの行列
+     * (0,n)～(n-1,n)要素が対応する固有値の列ベクトル
+     * になっています。
+     * (固有ベクトル1,固有ベクトル2,…,固有ベクトルn,固有値)のn×(n+1)行列
      *
-     * @param threshold_abs ɗpΌ덷
-     * @param threshold_rel ɗp鑊Ό덷
-     * @return (Matrix<Complex<T> >) ŗLlAŗLxNg
+     * @param threshold_abs 収束判定に用いる絶対誤差
+     * @param threshold_rel 収束判定に用いる相対誤差
+     * @return (Matrix<Complex<T> >) 固有値、固有ベクトル
      */
     Matrix<Complex<T> > eigen(
         const T &threshold_abs,
@@ -1868,7 +2301,7 @@ class Matrix{
 
     	if(!isSquare()){throw MatrixException("Operation void!!");}
 
-      //p[@(ׂ@)
+      //パワー法(べき乗法)
       /*self_t result(rows(), rows() + 1);
       self_t source = copy();
       for(int i = 0; i < columns(); i++){result(0, i) = T(1);}
@@ -1890,18 +2323,18 @@ class Matrix{
       }
       return result;*/
 
-      //_uQR@
-      /* <菇>
-       * nEXz_[@KpāAwbZxNsɒuA
-       * _uQR@KpB
-       * ʁAŗLl̂ŁAŗLxNgvZB
+      //ダブルQR法
+      /* <手順>
+       * ハウスホルダー法を適用して、上ヘッセンベルク行列に置換後、
+       * ダブルQR法を適用。
+       * 結果、固有値が得られるので、固有ベクトルを計算。
        */
 
-      //ʂ̊i[p̍s
+      //結果の格納用の行列
       Matrix<Complex<T> > result(rows(), rows() + 1);
 
-      //ŗLľvZ
-      Matrix<Complex<T> > lambda(result.partial(rows(), 1, 0, rows()));   //ŗLl
+      //固有値の計算
+      Matrix<Complex<T> > lambda(result.partial(rows(), 1, 0, rows()));   //固有値
 
       T mu_sum(0), mu_multi(0);
       Complex<T> p1, p2;
@@ -1923,7 +2356,7 @@ class Matrix{
           break;
         }
 
-        //ʁA*̍XV(4.143)
+        //μ、μ*の更新(4.143)
         {
           Complex<T> p1_new, p2_new;
           A.eigen22(m-2, m-2, p1_new, p2_new);
@@ -1949,7 +2382,7 @@ class Matrix{
           p1 = p1_new, p2 = p2_new;
         }
 
-        //nEXz_[ϊJԂ
+        //ハウスホルダー変換を繰り返す
         T b1, b2, b3, r;
         for(int i = 0; i < m - 1; i++){
         	if(i == 0){
@@ -1985,26 +2418,26 @@ class Matrix{
           throw MatrixException("Cannot calc eigen values!!");
         }
 
-        //
+        //収束判定
 
-        T A_m2_abs(_abs(A(m-2, m-2))), A_m1_abs(_abs(A(m-1, m-1)));
+        T A_m2_abs(std::abs(A(m-2, m-2))), A_m1_abs(std::abs(A(m-1, m-1)));
         T epsilon(threshold_abs
           + threshold_rel * ((A_m2_abs < A_m1_abs) ? A_m2_abs : A_m1_abs));
 
         //std::cout << "epsil(" << m << ") " << epsilon << std::endl;
 
-        if(_abs(A(m-1, m-2)) < epsilon){
+        if(std::abs(A(m-1, m-2)) < epsilon){
           --m;
           lambda(m, 0) = A(m, m);
-        }else if(_abs(A(m-2, m-3)) < epsilon){
+        }else if(std::abs(A(m-2, m-3)) < epsilon){
           A.eigen22(m-2, m-2, lambda(m-1, 0), lambda(m-2, 0));
           m -= 2;
         }
       }
 
 #ifdef MATRIX_EIGENVEC_SIMPLE
-      //ŗLxNǧvZ
-      Matrix<Complex<T> > x(rows(), rows());  //ŗLxNg
+      //固有ベクトルの計算
+      Matrix<Complex<T> > x(rows(), rows());  //固有ベクトル
       A = A_;
 
       for(unsigned int j = 0; j < rows(); j++){
@@ -2024,8 +2457,8 @@ class Matrix{
         //std::cout << x.partial(rows(), 1, 0, j).transpose() << std::endl;
       }
 #else
-      //ŗLxNǧvZ(t@)
-      Matrix<Complex<T> > x(Matrix<Complex<T> >::getI(rows()));  //ŗLxNg
+      //固有ベクトルの計算(逆反復法)
+      Matrix<Complex<T> > x(Matrix<Complex<T> >::getI(rows()));  //固有ベクトル
       A = A_;
       Matrix<Complex<T> > A_C(rows(), rows());
       for(unsigned int i = 0; i < rows(); i++){
@@ -2035,10 +2468,10 @@ class Matrix{
       }
 
       for(unsigned int j = 0; j < rows(); j++){
-        // http://www.prefield.com/algorithm/math/eigensystem.html Ql
-        // AŗLlꍇ̑Ώ@ƂāA
+        // http://www.prefield.com/algorithm/math/eigensystem.html を参考に
+        // かつ、固有値が等しい場合の対処方法として、
         // http://www.nrbook.com/a/bookcpdf/c11-7.pdf
-        // QlɁAlUĂ݂邱Ƃɂ
+        // を参考に、値を振ってみることにした
         Matrix<Complex<T> > A_C_lambda(A_C.copy());
         Complex<T> approx_lambda(lambda(j, 0));
         if((A_C_lambda(j, j) - approx_lambda).abs() <= 1E-3){
@@ -2078,7 +2511,7 @@ class Matrix{
       //std::cout << "x * x^-1" << x * x.inverse() << std::endl;
       std::cout << "x * lambda * x^-1:" << x * lambda2 * x.inverse() << std::endl;*/
 
-      //ʂ̊i[
+      //結果の格納
       for(unsigned int j = 0; j < x.columns(); j++){
         for(unsigned int i = 0; i < x.rows(); i++){
           for(unsigned int k = 0; k < transform.columns(); k++){
@@ -2086,7 +2519,7 @@ class Matrix{
           }
         }
 
-        //K
+        //正規化
         Complex<T> _norm;
         for(unsigned int i = 0; i < rows(); i++){
         	_norm += result(i, j).abs2();
@@ -2102,34 +2535,34 @@ class Matrix{
     }
 
     /**
-     * ŗLlAŗLxNg߂܂B
-     * ԋplMatrix^ŁA
-     * (0,0)`(n-1,n-1)vfŗLxNg̍s
-     * (0,n)`(n-1,n)vfΉŗLl̗xNg
-     * ɂȂĂ܂B
-     * (ŗLxNg1,ŗLxNg2,c,ŗLxNgn,ŗLl)n~(n+1)s
+     * 固有値、固有ベクトルを求めます。
+     * 返却値はMatrix型で、
+     * (0,0)～(n-1,n-1)要素が固有ベクトルの行列
+     * (0,n)～(n-1,n)要素が対応する固有値の列ベクトル
+     * になっています。
+     * (固有ベクトル1,固有ベクトル2,…,固有ベクトルn,固有値)のn×(n+1)行列
      *
-     * @return (Matrix<Complex<T> >) ŗLlAŗLxNg
+     * @return (Matrix<Complex<T> >) 固有値、固有ベクトル
      */
     Matrix<Complex<T> > eigen() const throw(MatrixException){return eigen(1E-10, 1E-7);}
 
   protected:
     /**
-     * s̕߂܂B
-     * ԋplMatrix^łB
+     * 行列の平方根を求めます。
+     * 返却値はMatrix型です。
      *
-     * sA
+     * 行列Aが
      * @f[
      *    A = V D V^{-1}
      * @f]
-     * ƌŗLl(D)ƌŗLxNg(V)ɕł
+     * と固有値(D)と固有ベクトル(V)に分解できれば
      * @f[
      *    A^{1/2} = V D^{1/2} V^{-1}
      * @f]
-     * łB
+     * である。
      *
-     * @param eigen_mat ŗLlAŗLxNg(n,n+1)̍s
-     * @return (Matrix<Complex<T> >) 
+     * @param eigen_mat 固有値、固有ベクトルが入った(n,n+1)の行列
+     * @return (Matrix<Complex<T> >) 平方根
      */
     Matrix<Complex<T> > sqrt(const Matrix<Complex<T> > &eigen_mat) const throw(MatrixException) {
       int n(eigen_mat.rows());
@@ -2144,12 +2577,12 @@ class Matrix{
 
   public:
     /**
-     * s̕߂܂B
-     * ԋplMatrix^łB
+     * 行列の平方根を求めます。
+     * 返却値はMatrix型です。
      *
-     * @param threshold_abs ŗLlAŗLxNg߂ۂɎɗpΌ덷
-     * @param threshold_abs ŗLlAŗLxNg߂ۂɎɗp鑊Ό덷
-     * @return (Matrix<Complex<T> >) 
+     * @param threshold_abs 固有値、固有ベクトル求める際に収束判定に用いる絶対誤差
+     * @param threshold_abs 固有値、固有ベクトル求める際に収束判定に用いる相対誤差
+     * @return (Matrix<Complex<T> >) 平方根
      */
     Matrix<Complex<T> > sqrt(
         const T &threshold_abs,
@@ -2158,17 +2591,136 @@ class Matrix{
     }
 
     /**
-     * s̕߂܂B
-     * ԋplMatrix^łB
+     * 行列の平方根を求めます。
+     * 返却値はMatrix型です。
      *
-     * @return (Matrix<Complex<T> >) 
+     * @return (Matrix<Complex<T> >) 平方根
      */
     Matrix<Complex<T> > sqrt() const throw(MatrixException){
       return sqrt(eigen());
     }
 
     /**
-     * s₷`ŏo͂܂B
+     * 対称行列の固有値、固有ベクトルをJacobi法で求めます。
+     * eigen()と異なりHessenberg変換やQR法を用いないため高速で、
+     * また結果は常に実数となります。
+     * 固有値は降順に並べられます。
+     *
+     * @param do_check 対称行列チェックを行うか(デフォルトtrue)
+     * @return (self_t) 固有ベクトル(0～n-1列、正規化済)、固有値(n列)からなる(n,n+1)の行列
+     * @throw MatrixException 対称行列ではない、または収束しなかった場合
+     */
+    self_t eigen_symmetric(bool do_check = true) const throw(MatrixException){
+      if(do_check && !isSymmetric()){throw MatrixException("Operation void!!");}
+      const unsigned int n(rows());
+
+      self_t A_mat(naked(n, n));
+      for(unsigned int i(0); i < n; i++){
+        for(unsigned int j(0); j < n; j++){
+          A_mat(i, j) = (*const_cast<Matrix *>(this))(i, j);
+        }
+      }
+      self_t result(n, n + 1);
+      for(unsigned int i(0); i < n; i++){result(i, i) = T(1);}
+
+      // 回転を高速に適用するため、内部の1次元配列を直接操作する
+      T *a(static_cast<Array2D_Dense<T> *>(A_mat.m_Storage)->buffer());
+      T *v(static_cast<Array2D_Dense<T> *>(result.m_Storage)->buffer());
+#define A(i, j) a[(i) * n + (j)]
+#define V(i, j) v[(i) * (n + 1) + (j)]
+      for(int sweep(0); ; sweep++){
+        T off(0);
+        for(unsigned int p(0); p < n; p++){
+          for(unsigned int q(p + 1); q < n; q++){
+            off += std::abs(A(p, q));
+          }
+        }
+        if(off == T(0)){break;}
+        if(sweep >= 50){throw MatrixException("Cannot calc eigen values!!");}
+
+        for(unsigned int p(0); p < n; p++){
+          for(unsigned int q(p + 1); q < n; q++){
+            T a_pq_abs(std::abs(A(p, q)));
+            if(a_pq_abs == T(0)){continue;}
+            T g(a_pq_abs * 100);
+            if((sweep > 3)
+                && ((std::abs(A(p, p)) + g) == std::abs(A(p, p)))
+                && ((std::abs(A(q, q)) + g) == std::abs(A(q, q)))){
+              // 対角成分に対して十分小さい場合は0とみなす
+              A(p, q) = A(q, p) = T(0);
+              continue;
+            }
+            T theta((A(q, q) - A(p, p)) / (A(p, q) * 2));
+            T t(T(1) / (std::abs(theta) + std::sqrt(theta * theta + 1)));
+            if(theta < T(0)){t = -t;}
+            T c(T(1) / std::sqrt(t * t + 1)), s(t * c);
+            for(unsigned int k(0); k < n; k++){
+              T a_kp(A(k, p)), a_kq(A(k, q));
+              A(k, p) = c * a_kp - s * a_kq;
+              A(k, q) = s * a_kp + c * a_kq;
+            }
+            for(unsigned int k(0); k < n; k++){
+              T a_pk(A(p, k)), a_qk(A(q, k));
+              A(p, k) = c * a_pk - s * a_qk;
+              A(q, k) = s * a_pk + c * a_qk;
+            }
+            A(p, q) = A(q, p) = T(0);
+            for(unsigned int k(0); k < n; k++){
+              T v_kp(V(k, p)), v_kq(V(k, q));
+              V(k, p) = c * v_kp - s * v_kq;
+              V(k, q) = s * v_kp + c * v_kq;
+            }
+          }
+        }
+      }
+
+      // 固有値を降順に並べ替え
+      for(unsigned int i(0); i < n; i++){V(i, n) = A(i, i);}
+      for(unsigned int i(0); i < n; i++){
+        unsigned int i_max(i);
+        for(unsigned int j(i + 1); j < n; j++){
+          if(V(j, n) > V(i_max, n)){i_max = j;}
+        }
+        if(i_max == i){continue;}
+        std::swap(V(i, n), V(i_max, n));
+        for(unsigned int k(0); k < n; k++){
+          std::swap(V(k, i), V(k, i_max));
+        }
+      }
+#undef A
+#undef V
+      return result;
+    }
+
+    /**
+     * 対称行列の平方根を求めます。
+     * eigen_symmetric()を利用し、@f$ V \sqrt{\Lambda} V^{T} @f$を返します。
+     * 負の固有値(丸め誤差によるもの)は0として扱います。
+     *
+     * @param do_check 対称行列チェックを行うか(デフォルトtrue)
+     * @return (self_t) 平方根(対称行列)
+     * @throw MatrixException 対称行列ではない、または収束しなかった場合
+     */
+    self_t sqrt_symmetric(bool do_check = true) const throw(MatrixException){
+      const unsigned int n(rows());
+      self_t eigen_mat(eigen_symmetric(do_check));
+      self_t res(n, n);
+      for(unsigned int k(0); k < n; k++){
+        T lambda(eigen_mat(k, n));
+        if(!(lambda > T(0))){continue;}
+        lambda = std::sqrt(lambda);
+        for(unsigned int i(0); i < n; i++){
+          T v_ik_lambda(eigen_mat(i, k) * lambda);
+          for(unsigned int j(0); j < n; j++){
+            res(i, j) += v_ik_lambda * eigen_mat(j, k);
+          }
+        }
+      }
+      return res;
+    }
+
+    /**
+     * 行列を見やすい形で出力します。
      *
      */
     friend std::ostream &operator<<(std::ostream &out, const self_t &matrix){
@@ -2188,12 +2740,12 @@ class Matrix{
 };
 
 /**
- * @brief Ϗꂽs
+ * @brief 委譲された行列
  *
- * Ϗꂽs(sA]usȂǂ̔hs)̊NX
- * ̍sNXł̓CgEGCg(AV[Rs[ɂ)ł邽߁A
- * ̂܂܂ł͔hNXɂĕQ܂B
- * Yڂ̂ÃNX̖łB
+ * 委譲された行列(部分行列、転置行列などの派生行列)の基底クラス
+ * 元の行列クラスではライトウエイト実装(代入時、シャローコピーによる解決)であるため、
+ * そのままでは派生クラスにおいて弊害が発生します。
+ * 当該項目を解消するのが、このクラスの役割です。
  */
 template <class T>
 class DelegatedMatrix : public Matrix<T>{
@@ -2212,15 +2764,21 @@ class DelegatedMatrix : public Matrix<T>{
       return *this;
     }
 
+#if __cplusplus >= 201103L
+    super_t &substitute(super_t &&matrix){
+      return substitute(static_cast<const super_t &>(matrix));
+    }
+#endif
+
     DelegatedMatrix(const typename super_t::storage_t *storage)
         : super_t(storage){}
     virtual ~DelegatedMatrix(){}
 
     /**
-     * ZqB
-     * NXStorageύX鑀ƈقȂAǂ̑s܂B
+     * 代入演算子。
+     * 基底クラスのStorageを変更する操作と異なり、成分どおしの代入を行います。
      *
-     * @param matrix s
+     * @param matrix 代入する行列
      */
     self_t &operator=(const super_t &matrix){
       return static_cast<self_t &>(self_t::substitute(matrix));
@@ -2239,12 +2797,12 @@ class DelegatedMatrix : public Matrix<T>{
 };
 
 /**
- * @brief ]qs(s)
+ * @brief 余因子行列(補行列)
  *
- * ]qs킷NX
- * ]q2z\Array2D_CoFactorƋ͂ĕsĂ܂B
+ * 余因子行列をあらわすクラス
+ * 余因子2次元配列を表現したArray2D_CoFactorと協力して部分行列を実現しています。
  *
- * @see Array2D_Partial 2z
+ * @see Array2D_Partial 部分2次元配列
  */
 template <class T>
 class CoMatrix : public DelegatedMatrix<T>{
@@ -2255,11 +2813,11 @@ class CoMatrix : public DelegatedMatrix<T>{
 
   public:
     /**
-     * PartialMatrix(s)NX̃RXgN^B
+     * PartialMatrix(部分行列)クラスのコンストラクタ。
      *
-     * @param matrix ̍s
-     * @param rowOffset ]qƂȂsCfbNX
-     * @param columnOffset CfbNX
+     * @param matrix 元の行列
+     * @param rowOffset 余因子となる行インデックス
+     * @param columnOffset 同じく列インデックス
      * @throw MatrixException
      */
     CoMatrix(
@@ -2271,7 +2829,7 @@ class CoMatrix : public DelegatedMatrix<T>{
                 rowCoFactor, columnCoFactor)){}
 
     /**
-     * fXgN^B
+     * デストラクタ。
      */
     ~CoMatrix(){}
 
@@ -2281,13 +2839,13 @@ class CoMatrix : public DelegatedMatrix<T>{
 };
 
 /**
- * @brief ]us
+ * @brief 転置行列
  *
- * ]us킷NXB
- * NXNXƂĒ`B
- * ]u2z\Array2D_TransposeƋ͂ē]usĂ܂B
+ * 転置行列をあらわすクラス。
+ * クラス内クラスとして定義。
+ * 転置2次元配列を表現したArray2D_Transposeと協力して転置行列を実現しています。
  *
- * @see Array2D_Transpose ]u2z
+ * @see Array2D_Transpose 転置2次元配列
  */
 template <class T>
 class TransposedMatrix : public DelegatedMatrix<T>{
@@ -2300,25 +2858,25 @@ class TransposedMatrix : public DelegatedMatrix<T>{
 
   public:
     /**
-     * TransposedMatrix(]us)NX̃RXgN^B
+     * TransposedMatrix(転置行列)クラスのコンストラクタ。
      *
-     * @param matrix ̍s
+     * @param matrix 元の行列
      * @throw MatrixException
      */
     TransposedMatrix(const root_t &matrix) throw(MatrixException)
         : super_t(new Array2D_Transpose<T>(*(matrix.storage()))){}
 
     /**
-     * fXgN^B
+     * デストラクタ。
      */
     ~TransposedMatrix(){}
 
     /**
-     * ]us]uČ̍sɖ߂܂B
-     * ԋps͂Ƃ̍sƃNĂ܂B
-     * Ƃ̍sƂ̐؂藣sɂtranspose().copy()ƂĂB
+     * 転置行列を転置して元の行列に戻します。
+     * 返却される行列はもとの行列とリンクしています。
+     * もとの行列との切り離しを行うにはtranspose().copy()としてください。
      *
-     * @return (Matrix<T>) ]us
+     * @return (Matrix<T>) 転置行列
      */
     inline root_t untranspose() const{
       return super_t::original();
@@ -2329,22 +2887,22 @@ class TransposedMatrix : public DelegatedMatrix<T>{
     }
     
     /**
-     * sZ܂B(]u * ]u)
+     * 行列を乗算します。(転置 * 非転置)
      *
-     * @param matrix s
-     * @return (root_t) 
-     * @throw MatrixException s̐ώZȂꍇ(Iyhs̗񐔂s̍sƓȂ)
+     * @param matrix かける行列
+     * @return (root_t) 結果
+     * @throw MatrixException 行列の積算が成立しない場合(オペランド行列の列数が引数行列の行数と等しくない)
      */
     root_t operator*(const root_t &matrix) const throw(MatrixException){
       return super_t::operator*(matrix);
     }
     
     /**
-     * sZ܂B(]u * ]u)
+     * 行列を乗算します。(転置 * 転置)
      *
-     * @param matrix s
-     * @return (root_t) 
-     * @throw MatrixException s̐ώZȂꍇ(Iyhs̗񐔂s̍sƓȂ)
+     * @param matrix かける行列
+     * @return (root_t) 結果
+     * @throw MatrixException 行列の積算が成立しない場合(オペランド行列の列数が引数行列の行数と等しくない)
      */
     root_t operator*(const self_t &matrix) const throw(MatrixException){
       return operator*((const root_t &)matrix);
@@ -2352,13 +2910,13 @@ class TransposedMatrix : public DelegatedMatrix<T>{
 };
 
 /**
- * @brief s
+ * @brief 部分行列
  *
- * s킷NX
- * NXNXƂĒ`B
- * 2z\Array2D_PartialƋ͂ĕsĂ܂B
+ * 部分行列をあらわすクラス
+ * クラス内クラスとして定義。
+ * 部分2次元配列を表現したArray2D_Partialと協力して部分行列を実現しています。
  *
- * @see Array2D_Partial 2z
+ * @see Array2D_Partial 部分2次元配列
  */
 template <class T>
 class PartialMatrix : public DelegatedMatrix<T>{
@@ -2369,13 +2927,13 @@ class PartialMatrix : public DelegatedMatrix<T>{
 
   public:
     /**
-     * PartialMatrix(s)NX̃RXgN^B
+     * PartialMatrix(部分行列)クラスのコンストラクタ。
      *
-     * @param matrix ̍s
-     * @param rows s
-     * @param columns 
-     * @param rowOffset s(0,0)ƂȂ錳̍s̃s{bg̍sCfbNX
-     * @param columnOffset CfbNX
+     * @param matrix 元の行列
+     * @param rows 行数
+     * @param columns 列数
+     * @param rowOffset 部分行列で(0,0)となる元の行列のピボットの行インデックス
+     * @param columnOffset 同じく列インデックス
      * @throw MatrixException
      */
     PartialMatrix(
@@ -2390,7 +2948,7 @@ class PartialMatrix : public DelegatedMatrix<T>{
                 rowOffset, columnOffset)){}
 
     /**
-     * fXgN^B
+     * デストラクタ。
      */
     ~PartialMatrix(){}
 
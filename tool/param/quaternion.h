@@ -33,9 +33,9 @@
 #define __QUATERNION_H
 
 /** @file
- * @brief NH[^jI(QuaternionA4)Cu
+ * @brief クォータニオン(Quaternion、4元数)ライブラリ
  * 
- * NH[^jI`CuB
+ * クォータニオンを定義したライブラリ。
  */
 
 #include <cmath>
@@ -47,16 +47,16 @@ template <class FloatT>
 struct QuaternionDataProperty{
   
 #if defined(_MSC_VER) || defined(__TI_COMPILER_VERSION__)
-  static const unsigned int OUT_OF_INDEX = 4; ///< ővf(4)
+  static const unsigned int OUT_OF_INDEX = 4; ///< 最大要素数(4)
 #else
-  static const unsigned int OUT_OF_INDEX; ///< ővf
+  static const unsigned int OUT_OF_INDEX; ///< 最大要素数
 #endif
 };
 
 #if !(defined(_MSC_VER) || defined(__TI_COMPILER_VERSION__))
 template <class FloatT>
 const unsigned int QuaternionDataProperty<FloatT>::OUT_OF_INDEX
-    = 4; ///< ővf
+    = 4; ///< 最大要素数
 #endif
 
 template <class FloatT>
@@ -65,9 +65,9 @@ class QuaternionData : public QuaternionDataProperty<FloatT> {
     typedef QuaternionData<FloatT> self_t;
   private:
     struct storage_t{
-      FloatT scalar;  ///< XJ[vf
-      Vector3<FloatT> vector; ///< xNgvf
-      int ref;  ///< QƃJE^
+      FloatT scalar;  ///< スカラー要素
+      Vector3<FloatT> vector; ///< ベクトル要素
+      int ref;  ///< 参照カウンタ
       storage_t() : ref(1) {}
       storage_t(const FloatT &q0, const Vector3<FloatT> &v)
           : scalar(q0), vector(v), ref(1) {}
@@ -75,30 +75,30 @@ class QuaternionData : public QuaternionDataProperty<FloatT> {
           const FloatT &q0, const FloatT &q1, 
           const FloatT &q2, const FloatT &q3)
           : scalar(q0), vector(q1, q2, q3), ref(1) {}
-    } *storage;  ///< Xg[W
+    } *storage;  ///< ストレージ
   protected:
     /**
-     * RXgN^
+     * コンストラクタ
      * 
      */
     QuaternionData() : storage(new storage_t()){}
     
     /**
-     * RXgN^
+     * コンストラクタ
      * 
-     * @param q0 XJ[vf
-     * @param v 3xNgvf
+     * @param q0 スカラー要素
+     * @param v 3次元ベクトル要素
      */
     QuaternionData(const FloatT &q0, const Vector3<FloatT> &v)
         : storage(new storage_t(q0, v)){}
     
     /**
-     * RXgN^
+     * コンストラクタ
      * 
-     * @param q0 XJ[vf
-     * @param q1 3xNgvf(X)
-     * @param q2 3xNgvf(Y)
-     * @param q3 3xNgvf(Z)
+     * @param q0 スカラー要素
+     * @param q1 3次元ベクトル要素の(X)
+     * @param q2 3次元ベクトル要素の(Y)
+     * @param q3 3次元ベクトル要素の(Z)
      */
     QuaternionData(
         const FloatT &q0, const FloatT &q1, 
@@ -106,22 +106,22 @@ class QuaternionData : public QuaternionDataProperty<FloatT> {
         : storage(new storage_t(q0, q1, q2, q3)) {}
     
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
      * 
-     * V[Rs[s܂B
+     * シャローコピーを行います。
      * 
-     * @param q Rs[
+     * @param q コピー元
      */
     QuaternionData(const self_t &q){
       if(storage = q.storage){(storage->ref)++;}
     }
     
     /**
-     * Zq
+     * 代入演算子
      * 
-     * V[Rs[őΉĂ܂B
+     * シャローコピーで対応しています。
      * 
-     * @param q Rs[
+     * @param q コピー元
      */
     self_t &operator=(const self_t &q){
       if(this == &q){return *this;}
@@ -129,11 +129,36 @@ class QuaternionData : public QuaternionDataProperty<FloatT> {
       if(storage = q.storage){(storage->ref)++;}
       return *this;
     }
+
+#if __cplusplus >= 201103L
+    /**
+     * ムーブコンストラクタ
+     * 
+     * ストレージの所有権を移すため、参照カウンタの操作は行われません。
+     * 移動元はストレージを持たない状態になり、代入(コピー、ムーブ)と破棄のみが可能です。
+     * なお、ムーブ代入の移動元は移動先のストレージと交換されるため、そのまま使用できます。
+     * 
+     * @param q 移動元
+     */
+    QuaternionData(self_t &&q) : storage(q.storage){
+      q.storage = NULL;
+    }
+    
+    /**
+     * ムーブ代入演算子
+     * 
+     * @param q 移動元
+     */
+    self_t &operator=(self_t &&q){
+      std::swap(storage, q.storage);
+      return *this;
+    }
+#endif
     
     /**
-     * fB[vRs[s܂B
+     * ディープコピーを行います。
      * 
-     * @return (Quarterion) Rs[
+     * @return (Quarterion) コピー
      */
     self_t deep_copy() const{
       return self_t(
@@ -143,10 +168,10 @@ class QuaternionData : public QuaternionDataProperty<FloatT> {
     
   public:
     /**
-     * fXgN^
+     * デストラクタ
      * 
-     * QƃJE^Z܂B
-     * QƃJE^0̏ꍇAgpĂ܂B
+     * 参照カウンタを減算します。
+     * もし参照カウンタが0の場合、使用していたメモリを解放します。
      */
     ~QuaternionData(){
       if(storage && ((--(storage->ref)) <= 0)){
@@ -155,24 +180,24 @@ class QuaternionData : public QuaternionDataProperty<FloatT> {
     }
     
     /**
-     * XJ[vfԂ܂B
+     * スカラー要素を返します。
      * 
-     * @return (T) XJ[vf
+     * @return (T) スカラー要素
      */
     FloatT &scalar(){return storage->scalar;}
     /**
-     * xNgvfԂ܂B
+     * ベクトル要素を返します。
      * 
-     * @return (Vector<FloatT>) xNgvf
+     * @return (Vector<FloatT>) ベクトル要素
      */
     Vector3<FloatT> &vector(){return storage->vector;}
     
     /**
-     * vf(̎Q)Ԃ܂B
-     * ]đ\łB
+     * 要素(の参照)を返します。
+     * 従って代入も可能です。
      * 
-     * @param index vfԍA0:XJ[vf,1`3:3xNgvfX`Z
-     * @return (FloatT &) vfւ̎Q
+     * @param index 要素番号、0:スカラー要素,1～3:3次元ベクトル要素X～Z
+     * @return (FloatT &) 要素への参照
      */
     FloatT &operator[](unsigned index){
       if(index == 0){return storage->scalar;}
@@ -181,26 +206,26 @@ class QuaternionData : public QuaternionDataProperty<FloatT> {
 };
 
 /**
- * @brief NH[^jI
+ * @brief クォータニオン
  * 
- * NH[^jI@f$ \Tilde{q} \f$̓XJ[vf@f$ q_{0} \f$
- * 3xNgvf@f$ \vec{q} \f$Ȃ
+ * クォータニオン@f$ \Tilde{q} \f$はスカラー要素@f$ q_{0} \f$と
+ * 3次元ベクトル要素@f$ \vec{q} \f$からなり
  * @f[
  *    \Tilde{q} \equiv \begin{Bmatrix} q_{0} \\ \vec{q} \end{Bmatrix}
  * @f]
- * ƕ\܂B
+ * と表現されます。
  * 
- * ɑSvf̓a1ƂȂPʃNH[^jIpƁA
- * 3ł̎pp\ۂ * IC[pŐ
- * @f$ \tan{\frac{\pi}{2}} @f$Ƃٓ_邱ƂłA
- * 炩ȉZsƂ\łB
+ * 特に全要素の二乗和が1となる単位クォータニオンを用いると、
+ * 3次元上での姿勢角を表す際に * オイラー角で生じる
+ * @f$ \tan{\frac{\pi}{2}} @f$といった特異点を回避することができ、
+ * 滑らかな演算を行うことが可能です。
  * 
- * ȂAIɎQƃJE^𗘗pCgEGCgȎɂȂĂ邽߁A
- * ≉Z񐔂ߖ񂳂邱Ƃ@̂܂B
- * ̂߂ɖIcopy()\bhgpȂƃfB[vRs[Ȃ̂ŁA
- * ėpsۂ͒ӂĂB
+ * なお、内部的に参照カウンタを利用したライトウエイトな実装になっているため、
+ * メモリや演算回数が節約されることが機体されます。
+ * そのために明示的にcopy()メソッドを使用しないとディープコピーがされないので、
+ * 再利用を行う際は注意してください。
  * 
- * @param FloatT ZxAdoubleȂ
+ * @param FloatT 演算精度、doubleなど
  * @see Vector3<FloatT>
  */
 template <class FloatT>
@@ -215,28 +240,28 @@ class Quaternion : public QuaternionData<FloatT> {
     using super_t::OUT_OF_INDEX;
     
     /**
-     * RXgN^
-     * Svf0ŏ܂B
+     * コンストラクタ
+     * 全要素を0で初期化します。
      */
     Quaternion()
         : super_t(FloatT(0), FloatT(0), FloatT(0), FloatT(0)) {}
     
     /**
-     * RXgN^
+     * コンストラクタ
      * 
-     * @param q0 XJ[vf
-     * @param v 3xNgvf
+     * @param q0 スカラー要素
+     * @param v 3次元ベクトル要素
      */
     Quaternion(const FloatT &q0, const Vector3<FloatT> &v)
         : super_t(q0, v){}
     
     /**
-     * RXgN^
+     * コンストラクタ
      * 
-     * @param q0 XJ[vf
-     * @param q1 3xNgvf(X)
-     * @param q2 3xNgvf(Y)
-     * @param q3 3xNgvf(Z)
+     * @param q0 スカラー要素
+     * @param q1 3次元ベクトル要素の(X)
+     * @param q2 3次元ベクトル要素の(Y)
+     * @param q3 3次元ベクトル要素の(Z)
      */
     Quaternion(
         const FloatT &q0, const FloatT &q1,
@@ -244,69 +269,88 @@ class Quaternion : public QuaternionData<FloatT> {
         : super_t(q0, q1, q2, q3) {}
     
     /**
-     * fXgN^
+     * デストラクタ
      * 
      */
     ~Quaternion(){}
     
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
      * 
-     * @param q Rs[
+     * @param q コピー元
      */
     Quaternion(const self_t &q) : super_t(q) {
       
     }
     
     /**
-     * Zq
+     * 代入演算子
      * 
-     * @param q Rs[
+     * @param q コピー元
      */
     self_t &operator=(const self_t &q){
       super_t::operator=(q);
       return *this;
     }
+
+#if __cplusplus >= 201103L
+    /**
+     * ムーブコンストラクタ
+     * 
+     * @param q 移動元
+     */
+    Quaternion(self_t &&q) : super_t(std::move(q)) {}
+    
+    /**
+     * ムーブ代入演算子
+     * 
+     * @param q 移動元
+     */
+    self_t &operator=(self_t &&q){
+      super_t::operator=(std::move(q));
+      return *this;
+    }
+#endif
     
     /**
-     * fB[vRs[s܂B
+     * ディープコピーを行います。
      * 
-     * @return (Quarterion) Rs[
+     * @return (Quarterion) コピー
      */
     self_t copy() const{
       return self_t((const super_t &)super_t::deep_copy());
     }
     
     /**
-     * vfݒ肵܂B
-     * vfԍ̒`operator[](unsigned)ɂĒ`Ă܂B
+     * 要素を設定します。
+     * 要素番号の定義はoperator[](unsigned)によって定義されています。
      * 
-     * @param index vfԍ
-     * @param value ݒ肷l
+     * @param index 要素番号
+     * @param value 設定する値
      * @see operator[](unsigned)
      */
     void set(unsigned index, const FloatT &value){(*this)[index] = value;}
     /**
-     * vf擾܂B
-     * vfԍ̒`operator[](unsigned)ɂĒ`Ă܂B
+     * 要素を取得します。
+     * 要素番号の定義はoperator[](unsigned)によって定義されています。
      * 
-     * @param index vfԍ
-     * @return FloatT vf
+     * @param index 要素番号
+     * @return FloatT 要素
      * @see operator[](unsigned)
      */
     FloatT get(unsigned index) const{return (*const_cast<self_t *>(this))[index];}
     
     /**
-     * NH[^jI߂܂B
-     * NH[^jI@f$ \Tilde{q}^{*} \f$
+     * 共役クォータニオンを求めます。
+     * 共役クォータニオン@f$ \Tilde{q}^{*} \f$は
      * @f[
      *     \Tilde{q}^{*} \equiv \begin{Bmatrix} q_{0} \\ - \vec{q} \end{Bmatrix}
      * @f]
-     * Œ`܂B
-     * ȂA߂ۂɃfB[vRs[Ă̂ŁAȌ̕ԋplɑ΂鑀ɂāA
-     * ̃NH[^jI͔jƂȂ܂B
+     * で定義されます。
+     * なお、求める際にディープコピーがされているので、以後の返却値に対する操作について、
+     * 元のクォータニオンは非破壊となります。
      * 
-     * @return (Quarterion<FloatT>) NH[^jI
+     * @return (Quarterion<FloatT>) 共役クォータニオン
      */
     self_t conj() const{
       self_t conj(
@@ -321,13 +365,13 @@ class Quaternion : public QuaternionData<FloatT> {
 #define POW2_ALREADY_DEFINED
 #endif
     /**
-     * vf̓a@f$ \left| \Tilde{q} \right|^{2} @f$߂܂B
+     * 要素の二乗和@f$ \left| \Tilde{q} \right|^{2} @f$を求めます。
      * @f[
      *     \left| \Tilde{q} \right|^{2} \equiv q_{0} {}^{2} + \left| \vec{q} \right|^{2}
      * @f]
-     * Œ`܂B
+     * で定義されます。
      * 
-     * @return (FloatT) 
+     * @return (FloatT) 結果
      */
     FloatT abs2() const{
       return pow2(get(0)) 
@@ -339,17 +383,17 @@ class Quaternion : public QuaternionData<FloatT> {
 #undef POW2_ALREADY_DEFINED
 #endif
     /**
-     * vf̓a̕(m)߂܂B
+     * 要素の二乗和の平方根(ノルム)を求めます。
      * 
-     * @return (FloatT) 
+     * @return (FloatT) 結果
      * @see abs2()
      */
     FloatT abs() const{return std::sqrt(abs2());}
 
     /**
-     * XJ[Ƃ̐ώZs܂BjIłB
+     * スカラーとの積算を行います。破壊的です。
      * 
-     * @return (Quaternion<FloatT>) 
+     * @return (Quaternion<FloatT>) 結果
      */
     self_t &operator*=(const FloatT &t){
       super_t::scalar() *= t;
@@ -358,37 +402,37 @@ class Quaternion : public QuaternionData<FloatT> {
     }
     
     /**
-     * XJ[Ƃ̐ώZs܂B
+     * スカラーとの積算を行います。
      * 
-     * @return (Quaternion<FloatT>) 
+     * @return (Quaternion<FloatT>) 結果
      */
     self_t operator*(const FloatT &t) const{return copy() *= t;}
     
     /**
-     * XJ[Ƃ̏Zs܂BjIłB
+     * スカラーとの除算を行います。破壊的です。
      * 
-     * @return (Quaternion<FloatT>) 
+     * @return (Quaternion<FloatT>) 結果
      */
     self_t &operator/=(const FloatT &t){return (*this) *= (FloatT(1) / t);}
     
     /**
-     * XJ[Ƃ̏Zs܂B
+     * スカラーとの除算を行います。
      * 
-     * @return (Quaternion<FloatT>) 
+     * @return (Quaternion<FloatT>) 結果
      */
     self_t operator/(const FloatT &t) const{return copy() /= t;}
     
     /**
-     * m1ɂȂ悤ɐK܂B
+     * ノルムが1になるように正規化します。
      * 
-     * @return (Quaternion<FloatT>) 
+     * @return (Quaternion<FloatT>) 結果
      * @see abs()
      */
     self_t regularize() const{return (*this) / abs();}
     
     /**
-     * NH[^jIƂ̐ώZs܂B
-     * ώZ @f$ \Tilde{q}_{a} \Tilde{q}_{b} @f$
+     * クォータニオンとの積算を行います。
+     * 積算 @f$ \Tilde{q}_{a} \Tilde{q}_{b} @f$は
      * @f[
      *    \Tilde{q}_{a} \Tilde{q}_{b}
      *      \equiv \begin{Bmatrix} q_{0a} \\ \vec{q}_{a} \end{Bmatrix}
@@ -398,9 +442,9 @@ class Quaternion : public QuaternionData<FloatT> {
      *          q_{0a} \vec{q}_{b} + q_{0b} \vec{q}_{a} + \vec{q}_{a} \times \vec{q}_{b} 
      *        \end{Bmatrix}
      * @f] 
-     * Œ`܂B
+     * で定義されます。
      * 
-     * @return (Quaternion<FloatT>) 
+     * @return (Quaternion<FloatT>) 結果
      */
     self_t operator*(const self_t &q) const{
       self_t result(
@@ -418,17 +462,17 @@ class Quaternion : public QuaternionData<FloatT> {
     }
     
     /**
-     * NH[^jIƂ̐ώZs܂BjIłB
-     * `operator*(const Quaternion &) constQƂĂB
+     * クォータニオンとの積算を行います。破壊的です。
+     * 定義はoperator*(const Quaternion &) constを参照してください。
      * 
-     * @return (Quaternion<FloatT>) 
+     * @return (Quaternion<FloatT>) 結果
      * @see operator*(const Quaternion<FloatT> &) const
      */
     self_t &operator*=(const self_t &q){return (*this) = (*this) * q;}
     
     /**
-     * NH[^jIƂ̉Zs܂BjIłB
-     * Z @f$ \Tilde{q}_{a} + \Tilde{q}_{b} @f$
+     * クォータニオンとの加算を行います。破壊的です。
+     * 加算 @f$ \Tilde{q}_{a} + \Tilde{q}_{b} @f$は
      * @f[
      *    \Tilde{q}_{a} + \Tilde{q}_{b}
      *      \equiv \begin{Bmatrix} q_{0a} \\ \vec{q}_{a} \end{Bmatrix}
@@ -438,26 +482,26 @@ class Quaternion : public QuaternionData<FloatT> {
      *          \vec{q}_{a} + \vec{q}_{b} 
      *        \end{Bmatrix}
      * @f] 
-     * Œ`܂B
+     * で定義されます。
      * 
-     * @return (Quaternion<FloatT>) 
+     * @return (Quaternion<FloatT>) 結果
      */
     self_t &operator+=(const self_t &q){
       for(unsigned int i(0); i < OUT_OF_INDEX; i++){(*this)[i] += q.get(i);}
       return *this;
     }
     /**
-     * NH[^jIƂ̉Zs܂B
-     * `operator+=(const Quaternion<FloatT> &) constQƂĂB
+     * クォータニオンとの加算を行います。
+     * 定義はoperator+=(const Quaternion<FloatT> &) constを参照してください。
      * 
-     * @return (Quaternion<FloatT>) 
+     * @return (Quaternion<FloatT>) 結果
      * @see operator+=(const Quaternion<FloatT> &)
      */
     self_t operator+(const self_t &q) const{return copy() += q;}
     
     /**
-     * NH[^jIƂ̌Zs܂BjIłB
-     * Z @f$ \Tilde{q}_{a} - \Tilde{q}_{b} @f$
+     * クォータニオンとの減算を行います。破壊的です。
+     * 加算 @f$ \Tilde{q}_{a} - \Tilde{q}_{b} @f$は
      * @f[
      *    \Tilde{q}_{a} - \Tilde{q}_{b}
      *      \equiv \begin{Bmatrix} q_{0a} \\ \vec{q}_{a} \end{Bmatrix}
@@ -467,26 +511,26 @@ class Quaternion : public QuaternionData<FloatT> {
      *          \vec{q}_{a} - \vec{q}_{b} 
      *        \end{Bmatrix}
      * @f] 
-     * Œ`܂B
+     * で定義されます。
      * 
-     * @return (Quaternion<FloatT>) 
+     * @return (Quaternion<FloatT>) 結果
      */
     self_t &operator-=(const self_t &q){
       for(unsigned int i(0); i < OUT_OF_INDEX; i++){(*this)[i] -= q.get(i);}
       return *this;
     }
     /**
-     * NH[^jIƂ̌Zs܂B
-     * `operator-=(const Quaternion<FloatT> &)QƂĂB
+     * クォータニオンとの減算を行います。
+     * 定義はoperator-=(const Quaternion<FloatT> &)を参照してください。
      * 
-     * @return (Quaternion<FloatT>) 
+     * @return (Quaternion<FloatT>) 結果
      * @see operator-=(const Quaternion<FloatT> &)
      */
     self_t operator-(const self_t &q) const{return copy() -= q;}
     
     /**
-     * 3xNgƂ̐ώZs܂BjIłB
-     * ώZ @f$ \Tilde{q} \vec{v} @f$
+     * 3次元ベクトルとの積算を行います。破壊的です。
+     * 積算 @f$ \Tilde{q} \vec{v} @f$は
      * @f[
      *    \Tilde{q} \vec{v}
      *      \equiv \begin{Bmatrix} q_{0} \\ \vec{q} \end{Bmatrix}
@@ -496,9 +540,9 @@ class Quaternion : public QuaternionData<FloatT> {
      *          q_{0} \vec{v} + \vec{q} \times \vec{v} 
      *        \end{Bmatrix}
      * @f] 
-     * Œ`܂B
+     * で定義されます。
      * 
-     * @return (Quaternion<FloatT>) 
+     * @return (Quaternion<FloatT>) 結果
      */
     self_t &operator*=(const Vector3<FloatT> &v){
       FloatT temp_scalar(super_t::scalar());
@@ -507,31 +551,31 @@ class Quaternion : public QuaternionData<FloatT> {
       return (*this);
     }
     /**
-     * 3xNgƂ̐ώZs܂B
-     * `operator*=(const Vector3<FloatT> &)QƂĂB
+     * 3次元ベクトルとの積算を行います。
+     * 定義はoperator*=(const Vector3<FloatT> &)を参照してください。
      * 
-     * @return (Quaternion<FloatT>) 
+     * @return (Quaternion<FloatT>) 結果
      * @see operator*=(const Vector3<FloatT> &)
      */
     self_t operator*(const Vector3<FloatT> &v) const{return copy() *= v;}
     
     /**
-     * ]p̔߂܂B
+     * 回転角の半分を求めます。
      * 
-     * @return (T) 
+     * @return (T) 結果
      */
     FloatT getTheta_2() const{return acos(regularize()[0]);}
     /**
-     * ]p߂܂B
+     * 回転角を求めます。
      * 
-     * @return (T) 
+     * @return (T) 結果
      * @see getTheta_2()
      */
     FloatT getTheta() const{return getTheta_2() * 2;}
     /**
-     * ]̍W߂܂B
+     * 回転軸の座標を求めます。
      * 
-     * @return (Vector3<FloatT>) 
+     * @return (Vector3<FloatT>) 結果
      */
     Vector3<FloatT> getAxis() const{
       Vector3<FloatT> axis;
@@ -549,7 +593,7 @@ class Quaternion : public QuaternionData<FloatT> {
 #define POW2_ALREADY_DEFINED
 #endif
     /**
-     * @f$ 3 \times 3 @f$ Direction Cosine Matrix(DCM)ɕϊ܂B
+     * @f$ 3 \times 3 @f$ のDirection Cosine Matrix(DCM)に変換します。
      * 
      * @return (Matrix<FloatT>) DCM
      */
@@ -581,11 +625,11 @@ class Quaternion : public QuaternionData<FloatT> {
 #endif
 
     /**
-     * Quaternion₷`ŏo͂܂B
+     * Quaternionを見やすい形で出力します。
      * 
-     * @param out o̓Xg[
-     * @param q o͑Ώ
-     * @return (ostream) o̓Xg[
+     * @param out 出力ストリーム
+     * @param q 出力対象
+     * @return (ostream) 出力ストリーム
      */
     friend std::ostream &operator<<(std::ostream &out, const self_t &q){
       for(unsigned int i(0); i < OUT_OF_INDEX; i++){
@@ -596,12 +640,12 @@ class Quaternion : public QuaternionData<FloatT> {
     }
     
     /**
-     * @f$ 4 \times 1 @f$s񂠂邢@f$ 1 \times 4 @f$sA
-     * 邢DCM̏𖞂@f$ 3 \times 3 @f$s
-     * Quaternion^ɕϊ܂B
+     * @f$ 4 \times 1 @f$行列あるいは@f$ 1 \times 4 @f$行列、
+     * あるいはDCMの条件を満たす@f$ 3 \times 3 @f$行列を
+     * Quaternion型に変換します。
      * 
-     * @param matrix s
-     * @throws MatrixException s̃TCYȂƂ
+     * @param matrix 行列
+     * @throws MatrixException 行列のサイズが正しくないとき
      */
     Quaternion(const Matrix<FloatT> &matrix) throw(MatrixException)
         : super_t() {
@@ -614,29 +658,29 @@ class Quaternion : public QuaternionData<FloatT> {
         for(int i(0); i < OUT_OF_INDEX; i++){(*this)[i] = m(0, i);}
       }else if((matrix.rows() == 3) && (matrix.columns() == 3)){
         
-        // TODO: DCM̏𖞂Ă邩Aׂ邱
+        // TODO: DCMの条件を満たしているか、調べること
         
-        // Ίpvf𑫂 3 q_0^2 - (q_1^2 + q_2^2 + q_3^2) == 4 q_0^2 - 1 ł
-        // q_0 >= 0ł邩q_0Ԃ͂߂ɂƂ        
+        // 対角要素を足すと 3 q_0^2 - (q_1^2 + q_2^2 + q_3^2) == 4 q_0^2 - 1 であり
+        // q_0 >= 0であるからq_0が一番はじめにとける        
         (*this)[0] = std::sqrt(((m(0, 0) + m(1, 1) + m(2, 2)) + 1) / 4);
         
         if((*this)[0] > 1E-10){
-          // Ίpvfc߂
+          // 非対角要素から残りを求める
           (*this)[1] = (m(1, 2) - m(2, 1)) / 4 / (*this)[0];
           (*this)[2] = (m(2, 0) - m(0, 2)) / 4 / (*this)[0];
           (*this)[3] = (m(0, 1) - m(1, 0)) / 4 / (*this)[0];
-        }else{  // 0ɋ߂Ƃ܂悭Ȃ
-          // Ίpvf(0)+(1)-(2) => (q_0^2 + q_1^2 + q_2^2) - 3 q_3^2 == 1 - 4 q_3^2 ł
-          // ̂Ƃq_3𐳂Ƃ
+        }else{  // 0に近いとあんまりよくない
+          // 対角要素(0)+(1)-(2) => (q_0^2 + q_1^2 + q_2^2) - 3 q_3^2 == 1 - 4 q_3^2 であり
+          // このときq_3を正とする
           (*this)[3] = std::sqrt(((m(0, 0) + m(1, 1) - m(2, 2)) - 1) / -4);
           if((*this)[3] > 1E-10){
             (*this)[1] = (m(2, 0) + m(0, 2)) / 4 / (*this)[3];
             (*this)[2] = (m(2, 1) + m(1, 2)) / 4 / (*this)[3];
-          }else{ // ܂菬Ɩ
-            // Ίpvf狁߂
-            // Ίpvf-(0)+(1)+(2) => (q_0^2 + q_2^2 + q_3^2) - 3 q_1^2 == 1 - 4 q_1^2
-            // Ίpvf(0)-(1)+(2) => (q_0^2 + q_1^2 + q_3^2) - 3 q_2^2 == 1 - 4 q_2^2
-            // ̂Ƃq_2𐳂ƂAq_1͔̕Ίpvf狁߂
+          }else{ // あまり小さいと問題
+            // 対角要素から求める
+            // 対角要素-(0)+(1)+(2) => (q_0^2 + q_2^2 + q_3^2) - 3 q_1^2 == 1 - 4 q_1^2
+            // 対角要素(0)-(1)+(2) => (q_0^2 + q_1^2 + q_3^2) - 3 q_2^2 == 1 - 4 q_2^2
+            // このときq_2を正とし、q_1の符号は非対角要素から求める
             (*this)[1] = std::sqrt(((-m(0, 0) + m(1, 1) + m(2, 2)) - 1) / -4);
             (*this)[2] = std::sqrt(((m(0, 0) - m(1, 1) + m(2, 2)) - 1) / -4);
             if(m(0, 1) + m(1, 0) < 0){(*this)[1] *= -1;}
@@ -648,9 +692,9 @@ class Quaternion : public QuaternionData<FloatT> {
     }
     
     /**
-     * @f$ 4 \times 1 @f$sɕϊ܂B
+     * @f$ 4 \times 1 @f$行列に変換します。
      * 
-     * @return (Matrix<FloatT>) s
+     * @return (Matrix<FloatT>) 行列
      */
     Matrix<FloatT> toMatrix() const{
       Matrix<FloatT> matrix = Matrix<FloatT>(OUT_OF_INDEX, 1);
@@ -33,9 +33,9 @@
 #define __VECTOR3_H
 
 /** @file
- * @brief 3xNgCu
+ * @brief 3次元ベクトルライブラリ
  * 
- * 3xNg`CuB
+ * 3次元ベクトルを定義したライブラリ。
  */
 
 #include <cmath>
@@ -44,24 +44,24 @@
 template <class FloatT>
 struct Vector3DataProperty{
   /**
-   * CfbNX̒`
+   * インデックスの定義
    * 
    */
   enum Index {
-      X_INDEX = 0,  ///< Xvf̓CfbNX0
-      Y_INDEX,      ///< Yvf̓CfbNX1
-      Z_INDEX};     ///< Zvf̓CfbNX2
+      X_INDEX = 0,  ///< X要素はインデックス0
+      Y_INDEX,      ///< Y要素はインデックス1
+      Z_INDEX};     ///< Z要素はインデックス2
 #if defined(_MSC_VER) || defined(__TI_COMPILER_VERSION__)
-  static const unsigned int OUT_OF_INDEX = 3; ///< ővf(3)
+  static const unsigned int OUT_OF_INDEX = 3; ///< 最大要素数(3)
 #else
-  static const unsigned int OUT_OF_INDEX; ///< ővf(3)
+  static const unsigned int OUT_OF_INDEX; ///< 最大要素数(3)
 #endif
 };
 
 #if !(defined(_MSC_VER) || defined(__TI_COMPILER_VERSION__))
 template <class FloatT>
 const unsigned int Vector3DataProperty<FloatT>::OUT_OF_INDEX 
-    = Vector3DataProperty<FloatT>::Z_INDEX + 1; ///< ővf(3)
+    = Vector3DataProperty<FloatT>::Z_INDEX + 1; ///< 最大要素数(3)
 #endif
 
 template <class FloatT>
@@ -72,8 +72,8 @@ class Vector3Data : public Vector3DataProperty<FloatT> {
     
   private:
     struct storage_t{
-      FloatT values[super_t::OUT_OF_INDEX];  ///<vfۑp
-      int ref;                      ///<QƃJE^
+      FloatT values[super_t::OUT_OF_INDEX];  ///<要素保存用
+      int ref;                      ///<参照カウンタ
       storage_t() : ref(1) {}
       storage_t(const FloatT &x, const FloatT &y, const FloatT &z)
           : ref(1) {
@@ -81,7 +81,7 @@ class Vector3Data : public Vector3DataProperty<FloatT> {
         values[super_t::Y_INDEX] = y;
         values[super_t::Z_INDEX] = z;
       }
-    } *storage;  ///< Xg[W
+    } *storage;  ///< ストレージ
     
     Vector3Data(storage_t *_storage) : storage(_storage){
       
@@ -89,19 +89,19 @@ class Vector3Data : public Vector3DataProperty<FloatT> {
     
   protected:
     /**
-     * RXgN^B
+     * コンストラクタ。
      */
     Vector3Data() : storage(new storage_t()){
       
     }
     
     /**
-     * RXgN^B
-     * w肵lŏ܂B
+     * コンストラクタ。
+     * 指定した値で初期化されます。
      * 
-     * @param x Xvf̒l
-     * @param y Yvf̒l
-     * @param z Zvf̒l
+     * @param x X要素の値
+     * @param y Y要素の値
+     * @param z Z要素の値
      */
     Vector3Data(const FloatT &x, const FloatT &y, const FloatT &z)
         : storage(new storage_t(x, y, z)){
@@ -109,22 +109,22 @@ class Vector3Data : public Vector3DataProperty<FloatT> {
     }
     
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
      * 
-     * V[Rs[s܂B
+     * シャローコピーを行います。
      * 
-     * @param v Rs[
+     * @param v コピー元
      */
     Vector3Data(const self_t &v){
       if(storage = v.storage){(storage->ref)++;}
     }
     
     /**
-     * Zq
+     * 代入演算子
      * 
-     * V[Rs[őΉĂ܂B
+     * シャローコピーで対応しています。
      * 
-     * @param v Rs[
+     * @param v コピー元
      */
     self_t &operator=(const self_t &v){
       if(this == &v){return *this;}
@@ -132,11 +132,36 @@ class Vector3Data : public Vector3DataProperty<FloatT> {
       if(storage = v.storage){(storage->ref)++;}
       return *this;
     }
+
+#if __cplusplus >= 201103L
+    /**
+     * ムーブコンストラクタ
+     * 
+     * ストレージの所有権を移すため、参照カウンタの操作は行われません。
+     * 移動元はストレージを持たない状態になり、代入(コピー、ムーブ)と破棄のみが可能です。
+     * なお、ムーブ代入の移動元は移動先のストレージと交換されるため、そのまま使用できます。
+     * 
+     * @param v 移動元
+     */
+    Vector3Data(self_t &&v) : storage(v.storage){
+      v.storage = NULL;
+    }
+    
+    /**
+     * ムーブ代入演算子
+     * 
+     * @param v 移動元
+     */
+    self_t &operator=(self_t &&v){
+      std::swap(storage, v.storage);
+      return *this;
+    }
+#endif
     
     /**
-     * fB[vRs[s܂B
+     * ディープコピーを行います。
      * 
-     * @return Rs[
+     * @return コピー
      */
     self_t deep_copy() const {
       storage_t *copied(new storage_t());
@@ -147,10 +172,10 @@ class Vector3Data : public Vector3DataProperty<FloatT> {
     }
   public:
     /**
-     * fXgN^B
+     * デストラクタ。
      * 
-     * QƃJE^Z܂B
-     * QƃJE^0̏ꍇAgpĂ܂B
+     * 参照カウンタを減算します。
+     * もし参照カウンタが0の場合、使用していたメモリを解放します。
      */
     ~Vector3Data(){
       if(storage && ((--(storage->ref)) <= 0)){
@@ -159,11 +184,11 @@ class Vector3Data : public Vector3DataProperty<FloatT> {
     }
     
     /**
-     * vf(̎Q)Ԃ܂B
-     * ]đ\łB
+     * 要素(の参照)を返します。
+     * 従って代入も可能です。
      * 
-     * @param index vfԍA0`2:vfX`Z
-     * @return (FloatT &) vfւ̎Q
+     * @param index 要素番号、0～2:要素X～Z
+     * @return (FloatT &) 要素への参照
      */
     FloatT &operator[](const unsigned int &index){
       //if(index => OUT_OF_INDEX){return NULL;}
@@ -172,17 +197,17 @@ class Vector3Data : public Vector3DataProperty<FloatT> {
 };
 
 /**
- * @brief 3xNg
+ * @brief 3次元ベクトル
  * 
- * 3xNgNXB
- * xNgg̒`ςOςȂǂ܂߂lXȉZ̒`sĂ܂B
+ * 3次元ベクトルクラス。
+ * ベクトル自身の定義や内積や外積などを含めた様々な演算の定義を行っています。
  * 
- * ȂAIɎQƃJE^𗘗pCgEGCgȎɂȂĂ邽߁A
- * ≉Z񐔂ߖ񂳂邱Ƃ@̂܂B
- * ̂߂ɖIcopy()\bhgpȂƃfB[vRs[Ȃ̂ŁA
- * ėpsۂ͒ӂĂB
+ * なお、内部的に参照カウンタを利用したライトウエイトな実装になっているため、
+ * メモリや演算回数が節約されることが機体されます。
+ * そのために明示的にcopy()メソッドを使用しないとディープコピーがされないので、
+ * 再利用を行う際は注意してください。
  * 
- * @param FloatT ZxAdoubleȂ
+ * @param FloatT 演算精度、doubleなど
  */
 template <class FloatT>
 class Vector3 : public Vector3Data<FloatT> {
@@ -194,52 +219,71 @@ class Vector3 : public Vector3Data<FloatT> {
     
   public:
     /**
-     * RXgN^B
-     * Svf0ŏ܂B
+     * コンストラクタ。
+     * 全要素は0で初期化されます。
      */
     Vector3() 
         : super_t(FloatT(0), FloatT(0), FloatT(0)){}
     
     /**
-     * RXgN^B
-     * w肵lŏ܂B
+     * コンストラクタ。
+     * 指定した値で初期化されます。
      * 
-     * @param x Xvf̒l
-     * @param y Yvf̒l
-     * @param z Zvf̒l
+     * @param x X要素の値
+     * @param y Y要素の値
+     * @param z Z要素の値
      */
     Vector3(const FloatT &x, const FloatT &y, const FloatT &z)
         : super_t(x, y, z){}
     
     /**
-     * fXgN^B
+     * デストラクタ。
      * 
      */
     ~Vector3(){}
     
     /**
-     * Rs[RXgN^
+     * コピーコンストラクタ
      * 
-     * @param v Rs[
+     * @param v コピー元
      */
     Vector3(const self_t &v) : super_t(v) {
       
     }
     
     /**
-     * Zq
+     * 代入演算子
      * 
-     * @param v Rs[
+     * @param v コピー元
      */
     self_t &operator=(const self_t &v){
       super_t::operator=(v);
       return *this;
     }
+
+#if __cplusplus >= 201103L
+    /**
+     * ムーブコンストラクタ
+     * 
+     * @param v 移動元
+     */
+    Vector3(self_t &&v) : super_t(std::move(v)) {}
+    
+    /**
+     * ムーブ代入演算子
+     * 
+     * @param v 移動元
+     */
+    self_t &operator=(self_t &&v){
+      super_t::operator=(std::move(v));
+      return *this;
+    }
+#endif
     
     /**
-     * fB[vRs[s܂B
+     * ディープコピーを行います。
      * 
-     * @return (Vector3) Rs[
+     * @return (Vector3) コピー
      */
     self_t copy() const{
       return self_t((const super_t &)super_t::deep_copy());
@@ -251,52 +295,52 @@ class Vector3 : public Vector3Data<FloatT> {
     using super_t::OUT_OF_INDEX;
     
     /**
-     * vfݒ肵܂B
-     * vfԍ̒`operator[](const unsigned int &)ɂĒ`Ă܂B
+     * 要素を設定します。
+     * 要素番号の定義はoperator[](const unsigned int &)によって定義されています。
      * 
-     * @param index vfԍ
-     * @param value ݒ肷l
+     * @param index 要素番号
+     * @param value 設定する値
      * @see operator[](const unsigned int &)
      */
     void set(unsigned index, const FloatT &value){(*this)[index] = value;}
     /**
-     * Xvfݒ肵܂B
-     * @param x ݒ肷l
+     * X要素を設定します。
+     * @param x 設定する値
      */
     void setX(const FloatT &x){set(X_INDEX, x);}
     /**
-     * Yvfݒ肵܂B
-     * @param y ݒ肷l
+     * Y要素を設定します。
+     * @param y 設定する値
      */
     void setY(const FloatT &y){set(Y_INDEX, y);}
     /**
-     * Zvfݒ肵܂B
-     * @param z ݒ肷l
+     * Z要素を設定します。
+     * @param z 設定する値
      */
     void setZ(const FloatT &z){set(Z_INDEX, z);}
     
     /**
-     * vf擾܂BlԂ̂߁A͕słB
-     * vfԍ̒`operator[](const unsigned int &)ɂĒ`Ă܂B
+     * 要素を取得します。値返しのため、代入は不可です。
+     * 要素番号の定義はoperator[](const unsigned int &)によって定義されています。
      * 
-     * @param index vfԍ
-     * @return FloatT vf
+     * @param index 要素番号
+     * @return FloatT 要素
      * @see operator[](const unsigned int &)
      */
     FloatT get(unsigned index) const{return (*const_cast<Vector3 *>(this))[index];}
     /**
-     * Xvf擾܂B
-     * @return FloatT Xvf
+     * X要素を取得します。
+     * @return FloatT X要素
      */
     FloatT getX() const{return get(X_INDEX);}
     /**
-     * Yvf擾܂B
-     * @return FloatT Yvf
+     * Y要素を取得します。
+     * @return FloatT Y要素
      */
     FloatT getY() const{return get(Y_INDEX);}
     /**
-     * Zvf擾܂B
-     * @return FloatT Zvf
+     * Z要素を取得します。
+     * @return FloatT Z要素
      */
     FloatT getZ() const{return get(Z_INDEX);}
 
@@ -306,16 +350,16 @@ class Vector3 : public Vector3Data<FloatT> {
 #define POW2_ALREADY_DEFINED
 #endif
     /**
-     * 3xNg@f$ \vec{v} @f$̃m@f$ \left| \vec{v} \right| @f$
-     * ߂܂B
-     * `3xNg
-     * @f$ \vec{v} \equiv \begin{pmatrix} x \\ y \\ z \end{pmatrix} @f$ɑ΂
+     * 3次元ベクトル@f$ \vec{v} @f$のノルム@f$ \left| \vec{v} \right| @f$の
+     * 二乗を求めます。
+     * 定義は3次元ベクトル
+     * @f$ \vec{v} \equiv \begin{pmatrix} x \\ y \\ z \end{pmatrix} @f$に対し
      * @f[
      *    \left| \vec{v} \right|^{2} \equiv x^{2} + y^{2} + z^{2}
      * @f]
-     * łB
+     * です。
      * 
-     * @return (T) 
+     * @return (T) 結果
      */
     FloatT abs2() const{
       FloatT result(0);
@@ -328,100 +372,100 @@ class Vector3 : public Vector3Data<FloatT> {
 #undef POW2_ALREADY_DEFINED
 #endif
     /**
-     * 3xNg@f$ \vec{v} @f$̃m@f$ \left| \vec{v} \right| @f$
-     * ߂܂B
-     * `abs2()QƂĂB
+     * 3次元ベクトル@f$ \vec{v} @f$のノルム@f$ \left| \vec{v} \right| @f$の
+     * を求めます。
+     * 定義はabs2()を参照してください。
      * 
-     * @return (T) 
+     * @return (T) 結果
      * @see abs2()
      */
     FloatT abs() const{return sqrt(abs2());}
     
     /**
-     * P}CiXIy[^B
+     * 単項マイナスオペレータ。
      * 
-     * @return (Vector3<FloatT>) SvfɃ}CiX
+     * @return (Vector3<FloatT>) 全要素にマイナスをつけたもの
      */
     self_t operator-() const{return (copy() *= -1);}
     
     /**
-     * XJ[ς܂BjIłB
+     * スカラー積をします。破壊的です。
      * 
-     * @param t XJ[
-     * @return (Vector3<FloatT>) 
+     * @param t スカラー
+     * @return (Vector3<FloatT>) 結果
      */
     self_t &operator*=(const FloatT &t){
       for(unsigned int i = 0; i < OUT_OF_INDEX; i++){(*this)[i] *= t;}
       return *this;
     }
     /**
-     * XJ[ς܂B
+     * スカラー積をします。
      * 
-     * @param t XJ[
-     * @return (Vector3<FloatT>) 
+     * @param t スカラー
+     * @return (Vector3<FloatT>) 結果
      * @see oprtator*=(const FloatT &t)
      */
     self_t operator*(const FloatT &t) const{return copy() *= t;}
     
     /**
-     * XJ[܂BjIłB
+     * スカラー割をします。破壊的です。
      * 
-     * @param t XJ[
-     * @return (Vector3<FloatT>) 
+     * @param t スカラー
+     * @return (Vector3<FloatT>) 結果
      */
     self_t &operator/=(const FloatT &t){return (*this) *= (FloatT(1) / t);}
     /**
-     * XJ[܂B
+     * スカラー割をします。
      * 
-     * @param t XJ[
-     * @return (Vector3<FloatT>) 
+     * @param t スカラー
+     * @return (Vector3<FloatT>) 結果
      * @see oprtator/=(const FloatT &t)
      */
     self_t operator/(const FloatT &t) const{return copy() /= t;}
     
     /**
-     * 3xNgƂ̉Z܂BjIłB
+     * 3次元ベクトルとの加算をします。破壊的です。
      * 
-     * @param v 3xNg
-     * @return (Vector3<FloatT>) 
+     * @param v 3次元ベクトル
+     * @return (Vector3<FloatT>) 結果
      */
     self_t &operator+=(const self_t &v){
       for(unsigned int i = 0; i < OUT_OF_INDEX; i++){(*this)[i] += v.get(i);}
       return *this;
     }
     /**
-     * 3xNgƂ̉Z܂B
+     * 3次元ベクトルとの加算をします。
      * 
-     * @param v 3xNg
-     * @return (Vector3<FloatT>) 
+     * @param v 3次元ベクトル
+     * @return (Vector3<FloatT>) 結果
      * @see operator+=(const Vector3<FloatT> &)
      */
     self_t operator+(const self_t &v) const{return copy() += v;}
     
     /**
-     * 3xNgƂ̌Z܂BjIłB
+     * 3次元ベクトルとの減算をします。破壊的です。
      * 
-     * @param v 3xNg
-     * @return (Vector3<FloatT>) 
+     * @param v 3次元ベクトル
+     * @return (Vector3<FloatT>) 結果
      */
     self_t &operator-=(const self_t &v){
      for(unsigned int i = 0; i < OUT_OF_INDEX; i++){(*this)[i] -= v.get(i);}
       return *this;
     }
     /**
-     * 3xNgƂ̌Z܂B
+     * 3次元ベクトルとの減算をします。
      * 
-     * @param v 3xNg
-     * @return (Vector3<FloatT>) 
+     * @param v 3次元ベクトル
+     * @return (Vector3<FloatT>) 結果
      * @see operator-=(const Vector3<FloatT> &)
      */
     self_t operator-(const self_t &v) const{return copy() -= v;}
     
     /**
-     * Oς܂B
+     * 外積をします。
      * 
-     * @param v 3xNg
-     * @return (Vector3<FloatT>) 
+     * @param v 3次元ベクトル
+     * @return (Vector3<FloatT>) 結果
      */
     self_t operator*(const self_t &v) const{
       self_t result;
@@ -432,10 +476,10 @@ class Vector3 : public Vector3Data<FloatT> {
     }
     
     /**
-     * ς܂B
+     * 内積をします。
      * 
-     * @param v 3xNg
-     * @return (Vector3<FloatT>) 
+     * @param v 3次元ベクトル
+     * @return (Vector3<FloatT>) 結果
      */
     FloatT innerp(const self_t &v) const{
      FloatT result(0);
@@ -446,10 +490,10 @@ class Vector3 : public Vector3Data<FloatT> {
     }
     
     /**
-     * Oς܂BjIłB
+     * 外積をします。破壊的です。
      * 
-     * @param v 3xNg
-     * @return (Vector3<FloatT>) 
+     * @param v 3次元ベクトル
+     * @return (Vector3<FloatT>) 結果
      * @see operator*(const Vector3<FloatT> &) const
      */
     self_t &operator*=(const self_t &v){
@@ -461,11 +505,11 @@ class Vector3 : public Vector3Data<FloatT> {
     }
 
     /**
-     * 3xNg₷`ŏo͂܂B
+     * 3次元ベクトルを見やすい形で出力します。
      * 
-     * @param out o̓Xg[
-     * @param v o͑Ώ
-     * @return (ostream) o̓Xg[ 
+     * @param out 出力ストリーム
+     * @param v 出力対象
+     * @return (ostream) 出力ストリーム 
      */
     friend std::ostream &operator<<(std::ostream &out, const self_t &v){
       out << "{";
@@ -477,10 +521,10 @@ class Vector3 : public Vector3Data<FloatT> {
     }
 
     /**
-     * @f$ 3 \times 1 @f$s񂠂邢@f$ 1 \times 3 @f$sVector3^ɕϊ܂B
+     * @f$ 3 \times 1 @f$行列あるいは@f$ 1 \times 3 @f$行列をVector3型に変換します。
      * 
-     * @param matrix s
-     * @throws MatrixException s̃TCYȂƂ
+     * @param matrix 行列
+     * @throws MatrixException 行列のサイズが正しくないとき
      */
     Vector3(const Matrix<FloatT> &matrix) throw(MatrixException)
         : super_t() {
@@ -512,9 +556,9 @@ class Vector3 : public Vector3Data<FloatT> {
     }
     
     /**
-     * @f$ 3 \times 1 @f$sɕϊ܂B
+     * @f$ 3 \times 1 @f$行列に変換します。
      * 
-     * @return (Matrix<FloatT>) s
+     * @return (Matrix<FloatT>) 行列
      */
     Matrix<FloatT> toMatrix() const{
       Matrix<FloatT> matrix(OUT_OF_INDEX, 1);
@@ -523,7 +567,7 @@ class Vector3 : public Vector3Data<FloatT> {
     }
     
     /**
-     * Oςs̐ς̌`ɕϊ܂BȂ킿A
+     * 外積を行列の積の形に変換します。すなわち、
      * @f$ \vec{v}_{\mathrm{this}} * \vec{v}_{\mathrm{another}} 
      *    = \begin{bmatrix} 
      *        0 & -v_{Z} & v_{Y} \\
@@ -531,7 +575,7 @@ class Vector3 : public Vector3Data<FloatT> {
      *        -v_{Y} & v_{X} & 0
      *      \end{bmatrix}_{v_\mathrm{this}} 
      *      v_{\mathrm{another}} @f$
-     * ƂȂ܂BȂ݂
+     * となります。ちなみに
      * @f$ \vec{v}_{\mathrm{another}} * \vec{v}_{\mathrm{this}} 
      *    = \begin{bmatrix} 
      *        0 & v_{Z} & -v_{Y} \\
@@ -540,7 +584,7 @@ class Vector3 : public Vector3Data<FloatT> {
      *      \end{bmatrix}_{v_\mathrm{this}} 
      *      v_{\mathrm{another}} 
      *    = - \left[ \; \right]_{v_\mathrm{this}} v_{\mathrm{another}} @f$
-     * łB
+     * です。
      * 
      */
     Matrix<FloatT> skewMatrix() const{
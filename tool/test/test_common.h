@@ -0,0 +1,77 @@
+/**
+ * @file Common checks of the unit tests
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef __TEST_COMMON_H__
+#define __TEST_COMMON_H__
+
+/*
+ * Each test is a stand-alone program, which reports failed checks with their locations
+ * to stderr, and returns non-zero when any check fails (see "make test").
+ */
+
+#include <iostream>
+#include <cmath>
+
+static int test_failures(0);
+
+#define TEST_CHECK(cond) { \
+  if(!(cond)){ \
+    std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #cond << std::endl; \
+    test_failures++; \
+  } \
+}
+
+#define TEST_CHECK_NEAR(a, b, tolerance) { \
+  double _a(a), _b(b); \
+  if(!(std::abs(_a - _b) <= (tolerance))){ \
+    std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #a " = " << _a \
+        << ", " #b " = " << _b << ", tolerance " << (tolerance) << std::endl; \
+    test_failures++; \
+  } \
+}
+
+/**
+ * Report the result of a test.
+ *
+ * @param name name of the test
+ * @return (int) exit code of the test program
+ */
+inline int test_result(const char *name){
+  std::cerr << name << ": " << (test_failures ? "FAILED" : "ok") << std::endl;
+  return test_failures ? 1 : 0;
+}
+
+#endif /* __TEST_COMMON_H__ */
@@ -0,0 +1,225 @@
+/**
+ * @file Round trip test of the buffered serial port (BufferedComportStreambuf) through a pseudo terminal
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+
+#include "util/comstream.h"
+
+#include "test_common.h"
+
+#ifndef _WIN32
+
+#include <stdlib.h>
+
+/**
+ * Pseudo terminal, whose slave is opened as a serial port, and whose master plays the device.
+ */
+struct PseudoTerminal {
+  int master;
+  std::string slave;
+  PseudoTerminal() : master(posix_openpt(O_RDWR | O_NOCTTY)), slave() {
+    if((master < 0) || (grantpt(master) != 0) || (unlockpt(master) != 0)){
+      perror("posix_openpt");
+      return;
+    }
+    slave = ptsname(master);
+  }
+  ~PseudoTerminal(){
+    if(master >= 0){close(master);}
+  }
+  bool valid() const {return !slave.empty();}
+
+  void write_all(const char *buf, std::size_t size){
+    while(size > 0){
+      ssize_t res(::write(master, buf, size));
+      if(res <= 0){return;}
+      buf += res;
+      size -= res;
+    }
+  }
+
+  /**
+   * @return (std::size_t) number of characters read before timeout
+   */
+  std::size_t read_all(char *buf, std::size_t size, const int &timeout_ms = 1000){
+    std::size_t res(0);
+    while(res < size){
+      struct pollfd fds;
+      fds.fd = master;
+      fds.events = POLLIN;
+      if(poll(&fds, 1, timeout_ms) <= 0){break;}
+      ssize_t read_count(::read(master, buf + res, size - res));
+      if(read_count <= 0){break;}
+      res += read_count;
+    }
+    return res;
+  }
+};
+
+static std::vector<char> pattern(const std::size_t &size, const int &seed){
+  std::vector<char> res(size);
+  for(std::size_t i(0); i < size; i++){
+    res[i] = (char)((i * 31 + seed) & 0xFF); // all the 256 values, including control characters
+  }
+  return res;
+}
+
+/**
+ * Data from the device must be received as they are, in chunks,
+ * with the positions and the times of reception.
+ */
+void test_receive(PseudoTerminal &pty){
+  BufferedComportStreambuf buf(pty.slave.c_str(), 0x100); // smaller than the data
+  buf.timeout_ms() = 1000;
+  std::istream in(&buf);
+
+  const std::size_t size(0x800);
+  std::vector<char> sent(pattern(size, 1));
+  pty.write_all(&sent[0], size);
+
+  double t_before(0);
+  {
+    char c;
+    in.get(c);
+    TEST_CHECK(c == sent[0]);
+    TEST_CHECK(buf.position() == 1);
+    TEST_CHECK(buf.received_at(0, t_before));
+  }
+
+  std::vector<char> received(size - 1);
+  in.read(&received[0], received.size());
+  TEST_CHECK(in.gcount() == (std::streamsize)received.size());
+  TEST_CHECK(std::memcmp(&received[0], &sent[1], received.size()) == 0);
+  TEST_CHECK(buf.position() == (long long)size);
+  TEST_CHECK(buf.chunks() >= (int)(size / 0x100)); // the buffer is filled several times
+
+  double t_last(0);
+  TEST_CHECK(buf.received_at(size - 1, t_last));
+  TEST_CHECK(t_last >= t_before);
+  TEST_CHECK(buf.last_chunk().position + buf.last_chunk().size == (long long)size);
+  TEST_CHECK(!buf.received_at(size, t_last)); // not received yet
+}
+
+/**
+ * Data to the device must be transmitted as they are, when flushed.
+ */
+void test_transmit(PseudoTerminal &pty){
+  BufferedComportStreambuf buf(pty.slave.c_str(), 0x100);
+  std::ostream out(&buf);
+
+  const std::size_t size(0x800);
+  std::vector<char> sent(pattern(size, 7));
+  out.write(&sent[0], 0x80); // within the buffer
+  out.flush();
+  std::vector<char> received(size);
+  TEST_CHECK(pty.read_all(&received[0], 0x80) == 0x80);
+  TEST_CHECK(std::memcmp(&received[0], &sent[0], 0x80) == 0);
+
+  out.write(&sent[0x80], size - 0x80); // beyond the buffer
+  out.put(sent[0]);
+  out.flush();
+  TEST_CHECK(out.good());
+  TEST_CHECK(pty.read_all(&received[0], size - 0x80 + 1) == (size - 0x80 + 1));
+  TEST_CHECK(std::memcmp(&received[0], &sent[0x80], size - 0x80) == 0);
+  TEST_CHECK(received[size - 0x80] == sent[0]);
+}
+
+/**
+ * Echo back by the device, through ComportStream.
+ */
+void test_round_trip(PseudoTerminal &pty){
+  ComportStream stream(pty.slave.c_str(), true);
+  TEST_CHECK(stream.buffered() != NULL);
+  if(!stream.buffered()){return;}
+  stream.buffered()->timeout_ms() = 1000;
+
+  for(int i(0); i < 8; i++){
+    std::vector<char> request(pattern(0x40 + i * 0x20, i));
+    stream.write(&request[0], request.size());
+    stream.flush();
+
+    std::vector<char> echo(request.size());
+    TEST_CHECK(pty.read_all(&echo[0], echo.size()) == echo.size());
+    pty.write_all(&echo[0], echo.size());
+
+    std::vector<char> response(request.size());
+    stream.read(&response[0], response.size());
+    TEST_CHECK(stream.gcount() == (std::streamsize)response.size());
+    TEST_CHECK(std::memcmp(&response[0], &request[0], request.size()) == 0);
+  }
+}
+
+/**
+ * Without data, reception must end with EOF after the timeout.
+ */
+void test_timeout(PseudoTerminal &pty){
+  BufferedComportStreambuf buf(pty.slave.c_str());
+  buf.timeout_ms() = 50;
+  std::istream in(&buf);
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  char c;
+  in.get(c);
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  double elapsed((t1.tv_sec - t0.tv_sec) + 1E-9 * (t1.tv_nsec - t0.tv_nsec));
+  TEST_CHECK(in.eof());
+  TEST_CHECK(buf.chunks() == 0);
+  TEST_CHECK(elapsed >= 0.04);
+  TEST_CHECK(elapsed < 1);
+}
+
+int main(){
+  PseudoTerminal pty;
+  TEST_CHECK(pty.valid());
+  if(pty.valid()){
+    test_receive(pty);
+    test_transmit(pty);
+    test_round_trip(pty);
+    test_timeout(pty);
+  }
+  return test_result("test_comstream");
+}
+
+#else
+
+int main(){
+  std::cerr << "test_comstream: skipped, a pseudo terminal is not available." << std::endl;
+  return 0;
+}
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * @file Test of the coning and sculling compensated increments (INS_ConingSculling)
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <cmath>
+#include <iostream>
+
+#include "navigation/INS.h"
+
+#include "test_common.h"
+
+typedef INS_ConingSculling<double> increment_t;
+typedef Vector3<double> vec3_t;
+
+/**
+ * Samples whose interval is zero must be ignored.
+ */
+void test_zero_interval(){
+  increment_t inc;
+  TEST_CHECK(inc.mean_accel().abs() == 0); // not NaN without samples
+  TEST_CHECK(inc.mean_gyro().abs() == 0);
+
+  inc.add(vec3_t(1, 2, 3), vec3_t(0.1, 0.2, 0.3), 0);
+  TEST_CHECK(inc.samples() == 0);
+  TEST_CHECK(inc.deltaT() == 0);
+  TEST_CHECK(inc.mean_accel().abs() == 0);
+
+  increment_t with_zero, without_zero;
+  for(int i(0); i < 4; i++){
+    vec3_t accel(1, 0.1 * i, -9.8), gyro(0.01 * i, 0.02, -0.01);
+    with_zero.add(accel, gyro, 0.01);
+    without_zero.add(accel, gyro, 0.01);
+    if(i == 1){with_zero.add(vec3_t(100, 100, 100), vec3_t(1, 1, 1), 0);}
+  }
+  TEST_CHECK(with_zero.samples() == without_zero.samples());
+  vec3_t diff_a(with_zero.mean_accel() - without_zero.mean_accel()),
+      diff_g(with_zero.mean_gyro() - without_zero.mean_gyro());
+  TEST_CHECK(diff_a.abs() == 0);
+  TEST_CHECK(diff_g.abs() == 0);
+}
+
+/**
+ * With constant inputs, there is neither coning nor sculling.
+ */
+void test_constant(){
+  increment_t inc;
+  vec3_t accel(0.5, -0.2, -9.8), gyro(0, 0, 0.1);
+  for(int i(0); i < 10; i++){inc.add(accel, gyro, 0.01);}
+  TEST_CHECK(inc.samples() == 10);
+  TEST_CHECK_NEAR(inc.deltaT(), 0.1, 1E-12);
+  TEST_CHECK((inc.mean_gyro() - gyro).abs() < 1E-12);
+  TEST_CHECK(std::abs(inc.mean_accel().getZ() - accel.getZ()) < 1E-12);
+}
+
+int main(){
+  test_zero_interval();
+  test_constant();
+  return test_result("test_coning_sculling");
+}
@@ -0,0 +1,257 @@
+/**
+ * @file Test of the position error of INS/GPS against truth, in both single and double precision
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "navigation/INS_GPS2.h"
+
+#include "test_common.h"
+
+/**
+ * Truth of a vehicle standing still, whose position and attitude are known.
+ */
+struct Truth {
+  double latitude, longitude, height;
+  Truth() : latitude(35.7 / 180 * M_PI), longitude(139.5 / 180 * M_PI), height(50) {}
+
+  /**
+   * Angular speed output, which is the Earth rate.
+   *
+   * @return (Vector3<double>) angular speed in the body frame [rad/s]
+   */
+  Vector3<double> gyro() const {
+    return Vector3<double>(
+        WGS84::Omega_Earth * std::cos(latitude), 0, -WGS84::Omega_Earth * std::sin(latitude));
+  }
+
+  /**
+   * Acceleration output, which cancels the gravity and the centripetal force
+   * in the same models as INS.
+   *
+   * @return (Vector3<double>) acceleration in the body frame [m/s^2]
+   */
+  Vector3<double> accel() const {
+    INS<double> ins;
+    ins.initPosition(latitude, longitude, height);
+    ins.initVelocity(0, 0, 0);
+    ins.initAttitude(0, 0, 0);
+    ins.update(Vector3<double>(0, 0, 0), gyro(), 1); // velocity after 1 s without accel
+    return Vector3<double>(-ins.v_north(), -ins.v_east(), -ins.v_down());
+  }
+
+  /**
+   * Horizontal distance from the truth.
+   *
+   * @return (double) distance [m]
+   */
+  double horizontal_error(const double &lat, const double &lon) const {
+    double north((lat - latitude) * WGS84::R_meridian(latitude)),
+        east((lon - longitude) * WGS84::R_normal(latitude) * std::cos(latitude));
+    return std::sqrt(north * north + east * east);
+  }
+};
+
+/**
+ * IMU outputs and GPS fixes generated from the truth.
+ * They are given in double, then rounded to FloatT
+ * as a navigator of FloatT would receive, except for the GPS position.
+ */
+template <class FloatT>
+struct Scenario {
+  Truth truth;
+  Vector3<FloatT> accel, gyro;
+  GPS_UBLOX_3D<FloatT> gps;
+
+  Scenario() : truth(), accel(), gyro(), gps() {
+    // the body frame coincides with the navigation frame (north, east, down)
+    Vector3<double> accel_d(truth.accel()), gyro_d(truth.gyro());
+    accel = Vector3<FloatT>(accel_d[0], accel_d[1], accel_d[2]);
+    gyro = Vector3<FloatT>(gyro_d[0], gyro_d[1], gyro_d[2]);
+
+    gps.v_n = gps.v_e = gps.v_d = 0;
+    gps.sigma_vel = 0.1;
+    gps.latitude = truth.latitude;
+    gps.longitude = truth.longitude;
+    gps.height = truth.height;
+    gps.sigma_2d = 1;
+    gps.sigma_height = 2;
+  }
+
+  /**
+   * Initialize a navigator at a wrong position.
+   */
+  template <class NAV>
+  void init(NAV &nav) const {
+    // start 3 m north and 2 m east of the truth, 5 m above
+    nav.initPosition(
+        truth.latitude + 3. / WGS84::R_meridian(truth.latitude),
+        truth.longitude + 2. / (WGS84::R_normal(truth.latitude) * std::cos(truth.latitude)),
+        truth.height + 5);
+    nav.initVelocity(0, 0, 0);
+    nav.initAttitude(0, 0, 0);
+    {
+      Matrix<FloatT> P(nav.getFilter().getP());
+      P(0, 0) = P(1, 1) = P(2, 2) = 1E+1;
+      P(3, 3) = P(4, 4) = P(5, 5) = 1E-8;
+      P(6, 6) = 1E+2;
+      P(7, 7) = P(8, 8) = P(9, 9) = 1E-4;
+      nav.getFilter().setP(P);
+    }
+    {
+      Matrix<FloatT> Q(nav.getFilter().getQ());
+      Q(0, 0) = Q(1, 1) = Q(2, 2) = 1E-4;
+      Q(3, 3) = Q(4, 4) = Q(5, 5) = 1E-8;
+      Q(6, 6) = 1E-6;
+      nav.getFilter().setQ(Q);
+    }
+  }
+
+  /**
+   * Proceed a second, i.e., 100 Hz IMU and 1 Hz GPS.
+   */
+  template <class NAV>
+  void step(NAV &nav) const {
+    for(int i(0); i < 100; i++){nav.update(accel, gyro, 0.01);}
+    nav.correct(gps);
+  }
+};
+
+/**
+ * Run INS/GPS starting from a wrong position, and return the position errors.
+ *
+ * @param horizontal horizontal error at the end [m]
+ * @param vertical vertical error at the end [m]
+ * @param horizontal_max maximum horizontal error after the convergence [m]
+ */
+template <class FloatT>
+void run(double &horizontal, double &vertical, double &horizontal_max){
+  INS_GPS2<FloatT> nav;
+  Scenario<FloatT> scenario;
+  const Truth &truth(scenario.truth);
+  scenario.init(nav);
+
+  horizontal_max = 0;
+  for(int t(1); t <= 600; t++){ // 600 s
+    scenario.step(nav);
+    double error(truth.horizontal_error(nav.latitude_precise(), nav.longitude_precise()));
+    if((t > 60) && (error > horizontal_max)){horizontal_max = error;}
+  }
+  horizontal = truth.horizontal_error(nav.latitude_precise(), nav.longitude_precise());
+  vertical = std::abs(nav.height_precise() - truth.height);
+}
+
+/**
+ * In single precision, the position corrections after the convergence are smaller
+ * than a unit in the last place (about 1 m in longitude), which must not be lost.
+ */
+void test_error_against_truth(){
+  double h_d, v_d, h_max_d, h_f, v_f, h_max_f;
+  run<double>(h_d, v_d, h_max_d);
+  run<float>(h_f, v_f, h_max_f);
+  std::cerr << "double: horizontal " << h_d << " (max " << h_max_d << "), vertical " << v_d << std::endl;
+  std::cerr << "float: horizontal " << h_f << " (max " << h_max_f << "), vertical " << v_f << std::endl;
+  TEST_CHECK(h_max_d < 0.01);
+  TEST_CHECK(v_d < 0.01);
+  TEST_CHECK(h_max_f < 0.01);
+  TEST_CHECK(v_f < 0.01);
+}
+
+/**
+ * Restore P as a checkpoint of INS_GPS does, i.e., the factors of a UD or square root filter.
+ */
+template <class FloatT>
+void restore_P(KalmanFilter<FloatT> &dst, const KalmanFilter<FloatT> &src){
+  dst.setP(src.getP());
+}
+template <class FloatT>
+void restore_P(KalmanFilterUD<FloatT> &dst, const KalmanFilterUD<FloatT> &src){
+  dst.setUD(src.getU(), src.getD());
+}
+template <class FloatT>
+void restore_P(KalmanFilterSquareRoot<FloatT> &dst, const KalmanFilterSquareRoot<FloatT> &src){
+  dst.setS(src.getS());
+}
+
+/**
+ * A navigator resumed from the states saved by get_precise() and the covariance
+ * must continue exactly as the uninterrupted one, even in single precision.
+ */
+template <class FloatT, class Filter>
+void test_resume(const char *name){
+  const int failures(test_failures);
+  typedef INS_GPS2<FloatT, Filter> nav_t;
+  Scenario<FloatT> scenario;
+  nav_t nav;
+  scenario.init(nav);
+  for(int t(1); t <= 300; t++){scenario.step(nav);}
+
+  nav_t resumed;
+  {
+    std::vector<double> x(nav.state_values());
+    for(unsigned int i(0); i < x.size(); i++){x[i] = nav.get_precise(i);}
+    resumed.set_states_precise(&x[0]);
+  }
+  restore_P(resumed.getFilter(), nav.getFilter());
+  resumed.getFilter().setQ(nav.getFilter().getQ());
+
+  for(int t(301); t <= 600; t++){
+    scenario.step(nav);
+    scenario.step(resumed);
+  }
+  for(unsigned int i(0); i < nav.state_values(); i++){
+    TEST_CHECK(resumed.get_precise(i) == nav.get_precise(i));
+  }
+  Matrix<FloatT>
+      &P(const_cast<Matrix<FloatT> &>(nav.getFilter().getP())),
+      &P_resumed(const_cast<Matrix<FloatT> &>(resumed.getFilter().getP()));
+  for(unsigned int i(0); i < P.rows(); i++){
+    for(unsigned int j(0); j < P.columns(); j++){
+      TEST_CHECK(P_resumed(i, j) == P(i, j));
+    }
+  }
+  if(test_failures > failures){std::cerr << "(" << name << ")" << std::endl;}
+}
+
+int main(){
+  test_error_against_truth();
+  test_resume<float, KalmanFilterUD<float> >("float, UD");
+  test_resume<float, KalmanFilterSquareRoot<float> >("float, SquareRoot");
+  test_resume<float, KalmanFilterJoseph<float> >("float, Joseph");
+  test_resume<double, KalmanFilterUD<double> >("double, UD");
+  return test_result("test_ins_gps_precision");
+}
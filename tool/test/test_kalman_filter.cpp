@@ -0,0 +1,162 @@
+/**
+ * @file Test of the Kalman filters updated in place
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "param/matrix.h"
+#include "algorithm/kalman.h"
+
+#include "test_common.h"
+
+typedef Matrix<double> mat_t;
+typedef Array2D_Dense_Pool<double> pool_t;
+
+struct Model {
+  mat_t P, Q, Phi, Gamma, H, R;
+  Model() : P(3, 3), Q(2, 2), Phi(3, 3), Gamma(3, 2), H(2, 3), R(2, 2) {
+    for(int i(0); i < 3; i++){
+      P(i, i) = 1. + i;
+      Phi(i, i) = 1;
+    }
+    P(0, 1) = P(1, 0) = 0.5;
+    Phi(0, 1) = Phi(1, 2) = 0.1;
+    Gamma(1, 0) = Gamma(2, 1) = 1;
+    Q(0, 0) = 0.01; Q(1, 1) = 0.02;
+    H(0, 0) = 1; H(1, 1) = 1; H(1, 2) = 0.5;
+    R(0, 0) = 0.1; R(1, 1) = 0.2;
+  }
+};
+
+bool equal(const mat_t &a, const mat_t &b){
+  mat_t &_a(const_cast<mat_t &>(a)), &_b(const_cast<mat_t &>(b));
+  for(unsigned int i(0); i < a.rows(); i++){
+    for(unsigned int j(0); j < a.columns(); j++){
+      if(_a(i, j) != _b(i, j)){return false;}
+    }
+  }
+  return true;
+}
+
+/**
+ * A copy of getP() must not change after the next step,
+ * and must be equal to P of the reference filter.
+ */
+template <class Filter>
+void test_copy_of_P(const char *name){
+  const int failures(test_failures);
+  Model model;
+  Filter filter(model.P, model.Q);
+  KalmanFilter<double> reference(model.P.copy(), model.Q.copy());
+
+  mat_t P0(filter.getP()), P0_deep(P0.copy());
+  filter.predict(model.Phi, model.Gamma);
+  reference.predict(model.Phi, model.Gamma);
+
+  // P may be restored lazily by getP(), therefore check after it
+  mat_t P1(filter.getP()), P1_deep(P1.copy());
+  TEST_CHECK(equal(P0, P0_deep));
+  TEST_CHECK(!equal(P1, P0_deep));
+  filter.correct(model.H, model.R);
+  reference.correct(model.H, model.R);
+
+  mat_t P2(filter.getP()), P2_deep(P2.copy());
+  TEST_CHECK(equal(P1, P1_deep));
+  filter.correct_sequential(model.H, model.R);
+
+  mat_t P3(filter.getP()), P3_deep(P3.copy());
+  TEST_CHECK(equal(P2, P2_deep));
+  filter.predict(model.Phi, model.Gamma, 0.01);
+  filter.getP();
+  TEST_CHECK(equal(P3, P3_deep));
+
+  // same results as the reference
+  reference.correct_sequential(model.H, model.R);
+  reference.predict(model.Phi, model.Gamma, 0.01);
+  mat_t diff(filter.getP() - reference.getP());
+  for(unsigned int i(0); i < 3; i++){
+    for(unsigned int j(0); j < 3; j++){
+      TEST_CHECK_NEAR(diff(i, j), 0, 1E-12);
+    }
+  }
+  if(test_failures > failures){std::cerr << "(" << name << ")" << std::endl;}
+}
+
+/**
+ * Without copies of P, the time update does not allocate the storage of P.
+ */
+template <class Filter>
+void test_in_place(const char *name){
+  const int failures(test_failures);
+  Model model;
+  Filter filter(model.P, model.Q);
+  filter.predict(model.Phi, model.Gamma); // reserve the workspace
+  const double *P_buffer(KalmanFilterKernel<double>::buffer(filter.getP()));
+  pool_t::stats_t base(pool_t::stats());
+  filter.predict(model.Phi, model.Gamma);
+  filter.getP();
+  TEST_CHECK(pool_t::stats().requested == base.requested);
+  TEST_CHECK(KalmanFilterKernel<double>::buffer(filter.getP()) == P_buffer);
+  if(test_failures > failures){std::cerr << "(" << name << ")" << std::endl;}
+}
+
+/**
+ * Without copies of P, the sequential correction updates P in place,
+ * and allocates only the returned gain after the workspace is reserved.
+ */
+template <class Filter>
+void test_sequential_in_place(const char *name){
+  const int failures(test_failures);
+  Model model;
+  Filter filter(model.P.copy(), model.Q);
+  filter.correct_sequential(model.H, model.R); // reserve the workspace
+  const double *P_buffer(KalmanFilterKernel<double>::buffer(filter.getP()));
+  pool_t::stats_t base(pool_t::stats());
+  filter.correct_sequential(model.H, model.R);
+  TEST_CHECK(pool_t::stats().requested == base.requested + 1);
+  TEST_CHECK(KalmanFilterKernel<double>::buffer(filter.getP()) == P_buffer);
+  if(test_failures > failures){std::cerr << "(" << name << ")" << std::endl;}
+}
+
+int main(){
+  test_copy_of_P<KalmanFilter<double> >("KalmanFilter");
+  test_copy_of_P<KalmanFilterJoseph<double> >("Joseph");
+  test_copy_of_P<KalmanFilterSquareRoot<double> >("SquareRoot");
+  test_copy_of_P<KalmanFilterUD<double> >("UD");
+  test_in_place<KalmanFilterJoseph<double> >("Joseph");
+  test_in_place<KalmanFilterSquareRoot<double> >("SquareRoot");
+  test_in_place<KalmanFilterUD<double> >("UD");
+  test_sequential_in_place<KalmanFilter<double> >("KalmanFilter");
+  test_sequential_in_place<KalmanFilterJoseph<double> >("Joseph");
+  return test_result("test_kalman_filter");
+}
@@ -0,0 +1,154 @@
+/**
+ * @file Test of the cached magnetic field model (MagneticFieldCache) against the direct evaluation of IGRF
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <cmath>
+#include <iostream>
+
+#include "navigation/MagneticField.h"
+
+#include "test_common.h"
+
+typedef MagneticFieldCache cache_t;
+typedef cache_t::res_t res_t;
+
+static double max_difference(const res_t &a, const res_t &b){
+  double res(std::abs(a.north - b.north));
+  if(std::abs(a.east - b.east) > res){res = std::abs(a.east - b.east);}
+  if(std::abs(a.down - b.down) > res){res = std::abs(a.down - b.down);}
+  return res;
+}
+
+/**
+ * Along a climbing track, every query must be within the tolerance of the direct evaluation,
+ * with much fewer evaluations than the queries.
+ *
+ * @param latitude_deg latitude at the start [deg]
+ * @param tolerance tolerance [nT]
+ */
+void test_track(const double &latitude_deg, const double &tolerance){
+  cache_t cache(IGRF11::IGRF2010, tolerance);
+  double error_max(0);
+  const int queries(18001); // 1 h at 5 Hz
+  for(int i(0); i < queries; i++){
+    double t(0.2 * i), distance(30 * t); // 30 m/s, heading north-east, climbing 3 m/s
+    double lat((latitude_deg / 180 * M_PI) + distance / std::sqrt(2.) / 6378137),
+        lng((139.5 / 180 * M_PI) + distance / std::sqrt(2.) / 6378137 / std::cos(lat)),
+        h(3 * t);
+    double error(max_difference(
+        cache(lat, lng, h), MagneticField::filed_components(IGRF11::IGRF2010, lat, lng, h)));
+    if(error > error_max){error_max = error;}
+  }
+  std::cerr << "latitude " << latitude_deg << " [deg], tolerance " << tolerance
+      << " [nT]: max error " << error_max << " [nT], "
+      << cache.evaluations() << " evaluations for " << queries << " queries" << std::endl;
+  TEST_CHECK(error_max <= tolerance);
+  TEST_CHECK(cache.evaluations() < (unsigned int)(queries / 10));
+}
+
+/**
+ * Inside the tile, the interpolation must be within the tolerance on a fine grid,
+ * not only at the points checked when the tile is built.
+ */
+void test_tile(const double &latitude_deg, const double &tolerance){
+  cache_t cache(IGRF11::IGRF2010, tolerance);
+  double lat0(latitude_deg / 180 * M_PI), lng0(-70. / 180 * M_PI); // aligned to the default tiles
+  cache(lat0, lng0, 0);
+  unsigned int evaluations(cache.evaluations());
+  double error_max(0);
+  const double step(M_PI / 180 / 10 / 16); // 1/16 of the default tile size
+  for(int i(0); i < 16; i++){
+    for(int j(0); j < 16; j++){
+      for(int k(0); k < 4; k++){
+        double lat(lat0 + step * i), lng(lng0 + step * j), h(250. * k);
+        double error(max_difference(
+            cache(lat, lng, h), MagneticField::filed_components(IGRF11::IGRF2010, lat, lng, h)));
+        if(error > error_max){error_max = error;}
+      }
+    }
+  }
+  std::cerr << "tile at latitude " << latitude_deg << " [deg]: max error " << error_max
+      << " [nT], " << (cache.evaluations() - evaluations) << " evaluations to cover it" << std::endl;
+  TEST_CHECK(error_max <= tolerance);
+}
+
+/**
+ * When the tolerance cannot be met after the divisions, the model must be evaluated directly.
+ */
+void test_fallback(){
+  cache_t cache(IGRF11::IGRF2010, 1E-9, M_PI / 180, M_PI / 180, 10000, 1);
+  double lat(35.7 / 180 * M_PI), lng(139.5 / 180 * M_PI), h(100);
+  res_t cached(cache(lat, lng, h)), exact(MagneticField::filed_components(IGRF11::IGRF2010, lat, lng, h));
+  TEST_CHECK(cache.direct_evaluation());
+  TEST_CHECK(max_difference(cached, exact) == 0);
+
+  // then, a reachable tolerance builds a tile again
+  cache.tolerance() = 1;
+  cache.invalidate();
+  cache(lat, lng, h);
+  TEST_CHECK(!cache.direct_evaluation());
+}
+
+/**
+ * The next tile starts from the last accepted size, whose build needs 27 evaluations
+ * (3 points in each direction) without retrying the larger ones.
+ */
+void test_continue(){
+  cache_t cache(IGRF11::IGRF2010, 0.01);
+  double lat(35.7 / 180 * M_PI), lng(139.5 / 180 * M_PI);
+  cache(lat, lng, 0);
+  unsigned int first(cache.evaluations());
+  TEST_CHECK(first > 27); // the default size does not meet 0.01 nT
+  unsigned int previous(first);
+  for(int i(1); i <= 100; i++){ // cross some tiles, in the same smoothness
+    cache(lat + M_PI / 180 / 1000 * i, lng, 0);
+    unsigned int evaluations(cache.evaluations() - previous);
+    TEST_CHECK((evaluations == 0) || (evaluations == 27));
+    previous = cache.evaluations();
+  }
+  TEST_CHECK(previous > first);
+}
+
+int main(){
+  test_track(35.7, 1);
+  test_track(80, 1);
+  test_track(35.7, 0.01);
+  test_tile(35.7, 1);
+  test_tile(80, 1);
+  test_tile(-30, 0.01);
+  test_fallback();
+  test_continue();
+  return test_result("test_magnetic_field_cache");
+}
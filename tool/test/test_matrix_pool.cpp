@@ -0,0 +1,134 @@
+/**
+ * @file Test of the storage pool of Array2D_Dense
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <vector>
+
+#include "param/matrix.h"
+
+#include "test_common.h"
+
+typedef Array2D_Dense_Pool<double> pool_t;
+typedef Matrix<double> mat_t;
+
+void test_disabled(){
+  pool_t::stats_t base(pool_t::stats());
+  {mat_t a(3, 3);}
+  {mat_t b(3, 3);}
+  pool_t::stats_t stats(pool_t::stats() - base);
+  TEST_CHECK(!pool_t::enabled());
+  TEST_CHECK(stats.requested == 2);
+  TEST_CHECK(stats.reused == 0);
+  TEST_CHECK(stats.cached == 0);
+  TEST_CHECK(pool_t::cached_blocks() == 0);
+
+  pool_t::Scope scope(false);
+  {mat_t c(3, 3);}
+  TEST_CHECK(!pool_t::enabled());
+  TEST_CHECK(pool_t::cached_blocks() == 0);
+}
+
+void test_reuse(){
+  pool_t::Scope scope;
+  TEST_CHECK(pool_t::enabled());
+  {
+    mat_t a(3, 3);
+    mat_t shared(a); // sharing the storage, released once
+  }
+  TEST_CHECK(pool_t::cached_blocks() == 1);
+  {
+    mat_t b(3, 3); // reuses the storage of a
+    mat_t c(2, 2); // different size class
+    b(0, 0) = 1;
+    TEST_CHECK(pool_t::cached_blocks() == 0);
+    TEST_CHECK(b(0, 0) == 1);
+  }
+  pool_t::stats_t stats(scope.stats());
+  TEST_CHECK(stats.requested == 3);
+  TEST_CHECK(stats.reused == 1);
+  TEST_CHECK(stats.released == 3);
+  TEST_CHECK(stats.cached == 3);
+  TEST_CHECK(pool_t::cached_blocks() == 2);
+}
+
+void test_release(){
+  pool_t::stats_t base(pool_t::stats());
+  {
+    pool_t::Scope outer;
+    {
+      pool_t::Scope inner;
+      std::vector<mat_t> mats;
+      for(int i(0); i < ARRAY2D_DENSE_POOL_MAX_CACHED + 10; i++){
+        mats.push_back(mat_t(4, 4));
+      }
+    }
+    // Free lists are capped, and kept until the outermost scope ends.
+    TEST_CHECK(pool_t::enabled());
+    TEST_CHECK(pool_t::cached_blocks() == ARRAY2D_DENSE_POOL_MAX_CACHED);
+    {mat_t a(ARRAY2D_DENSE_POOL_MAX_SIZE + 1, 1);} // too large to be pooled
+    TEST_CHECK(pool_t::cached_blocks() == ARRAY2D_DENSE_POOL_MAX_CACHED);
+  }
+  pool_t::stats_t stats(pool_t::stats() - base);
+  TEST_CHECK(!pool_t::enabled());
+  TEST_CHECK(pool_t::cached_blocks() == 0);
+  TEST_CHECK(stats.cached == ARRAY2D_DENSE_POOL_MAX_CACHED);
+  TEST_CHECK(stats.purged == ARRAY2D_DENSE_POOL_MAX_CACHED);
+  TEST_CHECK(stats.frees_avoided() == 0);
+}
+
+void test_threads(){
+#if defined(_OPENMP)
+  int reused(0), cached(0);
+#pragma omp parallel for reduction(+:reused, cached)
+  for(int i = 0; i < 8; i++){
+    pool_t::Scope scope; // the pool of each thread
+    {mat_t a(3, 3);}
+    {mat_t b(3, 3);}
+    reused += scope.stats().reused;
+    cached += pool_t::cached_blocks();
+  }
+  TEST_CHECK(reused == 8);
+  TEST_CHECK(cached == 8);
+  TEST_CHECK(pool_t::cached_blocks() == 0);
+#endif
+}
+
+int main(){
+  test_disabled();
+  test_reuse();
+  test_release();
+  test_threads();
+  return test_result("test_matrix_pool");
+}
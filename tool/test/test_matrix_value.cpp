@@ -0,0 +1,147 @@
+/**
+ * @file Test of the value mode (MATRIX_NO_FLY_WEIGHT) and the move semantics of the parameter classes
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Matrix<double> is in the value mode, and Matrix<float> is in the default (fly weight) mode.
+ * The move semantics are tested when built as C++11, e.g., make test CPPFLAGS=-std=gnu++11
+ */
+
+#include "param/matrix.h"
+
+MATRIX_NO_FLY_WEIGHT(double);
+
+#include "param/vector3.h"
+#include "param/quaternion.h"
+
+#include "test_common.h"
+
+typedef Matrix<double> mat_t;
+typedef Array2D_Dense_Pool<double> pool_t;
+
+void test_value(){
+  mat_t a(2, 2);
+  a(0, 0) = 1;
+
+  pool_t::stats_t base(pool_t::stats());
+  mat_t b(a);
+  TEST_CHECK(pool_t::stats().requested - base.requested == 1); // deep copy
+  b(0, 0) = 2;
+  TEST_CHECK(a(0, 0) == 1);
+
+  mat_t c;
+  c = a;
+  c(0, 0) = 3;
+  TEST_CHECK(a(0, 0) == 1);
+  TEST_CHECK(c(0, 0) == 3);
+
+  // Views still refer to the original.
+  a.transpose()(0, 1) = 4;
+  TEST_CHECK(a(1, 0) == 4);
+  a.partial(1, 1, 1, 1)(0, 0) = 5;
+  TEST_CHECK(a(1, 1) == 5);
+  a.partial(1, 2, 0, 0) = b.partial(1, 2, 0, 0);
+  TEST_CHECK(a(0, 0) == 2);
+  TEST_CHECK(b(0, 0) == 2);
+}
+
+void test_fly_weight(){
+  Matrix<float> a(2, 2);
+  Matrix<float> b(a);
+  b(0, 0) = 1;
+  TEST_CHECK(a(0, 0) == 1); // shared
+  Matrix<float> c(a.copy());
+  c(0, 0) = 2;
+  TEST_CHECK(a(0, 0) == 1);
+}
+
+void test_move(){
+#if __cplusplus >= 201103L
+  {
+    mat_t a(2, 2);
+    a(0, 0) = 1;
+    pool_t::stats_t base(pool_t::stats());
+    mat_t b(std::move(a));
+    TEST_CHECK(pool_t::stats().requested == base.requested);
+    TEST_CHECK(b(0, 0) == 1);
+    a = b; // a moved-from matrix can be assigned
+    TEST_CHECK(a(0, 0) == 1);
+    mat_t c(3, 3);
+    c = std::move(b);
+    TEST_CHECK(c.rows() == 2);
+    TEST_CHECK(b.rows() == 3); // exchanged
+  }
+  {
+    Matrix<float> a(2, 2), b(2, 2);
+    b(0, 1) = 1;
+    a.partial(2, 2, 0, 0) = b.transpose().copy(); // an rvalue into a view writes through
+    TEST_CHECK(a(1, 0) == 1);
+  }
+  {
+    typedef Vector3<double> vec_t;
+    vec_t v(1, 2, 3);
+    vec_t w(std::move(v));
+    TEST_CHECK(w[0] == 1);
+    v = w; // a moved-from vector can be assigned
+    TEST_CHECK(v[2] == 3);
+    vec_t x(4, 5, 6);
+    x = std::move(w);
+    TEST_CHECK(x[0] == 1);
+    TEST_CHECK(w[0] == 4); // exchanged, then usable
+    vec_t y(std::move(x));
+    x = std::move(y); // moved-from, then move assigned
+    TEST_CHECK(x[1] == 2);
+  }
+  {
+    typedef Quaternion<double> quat_t;
+    quat_t q(1, 0, 0, 0);
+    quat_t r(std::move(q));
+    TEST_CHECK(r[0] == 1);
+    q = r.copy();
+    TEST_CHECK(q[0] == 1);
+    quat_t s(0, 1, 0, 0);
+    s = std::move(r);
+    TEST_CHECK(s[0] == 1);
+    TEST_CHECK(r[1] == 1);
+  }
+#endif
+}
+
+int main(){
+  test_value();
+  test_fly_weight();
+  test_move();
+  return test_result("test_matrix_value");
+}
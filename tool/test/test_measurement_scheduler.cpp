@@ -0,0 +1,156 @@
+/**
+ * @file Test of the merge of the measurements of several streams (MeasurementSchedulerGeneric)
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <vector>
+
+#include "util/time_ring.h"
+#include "util/measurement_scheduler.h"
+
+#include "test_common.h"
+
+struct Measurement {
+  double itow;
+  int stream;
+};
+
+/**
+ * Stream of measurements, whose page contains zero or one measurement.
+ */
+struct Stream {
+  std::vector<double> pages; ///< time of the measurement of each page, negative for no measurement
+  unsigned int read;
+  int id;
+  TimeRing<Measurement> g_packets;
+  Stream(const int &_id) : pages(), read(0), id(_id), g_packets(0x10) {}
+  bool process_1page(){
+    if(read >= pages.size()){return false;}
+    double itow(pages[read++]);
+    if(itow >= 0){
+      Measurement m = {itow, id};
+      g_packets.push_back(m);
+    }
+    return true;
+  }
+};
+
+typedef MeasurementSchedulerGeneric<Stream> scheduler_t;
+
+/**
+ * Merge the streams in the same way as the forward processing of INS_GPS.
+ *
+ * @param streams streams
+ * @param merged measurements in the merged order
+ * @param pending_max maximum number of pending measurements of a stream
+ */
+void merge(std::vector<Stream *> &streams, std::vector<Measurement> &merged, unsigned int &pending_max){
+  scheduler_t scheduler;
+  pending_max = 0;
+  for(unsigned int i(0); i < streams.size(); i++){
+    if(scheduler_t::fill(streams[i])){scheduler.push(streams[i]);}
+  }
+  Stream *previous(NULL);
+  while(true){
+    if(previous && scheduler_t::fill(previous)){scheduler.push(previous);}
+    if(scheduler.empty()){break;}
+    Stream *current(previous = scheduler.pop());
+    if(current->g_packets.size() > pending_max){pending_max = current->g_packets.size();}
+    merged.push_back(current->g_packets.front());
+    current->g_packets.pop_front();
+  }
+}
+
+/**
+ * Interleaved streams having different rates, gaps, and pages without measurement
+ * must be merged in order of time without loss, reading ahead only one measurement of each.
+ */
+void test_interleaved(){
+  Stream a(0), b(1), c(2), empty(3);
+  for(int i(0); i < 50; i++){ // 5 Hz
+    a.pages.push_back(100000 + 0.2 * i);
+    a.pages.push_back(-1); // A page, for instance
+  }
+  for(int i(0); i < 100; i++){ // 10 Hz, with an outage
+    if((i >= 30) && (i < 60)){continue;}
+    b.pages.push_back(100000.05 + 0.1 * i);
+  }
+  for(int i(0); i < 10; i++){ // 1 Hz, starting later
+    c.pages.push_back(-1);
+    c.pages.push_back(100003.03 + i);
+  }
+  empty.pages.assign(5, -1);
+
+  std::vector<Stream *> streams;
+  streams.push_back(&a); streams.push_back(&b); streams.push_back(&empty); streams.push_back(&c);
+  std::vector<Measurement> merged;
+  unsigned int pending_max;
+  merge(streams, merged, pending_max);
+
+  TEST_CHECK(merged.size() == (50 + 70 + 10));
+  int counts[4] = {0};
+  for(unsigned int i(0); i < merged.size(); i++){
+    counts[merged[i].stream]++;
+    if(i > 0){TEST_CHECK(merged[i - 1].itow <= merged[i].itow);}
+  }
+  TEST_CHECK(counts[0] == 50);
+  TEST_CHECK(counts[1] == 70);
+  TEST_CHECK(counts[2] == 10);
+  TEST_CHECK(counts[3] == 0);
+  TEST_CHECK(pending_max == 1);
+  TEST_CHECK(a.read == a.pages.size());
+  TEST_CHECK(empty.read == empty.pages.size());
+}
+
+/**
+ * A single stream is passed through as it is.
+ */
+void test_single(){
+  Stream a(0);
+  for(int i(0); i < 10; i++){a.pages.push_back(10 + i);}
+  std::vector<Stream *> streams(1, &a);
+  std::vector<Measurement> merged;
+  unsigned int pending_max;
+  merge(streams, merged, pending_max);
+  TEST_CHECK(merged.size() == 10);
+  for(unsigned int i(0); i < merged.size(); i++){
+    TEST_CHECK(merged[i].itow == (10 + i));
+  }
+}
+
+int main(){
+  test_interleaved();
+  test_single();
+  return test_result("test_measurement_scheduler");
+}
@@ -0,0 +1,233 @@
+/**
+ * @file Test of the ring buffer in shared memory (SharedMemoryRing), with a reader in another process
+ *
+ */
+
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "util/shm_ring.h"
+
+#include "test_common.h"
+
+#ifndef _WIN32
+
+#include <sys/wait.h>
+
+struct Record {
+  unsigned int index;
+  double value[4];
+};
+
+typedef SharedMemoryRing<Record> ring_t;
+
+static std::string unique_name(const char *suffix){
+  std::stringstream ss;
+  ss << "/test_shm_ring_" << getpid() << "_" << suffix;
+  return ss.str();
+}
+
+static Record make_record(const unsigned int &i){
+  Record res = {i, {i * 1., i * 2., i * 3., i * 4.}};
+  return res;
+}
+
+static bool check_record(const Record &r, const unsigned int &i){
+  return (r.index == i) && (r.value[0] == i * 1.) && (r.value[3] == i * 4.);
+}
+
+/**
+ * Records written must be read in place, and overwritten ones must be detected.
+ */
+void test_read_write(){
+  std::string name(unique_name("rw"));
+  ring_t writer(name.c_str(), 3);
+  TEST_CHECK(writer.capacity() == 4);
+  ring_t reader(name.c_str());
+  TEST_CHECK(reader.capacity() == 4);
+
+  Record r;
+  TEST_CHECK(!reader.latest(r));
+  TEST_CHECK(reader.peek(0) == NULL);
+
+  for(unsigned int i(0); i < 10; i++){writer.push(make_record(i));}
+  TEST_CHECK(reader.written() == 10);
+  TEST_CHECK(reader.latest(r) && check_record(r, 9));
+  TEST_CHECK(reader.peek(5) == NULL); // overwritten
+  const Record *p(reader.peek(6));
+  TEST_CHECK(p && check_record(*p, 6) && reader.verify(6));
+  writer.push(make_record(10)); // overwrites 6
+  TEST_CHECK(!reader.verify(6));
+  TEST_CHECK(reader.peek(10) && check_record(*reader.peek(10), 10));
+}
+
+/**
+ * Even the smallest ring must keep the latest record readable
+ * while the next one is being written, e.g., by a writer which died meanwhile.
+ */
+void test_smallest(){
+  std::string name(unique_name("small"));
+  ring_t writer(name.c_str(), 1);
+  TEST_CHECK(writer.capacity() == 2);
+  ring_t reader(name.c_str());
+  writer.push(make_record(0));
+  writer.push(make_record(1));
+  writer.begin_write() = make_record(2); // without end_write()
+  Record r;
+  TEST_CHECK(reader.latest(r) && check_record(r, 1));
+  TEST_CHECK(reader.peek(2) == NULL);
+}
+
+/**
+ * A name used by another living writer, and an incompatible record, must be rejected.
+ */
+void test_reject(){
+  std::string name(unique_name("reject"));
+  ring_t writer(name.c_str(), 4);
+  writer.push(make_record(1));
+  bool thrown(false);
+  try{
+    ring_t second(name.c_str(), 4);
+  }catch(std::ios_base::failure &e){
+    thrown = true;
+  }
+  TEST_CHECK(thrown);
+  Record r;
+  TEST_CHECK(ring_t(name.c_str()).latest(r) && check_record(r, 1)); // not reinitialized
+
+  thrown = false;
+  try{
+    SharedMemoryRing<double> reader(name.c_str());
+  }catch(std::ios_base::failure &e){
+    thrown = true;
+  }
+  TEST_CHECK(thrown);
+
+  thrown = false;
+  try{
+    ring_t reader(unique_name("missing").c_str());
+  }catch(std::ios_base::failure &e){
+    thrown = true;
+  }
+  TEST_CHECK(thrown);
+}
+
+/**
+ * A name left by a crashed writer must be created again,
+ * while a reader attached to the old one can continue to read it.
+ */
+void test_stale(){
+  std::string name(unique_name("stale"));
+  pid_t pid(fork());
+  if(pid == 0){ // writer which exits without closing
+    ring_t *writer(new ring_t(name.c_str(), 4));
+    writer->push(make_record(100));
+    _exit(0);
+  }
+  int status;
+  waitpid(pid, &status, 0);
+
+  ring_t old_reader(name.c_str());
+  Record r;
+  TEST_CHECK(old_reader.latest(r) && check_record(r, 100));
+
+  ring_t writer(name.c_str(), 16);
+  TEST_CHECK(writer.capacity() == 16);
+  writer.push(make_record(0));
+  ring_t reader(name.c_str());
+  TEST_CHECK(reader.written() == 1);
+  TEST_CHECK(reader.latest(r) && check_record(r, 0));
+  TEST_CHECK(old_reader.latest(r) && check_record(r, 100));
+  TEST_CHECK(old_reader.capacity() == 4);
+}
+
+/**
+ * Reader in another process, which follows the writer and counts the records it has missed.
+ * This is also an example of a reader.
+ *
+ * @param name name of the shared memory
+ * @param records number of records to be read
+ * @return (int) 0 when all the records read are consistent
+ */
+static int read_in_child(const char *name, const unsigned int &records){
+  ring_t reader(name);
+  unsigned int next(0), missed(0), read(0);
+  while(next < records){
+    unsigned int written(reader.written());
+    if(next == written){usleep(100); continue;}
+    if(written - next > reader.capacity()){ // too slow, skip to the oldest available
+      missed += written - reader.capacity() - next;
+      next = written - reader.capacity();
+    }
+    const Record *p(reader.peek(next));
+    if(!p){continue;} // being overwritten, retry
+    Record r(*p);
+    if(!reader.verify(next)){continue;}
+    if(!check_record(r, next)){return 1;}
+    next++;
+    read++;
+  }
+  return ((read + missed) == records) ? 0 : 1;
+}
+
+void test_other_process(){
+  std::string name(unique_name("process"));
+  const unsigned int records(100000);
+  ring_t writer(name.c_str(), 0x100);
+  pid_t pid(fork());
+  if(pid == 0){_exit(read_in_child(name.c_str(), records));}
+  for(unsigned int i(0); i < records; i++){writer.push(make_record(i));}
+  int status;
+  waitpid(pid, &status, 0);
+  TEST_CHECK(WIFEXITED(status) && (WEXITSTATUS(status) == 0));
+}
+
+int main(){
+  test_read_write();
+  test_smallest();
+  test_reject();
+  test_stale();
+  test_other_process();
+  return test_result("test_shm_ring");
+}
+
+#else
+
+int main(){
+  std::cerr << "test_shm_ring: skipped on Windows." << std::endl;
+  return 0;
+}
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef __ALLAN_VARIANCE_H__
+#define __ALLAN_VARIANCE_H__
+
+#include <vector>
+#include <cmath>
+
+/**
+ * Overlapping Allan variance of a stream of samples, such as outputs of a gyro,
+ * at octave-spaced averaging times tau = m * tau0 (m = 1, 2, 4, ...),
+ *   sigma^2(tau) = sum_k (x_{k+2m} - 2 x_{k+m} + x_k)^2 / (2 m^2 count),
+ * where x_k is the sum of the first k samples, and tau0 is the sampling interval.
+ * The result is in units of the samples, and the sampling interval is assumed to be constant.
+ *
+ * Samples are processed one by one without being stored.
+ * For each octave, x_k are kept in a ring buffer of 2 * (m / stride) + 1 elements,
+ * where x_k are taken every stride samples, and stride is 1 while m <= density,
+ * otherwise m / density. Therefore the memory usage is bounded by octaves * density,
+ * and the time per sample is O(log(density)) regardless of the number of samples.
+ * A larger density makes the estimation of long tau closer to the fully overlapping one.
+ *
+ * @param FloatT precision
+ */
+template <class FloatT = double>
+class AllanVariance {
+  protected:
+    struct octave_t {
+      unsigned long m; ///< averaging factor
+      unsigned long stride; ///< interval of x_k taken in the ring buffer
+      std::vector<FloatT> x; ///< ring buffer
+      unsigned int head, stored;
+      FloatT sum; ///< sum of squared second differences
+      unsigned long count; ///< number of second differences
+
+      octave_t(const unsigned long &_m, const unsigned long &_stride)
+          : m(_m), stride(_stride), x(((m / stride) * 2) + 1),
+          head(0), stored(0), sum(0), count(0) {}
+
+      void push(const FloatT &value){
+        x[head] = value;
+        if(++head == x.size()){head = 0;}
+        if(stored < x.size()){
+          if(++stored < x.size()){return;}
+        }
+        // The newest is value, the oldest is at head, and the middle is m / stride after the oldest.
+        unsigned int middle(head + (m / stride));
+        if(middle >= x.size()){middle -= x.size();}
+        FloatT diff(value - x[middle] * 2 + x[head]);
+        sum += diff * diff;
+        count++;
+      }
+    };
+    std::vector<octave_t> octaves;
+    FloatT offset; ///< the first sample, which is subtracted from all the samples to keep x_k small
+    FloatT phase; ///< x_k
+    unsigned long samples;
+
+  public:
+    /**
+     * Constructor
+     *
+     * @param octave_size number of octaves, therefore the maximum m is 2^(octave_size - 1)
+     * @param density number of x_k kept per m in an octave, which is rounded up to a power of 2
+     */
+    AllanVariance(const unsigned int &octave_size = 32, const unsigned long &density = 256)
+        : octaves(), offset(0), phase(0), samples(0) {
+      unsigned long d(1);
+      while(d < density){d <<= 1;}
+      octaves.reserve(octave_size);
+      for(unsigned int i(0); i < octave_size; i++){
+        unsigned long m(1UL << i);
+        octaves.push_back(octave_t(m, (m > d) ? (m / d) : 1));
+        octaves.back().push(0); // x_0
+      }
+    }
+
+    /**
+     * Append a sample.
+     */
+    void push(const FloatT &value){
+      if(samples == 0){offset = value;}
+      phase += (value - offset);
+      samples++;
+      // Strides are non-decreasing powers of 2, then the rest do not take x_k.
+      for(unsigned int i(0); i < octaves.size(); i++){
+        if((samples & (octaves[i].stride - 1)) != 0){break;}
+        octaves[i].push(phase);
+      }
+    }
+
+    /**
+     * Append samples.
+     *
+     * @param values samples
+     * @param n number of samples
+     */
+    void push(const FloatT *values, const unsigned long &n){
+      for(unsigned long i(0); i < n; i++){push(values[i]);}
+    }
+
+    unsigned long size() const {return samples;}
+    unsigned int octave_size() const {return octaves.size();}
+
+    /**
+     * @param octave index of the octave
+     * @return (unsigned long) averaging factor m, i.e., tau / tau0
+     */
+    unsigned long m(const unsigned int &octave) const {return octaves[octave].m;}
+
+    /**
+     * @param octave index of the octave
+     * @return (unsigned long) number of the second differences, zero when samples are too few
+     */
+    unsigned long count(const unsigned int &octave) const {return octaves[octave].count;}
+
+    /**
+     * @param octave index of the octave
+     * @return (FloatT) Allan variance, or zero when samples are too few
+     */
+    FloatT variance(const unsigned int &octave) const {
+      const octave_t &target(octaves[octave]);
+      if(target.count == 0){return 0;}
+      return target.sum / (FloatT(target.m) * target.m * target.count * 2);
+    }
+
+    /**
+     * @param octave index of the octave
+     * @return (FloatT) Allan deviation, or zero when samples are too few
+     */
+    FloatT deviation(const unsigned int &octave) const {
+      return std::sqrt(variance(octave));
+    }
+};
+
+#endif /* __ALLAN_VARIANCE_H__ */
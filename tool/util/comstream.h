@@ -36,6 +36,8 @@
 #include <iostream>
 #include <string>
 
+#include <vector>
+
 #include <cstring>
 
 #ifdef _WIN32
@@ -45,8 +47,14 @@
 #include <termios.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <time.h>
 #include <sys/ioctl.h>
 #include <cstdio>
+#if defined(__linux__)
+#include <linux/serial.h>
+#endif
 #endif
 
 /**
@@ -313,8 +321,8 @@ class basic_ComportStreambuf : public std::basic_streambuf<_Elem, _Traits> {
       std::cerr << ((tio.c_lflag & NOFLSH) ? '+' : '-') << "NOFLSH ";
       std::cerr << std::endl;
       
-      std::cerr << "c_cc[VTIME]: " << (int)(tio.c_cc[VTIME]) << std::endl;  // LN^ԃ^C}
-      std::cerr << "c_cc[VMIN]: " << (int)(tio.c_cc[VMIN]) << std::endl;    // n󂯎܂ŃubN
+      std::cerr << "c_cc[VTIME]: " << (int)(tio.c_cc[VTIME]) << std::endl;  // キャラクタ間タイマ
+      std::cerr << "c_cc[VMIN]: " << (int)(tio.c_cc[VMIN]) << std::endl;    // n文字受け取るまでブロックする
     }
     virtual void config(){
       struct termios config_data;
@@ -327,7 +335,7 @@ class basic_ComportStreambuf : public std::basic_streambuf<_Elem, _Traits> {
 #endif
       
       /*
-       * raw[h
+       * rawモード
        */
 #if defined(HAVE_CFMAKERAW) || !defined(__CYGWIN__)
       cfmakeraw(&config_data);
@@ -363,7 +371,7 @@ class basic_ComportStreambuf : public std::basic_streambuf<_Elem, _Traits> {
       config_data.c_cc[VTIME] = 0;  // timer between two characters
       config_data.c_cc[VMIN] = 1;   // blocking until n characters recption
       
-      tcsetattr(handle, TCSANOW, &config_data); // ݒۑ
+      tcsetattr(handle, TCSANOW, &config_data); // 設定を保存
       
 #ifdef DEBUG
       print_status(config_data);
@@ -388,6 +396,15 @@ class basic_ComportStreambuf : public std::basic_streambuf<_Elem, _Traits> {
         case 38400: new_speed = B38400; break;
         case 57600: new_speed = B57600; break;
         case 115200: new_speed = B115200; break;
+#ifdef B230400
+        case 230400: new_speed = B230400; break;
+#endif
+#ifdef B460800
+        case 460800: new_speed = B460800; break;
+#endif
+#ifdef B921600
+        case 921600: new_speed = B921600; break;
+#endif
         default: return -1;
       }
       cfsetispeed(&config_data, new_speed);
@@ -465,8 +482,8 @@ class basic_ComportStreambuf : public std::basic_streambuf<_Elem, _Traits> {
       return comstat.cbInQue;
     }
 #else
-    /* TODO: unistd.h̒ᐅI/O̓obt@OȂ̂߁A
-     * streambuf̕Wł0Ԃł悢?
+    /* TODO: unistd.hの低水準I/Oはバッファリングなしのため、
+     * streambufの標準挙動である0返しでよい?
      * @see http://sato-www.cs.titech.ac.jp/pro3/slides/unix2-4.pdf
      * @see http://www.cplusplus.com/reference/iostream/streambuf/showmanyc/
      */
@@ -539,9 +556,9 @@ class basic_ComportStreambuf : public std::basic_streambuf<_Elem, _Traits> {
       return (streamsize)transmitted;
     }
 #else
-    /* TODO: unistd.h̒ᐅI/O̓obt@OȂ̂߁A
-     * ɂƂwriteĂяoƂŁA1ŕԂĂĂ܂?
-     * Ŝ߁Astreambuf̕WłsputcĂяoőΉ
+    /* TODO: unistd.hの低水準I/Oはバッファリングなしのため、
+     * 複数文字を引数にとるwriteを呼び出しだところで、1文字書きだけで返ってきてしまう?
+     * 安全のため、streambufの標準挙動であるsputc複数回呼び出しで対応
      * @see http://www.cplusplus.com/reference/iostream/streambuf/xsputn/
      */
     /*streamsize xsputn(const _Elem *s, streamsize n){
@@ -575,9 +592,9 @@ class basic_ComportStreambuf : public std::basic_streambuf<_Elem, _Traits> {
       return (streamsize)received;
     }
 #else
-    /* TODO: unistd.h̒ᐅI/O̓obt@OȂ̂߁A
-     * ɂƂreadĂяoƂŁA1ǂ݂ŕԂĂĂ܂
-     * streambuf̕WłsbumpcĂяoőΉ
+    /* TODO: unistd.hの低水準I/Oはバッファリングなしのため、
+     * 複数文字を引数にとるreadを呼び出しだところで、1文字読みだけで返ってきてしまう
+     * streambufの標準挙動であるsbumpc複数回呼び出しで対応
      * @see http://www.cplusplus.com/reference/iostream/streambuf/xsgetn/
      */
     /*streamsize xsgetn(_Elem *s, streamsize n){
@@ -660,19 +677,332 @@ class basic_ComportStreambuf : public std::basic_streambuf<_Elem, _Traits> {
     }
 };
 
+/**
+ * Buffered streambuf for serial/tty port
+ * 
+ * Received data is read in chunks as large as available, and transmitted data
+ * is written in chunks when flushed, instead of one system call per character.
+ * On POSIX, the port is non-blocking and waited with poll(2).
+ * The time when each chunk is received is recorded for latency measurement.
+ */
+template<
+    class _Elem, 
+    class _Traits>
+class basic_BufferedComportStreambuf : public basic_ComportStreambuf<_Elem, _Traits> {
+  public:
+    typedef basic_ComportStreambuf<_Elem, _Traits> super_t;
+    typedef std::basic_streambuf<_Elem, _Traits> root_t;
+    typedef std::streamsize streamsize;
+    typedef typename super_t::int_type int_type;
+    
+    /**
+     * Record of a received chunk
+     */
+    struct chunk_t {
+      long long position; ///< position of the head of the chunk in the received data
+      streamsize size; ///< number of characters
+      double received_at; ///< time of reception in seconds, monotonic clock
+    };
+    
+  protected:
+    std::vector<_Elem> in_buffer, out_buffer;
+    long long total_received;
+    int m_timeout_ms;
+    
+    static const int chunk_history_size = 0x40;
+    chunk_t chunk_history[chunk_history_size];
+    int chunk_count;
+    
+    static double now(){
+#ifdef _WIN32
+      LARGE_INTEGER count, freq;
+      QueryPerformanceCounter(&count);
+      QueryPerformanceFrequency(&freq);
+      return (double)count.QuadPart / freq.QuadPart;
+#else
+      struct timespec ts;
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+      return ts.tv_sec + 1E-9 * ts.tv_nsec;
+#endif
+    }
+    
+    /**
+     * Wait for received data, and then read them as many as possible.
+     * 
+     * @return (streamsize) number of characters read, or zero when timed out or failed
+     */
+    streamsize read_chunk(){
+      const streamsize capacity(in_buffer.size());
+      streamsize received(0);
+      double t_received;
+#ifdef _WIN32
+      DWORD dwerrors, read_count;
+      COMSTAT comstat;
+      ClearCommError(super_t::handle, &dwerrors, &comstat);
+      // Wait for at least one character when nothing is queued.
+      DWORD request(comstat.cbInQue > 0 ? comstat.cbInQue : 1);
+      if(request > (DWORD)capacity){request = (DWORD)capacity;}
+      if(!ReadFile(super_t::handle, (LPVOID)&in_buffer[0],
+          request * sizeof(_Elem), &read_count, NULL)){
+        return 0;
+      }
+      t_received = now();
+      received = read_count / sizeof(_Elem);
+#else
+      while(true){
+        struct pollfd fds;
+        fds.fd = super_t::handle;
+        fds.events = POLLIN;
+        int res(poll(&fds, 1, m_timeout_ms));
+        if(res < 0){
+          if(errno == EINTR){continue;}
+          return 0;
+        }
+        if(res == 0){return 0;} // timeout
+        t_received = now();
+        ssize_t read_count(read(super_t::handle, (void *)&in_buffer[0], capacity * sizeof(_Elem)));
+        if(read_count < 0){
+          if((errno == EAGAIN) || (errno == EINTR)){continue;}
+          return 0;
+        }
+        if(read_count == 0){return 0;} // hang up
+        received = read_count / sizeof(_Elem);
+        break;
+      }
+#endif
+      if(received > 0){
+        chunk_t &chunk(chunk_history[(chunk_count++) % chunk_history_size]);
+        chunk.position = total_received;
+        chunk.size = received;
+        chunk.received_at = t_received;
+        total_received += received;
+      }
+      return received;
+    }
+    
+    /**
+     * Write all the buffered data to be transmitted.
+     * 
+     * @return (bool) true when success, otherwise false
+     */
+    bool flush_out(){
+      const char *data((const char *)root_t::pbase());
+      std::size_t rest((root_t::pptr() - root_t::pbase()) * sizeof(_Elem));
+      while(rest > 0){
+#ifdef _WIN32
+        DWORD transmitted;
+        if(!WriteFile(super_t::handle, (LPCVOID)data, (DWORD)rest, &transmitted, NULL)){
+          return false;
+        }
+#else
+        ssize_t transmitted(write(super_t::handle, (const void *)data, rest));
+        if(transmitted < 0){
+          if(errno == EINTR){continue;}
+          if(errno != EAGAIN){return false;}
+          struct pollfd fds;
+          fds.fd = super_t::handle;
+          fds.events = POLLOUT;
+          poll(&fds, 1, -1);
+          continue;
+        }
+#endif
+        data += transmitted;
+        rest -= transmitted;
+      }
+      root_t::setp(&out_buffer[0], &out_buffer[0] + out_buffer.size());
+      return true;
+    }
+    
+  public:
+    /**
+     * Constructor
+     * 
+     * @param port_spec port name
+     * @param buffer_size size of each of receive and transmit buffers in characters
+     */
+    basic_BufferedComportStreambuf(
+        const char *port_spec, const std::size_t &buffer_size = 0x1000)
+        throw(std::ios_base::failure)
+        : super_t(port_spec),
+        in_buffer(buffer_size), out_buffer(buffer_size),
+        total_received(0), m_timeout_ms(-1), chunk_count(0) {
+#ifndef _WIN32
+      int flags(fcntl(super_t::handle, F_GETFL));
+      if((flags == -1) || (fcntl(super_t::handle, F_SETFL, flags | O_NONBLOCK) == -1)){
+        perror("set O_NONBLOCK");
+        throw std::ios_base::failure(std::string("Could not set O_NONBLOCK ").append(port_spec));
+      }
+#endif
+      root_t::setg(&in_buffer[0], &in_buffer[0], &in_buffer[0]);
+      root_t::setp(&out_buffer[0], &out_buffer[0] + out_buffer.size());
+    }
+    ~basic_BufferedComportStreambuf(){
+      flush_out();
+    }
+    
+    /**
+     * Timeout of reception in milliseconds, negative value means infinite.
+     * When timed out, the stream reaches EOF.
+     */
+    int &timeout_ms(){return m_timeout_ms;}
+    
+    /**
+     * Configure the port for low latency.
+     * The driver is requested to pass received data immediately (Linux ASYNC_LOW_LATENCY),
+     * which is ignored when not supported, such as a pseudo terminal.
+     */
+    void config_low_latency(){
+#ifdef _WIN32
+      COMMTIMEOUTS tout;
+      GetCommTimeouts(super_t::handle, &tout);
+      tout.ReadIntervalTimeout = 1;
+      SetCommTimeouts(super_t::handle, &tout);
+#else
+#if defined(__linux__) && defined(TIOCGSERIAL) && defined(ASYNC_LOW_LATENCY)
+      struct serial_struct serial;
+      if(ioctl(super_t::handle, TIOCGSERIAL, &serial) == 0){
+        serial.flags |= ASYNC_LOW_LATENCY;
+        ioctl(super_t::handle, TIOCSSERIAL, &serial);
+      }
+#endif
+      if(isatty(super_t::handle)){
+        struct termios config_data;
+        tcgetattr(super_t::handle, &config_data);
+        config_data.c_cc[VTIME] = 0;
+        config_data.c_cc[VMIN] = 1;
+        tcsetattr(super_t::handle, TCSANOW, &config_data);
+      }
+#endif
+    }
+    
+    /**
+     * @return (long long) number of characters consumed from the received data
+     */
+    long long position() const {
+      return total_received - (root_t::egptr() - root_t::gptr());
+    }
+    
+    /**
+     * @return (int) number of chunks received so far
+     */
+    int chunks() const {return chunk_count;}
+    
+    /**
+     * @return (const chunk_t &) the last received chunk, valid only when chunks() > 0
+     */
+    const chunk_t &last_chunk() const {
+      return chunk_history[(chunk_count - 1) % chunk_history_size];
+    }
+    
+    /**
+     * Get time of reception of the specified position in the received data,
+     * which is searched in the recent chunks.
+     * 
+     * @param pos position, for example, position() before reading a packet
+     * @param t time of reception in seconds
+     * @return (bool) true when found, otherwise false
+     */
+    bool received_at(const long long &pos, double &t) const {
+      int oldest(chunk_count > chunk_history_size ? (chunk_count - chunk_history_size) : 0);
+      for(int i(chunk_count - 1); i >= oldest; i--){
+        const chunk_t &chunk(chunk_history[i % chunk_history_size]);
+        if(chunk.position > pos){continue;}
+        if(pos >= chunk.position + chunk.size){return false;}
+        t = chunk.received_at;
+        return true;
+      }
+      return false;
+    }
+    
+  protected:
+#ifdef _WIN32
+    streamsize showmanyc(){
+      return 0;
+    }
+#endif
+    
+    int_type underflow(){
+      if(root_t::gptr() < root_t::egptr()){
+        return _Traits::to_int_type(*root_t::gptr());
+      }
+      streamsize received(read_chunk());
+      if(received <= 0){return _Traits::eof();}
+      root_t::setg(&in_buffer[0], &in_buffer[0], &in_buffer[0] + received);
+      return _Traits::to_int_type(*root_t::gptr());
+    }
+    
+    int_type uflow(){
+      int_type res(underflow());
+      if(res != _Traits::eof()){root_t::gbump(1);}
+      return res;
+    }
+    
+    streamsize xsgetn(_Elem *s, streamsize n){
+      streamsize res(0);
+      while(res < n){
+        streamsize available(root_t::egptr() - root_t::gptr());
+        if(available <= 0){
+          if(underflow() == _Traits::eof()){break;}
+          continue;
+        }
+        if(available > (n - res)){available = n - res;}
+        std::memcpy(s + res, root_t::gptr(), available * sizeof(_Elem));
+        root_t::gbump((int)available);
+        res += available;
+      }
+      return res;
+    }
+    
+    int_type overflow(int_type c = _Traits::eof()){
+      if(!flush_out()){return _Traits::eof();}
+      if(c != _Traits::eof()){
+        *root_t::pptr() = _Traits::to_char_type(c);
+        root_t::pbump(1);
+        return c;
+      }
+      return _Traits::not_eof(c);
+    }
+    
+    streamsize xsputn(const _Elem *s, streamsize n){
+      return root_t::xsputn(s, n);
+    }
+    
+    int sync(){
+      return flush_out() ? 0 : -1;
+    }
+};
+
 typedef basic_ComportStreambuf<char, std::char_traits<char> > ComportStreambuf;
+typedef basic_BufferedComportStreambuf<char, std::char_traits<char> > BufferedComportStreambuf;
 
 class ComportStream : public std::iostream{
   public:
     typedef ComportStreambuf buf_t;
   protected:
     typedef std::iostream super_t;
-    buf_t buf;
+    buf_t *buf;
   public:
-    ComportStream(const char *port_spec) throw(std::ios_base::failure)
-        : buf(port_spec), super_t(&buf){}
-    ~ComportStream(){}
-    buf_t &buffer(){return buf;}
+    /**
+     * Constructor
+     * 
+     * @param port_spec port name
+     * @param buffered true when BufferedComportStreambuf is used
+     */
+    ComportStream(const char *port_spec, const bool &buffered = false) throw(std::ios_base::failure)
+        : super_t(NULL),
+        buf(buffered ? new BufferedComportStreambuf(port_spec) : new buf_t(port_spec)) {
+      super_t::rdbuf(buf);
+    }
+    ~ComportStream(){
+      delete buf;
+    }
+    buf_t &buffer(){return *buf;}
+    /**
+     * @return (BufferedComportStreambuf *) buffer, or NULL when not buffered
+     */
+    BufferedComportStreambuf *buffered(){
+      return dynamic_cast<BufferedComportStreambuf *>(buf);
+    }
 };
 
 #endif /* __COMSTREAM_H__ */
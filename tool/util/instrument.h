@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef __INSTRUMENT_H__
+#define __INSTRUMENT_H__
+
+/**
+ * Instrumentation of processing stages with scoped timers and counters.
+ *
+ * It is enabled only when INSTRUMENT macro is defined, for example, by
+ * "make CPPFLAGS=-DINSTRUMENT"; otherwise, the macros are expanded to nothing.
+ *
+ * INSTRUMENT_SCOPE(name) measures the time from the statement to the end of the scope
+ * with the monotonic clock, and accumulates it into the histogram of the stage named name.
+ * INSTRUMENT_COUNT(name, n) adds n to the counter named name.
+ * INSTRUMENT_TICK() prints the summary periodically when Instrument::interval() is positive.
+ * The summary, the count, mean, p50, p99, and max of each stage and the rate of each counter,
+ * is printed to stderr at exit as CSV, or as JSON when Instrument::json() is true.
+ *
+ * The histogram has 8 sub-buckets per power of 2, therefore the percentiles are
+ * within about 6 percent. Stages and counters may be updated in OpenMP parallel regions.
+ */
+
+#if defined(INSTRUMENT)
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+class Instrument {
+  public:
+    typedef long long ns_t;
+
+    static ns_t now(){
+#ifdef _WIN32
+      LARGE_INTEGER count, freq;
+      QueryPerformanceCounter(&count);
+      QueryPerformanceFrequency(&freq);
+      return (ns_t)((double)count.QuadPart * 1E9 / freq.QuadPart);
+#else
+      struct timespec ts;
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+      return (ns_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+    }
+
+    class Histogram {
+      public:
+        static const int SUB_BITS = 3;
+        static const int SUB_BUCKETS = 1 << SUB_BITS;
+        static const int BUCKETS = SUB_BUCKETS * 62;
+      protected:
+        ns_t counts[BUCKETS];
+        ns_t m_count, m_sum, m_max;
+        static int index(const ns_t &v){
+          if(v < SUB_BUCKETS){return (v < 0) ? 0 : (int)v;}
+          int e(SUB_BITS);
+          while((v >> (e + 1)) > 0){e++;}
+          return (e - SUB_BITS + 1) * SUB_BUCKETS + (int)((v >> (e - SUB_BITS)) & (SUB_BUCKETS - 1));
+        }
+        /**
+         * @return (ns_t) middle value of the bucket
+         */
+        static ns_t value(const int &i){
+          if(i < SUB_BUCKETS){return i;}
+          int e((i / SUB_BUCKETS) + SUB_BITS - 1);
+          ns_t lower((ns_t)(SUB_BUCKETS + (i % SUB_BUCKETS)) << (e - SUB_BITS));
+          return lower + (((ns_t)1 << (e - SUB_BITS)) >> 1);
+        }
+      public:
+        Histogram() : m_count(0), m_sum(0), m_max(0) {
+          for(int i(0); i < BUCKETS; i++){counts[i] = 0;}
+        }
+        void add(const ns_t &v){
+          ns_t &bucket(counts[index(v)]);
+#if defined(_OPENMP)
+#pragma omp atomic
+#endif
+          bucket++;
+#if defined(_OPENMP)
+#pragma omp atomic
+#endif
+          m_count++;
+#if defined(_OPENMP)
+#pragma omp atomic
+#endif
+          m_sum += v;
+          if(v > m_max){
+#if defined(_OPENMP)
+#pragma omp critical(instrument_max)
+#endif
+            if(v > m_max){m_max = v;}
+          }
+        }
+        const ns_t &count() const {return m_count;}
+        const ns_t &sum() const {return m_sum;}
+        const ns_t &max() const {return m_max;}
+        /**
+         * @param ratio 0.5 for median
+         * @return (ns_t) percentile, which does not exceed max()
+         */
+        ns_t percentile(const double &ratio) const {
+          ns_t threshold((ns_t)(ratio * m_count)), accumulated(0);
+          for(int i(0); i < BUCKETS; i++){
+            accumulated += counts[i];
+            if(accumulated > threshold){
+              ns_t res(value(i));
+              return (res > m_max) ? m_max : res;
+            }
+          }
+          return m_max;
+        }
+    };
+
+    struct Stage {
+      const char *name;
+      Histogram histogram;
+      Stage(const char *_name) : name(_name), histogram() {}
+    };
+
+    struct Counter {
+      const char *name;
+      ns_t value;
+      Counter(const char *_name) : name(_name), value(0) {}
+      void add(const ns_t &n){
+#if defined(_OPENMP)
+#pragma omp atomic
+#endif
+        value += n;
+      }
+    };
+
+    class Scope {
+      protected:
+        Stage &stage;
+        ns_t t0;
+      public:
+        Scope(Stage &_stage) : stage(_stage), t0(now()) {}
+        ~Scope(){stage.histogram.add(now() - t0);}
+    };
+
+  protected:
+    std::vector<Stage *> stages;
+    std::vector<Counter *> counters;
+    ns_t t_start, t_last_report;
+    bool m_json;
+    double m_interval;
+    unsigned int ticks;
+
+    Instrument()
+        : stages(), counters(), t_start(now()), t_last_report(t_start),
+        m_json(false), m_interval(0), ticks(0) {}
+
+  public:
+    ~Instrument(){
+      report(std::cerr);
+      for(unsigned int i(0); i < stages.size(); i++){delete stages[i];}
+      for(unsigned int i(0); i < counters.size(); i++){delete counters[i];}
+    }
+
+    static Instrument &get(){
+      static Instrument instance;
+      return instance;
+    }
+
+    bool &json(){return m_json;}
+    double &interval(){return m_interval;} ///< period of the summary [s], non-positive means only at exit
+
+    Stage &stage(const char *name){
+      Stage *res;
+#if defined(_OPENMP)
+#pragma omp critical(instrument_register)
+#endif
+      {
+        stages.push_back(new Stage(name));
+        res = stages.back();
+      }
+      return *res;
+    }
+
+    Counter &counter(const char *name){
+      Counter *res;
+#if defined(_OPENMP)
+#pragma omp critical(instrument_register)
+#endif
+      {
+        counters.push_back(new Counter(name));
+        res = counters.back();
+      }
+      return *res;
+    }
+
+    void tick(){
+      if((m_interval <= 0) || ((++ticks & 0x3FF) != 0)){return;}
+      ns_t t(now());
+      if((t - t_last_report) < (ns_t)(m_interval * 1E9)){return;}
+      t_last_report = t;
+      report(std::cerr);
+    }
+
+    /**
+     * Print the summary. Stages and counters of the same name, which are defined
+     * at different places, are printed separately.
+     */
+    void report(std::ostream &out) const {
+      const double elapsed(1E-9 * (now() - t_start));
+      std::ios_base::fmtflags flags(out.flags());
+      std::streamsize precision(out.precision());
+      out << std::setprecision(6);
+      if(m_json){
+        out << "{\"elapsed_s\": " << elapsed << ", \"stages\": [";
+        for(unsigned int i(0); i < stages.size(); i++){
+          const Histogram &h(stages[i]->histogram);
+          out << (i > 0 ? ", " : "")
+              << "{\"name\": \"" << stages[i]->name << "\""
+              << ", \"count\": " << h.count()
+              << ", \"total_ms\": " << (1E-6 * h.sum())
+              << ", \"mean_us\": " << (h.count() > 0 ? (1E-3 * h.sum() / h.count()) : 0)
+              << ", \"p50_us\": " << (1E-3 * h.percentile(0.5))
+              << ", \"p99_us\": " << (1E-3 * h.percentile(0.99))
+              << ", \"max_us\": " << (1E-3 * h.max()) << "}";
+        }
+        out << "], \"counters\": [";
+        for(unsigned int i(0); i < counters.size(); i++){
+          out << (i > 0 ? ", " : "")
+              << "{\"name\": \"" << counters[i]->name << "\""
+              << ", \"value\": " << counters[i]->value
+              << ", \"per_s\": " << (elapsed > 0 ? (counters[i]->value / elapsed) : 0) << "}";
+        }
+        out << "]}" << std::endl;
+      }else{
+        out << "instrument, elapsed [s], " << elapsed << std::endl;
+        out << "stage, count, total [ms], mean [us], p50 [us], p99 [us], max [us]" << std::endl;
+        for(unsigned int i(0); i < stages.size(); i++){
+          const Histogram &h(stages[i]->histogram);
+          out << stages[i]->name << ", "
+              << h.count() << ", "
+              << (1E-6 * h.sum()) << ", "
+              << (h.count() > 0 ? (1E-3 * h.sum() / h.count()) : 0) << ", "
+              << (1E-3 * h.percentile(0.5)) << ", "
+              << (1E-3 * h.percentile(0.99)) << ", "
+              << (1E-3 * h.max()) << std::endl;
+        }
+        out << "counter, value, per second" << std::endl;
+        for(unsigned int i(0); i < counters.size(); i++){
+          out << counters[i]->name << ", "
+              << counters[i]->value << ", "
+              << (elapsed > 0 ? (counters[i]->value / elapsed) : 0) << std::endl;
+        }
+      }
+      out.flags(flags);
+      out.precision(precision);
+    }
+};
+
+#define INSTRUMENT_CONCAT2(a, b) a ## b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT2(a, b)
+#define INSTRUMENT_SCOPE(name) \
+static Instrument::Stage &INSTRUMENT_CONCAT(instrument_stage_, __LINE__)(Instrument::get().stage(name)); \
+Instrument::Scope INSTRUMENT_CONCAT(instrument_scope_, __LINE__)(INSTRUMENT_CONCAT(instrument_stage_, __LINE__))
+#define INSTRUMENT_COUNT(name, n) { \
+  static Instrument::Counter &instrument_counter(Instrument::get().counter(name)); \
+  instrument_counter.add(n); \
+}
+#define INSTRUMENT_TICK() Instrument::get().tick()
+
+#else /* INSTRUMENT */
+
+#define INSTRUMENT_SCOPE(name)
+#define INSTRUMENT_COUNT(name, n)
+#define INSTRUMENT_TICK()
+
+#endif /* INSTRUMENT */
+
+#endif /* __INSTRUMENT_H__ */
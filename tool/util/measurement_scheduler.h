@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef __MEASUREMENT_SCHEDULER_H__
+#define __MEASUREMENT_SCHEDULER_H__
+
+#include <vector>
+#include <algorithm>
+
+/**
+ * Scheduler to merge the pending measurements of several input streams in order of time.
+ * Each stream is read ahead until it has a pending measurement,
+ * and the streams are kept in a min-heap keyed on the time of their pending measurements,
+ * therefore the next measurement is found in O(log k) for k streams.
+ *
+ * @param StreamT type of a stream, which has a queue of the pending measurements as
+ * StreamT::g_packets (such as TimeRing, whose items are time stamped by itow),
+ * and reads them with bool StreamT::process_1page(), which returns false when exhausted.
+ */
+template <class StreamT>
+class MeasurementSchedulerGeneric {
+  protected:
+    std::vector<StreamT *> heap;
+    static bool later(const StreamT *a, const StreamT *b){
+      return a->g_packets.front().itow > b->g_packets.front().itow;
+    }
+  public:
+    MeasurementSchedulerGeneric() : heap() {}
+
+    /**
+     * Read a stream until it has a pending measurement.
+     *
+     * @param stream stream
+     * @return (bool) true when a measurement is pending, false when the stream is exhausted
+     */
+    static bool fill(StreamT *stream){
+      while(stream->g_packets.empty()){
+        if(!stream->process_1page()){return false;}
+      }
+      return true;
+    }
+
+    bool empty() const {return heap.empty();}
+
+    /**
+     * @param stream stream having a pending measurement
+     */
+    void push(StreamT *stream){
+      heap.push_back(stream);
+      std::push_heap(heap.begin(), heap.end(), later);
+    }
+
+    /**
+     * @return (StreamT *) stream whose pending measurement is the oldest
+     */
+    StreamT *pop(){
+      std::pop_heap(heap.begin(), heap.end(), later);
+      StreamT *res(heap.back());
+      heap.pop_back();
+      return res;
+    }
+};
+
+#endif /* __MEASUREMENT_SCHEDULER_H__ */
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef __SCRATCH_FILE_H__
+#define __SCRATCH_FILE_H__
+
+#include <ios>
+#include <string>
+#include <algorithm>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <vector>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+#endif
+
+/**
+ * Temporary file which is appended sequentially and then read backward,
+ * for example, to store the forward pass of a smoother.
+ *
+ * The file is accessed through a window of a fixed size,
+ * which is memory-mapped (POSIX) or buffered (Windows),
+ * therefore the memory usage is constant regardless of the file size,
+ * and the file is always read and written in large blocks.
+ * The file is removed automatically when closed.
+ */
+class ScratchFile {
+  public:
+    typedef long long offset_t;
+
+  protected:
+    std::size_t page_size; ///< unit of the file offset of a window
+    std::size_t window_size; ///< size of a window, multiple of the page size
+    offset_t length; ///< size of the contents
+
+    char *window; ///< current window
+    offset_t window_offset; ///< file offset of the head of the window
+    std::size_t window_length; ///< valid length of the window
+    bool window_dirty; ///< true when the window is for writing
+
+#ifdef _WIN32
+    std::FILE *fp;
+    std::vector<char> buffer;
+#else
+    int fd;
+#endif
+
+#ifdef _WIN32
+    /**
+     * Seek with a 64-bit offset; fseek() with long fails beyond 2GB on Windows.
+     */
+    bool seek(const offset_t &offset){
+      return _fseeki64(fp, offset, SEEK_SET) == 0;
+    }
+#endif
+
+    void release() throw(std::ios_base::failure) {
+      if(!window){return;}
+#ifdef _WIN32
+      if(window_dirty){
+        window = NULL;
+        if((!seek(window_offset))
+            || (std::fwrite(&buffer[0], 1, window_length, fp) != window_length)){
+          throw std::ios_base::failure("Could not write scratch file");
+        }
+      }
+#else
+      munmap(window, window_size);
+#endif
+      window = NULL;
+    }
+
+    /**
+     * Map the window [offset, offset + window_size).
+     *
+     * @param offset file offset, which must be a multiple of page_size
+     * @param for_write true to write, false to read
+     */
+    void acquire(const offset_t &offset, const bool &for_write) throw(std::ios_base::failure) {
+      release();
+      window_offset = offset;
+      window_length = (std::size_t)std::min((offset_t)window_size, length - offset);
+      window_dirty = for_write;
+#ifdef _WIN32
+      window = &buffer[0];
+      if(!for_write){
+        if((!seek(offset)) || (std::fread(window, 1, window_length, fp) != window_length)){
+          throw std::ios_base::failure("Could not read scratch file");
+        }
+      }
+#else
+      if(for_write && (ftruncate(fd, offset + window_size) != 0)){
+        throw std::ios_base::failure("Could not extend scratch file");
+      }
+      void *res(mmap(NULL, window_size,
+          for_write ? (PROT_READ | PROT_WRITE) : PROT_READ,
+          MAP_SHARED, fd, offset));
+      if(res == MAP_FAILED){
+        throw std::ios_base::failure("Could not map scratch file");
+      }
+      window = static_cast<char *>(res);
+      if(!for_write){
+        // Read the whole window ahead in large blocks
+        madvise(window, window_length, MADV_WILLNEED);
+      }
+#endif
+    }
+
+  private:
+    ScratchFile(const ScratchFile &);
+    ScratchFile &operator=(const ScratchFile &);
+
+  public:
+    /**
+     * Constructor
+     *
+     * @param dir directory of the temporary file;
+     * when NULL, TMPDIR environment variable or /tmp is used.
+     * @param window_size_min minimum size of the window in bytes,
+     * which is rounded up to a multiple of the page size with a margin of a page.
+     * The size of a block to be read at once must not exceed it.
+     */
+    ScratchFile(const char *dir = NULL, const std::size_t &window_size_min = 0x1000000)
+        throw(std::ios_base::failure)
+        : page_size(1), window_size(window_size_min), length(0),
+        window(NULL), window_offset(0), window_length(0), window_dirty(false) {
+#ifdef _WIN32
+      if(!(fp = std::tmpfile())){
+        throw std::ios_base::failure("Could not create scratch file");
+      }
+      buffer.resize(window_size);
+#else
+      page_size = sysconf(_SC_PAGESIZE);
+      window_size = ((window_size + page_size - 1) / page_size + 1) * page_size;
+      if(!dir){dir = std::getenv("TMPDIR");}
+      std::string path(dir ? dir : "/tmp");
+      path.append("/scratch_XXXXXX");
+      if((fd = mkstemp(&path[0])) == -1){
+        throw std::ios_base::failure(std::string("Could not create scratch file in ").append(path));
+      }
+      unlink(path.c_str());
+#endif
+    }
+
+    ~ScratchFile(){
+      try{release();}catch(std::ios_base::failure &){}
+#ifdef _WIN32
+      std::fclose(fp);
+#else
+      close(fd);
+#endif
+    }
+
+    /**
+     * @return (offset_t) size of the contents in bytes
+     */
+    const offset_t &size() const {return length;}
+
+    /**
+     * Append data to the end of the file.
+     *
+     * @param data data
+     * @param size size of data in bytes
+     */
+    void write(const void *data, std::size_t size) throw(std::ios_base::failure) {
+      const char *src(static_cast<const char *>(data));
+      while(size > 0){
+        if((!window) || (!window_dirty)
+            || (length >= window_offset + (offset_t)window_size)){
+          acquire(length - (length % window_size), true);
+        }
+        std::size_t pos(length - window_offset);
+        std::size_t chunk(std::min(size, window_size - pos));
+        std::memcpy(window + pos, src, chunk);
+        length += chunk;
+        window_length = pos + chunk;
+        src += chunk;
+        size -= chunk;
+      }
+    }
+
+    /**
+     * Backward reader.
+     * Each read() returns the block just before the previous one.
+     */
+    class reverse_reader {
+      protected:
+        ScratchFile &file;
+        offset_t position;
+      public:
+        reverse_reader(ScratchFile &_file) : file(_file), position(_file.length) {
+          file.release();
+#ifndef _WIN32
+          if(ftruncate(file.fd, file.length) != 0){
+            throw std::ios_base::failure("Could not truncate scratch file");
+          }
+#endif
+        }
+        bool empty() const {return position <= 0;}
+        /**
+         * Read a block backward.
+         * The returned pointer is valid until the next call.
+         *
+         * @param size size of the block in bytes, which must be smaller than the window size
+         * @return (const char *) head of the block
+         */
+        const char *read(const std::size_t &size) throw(std::ios_base::failure) {
+          if((offset_t)size > position){
+            throw std::ios_base::failure("Scratch file underflow");
+          }
+          if(size > file.window_size - file.page_size){
+            throw std::ios_base::failure("Too large block for scratch file");
+          }
+          position -= size;
+          if((!file.window) || file.window_dirty
+              || (position < file.window_offset)
+              || (position + (offset_t)size > file.window_offset + (offset_t)file.window_length)){
+            // The new window ends at or after the end of the block.
+            offset_t start(std::max((offset_t)0, position + (offset_t)size - (offset_t)file.window_size));
+            start = ((start + file.page_size - 1) / file.page_size) * file.page_size;
+            file.acquire(start, false);
+          }
+          return file.window + (position - file.window_offset);
+        }
+    };
+};
+
+#endif /* __SCRATCH_FILE_H__ */
@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef __SHM_RING_H__
+#define __SHM_RING_H__
+
+#include <ios>
+#include <string>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
+/**
+ * Ring buffer of fixed size records in shared memory,
+ * which is written by a single process and read by any number of processes.
+ *
+ * Each slot has a sequence counter, which is 2n+1 while the n-th record is being written,
+ * and 2n+2 after completed. A reader accesses a record in place without system calls,
+ * then confirms that the counter is unchanged, i.e., the record was not overwritten meanwhile.
+ * The writer never waits for the readers; a reader which is too slow only misses records.
+ *
+ * The shared memory is named by shm_open(3) on POSIX, and by a file mapping object on Windows.
+ * The writer removes the name when closed, while the readers attached already can continue.
+ * A name which is used by another living writer is rejected.
+ * On POSIX, a name left by a writer which has exited without closing (e.g., crashed) is removed
+ * and created again, therefore the readers attached to the old one are never resized under them;
+ * they stop receiving new records and should attach again.
+ *
+ * @param T type of a record, which must be a plain old data
+ */
+template <class T>
+class SharedMemoryRing {
+  public:
+    struct header_t {
+      char magic[8];
+      unsigned int record_size; ///< sizeof(T), which is checked by the readers
+      unsigned int capacity; ///< number of slots, power of 2
+      volatile unsigned int written; ///< number of records written so far
+      int writer_id; ///< process ID of the writer
+      char reserved[64 - 8 - sizeof(unsigned int) * 3 - sizeof(int)];
+    };
+    struct slot_t {
+      volatile unsigned int sequence;
+      T value;
+    };
+
+  protected:
+    static const char *magic(){return "SHMRING";}
+    
+    std::string name;
+    bool writer;
+    std::size_t mapped_size;
+    header_t *header;
+    slot_t *slots;
+#ifdef _WIN32
+    HANDLE mapping;
+#endif
+
+    static void barrier(){
+#ifdef _MSC_VER
+      MemoryBarrier();
+#else
+      __sync_synchronize();
+#endif
+    }
+
+#ifndef _WIN32
+    /**
+     * Check whether the existing shared memory of the name is left by a writer which has exited.
+     *
+     * @return (bool) true when left, false when its writer is alive or unknown
+     */
+    bool is_stale() const {
+      int fd(shm_open(name.c_str(), O_RDONLY, 0));
+      if(fd == -1){return errno == ENOENT;}
+      struct stat st;
+      bool res(false);
+      if((fstat(fd, &st) == 0) && ((std::size_t)st.st_size >= sizeof(header_t))){
+        void *p(mmap(NULL, sizeof(header_t), PROT_READ, MAP_SHARED, fd, 0));
+        if(p != MAP_FAILED){
+          const header_t *h(static_cast<const header_t *>(p));
+          res = (std::strncmp(h->magic, magic(), sizeof(h->magic)) != 0) // broken
+              || ((kill(h->writer_id, 0) != 0) && (errno == ESRCH)); // writer has exited
+          munmap(p, sizeof(header_t));
+        }
+      }else{
+        res = true; // broken
+      }
+      close(fd);
+      return res;
+    }
+#endif
+
+    void *map(const bool &create, const std::size_t &size) throw(std::ios_base::failure) {
+      void *res;
+#ifdef _WIN32
+      mapping = create
+          ? CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, (DWORD)size, name.c_str())
+          : OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+      if(!mapping){
+        throw std::ios_base::failure(std::string("Could not open shared memory ").append(name));
+      }
+      if(create && (GetLastError() == ERROR_ALREADY_EXISTS)){ // it lives as long as its users
+        CloseHandle(mapping);
+        throw std::ios_base::failure(std::string("Shared memory is used by another writer ").append(name));
+      }
+      res = MapViewOfFile(mapping, create ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+      if(!res){
+        CloseHandle(mapping);
+        throw std::ios_base::failure(std::string("Could not map shared memory ").append(name));
+      }
+#else
+      int fd(create
+          ? shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644)
+          : shm_open(name.c_str(), O_RDONLY, 0));
+      if(create && (fd == -1) && (errno == EEXIST)){
+        if(!is_stale()){
+          throw std::ios_base::failure(std::string("Shared memory is used by another writer ").append(name));
+        }
+        shm_unlink(name.c_str());
+        fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+      }
+      if(fd == -1){
+        throw std::ios_base::failure(std::string("Could not open shared memory ").append(name));
+      }
+      if(create && (ftruncate(fd, size) != 0)){
+        close(fd);
+        shm_unlink(name.c_str());
+        throw std::ios_base::failure(std::string("Could not resize shared memory ").append(name));
+      }
+      res = mmap(NULL, size, create ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, fd, 0);
+      close(fd);
+      if(res == MAP_FAILED){
+        throw std::ios_base::failure(std::string("Could not map shared memory ").append(name));
+      }
+#endif
+      return res;
+    }
+    
+    void unmap(){
+#ifdef _WIN32
+      UnmapViewOfFile(header);
+      CloseHandle(mapping);
+#else
+      munmap(header, mapped_size);
+#endif
+    }
+
+  private:
+    SharedMemoryRing(const SharedMemoryRing &);
+    SharedMemoryRing &operator=(const SharedMemoryRing &);
+
+  public:
+    /**
+     * Create a ring as the writer.
+     *
+     * @param _name name of the shared memory, for example, "/ins_gps" on POSIX
+     * @param capacity_min minimum number of slots, which is rounded up to a power of 2, and at least 2
+     * so that the latest completed record is never the slot being written
+     */
+    SharedMemoryRing(const char *_name, const unsigned int &capacity_min)
+        throw(std::ios_base::failure)
+        : name(_name), writer(true) {
+      unsigned int capacity(2);
+      while(capacity < capacity_min){capacity <<= 1;}
+      mapped_size = sizeof(header_t) + sizeof(slot_t) * capacity;
+      header = static_cast<header_t *>(map(true, mapped_size));
+      slots = reinterpret_cast<slot_t *>(header + 1);
+      
+      std::memset(header->magic, 0, sizeof(header->magic)); // invalidate until initialized
+      barrier();
+      header->record_size = sizeof(T);
+      header->capacity = capacity;
+      header->written = 0;
+#ifdef _WIN32
+      header->writer_id = (int)GetCurrentProcessId();
+#else
+      header->writer_id = (int)getpid();
+#endif
+      for(unsigned int i(0); i < capacity; i++){
+        slots[i].sequence = 0;
+      }
+      barrier();
+      std::strcpy(header->magic, magic());
+    }
+
+    /**
+     * Attach to an existing ring as a reader.
+     *
+     * @param _name name of the shared memory
+     */
+    SharedMemoryRing(const char *_name) throw(std::ios_base::failure)
+        : name(_name), writer(false) {
+      mapped_size = sizeof(header_t);
+      header = static_cast<header_t *>(map(false, mapped_size));
+      if((std::strcmp(header->magic, magic()) != 0) || (header->record_size != sizeof(T))){
+        unmap();
+        throw std::ios_base::failure(std::string("Incompatible shared memory ").append(name));
+      }
+      std::size_t size(sizeof(header_t) + sizeof(slot_t) * header->capacity);
+      unmap();
+      mapped_size = size;
+      header = static_cast<header_t *>(map(false, mapped_size));
+      slots = reinterpret_cast<slot_t *>(header + 1);
+    }
+
+    ~SharedMemoryRing(){
+      unmap();
+#ifndef _WIN32
+      if(writer){shm_unlink(name.c_str());}
+#endif
+    }
+
+    unsigned int capacity() const {return header->capacity;}
+
+    /**
+     * Get the slot of the next record to be written in place (writer only).
+     * It must be followed by end_write().
+     *
+     * @return (T &) record
+     */
+    T &begin_write(){
+      const unsigned int n(header->written);
+      slot_t &slot(slots[n & (header->capacity - 1)]);
+      slot.sequence = n * 2 + 1;
+      barrier();
+      return slot.value;
+    }
+
+    /**
+     * Publish the record obtained by begin_write() (writer only).
+     */
+    void end_write(){
+      const unsigned int n(header->written);
+      barrier();
+      slots[n & (header->capacity - 1)].sequence = n * 2 + 2;
+      barrier();
+      header->written = n + 1;
+    }
+
+    /**
+     * Write a record (writer only).
+     *
+     * @param value record
+     */
+    void push(const T &value){
+      begin_write() = value;
+      end_write();
+    }
+
+    /**
+     * @return (unsigned int) number of records written so far,
+     * therefore the latest one is written() - 1.
+     */
+    unsigned int written() const {
+      unsigned int res(header->written);
+      barrier();
+      return res;
+    }
+
+    /**
+     * Access the n-th record in place.
+     * Since it may be overwritten at any time, verify() must be checked after use.
+     *
+     * @param n sequence number of the record
+     * @return (const T *) record, or NULL when not written yet or already overwritten
+     */
+    const T *peek(const unsigned int &n) const {
+      const slot_t &slot(slots[n & (header->capacity - 1)]);
+      if(slot.sequence != n * 2 + 2){return NULL;}
+      barrier();
+      return &slot.value;
+    }
+
+    /**
+     * @param n sequence number of the record accessed by peek()
+     * @return (bool) true when the record has not been overwritten since peek()
+     */
+    bool verify(const unsigned int &n) const {
+      barrier();
+      return slots[n & (header->capacity - 1)].sequence == n * 2 + 2;
+    }
+
+    /**
+     * Copy the latest record.
+     *
+     * @param res record
+     * @param retry_max maximum number of attempts
+     * when the record is overwritten while being copied
+     * @return (bool) true when copied, false when no record is written yet,
+     * or when no attempt succeeds, for example, the writer has stopped in the middle of writing
+     */
+    bool latest(T &res, const unsigned int &retry_max = 8) const {
+      for(unsigned int i(0); i < retry_max; i++){
+        const unsigned int n(written());
+        if(n == 0){return false;}
+        const T *p(peek(n - 1));
+        if(!p){continue;}
+        res = *p;
+        if(verify(n - 1)){return true;}
+      }
+      return false;
+    }
+};
+
+#endif /* __SHM_RING_H__ */
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2015, M.Naruoka (fenrir)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * - Redistributions of source code must retain the above copyright notice,
+ *   this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright notice,
+ *   this list of conditions and the following disclaimer in the documentation
+ *   and/or other materials provided with the distribution.
+ * - Neither the name of the naruoka.org nor the names of its contributors
+ *   may be used to endorse or promote products derived from this software
+ *   without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY,
+ * OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef __TIME_RING_H__
+#define __TIME_RING_H__
+
+#include <vector>
+
+/**
+ * Fixed capacity ring buffer of time stamped samples, such as sensor data.
+ * The time stamps must be non-decreasing in order of push_back(),
+ * therefore a sample at an arbitrary time is found by binary search.
+ * When the buffer is full, push_back() discards the oldest one.
+ * Both push_back() and pop_front() are O(1) without heap allocation.
+ *
+ * @param T type of a sample, whose time stamp is T::itow
+ * @param TimeT type of the time stamp
+ */
+template <class T, class TimeT = double>
+class TimeRing {
+  protected:
+    std::vector<T> storage;
+    unsigned int head, length;
+
+  public:
+    TimeRing(const unsigned int &capacity)
+        : storage(capacity), head(0), length(0) {}
+
+    unsigned int capacity() const {return storage.size();}
+    unsigned int size() const {return length;}
+    bool empty() const {return length == 0;}
+    bool full() const {return length == storage.size();}
+
+    /**
+     * @param index 0 is the oldest
+     */
+    T &operator[](const unsigned int &index){
+      return storage[(head + index) % storage.size()];
+    }
+    const T &operator[](const unsigned int &index) const {
+      return storage[(head + index) % storage.size()];
+    }
+    T &front(){return (*this)[0];}
+    const T &front() const {return (*this)[0];}
+    T &back(){return (*this)[length - 1];}
+    const T &back() const {return (*this)[length - 1];}
+
+    /**
+     * Append a sample. When full, the oldest one is discarded.
+     *
+     * @param value sample, whose time stamp must not be older than back()
+     */
+    void push_back(const T &value){
+      if(length == storage.size()){
+        head = (head + 1) % storage.size();
+        length--;
+      }
+      (*this)[length++] = value;
+    }
+
+    /**
+     * Discard the oldest samples.
+     *
+     * @param count number of samples to be discarded
+     */
+    void pop_front(unsigned int count = 1){
+      if(count > length){count = length;}
+      head = (head + count) % storage.size();
+      length -= count;
+    }
+
+    void clear(){head = length = 0;}
+
+    /**
+     * Find the first sample whose time stamp is not older than the specified time.
+     *
+     * @param t time
+     * @return (unsigned int) index of the sample, or size() when all samples are older
+     */
+    unsigned int lower_bound(const TimeT &t) const {
+      unsigned int first(0), count(length);
+      while(count > 0){
+        unsigned int step(count / 2), mid(first + step);
+        if((*this)[mid].itow < t){
+          first = mid + 1;
+          count -= step + 1;
+        }else{
+          count = step;
+        }
+      }
+      return first;
+    }
+
+    /**
+     * Find the pair of samples bracketing the specified time,
+     * which is used to interpolate (or extrapolate at the both ends) a value as
+     * (*this)[index] * (1 - ratio) + (*this)[index + 1] * ratio.
+     *
+     * @param t time
+     * @param index index of the earlier sample of the pair
+     * @param ratio position of t in the pair, which is out of [0, 1] for extrapolation
+     * @return (bool) true when found, false when less than two samples are stored
+     */
+    bool bracket(const TimeT &t, unsigned int &index, TimeT &ratio) const {
+      if(length < 2){return false;}
+      index = lower_bound(t);
+      index = (index == 0) ? 0 : ((index >= length) ? (length - 2) : (index - 1));
+      TimeT interval((*this)[index + 1].itow - (*this)[index].itow);
+      ratio = (interval > 0) ? ((t - (*this)[index].itow) / interval) : 1;
+      return true;
+    }
+
+    /**
+     * Weights of cubic Hermite (Catmull-Rom) interpolation,
+     * which interpolates samples y[-1], y[0], y[1], y[2] at ratio between y[0] and y[1]
+     * with continuous first derivatives, suitable for angular rates.
+     * It assumes samples are equally spaced.
+     *
+     * @param ratio position between y[0] and y[1]
+     * @param weights weights of y[-1], y[0], y[1], y[2]
+     */
+    static void hermite_weights(const TimeT &ratio, TimeT (&weights)[4]){
+      TimeT r2(ratio * ratio), r3(r2 * ratio);
+      weights[0] = (-r3 + r2 * 2 - ratio) / 2;
+      weights[1] = (r3 * 3 - r2 * 5 + 2) / 2;
+      weights[2] = (-r3 * 3 + r2 * 4 + ratio) / 2;
+      weights[3] = (r3 - r2) / 2;
+    }
+};
+
+#endif /* __TIME_RING_H__ */